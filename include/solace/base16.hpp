@@ -23,10 +23,18 @@
 #define SOLACE_BASE16_HPP
 
 #include "solace/encoder.hpp"
+#include "solace/stringView.hpp"
 
 
 namespace Solace {
 
+/// Case of letter digits 'a'-'f' produced by Base16 encoders. Decoders accept both.
+enum class Base16Case : byte {
+    Lower,
+    Upper
+};
+
+
 /**
  * RFC-4648 compatible Base16 encoder.
  */
@@ -38,8 +46,9 @@ public:
 
 public:
 
-    Base16Encoder(ByteWriter& dest) :
-        Encoder(dest)
+    Base16Encoder(ByteWriter& dest, Base16Case letterCase = Base16Case::Lower) :
+        Encoder(dest),
+        _letterCase{letterCase}
     {}
 
 	size_type encodedSize(MemoryView data) const override;
@@ -48,6 +57,10 @@ public:
 
     Result<void, Error>
 	encode(MemoryView src) override;
+
+private:
+
+    Base16Case      _letterCase;
 };
 
 class Base16Encoded_Iterator {
@@ -151,5 +164,101 @@ Base16Decoded_Iterator base16Decode_end(MemoryView src) {
     return {src.end(), src.end()};
 }
 
+
+/**
+ * Base16 encoder for data that comes in chunks.
+ * Optionally output is broken into lines of the given length. No line break is written after the last line.
+ */
+class Base16StreamEncoder : public StreamEncoder {
+public:
+    using StreamEncoder::size_type;
+
+public:
+
+    /**
+     * Construct a new encoder.
+     * @param dest Destination buffer to write encoded data to.
+     * @param lineLength Max number of characters in a line of output, rounded down to a multiple of 2.
+     * Zero disables line wrapping.
+     * @param lineBreak Separator to write between lines.
+     */
+    Base16StreamEncoder(ByteWriter& dest, size_type lineLength = 0, StringLiteral lineBreak = "\n",
+                        Base16Case letterCase = Base16Case::Lower) :
+        StreamEncoder(dest),
+        _lineLength{lineLength & ~size_type{1}},
+        _lineBreak{lineBreak},
+        _letterCase{letterCase}
+    {}
+
+    Base16StreamEncoder(ByteWriter& dest, Base16Case letterCase) :
+        Base16StreamEncoder(dest, 0, "\n", letterCase)
+    {}
+
+    /** Get exact number of bytes the next call to encode(data) will write. */
+	size_type encodedSize(MemoryView data) const override;
+
+    using StreamEncoder::encode;
+
+    Result<void, Error>
+	encode(MemoryView src) override;
+
+    Result<void, Error>
+    finish() override;
+
+    void reset() noexcept override;
+
+private:
+
+    size_type       _lineLength;
+    StringView      _lineBreak;
+    Base16Case      _letterCase;
+    size_type       _column{0};
+};
+
+
+/**
+ * Base16 decoder for data that comes in chunks.
+ * A character of a pair split between chunks is carried over to the next call.
+ * White space is skipped, so line wrapped data can be fed as is.
+ */
+class Base16StreamDecoder : public StreamEncoder {
+public:
+    using StreamEncoder::size_type;
+
+public:
+
+    Base16StreamDecoder(ByteWriter& dest) :
+        StreamEncoder(dest)
+    {}
+
+    /** Get the max number of bytes the next call to encode(data) may write. */
+	size_type encodedSize(MemoryView data) const override;
+
+    using StreamEncoder::encode;
+
+    /**
+     * Decode the input, carrying over the first character of an incomplete pair.
+     * Unlike Base16Decoder, output is not atomic: bytes decoded before an error are written.
+     * @return Error if the input has a character that is neither a hex digit nor white space,
+     * or the destination is full.
+     */
+    Result<void, Error>
+	encode(MemoryView src) override;
+
+    /**
+     * Check that no character is left carried over.
+     * @return Error if input has ended with a half of a pair.
+     */
+    Result<void, Error>
+    finish() override;
+
+    void reset() noexcept override;
+
+private:
+
+    bool            _hasHighNibble{false};
+    byte            _highNibble{0};
+};
+
 }  // End of namespace Solace
 #endif  // SOLACE_BASE16_HPP
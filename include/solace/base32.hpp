@@ -0,0 +1,283 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/base32.hpp
+ *	@brief		Base32 encoders and decoders.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_BASE32_HPP
+#define SOLACE_BASE32_HPP
+
+#include "solace/encoder.hpp"
+
+
+namespace Solace {
+
+namespace details {
+/// Description of a Base32 alphabet variant. Not to be used directly.
+struct Base32Alphabet;
+}  // namespace details
+
+
+/**
+ * RFC-4648 compatible Base32 encoder.
+ * Output is padded with '=' to a multiple of 8 characters.
+ */
+class Base32Encoder : public Encoder {
+public:
+    using Encoder::size_type;
+
+    /** Get the size of padded Base32 encoding of the given number of bytes. */
+    static size_type encodedSize(size_type len);
+
+public:
+
+    Base32Encoder(ByteWriter& dest);
+
+	size_type encodedSize(MemoryView data) const override;
+
+    using Encoder::encode;
+
+    Result<void, Error>
+	encode(MemoryView src) override;
+
+protected:
+
+    Base32Encoder(ByteWriter& dest, details::Base32Alphabet const& alphabet) :
+        Encoder(dest),
+        _alphabet{&alphabet}
+    {}
+
+private:
+
+    details::Base32Alphabet const* _alphabet;
+};
+
+
+/**
+ * RFC-4648 compatible Base32 decoder.
+ * Both upper and lower case letters are accepted. Padding is optional.
+ */
+class Base32Decoder : public Encoder {
+public:
+    using Encoder::size_type;
+
+public:
+
+    Base32Decoder(ByteWriter& dest);
+
+    /** Get the max number of bytes encoded data may decode to. */
+	size_type encodedSize(MemoryView data) const override;
+
+    using Encoder::encode;
+
+    /**
+     * Decode given data.
+     * @return Error if data contains characters outside of the alphabet or ends with an incomplete group.
+     */
+    Result<void, Error>
+	encode(MemoryView src) override;
+
+protected:
+
+    Base32Decoder(ByteWriter& dest, details::Base32Alphabet const& alphabet) :
+        Encoder(dest),
+        _alphabet{&alphabet}
+    {}
+
+private:
+
+    details::Base32Alphabet const* _alphabet;
+};
+
+
+/**
+ * RFC-4648 Base32 encoder with "Extended Hex" alphabet that preserves sort order of encoded data.
+ */
+class Base32HexEncoder : public Base32Encoder {
+public:
+    using Base32Encoder::size_type;
+
+public:
+
+    Base32HexEncoder(ByteWriter& dest);
+};
+
+
+/**
+ * RFC-4648 Base32 decoder for "Extended Hex" alphabet.
+ */
+class Base32HexDecoder : public Base32Decoder {
+public:
+    using Base32Decoder::size_type;
+
+public:
+
+    Base32HexDecoder(ByteWriter& dest);
+};
+
+
+/**
+ * Crockford's Base32 encoder: human readable alphabet that excludes I, L, O and U. Output is not padded.
+ */
+class CrockfordBase32Encoder : public Base32Encoder {
+public:
+    using Base32Encoder::size_type;
+
+public:
+
+    CrockfordBase32Encoder(ByteWriter& dest);
+};
+
+
+/**
+ * Crockford's Base32 decoder.
+ * Decoding is case insensitive, 'I' and 'L' are read as '1', 'O' is read as '0' and hyphens are ignored.
+ */
+class CrockfordBase32Decoder : public Base32Decoder {
+public:
+    using Base32Decoder::size_type;
+
+public:
+
+    CrockfordBase32Decoder(ByteWriter& dest);
+};
+
+
+/**
+ * Base32 encoder for data that comes in chunks.
+ * Up to 4 bytes that do not form a complete group are carried over to the next call.
+ * The final group, padded if the alphabet uses padding, is written by finish().
+ */
+class Base32StreamEncoder : public StreamEncoder {
+public:
+    using StreamEncoder::size_type;
+
+public:
+
+    Base32StreamEncoder(ByteWriter& dest);
+
+    /** Get exact number of bytes the next call to encode(data) will write. */
+	size_type encodedSize(MemoryView data) const override;
+
+    using StreamEncoder::encode;
+
+    Result<void, Error>
+	encode(MemoryView src) override;
+
+    Result<void, Error>
+    finish() override;
+
+    void reset() noexcept override;
+
+protected:
+
+    Base32StreamEncoder(ByteWriter& dest, details::Base32Alphabet const& alphabet) :
+        StreamEncoder(dest),
+        _alphabet{&alphabet}
+    {}
+
+private:
+
+    details::Base32Alphabet const*  _alphabet;
+    size_type                       _carryCount{0};
+    byte                            _carry[5]{};
+};
+
+
+/**
+ * Base32 decoder for data that comes in chunks.
+ * Characters that do not form a complete group are carried over to the next call. White space is skipped.
+ */
+class Base32StreamDecoder : public StreamEncoder {
+public:
+    using StreamEncoder::size_type;
+
+public:
+
+    Base32StreamDecoder(ByteWriter& dest);
+
+    /** Get the max number of bytes the next call to encode(data) may write. */
+	size_type encodedSize(MemoryView data) const override;
+
+    using StreamEncoder::encode;
+
+    Result<void, Error>
+	encode(MemoryView src) override;
+
+    /**
+     * Decode carried over characters of unpadded input.
+     * @return Error if carried over characters do not form a valid final group.
+     */
+    Result<void, Error>
+    finish() override;
+
+    void reset() noexcept override;
+
+protected:
+
+    Base32StreamDecoder(ByteWriter& dest, details::Base32Alphabet const& alphabet) :
+        StreamEncoder(dest),
+        _alphabet{&alphabet}
+    {}
+
+private:
+
+    details::Base32Alphabet const*  _alphabet;
+    size_type                       _carryCount{0};
+    byte                            _carry[8]{};
+    bool                            _padded{false};
+};
+
+
+/**
+ * Streaming variant of Base32 encoder with "Extended Hex" alphabet.
+ */
+class Base32HexStreamEncoder : public Base32StreamEncoder {
+public:
+    Base32HexStreamEncoder(ByteWriter& dest);
+};
+
+
+/**
+ * Streaming variant of Base32 decoder for "Extended Hex" alphabet.
+ */
+class Base32HexStreamDecoder : public Base32StreamDecoder {
+public:
+    Base32HexStreamDecoder(ByteWriter& dest);
+};
+
+
+/**
+ * Streaming variant of Crockford's Base32 encoder.
+ */
+class CrockfordBase32StreamEncoder : public Base32StreamEncoder {
+public:
+    CrockfordBase32StreamEncoder(ByteWriter& dest);
+};
+
+
+/**
+ * Streaming variant of Crockford's Base32 decoder.
+ */
+class CrockfordBase32StreamDecoder : public Base32StreamDecoder {
+public:
+    CrockfordBase32StreamDecoder(ByteWriter& dest);
+};
+
+}  // End of namespace Solace
+#endif  // SOLACE_BASE32_HPP
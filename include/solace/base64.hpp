@@ -23,6 +23,7 @@
 #define SOLACE_BASE64_HPP
 
 #include "solace/encoder.hpp"
+#include "solace/stringView.hpp"
 
 namespace Solace {
 
@@ -122,5 +123,138 @@ public:
 };
 
 
+/**
+ * Base64 encoder for data that comes in chunks.
+ * Unlike Base64Encoder, that pads output after each call, this encoder carries up to 2 bytes that do not form
+ * a complete group over to the next call. Padding is written by finish().
+ *
+ * Optionally output is broken into lines of the given length, e.g. kMimeLineLength with "\r\n" for MIME
+ * or kPemLineLength with "\n" for PEM. No line break is written after the last line.
+ */
+class Base64StreamEncoder : public StreamEncoder {
+public:
+    using StreamEncoder::size_type;
+
+    /// Max length of a line of encoded data in MIME (RFC-2045).
+    static constexpr size_type kMimeLineLength = 76;
+
+    /// Length of a line of encoded data in PEM (RFC-7468).
+    static constexpr size_type kPemLineLength = 64;
+
+public:
+
+    /**
+     * Construct a new encoder.
+     * @param dest Destination buffer to write encoded data to.
+     * @param lineLength Max number of characters in a line of output, rounded down to a multiple of 4.
+     * Zero disables line wrapping.
+     * @param lineBreak Separator to write between lines.
+     */
+    Base64StreamEncoder(ByteWriter& dest, size_type lineLength = 0, StringLiteral lineBreak = "\r\n");
+
+    /** Get exact number of bytes the next call to encode(data) will write. */
+	size_type encodedSize(MemoryView data) const override;
+
+    using StreamEncoder::encode;
+
+    Result<void, Error>
+	encode(MemoryView src) override;
+
+    Result<void, Error>
+    finish() override;
+
+    void reset() noexcept override;
+
+protected:
+
+    Base64StreamEncoder(ByteWriter& dest, byte const* alphabet, size_type lineLength, StringLiteral lineBreak);
+
+    size_type wrappedSize(size_type groupsCount) const noexcept;
+    byte* writeGroups(byte* dest, byte const* src, size_type len) noexcept;
+
+private:
+
+    byte const*     _alphabet;
+    size_type       _lineLength;
+    StringView      _lineBreak;
+    size_type       _column{0};
+    size_type       _carryCount{0};
+    byte            _carry[3]{};
+};
+
+
+/**
+ * Base64 decoder for data that comes in chunks.
+ * Characters that do not form a complete group are carried over to the next call.
+ * Line breaks and other white space are skipped, so wrapped MIME or PEM data can be fed as is.
+ * Any other character that is not part of the alphabet or padding is an error.
+ */
+class Base64StreamDecoder : public StreamEncoder {
+public:
+    using StreamEncoder::size_type;
+
+public:
+
+    Base64StreamDecoder(ByteWriter& dest);
+
+    /** Get the max number of bytes the next call to encode(data) may write. */
+	size_type encodedSize(MemoryView data) const override;
+
+    using StreamEncoder::encode;
+
+    Result<void, Error>
+	encode(MemoryView src) override;
+
+    /**
+     * Decode carried over characters of unpadded input.
+     * @return Error if a single character has been carried.
+     */
+    Result<void, Error>
+    finish() override;
+
+    void reset() noexcept override;
+
+protected:
+
+    Base64StreamDecoder(ByteWriter& dest, byte const* decodingTable);
+
+    Result<void, Error> flushCarry();
+
+private:
+
+    byte const*     _decodingTable;
+    size_type       _carryCount{0};
+    byte            _carry[4]{};
+    bool            _padded{false};
+    size_type       _paddingLeft{0};
+};
+
+
+/**
+ * URL safe variant of streaming Base64 encoder.
+ */
+class Base64UrlStreamEncoder : public Base64StreamEncoder {
+public:
+    using Base64StreamEncoder::size_type;
+
+public:
+
+    Base64UrlStreamEncoder(ByteWriter& dest, size_type lineLength = 0, StringLiteral lineBreak = "\r\n");
+};
+
+
+/**
+ * URL safe variant of streaming Base64 decoder.
+ */
+class Base64UrlStreamDecoder : public Base64StreamDecoder {
+public:
+    using Base64StreamDecoder::size_type;
+
+public:
+
+    Base64UrlStreamDecoder(ByteWriter& dest);
+};
+
+
 }  // End of namespace Solace
 #endif  // SOLACE_BASE64_HPP
@@ -0,0 +1,42 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/bitOrder.hpp
+ *	@brief		Order of bits in bit-packed streams.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_BITORDER_HPP
+#define SOLACE_BITORDER_HPP
+
+
+namespace Solace {
+
+/**
+ * Order in which bits of a stream are packed into bytes.
+ */
+enum class BitOrder {
+    /// First bit of the stream is the most significant bit of the first byte; values are stored high bits first.
+    /// Used by most network protocols, JPEG and H.264.
+    MsbFirst,
+
+    /// First bit of the stream is the least significant bit of the first byte; values are stored low bits first.
+    /// Used by Deflate and most integer bit-packing codecs.
+    LsbFirst
+};
+
+}  // End of namespace Solace
+#endif  // SOLACE_BITORDER_HPP
@@ -0,0 +1,217 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/bitReader.hpp
+ *	@brief		Bit-level stream reader.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_BITREADER_HPP
+#define SOLACE_BITREADER_HPP
+
+#include "solace/bitOrder.hpp"
+#include "solace/memoryView.hpp"
+#include "solace/arrayView.hpp"
+
+#include "solace/details/byte_swap.hpp"
+
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+
+namespace Solace {
+
+/**
+ * Reader of bit-packed data.
+ *
+ * Bits are read from a 64 bit buffer refilled a whole word at a time, so reading a field takes a shift and a mask
+ * with no per-bit or per-byte loops. Reader does not own the memory it reads.
+ * All read methods leave the position unchanged on error.
+ */
+class BitReader {
+public:
+    using size_type = MemoryView::size_type;
+
+    /// Max number of bits peekBits() can look ahead.
+    static constexpr uint32 kMaxPeekBits = 56;
+
+public:
+
+    /** Construct an empty reader */
+    constexpr BitReader() noexcept = default;
+
+    /**
+     * Construct a reader of the given data.
+     * @param data Data to read bits from.
+     * @param order Order in which bits are packed.
+     */
+    BitReader(MemoryView data, BitOrder order = BitOrder::MsbFirst) noexcept
+        : _begin{data.begin()}
+        , _next{data.begin()}
+        , _end{data.end()}
+        , _order{order}
+    {
+        refill();
+    }
+
+    /** Get order in which bits are read. */
+    constexpr BitOrder order() const noexcept { return _order; }
+
+    /** Get total number of bits in the stream. */
+    size_type limit() const noexcept { return static_cast<size_type>(_end - _begin) * 8; }
+
+    /** Get current position in the stream, in bits. */
+    size_type bitPosition() const noexcept { return static_cast<size_type>(_next - _begin) * 8 - _bitsAvailable; }
+
+    /**
+     * Set current position in the stream.
+     * @param newPosition Position in bits. Must not exceed the limit.
+     */
+    Result<void, Error> bitPosition(size_type newPosition) noexcept;
+
+    /** Get number of bits left to read. */
+    size_type remainingBits() const noexcept { return static_cast<size_type>(_end - _next) * 8 + _bitsAvailable; }
+
+    /** Check if there are bits left to read. */
+    bool hasRemaining() const noexcept { return remainingBits() > 0; }
+
+    /** Skip the given number of bits. */
+    Result<void, Error> skipBits(size_type count) noexcept {
+        if (remainingBits() < count) {
+            return makeError(SystemErrors::Overflow, "BitReader::skipBits()");
+        }
+
+        return bitPosition(bitPosition() + count);
+    }
+
+    /** Skip bits up to the next byte boundary. */
+    BitReader& alignToByte() noexcept {
+        consumeUnchecked(_bitsAvailable % 8);
+
+        return *this;
+    }
+
+    /**
+     * Get the next bits without advancing the position.
+     * @param count Number of bits to peek: [0, kMaxPeekBits].
+     */
+    Result<uint64, Error> peekBits(uint32 count) noexcept {
+        if (count > kMaxPeekBits) {
+            return makeError(GenericError::RANGE, "BitReader::peekBits()");
+        }
+        if (remainingBits() < count) {
+            return makeError(SystemErrors::Overflow, "BitReader::peekBits()");
+        }
+
+        refill();
+        return Ok(peekUnchecked(count));
+    }
+
+    /**
+     * Read a value stored in the given number of bits.
+     * @param count Number of bits to read: [0, 64].
+     */
+    Result<uint64, Error> readBits(uint32 count) noexcept {
+        if (count > kMaxPeekBits) {
+            return readWide(count);
+        }
+        if (remainingBits() < count) {
+            return makeError(SystemErrors::Overflow, "BitReader::readBits()");
+        }
+
+        refill();
+        auto const value = peekUnchecked(count);
+        consumeUnchecked(count);
+
+        return Ok(value);
+    }
+
+    /** Read a single bit. */
+    Result<bool, Error> readBit() noexcept {
+        if (!hasRemaining()) {
+            return makeError(SystemErrors::Overflow, "BitReader::readBit()");
+        }
+
+        refill();
+        auto const value = peekUnchecked(1);
+        consumeUnchecked(1);
+
+        return Ok(value != 0);
+    }
+
+    /**
+     * Read an array of values packed with the same number of bits each.
+     * @param values Destination for unpacked values. Its size determines number of values to read.
+     * @param bitWidth Number of bits each value is stored in: [0, 32].
+     */
+    Result<void, Error> readPacked(ArrayView<uint32> values, uint32 bitWidth) noexcept;
+
+protected:
+
+    Result<uint64, Error> readWide(uint32 count) noexcept;
+
+    /// Load more bits into the buffer. Leaves at least kMaxPeekBits bits in the buffer, unless at the end of data.
+    void refill() noexcept {
+        if (_end - _next >= 8) {
+            // Load a whole word, and only keep as many bytes of it as fit into the buffer completely.
+            if (_order == BitOrder::MsbFirst) {
+                _buffer |= details::loadBE<uint64>(_next) >> _bitsAvailable;
+            } else {
+                _buffer |= details::loadLE<uint64>(_next) << _bitsAvailable;
+            }
+
+            _next += (63 - _bitsAvailable) >> 3;
+            _bitsAvailable |= 56;
+        } else {
+            refillTail();
+        }
+    }
+
+    /// Load the remaining bytes when less than a word of data is left.
+    void refillTail() noexcept;
+
+    /// Most significant end of the buffer holds the next bits in MSB mode, least significant end in LSB mode.
+    uint64 peekUnchecked(uint32 count) const noexcept {
+        return (_order == BitOrder::MsbFirst)
+                ? (_buffer >> 1) >> (63 - count)
+                : _buffer & ((uint64{1} << count) - 1);
+    }
+
+    void consumeUnchecked(uint32 count) noexcept {
+        if (_order == BitOrder::MsbFirst) {
+            _buffer <<= count;
+        } else {
+            _buffer >>= count;
+        }
+
+        _bitsAvailable -= count;
+    }
+
+private:
+
+    byte const* _begin{nullptr};
+    byte const* _next{nullptr};     //!< Next byte to load into the buffer
+    byte const* _end{nullptr};
+
+    uint64      _buffer{0};
+    uint32      _bitsAvailable{0};  //!< Number of valid bits in the buffer
+
+    BitOrder    _order{BitOrder::MsbFirst};
+};
+
+}  // End of namespace Solace
+#endif  // SOLACE_BITREADER_HPP
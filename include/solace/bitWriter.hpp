@@ -0,0 +1,183 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/bitWriter.hpp
+ *	@brief		Bit-level stream writer.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_BITWRITER_HPP
+#define SOLACE_BITWRITER_HPP
+
+#include "solace/bitOrder.hpp"
+#include "solace/mutableMemoryView.hpp"
+#include "solace/arrayView.hpp"
+
+#include "solace/details/byte_swap.hpp"
+
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+
+namespace Solace {
+
+/**
+ * Writer of bit-packed data.
+ *
+ * Bits are accumulated in a 64 bit buffer that is stored a whole word at a time when there is enough room.
+ * Writer may overwrite destination bytes past the current position. Last partial byte is only stored by flush().
+ * All write methods leave the position unchanged on error.
+ */
+class BitWriter {
+public:
+    using size_type = MutableMemoryView::size_type;
+
+public:
+
+    /** Construct an empty writer */
+    constexpr BitWriter() noexcept = default;
+
+    /**
+     * Construct a writer into the given memory.
+     * @param dest Memory to write bits into.
+     * @param order Order in which bits are packed.
+     */
+    BitWriter(MutableMemoryView dest, BitOrder order = BitOrder::MsbFirst) noexcept
+        : _begin{dest.begin()}
+        , _next{dest.begin()}
+        , _end{dest.end()}
+        , _order{order}
+    {}
+
+    /** Get order in which bits are written. */
+    constexpr BitOrder order() const noexcept { return _order; }
+
+    /** Get capacity of the destination in bits. */
+    size_type limit() const noexcept { return static_cast<size_type>(_end - _begin) * 8; }
+
+    /** Get current position in the stream, in bits. */
+    size_type bitPosition() const noexcept { return static_cast<size_type>(_next - _begin) * 8 + _bitsUsed; }
+
+    /** Get number of bits that can still be written. */
+    size_type remainingBits() const noexcept { return limit() - bitPosition(); }
+
+    /** Get number of bytes written so far, including the last partial one. */
+    size_type bytesWritten() const noexcept { return (bitPosition() + 7) / 8; }
+
+    /**
+     * Write a value using the given number of bits.
+     * @param value Value to write. Bits above the count are ignored.
+     * @param count Number of bits to write: [0, 64].
+     */
+    Result<void, Error> writeBits(uint64 value, uint32 count) noexcept {
+        if (count > kMaxFastBits) {
+            return writeWide(value, count);
+        }
+        if (remainingBits() < count) {
+            return makeError(SystemErrors::Overflow, "BitWriter::writeBits()");
+        }
+
+        writeUnchecked(value, count);
+
+        return Ok();
+    }
+
+    /** Write a single bit. */
+    Result<void, Error> writeBit(bool value) noexcept {
+        return writeBits(value ? 1 : 0, 1);
+    }
+
+    /**
+     * Write an array of values using the same number of bits for each.
+     * @param values Values to write. Bits above the bitWidth are ignored.
+     * @param bitWidth Number of bits to write each value with: [0, 32].
+     */
+    Result<void, Error> writePacked(ArrayView<uint32 const> values, uint32 bitWidth) noexcept;
+
+    /** Pad with zero bits up to the next byte boundary. */
+    BitWriter& alignToByte() noexcept {
+        if (_bitsUsed > 0) {
+            _bitsUsed = 8;
+            storeBytes();
+        }
+
+        return *this;
+    }
+
+    /** Store the last partial byte, so that bytesWritten() bytes of the destination hold the data written. */
+    BitWriter& flush() noexcept {
+        if (_bitsUsed > 0) {
+            *_next = static_cast<byte>((_order == BitOrder::MsbFirst) ? (_buffer >> 56) : _buffer);
+        }
+
+        return *this;
+    }
+
+protected:
+
+    /// Max number of bits that can be added to the buffer at once.
+    static constexpr uint32 kMaxFastBits = 56;
+
+    Result<void, Error> writeWide(uint64 value, uint32 count) noexcept;
+
+    /// Most significant end of the buffer holds the first bits in MSB mode, least significant end in LSB mode.
+    void writeUnchecked(uint64 value, uint32 count) noexcept {
+        auto const bits = value & ((uint64{1} << count) - 1);
+        _buffer |= (_order == BitOrder::MsbFirst)
+                ? (bits << 1) << (63 - _bitsUsed - count)  // Shift in two steps to keep it defined for count 0
+                : bits << _bitsUsed;
+        _bitsUsed += count;
+
+        storeBytes();
+    }
+
+    /// Move complete bytes out of the buffer into the destination.
+    void storeBytes() noexcept {
+        if (_end - _next >= 8) {
+            auto const bytes = _bitsUsed >> 3;
+            if (_order == BitOrder::MsbFirst) {
+                details::storeBE(_next, _buffer);
+                _buffer <<= 8 * bytes;
+            } else {
+                details::storeLE(_next, _buffer);
+                _buffer >>= 8 * bytes;
+            }
+
+            _next += bytes;
+            _bitsUsed &= 7;
+        } else {
+            storeTail();
+        }
+    }
+
+    /// Store complete bytes one at a time when less than a word of space is left.
+    void storeTail() noexcept;
+
+private:
+
+    byte*       _begin{nullptr};
+    byte*       _next{nullptr};     //!< Destination of the first byte in the buffer
+    byte*       _end{nullptr};
+
+    uint64      _buffer{0};
+    uint32      _bitsUsed{0};       //!< Number of bits in the buffer, less than 8 between calls
+
+    BitOrder    _order{BitOrder::MsbFirst};
+};
+
+}  // End of namespace Solace
+#endif  // SOLACE_BITWRITER_HPP
@@ -25,6 +25,12 @@
 #include "solace/memoryView.hpp"
 #include "solace/mutableMemoryView.hpp"     // read destination
 #include "solace/memoryResource.hpp"
+#include "solace/arrayView.hpp"
+#include "solace/varint.hpp"
+
+#include "solace/details/byte_swap.hpp"
+
+#include <cstring>  // memcpy
 
 #include "solace/result.hpp"
 #include "solace/error.hpp"
@@ -41,6 +47,8 @@ class ByteReader {
 public:
     using size_type = MemoryResource::size_type;
 
+    class Cursor;
+
 public:
 
     /** Construct an empty buffer of size zero */
@@ -252,8 +260,72 @@ public:
     Result<void, Error>  readBE(int64& value) noexcept { return readBE(reinterpret_cast<uint64&>(value)); }
     Result<void, Error>  readBE(uint64& value)noexcept;
 
+    /**
+     * Read an array of values converting each from the given byte order.
+     * @return Error if there is not enough data to read all the values. Nothing is read in that case.
+     */
+    Result<void, Error>  readLE(ArrayView<uint16> values) noexcept {
+        return readArray(values.begin(), values.size(), sizeof(uint16), false);
+    }
+
+    Result<void, Error>  readLE(ArrayView<uint32> values) noexcept {
+        return readArray(values.begin(), values.size(), sizeof(uint32), false);
+    }
+
+    Result<void, Error>  readLE(ArrayView<uint64> values) noexcept {
+        return readArray(values.begin(), values.size(), sizeof(uint64), false);
+    }
+
+    Result<void, Error>  readBE(ArrayView<uint16> values) noexcept {
+        return readArray(values.begin(), values.size(), sizeof(uint16), true);
+    }
+
+    Result<void, Error>  readBE(ArrayView<uint32> values) noexcept {
+        return readArray(values.begin(), values.size(), sizeof(uint32), true);
+    }
+
+    Result<void, Error>  readBE(ArrayView<uint64> values) noexcept {
+        return readArray(values.begin(), values.size(), sizeof(uint64), true);
+    }
+
+    /**
+     * Read a variable length integer: unsigned LEB128, signed values are ZigZag decoded.
+     * @return Error if data ends before the integer does or encoded value does not fit the type.
+     * Position is not changed in case of an error.
+     */
+    Result<void, Error>  readVarint(int32& value) noexcept;
+    Result<void, Error>  readVarint(uint32& value) noexcept;
+    Result<void, Error>  readVarint(int64& value) noexcept;
+    Result<void, Error>  readVarint(uint64& value) noexcept;
+
+    /**
+     * Read a sequence of unsigned LEB128 integers.
+     * @param values Destination to store values into. The number of values to read is the size of the destination.
+     * @return Error if data ends before all values are read or the data is malformed.
+     * Position is not changed in case of an error but the content of the destination is unspecified.
+     */
+    Result<void, Error>  readVarints(ArrayView<uint64> values) noexcept;
+
+    /**
+     * Read a sequence of integers in group varint encoding. @see ByteWriter::writeGroupVarint
+     * @param values Destination to store values into. The number of values to read is the size of the destination.
+     * @return Error if data ends before all values are read.
+     * Position is not changed in case of an error but the content of the destination is unspecified.
+     */
+    Result<void, Error>  readGroupVarint(ArrayView<uint32> values) noexcept;
+
+    /**
+     * Ensure that the given number of bytes is available to read without per read checks.
+     * @param size Number of bytes that are going to be read.
+     * @return A cursor to read the bytes with or an error if there is not enough data remaining.
+     * @see ByteReader::Cursor
+     */
+    Result<Cursor, Error> ensure(size_type size) noexcept;
+
 protected:
 	Result<void, Error>  read(MemoryView::MutableMemoryAddress dest, size_type count) noexcept;
+	Result<void, Error>  readArray(MemoryView::MutableMemoryAddress dest, size_type count, size_type valueSize,
+								   bool bigEndian) noexcept;
 
 protected:
 
@@ -265,6 +337,107 @@ protected:
 };
 
 
+/**
+ * Raw cursor over the data made available by ByteReader::ensure().
+ * Reads through the cursor are not checked: it is up to the caller not to read more than ensured.
+ * Bytes read are consumed, advancing the reader's position, when the cursor is destroyed.
+ * The reader must not be used otherwise while the cursor exists.
+ */
+class ByteReader::Cursor {
+public:
+
+    Cursor(Cursor const&) = delete;
+    Cursor& operator= (Cursor const&) = delete;
+
+    Cursor(Cursor&& other) noexcept
+        : _reader{exchange(other._reader, nullptr)}
+        , _begin{other._begin}
+        , _pos{other._pos}
+        , _end{other._end}
+    {}
+
+    Cursor& operator= (Cursor&&) = delete;
+
+    ~Cursor() {
+        if (_reader) {
+            _reader->_position += consumed();
+        }
+    }
+
+    /** Number of bytes read through the cursor. */
+    size_type consumed() const noexcept { return static_cast<size_type>(_pos - _begin); }
+
+    /** Number of ensured bytes not yet read. */
+    size_type remaining() const noexcept { return static_cast<size_type>(_end - _pos); }
+
+    /** Address of the next byte to read. Use advance() after reading through it directly. */
+    byte const* data() const noexcept { return _pos; }
+
+    Cursor& advance(size_type count) noexcept { _pos += count; return *this; }
+
+    byte get() noexcept { return *_pos++; }
+
+    Cursor& read(MutableMemoryView dest) noexcept {
+        std::memcpy(dest.dataAddress(), _pos, dest.size());
+        _pos += dest.size();
+
+        return *this;
+    }
+
+    Cursor& readLE(uint16& value) noexcept {
+        value = details::loadLE<uint16>(_pos);
+        _pos += sizeof(value);
+        return *this;
+    }
+
+    Cursor& readLE(uint32& value) noexcept {
+        value = details::loadLE<uint32>(_pos);
+        _pos += sizeof(value);
+        return *this;
+    }
+
+    Cursor& readLE(uint64& value) noexcept {
+        value = details::loadLE<uint64>(_pos);
+        _pos += sizeof(value);
+        return *this;
+    }
+
+    Cursor& readBE(uint16& value) noexcept {
+        value = details::loadBE<uint16>(_pos);
+        _pos += sizeof(value);
+        return *this;
+    }
+
+    Cursor& readBE(uint32& value) noexcept {
+        value = details::loadBE<uint32>(_pos);
+        _pos += sizeof(value);
+        return *this;
+    }
+
+    Cursor& readBE(uint64& value) noexcept {
+        value = details::loadBE<uint64>(_pos);
+        _pos += sizeof(value);
+        return *this;
+    }
+
+private:
+    friend class ByteReader;
+
+    Cursor(ByteReader& reader, byte const* begin, size_type size) noexcept
+        : _reader{&reader}
+        , _begin{begin}
+        , _pos{begin}
+        , _end{begin + size}
+    {}
+
+private:
+    ByteReader*     _reader;
+    byte const*     _begin;
+    byte const*     _pos;
+    byte const*     _end;
+};
+
+
 inline
 void swap(ByteReader& lhs, ByteReader& rhs) noexcept {
     lhs.swap(rhs);
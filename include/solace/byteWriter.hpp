@@ -24,6 +24,12 @@
 
 #include "solace/mutableMemoryView.hpp"
 #include "solace/memoryResource.hpp"
+#include "solace/arrayView.hpp"
+#include "solace/varint.hpp"
+
+#include "solace/details/byte_swap.hpp"
+
+#include <cstring>  // memcpy
 
 #include "solace/result.hpp"
 #include "solace/error.hpp"
@@ -39,6 +45,8 @@ class ByteWriter {
 public:
     using size_type = MemoryResource::size_type;
 
+    class Cursor;
+
 public:
 
     /** Construct an empty writer that has nowhere to write too */
@@ -253,9 +261,63 @@ public:
     Result<void, Error> writeBE(int64 value) noexcept { return writeBE(static_cast<uint64>(value)); }
     Result<void, Error> writeBE(uint64 value) noexcept;
 
+    /**
+     * Write an array of values converting each to the given byte order.
+     * @return Error if all the values don't fit. Nothing is written in that case.
+     */
+    Result<void, Error> writeLE(ArrayView<uint16 const> values) noexcept {
+        return writeArray(values.data(), values.size(), sizeof(uint16), false);
+    }
+
+    Result<void, Error> writeLE(ArrayView<uint32 const> values) noexcept {
+        return writeArray(values.data(), values.size(), sizeof(uint32), false);
+    }
+
+    Result<void, Error> writeLE(ArrayView<uint64 const> values) noexcept {
+        return writeArray(values.data(), values.size(), sizeof(uint64), false);
+    }
+
+    Result<void, Error> writeBE(ArrayView<uint16 const> values) noexcept {
+        return writeArray(values.data(), values.size(), sizeof(uint16), true);
+    }
+
+    Result<void, Error> writeBE(ArrayView<uint32 const> values) noexcept {
+        return writeArray(values.data(), values.size(), sizeof(uint32), true);
+    }
+
+    Result<void, Error> writeBE(ArrayView<uint64 const> values) noexcept {
+        return writeArray(values.data(), values.size(), sizeof(uint64), true);
+    }
+
+    // Variable length integers: unsigned LEB128, signed values are ZigZag encoded first.
+    Result<void, Error> writeVarint(int32 value)  noexcept { return writeVarint(zigZagEncode(value)); }
+    Result<void, Error> writeVarint(uint32 value) noexcept { return writeVarint(static_cast<uint64>(value)); }
+    Result<void, Error> writeVarint(int64 value)  noexcept { return writeVarint(zigZagEncode(value)); }
+    Result<void, Error> writeVarint(uint64 value) noexcept;
+
+    /**
+     * Write values using group varint encoding.
+     * Each group of 4 values is written as a tag byte followed by the values in little endian, 1 to 4 bytes each.
+     * Tag holds (length - 1) of each value in a pair of bits, first value in the lowest bits.
+     * The last group may hold less than 4 values: its tag bits for the missing values are zero.
+     * @param values Values to write.
+     * @return Result of write operation. Nothing is written if values don't fit.
+     */
+    Result<void, Error> writeGroupVarint(ArrayView<uint32 const> values) noexcept;
+
+    /**
+     * Reserve space for writing without per write checks.
+     * @param size Number of bytes to reserve.
+     * @return A cursor to write into the reserved space or an error if there is not enough space remaining.
+     * @see ByteWriter::Cursor
+     */
+    Result<Cursor, Error> reserve(size_type size) noexcept;
+
 protected:
 
 	Result<void, Error> write(MemoryView::MemoryAddress srcAddr, size_type count) noexcept;
+	Result<void, Error> writeArray(MemoryView::MemoryAddress srcAddr, size_type count, size_type valueSize,
+								   bool bigEndian) noexcept;
 
 private:
 
@@ -266,6 +328,79 @@ private:
 };
 
 
+/**
+ * Raw cursor into the space reserved in a writer with ByteWriter::reserve().
+ * Writes through the cursor are not checked: it is up to the caller not to write more than reserved.
+ * Bytes written are committed to the writer, advancing its position, when the cursor is destroyed.
+ * The writer must not be used otherwise while the cursor exists.
+ */
+class ByteWriter::Cursor {
+public:
+
+    Cursor(Cursor const&) = delete;
+    Cursor& operator= (Cursor const&) = delete;
+
+    Cursor(Cursor&& other) noexcept
+        : _writer{exchange(other._writer, nullptr)}
+        , _begin{other._begin}
+        , _pos{other._pos}
+        , _end{other._end}
+    {}
+
+    Cursor& operator= (Cursor&&) = delete;
+
+    ~Cursor() {
+        if (_writer) {
+            _writer->_position += written();
+        }
+    }
+
+    /** Number of bytes written through the cursor. */
+    size_type written() const noexcept { return static_cast<size_type>(_pos - _begin); }
+
+    /** Number of reserved bytes not yet written. */
+    size_type remaining() const noexcept { return static_cast<size_type>(_end - _pos); }
+
+    /** Address of the next byte to write. Use advance() after writing through it directly. */
+    byte* data() noexcept { return _pos; }
+
+    Cursor& advance(size_type count) noexcept { _pos += count; return *this; }
+
+    Cursor& write(byte value) noexcept { *_pos++ = value; return *this; }
+
+    Cursor& write(MemoryView data) noexcept {
+        std::memcpy(_pos, data.dataAddress(), data.size());
+        _pos += data.size();
+
+        return *this;
+    }
+
+    Cursor& writeLE(uint16 value) noexcept { details::storeLE(_pos, value); _pos += sizeof(value); return *this; }
+    Cursor& writeLE(uint32 value) noexcept { details::storeLE(_pos, value); _pos += sizeof(value); return *this; }
+    Cursor& writeLE(uint64 value) noexcept { details::storeLE(_pos, value); _pos += sizeof(value); return *this; }
+
+    Cursor& writeBE(uint16 value) noexcept { details::storeBE(_pos, value); _pos += sizeof(value); return *this; }
+    Cursor& writeBE(uint32 value) noexcept { details::storeBE(_pos, value); _pos += sizeof(value); return *this; }
+    Cursor& writeBE(uint64 value) noexcept { details::storeBE(_pos, value); _pos += sizeof(value); return *this; }
+
+private:
+    friend class ByteWriter;
+
+    Cursor(ByteWriter& writer, byte* begin, size_type size) noexcept
+        : _writer{&writer}
+        , _begin{begin}
+        , _pos{begin}
+        , _end{begin + size}
+    {}
+
+private:
+    ByteWriter*     _writer;
+    byte*           _begin;
+    byte*           _pos;
+    byte*           _end;
+};
+
+
 inline void swap(ByteWriter& lhs, ByteWriter& rhs) noexcept {
     lhs.swap(rhs);
 }
@@ -0,0 +1,166 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/chainReader.hpp
+ *	@brief		Byte reader over a sequence of non-contiguous memory segments.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_CHAINREADER_HPP
+#define SOLACE_CHAINREADER_HPP
+
+#include "solace/memoryView.hpp"
+#include "solace/mutableMemoryView.hpp"     // read destination
+#include "solace/arrayView.hpp"
+
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
+
+namespace Solace {
+
+/**
+ * Stream reader over a chain of memory segments, such as buffers of a message received in parts.
+ * It mirrors reading API of ByteReader without coalescing segments into a contiguous buffer first:
+ * reads that cross segments boundaries are assembled transparently.
+ *
+ * Position and limit are offsets into the logical concatenation of all segments.
+ * Segments array and the memory it refers to must outlive the reader.
+ */
+class ChainReader {
+public:
+    using size_type = MemoryView::size_type;
+
+public:
+
+    /** Construct an empty reader */
+    constexpr ChainReader() noexcept = default;
+
+    /**
+     * Construct a reader over a chain of segments.
+     * @param segments Segments to read, in order. Empty segments are allowed.
+     */
+    ChainReader(ArrayView<MemoryView const> segments) noexcept;
+
+    /** Get total number of bytes in all the segments. */
+    constexpr size_type limit() const noexcept { return _limit; }
+
+    /** Get remaining number of bytes in the chain. */
+    constexpr size_type remaining() const noexcept { return limit() - position(); }
+
+    /** Check if there are bytes left to read. */
+    constexpr bool hasRemaining() const noexcept { return remaining() > 0; }
+
+    /** Get current position in the chain. */
+    constexpr size_type position() const noexcept { return _position; }
+
+    /**
+     * Set current position to the given one.
+     * @param newPosition Position in the chain to set. Must not exceed the limit.
+     */
+    Result<void, Error> position(size_type newPosition) noexcept;
+
+    /** Set position back to the previously saved mark */
+    Result<void, Error> reset(size_type savedMark) noexcept { return position(savedMark); }
+
+    /** Set position back to the start of the chain. */
+    ChainReader& rewind() noexcept;
+
+    /**
+     * Increment current position by the given amount.
+     * @param increment Amount to advance current position by.
+     */
+    Result<void, Error> advance(size_type increment) noexcept;
+
+    /** Get number of segments in the chain. */
+    constexpr size_type segmentsCount() const noexcept { return _segments.size(); }
+
+    /**
+     * Get a view of the bytes remaining in the current segment.
+     * @note Unlike ByteReader this is not all of the remaining data, unless the chain has a single segment.
+     */
+    MemoryView viewRemaining() const noexcept;
+
+    /**
+     * Get a view of the next bytes without copying if they all are in the current segment.
+     * Otherwise the bytes are assembled in the given scratch buffer.
+     * @param size Number of bytes to read.
+     * @param scratch Buffer to copy bytes into if they cross segments boundary. Must be at least size bytes.
+     * @return View of the bytes read or an error. Position is unchanged on error.
+     */
+    Result<MemoryView, Error> readView(size_type size, MutableMemoryView scratch) noexcept;
+
+    /** Get a single byte and advance current position. */
+    Result<byte, Error> get() noexcept;
+
+    /**
+     * Copy bytes into the destination. Destination size determines number of bytes to read.
+     * @return Error if the chain has fewer bytes remaining. Position is unchanged on error.
+     */
+    Result<void, Error> read(MutableMemoryView dest) noexcept {
+        return read(dest.dataAddress(), dest.size());
+    }
+
+    Result<void, Error>  read(char*      dest) noexcept { return read(dest, sizeof(char));    }
+    Result<void, Error>  read(int8*      dest) noexcept { return read(dest, sizeof(int8));    }
+    Result<void, Error>  read(uint8*     dest) noexcept { return read(dest, sizeof(uint8));   }
+    Result<void, Error>  read(int16*     dest) noexcept { return read(dest, sizeof(int16));   }
+    Result<void, Error>  read(uint16*    dest) noexcept { return read(dest, sizeof(uint16));  }
+    Result<void, Error>  read(int32*     dest) noexcept { return read(dest, sizeof(int32));   }
+    Result<void, Error>  read(uint32*    dest) noexcept { return read(dest, sizeof(uint32));  }
+    Result<void, Error>  read(int64*     dest) noexcept { return read(dest, sizeof(int64));   }
+    Result<void, Error>  read(uint64*    dest) noexcept { return read(dest, sizeof(uint64));  }
+    Result<void, Error>  read(float32*   dest) noexcept { return read(dest, sizeof(float32)); }
+    Result<void, Error>  read(float64*   dest) noexcept { return read(dest, sizeof(float64)); }
+
+    // Endianess aware read methods
+    Result<void, Error>  readLE(int8& value)  noexcept { return read(&value, sizeof(int8)); }
+    Result<void, Error>  readLE(uint8& value) noexcept { return read(&value, sizeof(uint8)); }
+    Result<void, Error>  readLE(int16& value) noexcept { return readLE(reinterpret_cast<uint16&>(value)); }
+    Result<void, Error>  readLE(uint16& value)noexcept;
+    Result<void, Error>  readLE(int32& value) noexcept { return readLE(reinterpret_cast<uint32&>(value)); }
+    Result<void, Error>  readLE(uint32& value)noexcept;
+    Result<void, Error>  readLE(int64& value) noexcept { return readLE(reinterpret_cast<uint64&>(value)); }
+    Result<void, Error>  readLE(uint64& value)noexcept;
+
+    Result<void, Error>  readBE(int8& value)  noexcept { return read(&value, sizeof(int8)); }
+    Result<void, Error>  readBE(uint8& value) noexcept { return read(&value, sizeof(uint8)); }
+    Result<void, Error>  readBE(int16& value) noexcept { return readBE(reinterpret_cast<uint16&>(value)); }
+    Result<void, Error>  readBE(uint16& value)noexcept;
+    Result<void, Error>  readBE(int32& value) noexcept { return readBE(reinterpret_cast<uint32&>(value)); }
+    Result<void, Error>  readBE(uint32& value)noexcept;
+    Result<void, Error>  readBE(int64& value) noexcept { return readBE(reinterpret_cast<uint64&>(value)); }
+    Result<void, Error>  readBE(uint64& value)noexcept;
+
+protected:
+
+    Result<void, Error> read(void* dest, size_type bytesToRead) noexcept;
+
+    /// Move position forward, crossing segments as needed, and copy bytes passed over if dest is not null.
+    /// Caller checks that enough bytes remain.
+    void consume(byte* dest, size_type count) noexcept;
+
+private:
+
+    ArrayView<MemoryView const> _segments;
+    size_type                   _segmentIndex{0};   //!< Current segment
+    size_type                   _segmentOffset{0};  //!< Offset of the position in the current segment
+    size_type                   _position{0};
+    size_type                   _limit{0};
+};
+
+}  // End of namespace Solace
+#endif  // SOLACE_CHAINREADER_HPP
@@ -261,6 +261,17 @@ public:
      */
 	static Char toUpper(Char const& c) noexcept { return c.toUpper(); }
 
+    /** Fold an ASCII character to lower case.
+     * Unlike toLower() this is locale independent: only 'A'..'Z' are mapped, any other byte is returned as is.
+     *
+     * @return Lower case of an ASCII letter or the argument itself.
+     */
+    static constexpr char foldAscii(char c) noexcept {
+        return (c >= 'A' && c <= 'Z')
+                ? static_cast<char>(c | 0x20)
+                : c;
+    }
+
 private:
 
     union {
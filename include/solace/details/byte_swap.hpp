@@ -0,0 +1,85 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/details/byte_swap.hpp
+ *  @brief		Implemenetation details: bulk byte order conversion.
+ * Note: Not to be included directly.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_DETAILS_BYTE_SWAP_HPP
+#define SOLACE_DETAILS_BYTE_SWAP_HPP
+
+#include "solace/types.hpp"
+
+#include <cstddef>
+
+
+namespace Solace { namespace details {
+
+/**
+ * Copy an array of values reversing byte order of each value.
+ * @param dest Destination address. Must not overlap the source.
+ * @param src Source address.
+ * @param count Number of values to copy.
+ * @param valueSize Size of a value in bytes: 2, 4 or 8.
+ */
+void copyByteSwapped(void* dest, void const* src, size_t count, size_t valueSize) noexcept;
+
+
+/**
+ * Store an unsigned value in little / big endian byte order independent of the host byte order.
+ * Compilers turn these into a single store, with a byte swap if needed.
+ */
+template<typename T>
+inline void storeLE(byte* dest, T value) noexcept {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        dest[i] = static_cast<byte>(value >> (8 * i));
+    }
+}
+
+template<typename T>
+inline void storeBE(byte* dest, T value) noexcept {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        dest[i] = static_cast<byte>(value >> (8 * (sizeof(T) - 1 - i)));
+    }
+}
+
+
+/** Load an unsigned value stored in little / big endian byte order. */
+template<typename T>
+inline T loadLE(byte const* src) noexcept {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<T>(static_cast<T>(src[i]) << (8 * i));
+    }
+
+    return value;
+}
+
+template<typename T>
+inline T loadBE(byte const* src) noexcept {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value = static_cast<T>((value << 8) | src[i]);
+    }
+
+    return value;
+}
+
+}  // End of namespace details
+}  // End of namespace Solace
+#endif  // SOLACE_DETAILS_BYTE_SWAP_HPP
@@ -0,0 +1,82 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/details/cpu_features.hpp
+ *  @brief		Implemenetation details: run-time CPU feature detection.
+ * Note: Not to be included directly.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_DETAILS_CPU_FEATURES_HPP
+#define SOLACE_DETAILS_CPU_FEATURES_HPP
+
+
+/**
+ * SOLACE_X86_DISPATCH is defined when the compiler can build functions for an instruction set
+ * wider than the one the library is compiled for and check CPU support for it at run-time.
+ * SOLACE_TARGET(isa) marks such function.
+ */
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SOLACE_X86_DISPATCH 1
+#define SOLACE_TARGET(isa) __attribute__((target(isa)))
+
+#include <cpuid.h>
+#endif
+
+
+namespace Solace { namespace details {
+
+/// Set of optional CPU features library code can take advantage of.
+struct CpuFeatures {
+	bool ssse3{false};
+	bool sse41{false};
+	bool sse42{false};
+	bool avx2{false};
+	bool avx512f{false};
+	bool sha{false};    //!< SHA-1 and SHA-256 instructions
+};
+
+
+/**
+ * Get features supported by the CPU the code is running on.
+ * Detection is done once and the result is cached.
+ */
+inline CpuFeatures const& cpuFeatures() noexcept {
+	static CpuFeatures const features = []() {
+		CpuFeatures f;
+#if defined(SOLACE_X86_DISPATCH)
+		__builtin_cpu_init();
+		f.ssse3 = __builtin_cpu_supports("ssse3");
+		f.sse41 = __builtin_cpu_supports("sse4.1");
+		f.sse42 = __builtin_cpu_supports("sse4.2");
+		f.avx2 = __builtin_cpu_supports("avx2");
+		f.avx512f = __builtin_cpu_supports("avx512f");
+
+		// Not all compiler versions know "sha" feature name, so query CPUID leaf 7 directly.
+		unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+		if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+			f.sha = (ebx & (1U << 29)) != 0;
+		}
+#endif
+		return f;
+	}();
+
+	return features;
+}
+
+}  // End of namespace details
+}  // End of namespace Solace
+#endif  // SOLACE_DETAILS_CPU_FEATURES_HPP
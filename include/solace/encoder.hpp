@@ -82,5 +82,35 @@ private:
 };
 
 
+/**
+ * Base class for encoders / decoders that can be fed data in chunks.
+ * A partial group of input that can not be transformed yet is carried over to the next call to encode().
+ * Once all the data has been fed finish() must be called to flush remaining state.
+ */
+class StreamEncoder : public Encoder {
+public:
+    using Encoder::size_type;
+
+public:
+
+    StreamEncoder(ByteWriter& dest) :
+        Encoder(dest)
+    {}
+
+    /**
+     * Flush any carried over input and reset the state so that a new stream can be encoded.
+     * @return Error if destination buffer is full or input ended with an incomplete group.
+     */
+    virtual Result<void, Error>
+    finish() = 0;
+
+    /**
+     * Drop any carried over input and reset the state.
+     * Use it to start over after an error.
+     */
+    virtual void reset() noexcept = 0;
+};
+
+
 }  // End of namespace Solace
 #endif  // SOLACE_ENCODER_HPP
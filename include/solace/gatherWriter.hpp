@@ -0,0 +1,189 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/gatherWriter.hpp
+ *	@brief		Writer that collects a chain of memory segments for vectored IO.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_GATHERWRITER_HPP
+#define SOLACE_GATHERWRITER_HPP
+
+#include "solace/mutableMemoryView.hpp"
+#include "solace/memoryResource.hpp"
+#include "solace/memoryManager.hpp"
+#include "solace/arrayView.hpp"
+#include "solace/byteWriter.hpp"
+
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
+#include <sys/uio.h>  // iovec
+
+
+namespace Solace {
+
+/**
+ * Write-only adapter that collects output as a chain of memory segments ready for writev() / sendmsg().
+ *
+ * Small writes are copied into a scratch arena, with consecutive copies coalesced into one segment.
+ * Views of at least copyThreshold bytes are referenced without a copy:
+ * memory they point to must stay valid and unchanged until the output is sent.
+ * Writes are atomic: a write that doesn't fit either the segments or the scratch arena changes nothing.
+ *
+ * Use clear() to reuse the writer for the next message.
+ */
+class GatherWriter {
+public:
+    using size_type = MemoryView::size_type;
+
+    /// Writes of this size or larger are referenced rather than copied by default.
+    static constexpr size_type kDefaultCopyThreshold = 256;
+
+public:
+
+    GatherWriter(GatherWriter const&) = delete;
+    GatherWriter& operator= (GatherWriter const&) = delete;
+
+    GatherWriter(GatherWriter&&) noexcept = default;
+    GatherWriter& operator= (GatherWriter&&) noexcept = default;
+
+    /**
+     * Construct a writer over caller owned memory.
+     * @param segments Storage for the segments chain. Limits number of segments.
+     * @param scratch Arena to copy small writes into.
+     * @param copyThreshold Size of writes that are referenced rather than copied.
+     */
+    GatherWriter(ArrayView<iovec> segments, MutableMemoryView scratch,
+                 size_type copyThreshold = kDefaultCopyThreshold) noexcept
+        : _segments{segments.begin()}
+        , _maxSegments{segments.size()}
+        , _scratch{scratch.begin()}
+        , _scratchSize{scratch.size()}
+        , _copyThreshold{copyThreshold}
+    {}
+
+    /** Get total number of bytes written. */
+    constexpr size_type size() const noexcept { return _size; }
+
+    /** Check if nothing has been written. */
+    constexpr bool empty() const noexcept { return (_size == 0); }
+
+    /** Get number of segments in the chain. */
+    constexpr size_type segmentsCount() const noexcept { return _segmentsCount; }
+
+    /** Get number of bytes of the scratch arena still available for copies. */
+    constexpr size_type scratchRemaining() const noexcept { return _scratchSize - _scratchUsed; }
+
+    /** Get the chain of segments to pass to writev() / sendmsg(). */
+    ArrayView<iovec const> iovecs() const noexcept {
+        return arrayView(static_cast<iovec const*>(_segments), _segmentsCount);
+    }
+
+    /** Forget all the segments and reuse the scratch arena. */
+    GatherWriter& clear() noexcept {
+        _segmentsCount = 0;
+        _scratchUsed = 0;
+        _size = 0;
+
+        return *this;
+    }
+
+    /**
+     * Write data: copy it if it's smaller than the copy threshold, reference it otherwise.
+     * @param data Data to write.
+     * @return Error if the data does not fit.
+     */
+    Result<void, Error> write(MemoryView data) noexcept {
+        return (data.size() < _copyThreshold)
+                ? copy(data)
+                : reference(data);
+    }
+
+    /** Write a copy of the data into the scratch arena. */
+    Result<void, Error> copy(MemoryView data) noexcept;
+
+    /**
+     * Append the data to the chain without copying it.
+     * @note Data must stay valid until the output is sent.
+     */
+    Result<void, Error> reference(MemoryView data) noexcept;
+
+    Result<void, Error> write(char value)    noexcept { return copy(wrapMemory(&value, sizeof(value))); }
+    Result<void, Error> write(uint8 value)   noexcept { return copy(wrapMemory(&value, sizeof(value))); }
+
+    // Endianess aware write methods
+    Result<void, Error> writeLE(uint16 value) noexcept;
+    Result<void, Error> writeLE(uint32 value) noexcept;
+    Result<void, Error> writeLE(uint64 value) noexcept;
+
+    Result<void, Error> writeBE(uint16 value) noexcept;
+    Result<void, Error> writeBE(uint32 value) noexcept;
+    Result<void, Error> writeBE(uint64 value) noexcept;
+
+    /**
+     * Copy all the segments into a contiguous destination.
+     * @return Error if destination doesn't have enough space. Nothing is written in that case.
+     */
+    Result<void, Error> copyTo(ByteWriter& dest) const noexcept;
+
+private:
+    friend Result<GatherWriter, Error>
+    makeGatherWriter(MemoryManager& memManager, size_type maxSegments, size_type scratchSize, size_type copyThreshold);
+
+    GatherWriter(MemoryResource&& memory, size_type maxSegments, size_type copyThreshold) noexcept;
+
+    /// Append a segment to the chain, extending the last one if the data follows it in memory.
+    Result<void, Error> append(byte const* data, size_type size, StringLiteral tag) noexcept;
+
+private:
+
+    MemoryResource  _memory;    //!< Owns segments and scratch if created with makeGatherWriter()
+
+    iovec*          _segments;
+    size_type       _maxSegments;
+    size_type       _segmentsCount{0};
+
+    byte*           _scratch;
+    size_type       _scratchSize;
+    size_type       _scratchUsed{0};
+
+    size_type       _copyThreshold;
+    size_type       _size{0};
+};
+
+
+/**
+ * Create a gather writer that owns its segments storage and scratch arena.
+ * @param memManager Memory manager to allocate storage.
+ * @param maxSegments Max number of segments in the chain.
+ * @param scratchSize Size of the arena for small writes.
+ * @param copyThreshold Size of writes that are referenced rather than copied.
+ * @return New writer or an error.
+ */
+Result<GatherWriter, Error>
+makeGatherWriter(MemoryManager& memManager, GatherWriter::size_type maxSegments, GatherWriter::size_type scratchSize,
+                 GatherWriter::size_type copyThreshold = GatherWriter::kDefaultCopyThreshold);
+
+/**
+ * Create a gather writer using system heap memory manager.
+ */
+Result<GatherWriter, Error>
+makeGatherWriter(GatherWriter::size_type maxSegments, GatherWriter::size_type scratchSize,
+                 GatherWriter::size_type copyThreshold = GatherWriter::kDefaultCopyThreshold);
+
+}  // End of namespace Solace
+#endif  // SOLACE_GATHERWRITER_HPP
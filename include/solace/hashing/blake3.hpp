@@ -0,0 +1,167 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/hashing/blake3.hpp
+ *	@brief		BLAKE3 cryptographic hash function.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_HASHING_BLAKE3_HPP
+#define SOLACE_HASHING_BLAKE3_HPP
+
+
+#include "solace/hashing/digestAlgorithm.hpp"
+
+#include "solace/mutableMemoryView.hpp"
+#include "solace/stringView.hpp"
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
+
+namespace Solace {
+namespace hashing {
+
+/**
+ * Implementation of BLAKE3 cryptographic hash function.
+ *
+ * Input is split into 1 KiB chunks that are the leaves of a binary hash tree. Whole chunks are compressed
+ * several at a time with SSE4.1, AVX2 or AVX-512, when the CPU supports them,
+ * and large inputs can be hashed by a number of threads with updateParallel().
+ *
+ * Besides the regular hashing, BLAKE3 has a keyed mode (a MAC / PRF) and a key derivation mode.
+ * Output can be extended to any length with finalize().
+ */
+class Blake3 final :
+        public HashingAlgorithm {
+public:
+    using HashingAlgorithm::size_type;
+
+    /// Size of the key for keyed hashing in bytes.
+    static constexpr size_type kKeySize = 32;
+
+    /// Size of the default output in bytes.
+    static constexpr size_type kDigestSize = 32;
+
+    /// Size of a leaf of the hash tree in bytes.
+    static constexpr size_type kChunkSize = 1024;
+
+    /// Max depth of the hash tree: enough for 2^64 bytes of input.
+    static constexpr size_type kMaxDepth = 54;
+
+public:
+
+    using HashingAlgorithm::update;
+
+    /** Construct a new hash computation in the regular hashing mode. */
+    Blake3() noexcept;
+
+    /**
+     * Create a hash computation in the keyed hashing mode.
+     * @param key Secret key of exactly kKeySize bytes.
+     * @return Hashing algorithm or an error if the key is of wrong size.
+     */
+    static Result<Blake3, Error> keyed(MemoryView key) noexcept;
+
+    /**
+     * Create a computation in the key derivation mode. Input is the key material to derive a key from.
+     * @param context Hard-coded, globally unique and application-specific context string.
+     */
+    static Blake3 deriveKey(StringView context) noexcept;
+
+    /**
+     * Get a string name of the hashing algorithm.
+     * @return A string name of the hashing algorithm.
+     */
+    StringView getAlgorithm() const override;
+
+    /**
+     * Get a length of the digest in bits.
+     * @return Length of the digest produced by this algorithm.
+     */
+    size_type getDigestLength() const override;
+
+    /**
+     * Update the digest with the given input.
+     * @param input A memory view to read data from.
+     * @return A reference to self for a fluent interface.
+     */
+    HashingAlgorithm& update(MemoryView input) override;
+
+    /**
+     * Update the digest with the given input, splitting the work on large input between threads.
+     * Result is the same as that of update().
+     * @param input A memory view to read data from.
+     * @param maxThreads Max number of threads to use, including the calling one. 0 to use all hardware threads.
+     * @return A reference to self for a fluent interface.
+     */
+    Blake3& updateParallel(MemoryView input, uint32 maxThreads = 0);
+
+
+    /**
+     * Get output of any length: extendable-output mode.
+     * State is not changed: more input can be added afterwards.
+     * @param output Buffer to fill with output bytes.
+     * @param offset Position in the output stream to start from.
+     */
+    void finalize(MutableMemoryView output, uint64 offset = 0) const noexcept;
+
+protected:
+
+    /**
+     * Completes the hash computation and gets the default kDigestSize bytes of the output.
+     * State is not changed: more input can be added afterwards.
+     * @param dest Destination for the digest of exactly getDigestLength() / 8 bytes.
+     */
+    void digestUnchecked(MutableMemoryView dest) override;
+
+    Blake3(uint32 const key[8], uint32 flags) noexcept;
+
+    void absorb(MemoryView input, uint32 maxThreads) noexcept;
+
+    /// Merge completed subtrees on the stack of chaining values, so that a new one can be pushed.
+    void mergeStack(uint64 totalChunks) noexcept;
+
+    /// Push chaining value of a subtree that starts at the given chunk.
+    void pushChainingValue(byte const* cv, uint64 chunkCounter) noexcept;
+
+    /// Absorb input into the current chunk. It must fit.
+    void updateChunk(byte const* data, size_type size) noexcept;
+
+    /// Start a new chunk.
+    void resetChunk(uint64 chunkCounter) noexcept;
+
+    size_type chunkLength() const noexcept { return _blocksCompressed * 64 + _bufferLength; }
+
+private:
+
+    uint32          _key[8];
+    uint32          _flags;
+
+    // Current chunk
+    uint32          _cv[8];         //!< Chaining value of the blocks compressed so far
+    uint64          _chunkCounter{0};
+    byte            _buffer[64]{};  //!< Last block of the chunk is kept until more input arrives
+    uint32          _bufferLength{0};
+    uint32          _blocksCompressed{0};
+
+    // Chaining values of completed subtrees on the left of the current chunk
+    byte            _stack[kMaxDepth + 1][32]{};
+    size_type       _stackSize{0};
+};
+
+}  // End of namespace hashing
+}  // End of namespace Solace
+#endif  // SOLACE_HASHING_BLAKE3_HPP
@@ -0,0 +1,112 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: CRC-32C checksum
+ *	@file		solace/hashing/crc32c.hpp
+ *	@brief		Defines CRC-32C (Castagnoli) checksum algorithm
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_HASHING_CRC32C_HPP
+#define SOLACE_HASHING_CRC32C_HPP
+
+#include "solace/hashing/digestAlgorithm.hpp"
+
+
+namespace Solace {
+namespace hashing {
+
+/**
+ * Implementation of CRC-32C checksum, the CRC variant used by iSCSI, SCTP, ext4 and many storage formats.
+ * It is not a cryptographic hash: use it to detect accidental corruption of data.
+ *
+ * Uses SSE 4.2 crc32 instruction when CPU supports it, and a slice-by-8 table algorithm otherwise.
+ * Digest is the checksum value in big-endian byte order.
+ */
+class Crc32c final :
+        public HashingAlgorithm {
+public:
+    using HashingAlgorithm::size_type;
+
+    /// Size of the digest in bytes.
+    static constexpr size_type kDigestSize = 4;
+
+public:
+
+    using HashingAlgorithm::update;
+
+    /**
+     * Construct a new checksum computation.
+     * @param crc Checksum of the preceding data to continue from.
+     */
+    constexpr Crc32c(uint32 crc = 0) noexcept
+        : _crc{crc}
+    {}
+
+    /**
+     * Get a string name of the hashing algorithm.
+     * @return A string name of the hashing algorithm.
+     */
+    StringView getAlgorithm() const override;
+
+    /**
+     * Get a length of the digest in bits.
+     * @return Length of the digest produced by this algorithm.
+     */
+    size_type getDigestLength() const override;
+
+    /**
+     * Update the digest with the given input.
+     * @param input A memory view to read data from.
+     * @return A reference to self for a fluent interface.
+     */
+    HashingAlgorithm& update(MemoryView input) override;
+
+    /** Get checksum of the data so far. */
+    constexpr uint32 value() const noexcept { return _crc; }
+
+    /**
+     * Compute checksum of the data.
+     * @param data Data to compute checksum of.
+     * @param crc Checksum of the preceding data to continue from.
+     * @return Checksum of the preceding data followed by the given data.
+     */
+    static uint32 compute(MemoryView data, uint32 crc = 0) noexcept;
+
+    /**
+     * Combine checksums of two adjacent chunks of data. This allows to checksum chunks independently, in parallel.
+     * @param crcA Checksum of the first chunk.
+     * @param crcB Checksum of the second chunk.
+     * @param lengthB Length of the second chunk in bytes.
+     * @return Checksum of the first chunk followed by the second one.
+     */
+    static uint32 combine(uint32 crcA, uint32 crcB, uint64 lengthB) noexcept;
+
+protected:
+
+    /**
+     * Completes the hash computation.
+     * @param dest Destination for the digest of exactly getDigestLength() / 8 bytes.
+     */
+    void digestUnchecked(MutableMemoryView dest) override;
+
+private:
+    uint32  _crc;
+};
+
+
+}  // End of namespace hashing
+}  // End of namespace Solace
+#endif  // SOLACE_HASHING_CRC32C_HPP
@@ -22,7 +22,13 @@
 #define SOLACE_HASHING_HASINGALGORITHM_HPP
 
 #include "solace/hashing/messageDigest.hpp"
+#include "solace/hashing/fixedSizeDigest.hpp"
 #include "solace/byteReader.hpp"
+#include "solace/mutableMemoryView.hpp"
+
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+#include "solace/posixErrorDomain.hpp"
 
 
 namespace Solace { namespace hashing {
@@ -36,6 +42,9 @@ class HashingAlgorithm {
 public:
     using size_type = MemoryView::size_type;
 
+    /// Max size of a digest produced by any of the algorithms in bytes.
+    static constexpr size_type kMaxDigestSize = 64;
+
 public:
 
     virtual ~HashingAlgorithm() = default;
@@ -76,9 +85,62 @@ public:
      * Completes the hash computation by performing final operations such as padding.
      * @return An array of bytes representing message digest.
      */
-    virtual MessageDigest digest() = 0;
+    virtual MessageDigest digest() {
+        auto const digestSize = getDigestLength() / 8;
+        if (digestSize > kMaxDigestSize) {  // Algorithm of a user may produce a longer digest
+            auto buffer = getSystemHeapMemoryManager().allocate(digestSize).unwrap();
+            digestUnchecked(buffer.view());
+
+            return MessageDigest(buffer.view());
+        }
+
+        byte result[kMaxDigestSize];
+        auto const digestView = wrapMemory(result, digestSize);
+        digestUnchecked(digestView);
+
+        return MessageDigest(digestView);
+    }
+
+    /**
+     * Completes the hash computation and writes the digest into the given memory, without heap allocations.
+     * @param dest Destination of at least getDigestLength() / 8 bytes. Only that many bytes are written.
+     * @return Error if the destination is too small. Nothing is written and the state is unchanged in that case.
+     */
+    Result<void, Error> digestInto(MutableMemoryView dest) {
+        auto const digestSize = getDigestLength() / 8;
+        if (dest.size() < digestSize) {
+            return makeError(SystemErrors::Overflow, "HashingAlgorithm::digestInto()");
+        }
+
+        digestUnchecked(dest.slice(0, digestSize));
+
+        return Ok();
+    }
+
+protected:
+
+    /**
+     * Completes the hash computation by performing final operations such as padding.
+     * @param dest Destination for the digest of exactly getDigestLength() / 8 bytes.
+     */
+    virtual void digestUnchecked(MutableMemoryView dest) = 0;
 };
 
+
+/**
+ * Completes the hash computation of an algorithm with a digest size known at compile time.
+ * Digest is returned by value, without heap allocations.
+ * @param algorithm Hashing algorithm that defines kDigestSize in bytes.
+ * @return Digest of the input.
+ */
+template<typename Algorithm>
+FixedSizeDigest<Algorithm::kDigestSize> fixedDigest(Algorithm& algorithm) {
+    FixedSizeDigest<Algorithm::kDigestSize> result;
+    algorithm.digestInto(result.view());
+
+    return result;
+}
+
 }  // End of namespace hashing
 }  // End of namespace Solace
 #endif  // SOLACE_HASHING_HASINGALGORITHM_HPP
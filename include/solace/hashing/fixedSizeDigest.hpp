@@ -16,27 +16,63 @@
 /*******************************************************************************
  * libSolace:
  *  @brief      Fixed size message digest
- *	@file		solace/hashing/messageDigest.hpp
+ *	@file		solace/hashing/fixedSizeDigest.hpp
  ******************************************************************************/
 #pragma once
 #ifndef SOLACE_HASHING_FIXEDSIZEDIGEST_HPP
 #define SOLACE_HASHING_FIXEDSIZEDIGEST_HPP
 
-#include "solace/types.hpp"
+#include "solace/hashing/messageDigest.hpp"
+
+#include "solace/mutableMemoryView.hpp"
+#include "solace/stringView.hpp"
+#include "solace/assert.hpp"
+
+#include <initializer_list>
+
 
 namespace Solace {
 namespace hashing {
 
+/**
+ * Message digest of a size known at compile time.
+ * Unlike MessageDigest the bytes are stored in the object itself, so no heap allocation is involved.
+ */
 template<size_t Size>
 class FixedSizeDigest {
 public:
+    using value_type = byte;
     using size_type = uint32;
 
+    using const_iterator = byte const*;
+    using const_reference = byte const&;
+    using const_pointer = byte const*;
+
+    /// Size of the digest in bytes.
+    static constexpr size_type kSize = Size;
+
+    /// Hex string representation of a digest, stored in place.
+    class HexString {
+    public:
+        StringView view() const noexcept { return StringView{_chars, 2 * Size}; }
+
+    private:
+        friend class FixedSizeDigest;
+        char _chars[2 * Size];
+    };
+
+public:
+
+    /** Construct a digest of all zero bytes */
+    constexpr FixedSizeDigest() noexcept
+        : _data{}
+    {}
+
     /**
      * Get a length of the digest in bits.
      * @return Size of the digest in bits.
      */
-    constexpr size_type getDigestLength() const {
+    constexpr size_type getDigestLength() const noexcept {
         return size() * 8;
     }
 
@@ -48,14 +84,73 @@ public:
         return Size;
     }
 
+    const_reference operator[] (size_type index) const {
+        index = assertIndexInRange(index, size(), "FixedSizeDigest[]");
+
+        return _data[index];
+    }
+
+    const_iterator begin() const noexcept { return _data; }
+    const_iterator end() const noexcept { return _data + Size; }
+    const_pointer data() const noexcept { return _data; }
+
+    MemoryView view() const noexcept { return wrapMemory(_data); }
+
+    /** Get writable view of the digest bytes, i.e. to be filled by HashingAlgorithm::digestInto() */
+    MutableMemoryView view() noexcept { return wrapMemory(_data); }
+
+    /** Format digest as a string of lower case hex digits. */
+    HexString toHex() const noexcept {
+        constexpr char kDigits[] = "0123456789abcdef";
+
+        HexString result;
+        for (size_t i = 0; i < Size; ++i) {
+            result._chars[2 * i] = kDigits[_data[i] >> 4];
+            result._chars[2 * i + 1] = kDigits[_data[i] & 0x0F];
+        }
+
+        return result;
+    }
+
+    bool equals(MemoryView other) const noexcept {
+        return view() == other;
+    }
+
 private:
 
     byte  _data[Size];
 };
 
 
-FixedSizeDigest<8>
-hash(uint32);
+template<size_t Size>
+bool operator== (FixedSizeDigest<Size> const& lhs, FixedSizeDigest<Size> const& rhs) noexcept {
+    return lhs.equals(rhs.view());
+}
+
+template<size_t Size>
+bool operator!= (FixedSizeDigest<Size> const& lhs, FixedSizeDigest<Size> const& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+template<size_t Size>
+bool operator== (FixedSizeDigest<Size> const& lhs, MessageDigest const& rhs) noexcept {
+    return lhs.equals(rhs.view());
+}
+
+template<size_t Size>
+bool operator== (MessageDigest const& lhs, FixedSizeDigest<Size> const& rhs) noexcept {
+    return rhs.equals(lhs.view());
+}
+
+template<size_t Size>
+bool operator== (FixedSizeDigest<Size> const& lhs, std::initializer_list<byte> rhs) noexcept {
+    return lhs.equals(wrapMemory(rhs.begin(), rhs.size()));
+}
+
+template<size_t Size>
+bool operator== (std::initializer_list<byte> lhs, FixedSizeDigest<Size> const& rhs) noexcept {
+    return rhs == lhs;
+}
 
 }  // End of namespace hashing
 }  // End of namespace Solace
@@ -0,0 +1,119 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/hashing/hasher.hpp
+ *	@brief		Statically dispatched hashing API.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_HASHING_HASHER_HPP
+#define SOLACE_HASHING_HASHER_HPP
+
+#include "solace/hashing/digestAlgorithm.hpp"
+#include "solace/assert.hpp"
+#include "solace/utils.hpp"
+
+#include <type_traits>
+
+
+namespace Solace {
+namespace hashing {
+
+/**
+ * Hash computation with a hashing algorithm known at compile time.
+ *
+ * Calls to the algorithm are statically dispatched: the exact type of the algorithm is known, and algorithms
+ * of the library are final, so there is no indirect call per update(), and the digest is returned by value
+ * with no heap allocation.
+ * Use the algorithm class itself where a type-erased HashingAlgorithm is needed.
+ *
+ * @tparam Algorithm Hashing algorithm that defines kDigestSize in bytes, i.e. Sha256.
+ */
+template<typename Algorithm>
+class Hasher {
+public:
+    using size_type = typename Algorithm::size_type;
+
+    /// Digest produced by the algorithm.
+    using Digest = FixedSizeDigest<Algorithm::kDigestSize>;
+
+    /// Size of the digest in bytes.
+    static constexpr size_type kDigestSize = Algorithm::kDigestSize;
+
+public:
+
+    /**
+     * Construct a new hash computation.
+     * @param args Arguments of the algorithm constructor, i.e. a seed.
+     */
+    template<typename... Args,
+             typename = std::enable_if_t<std::is_constructible<Algorithm, Args...>::value>>
+    explicit Hasher(Args&&... args)
+        : _algorithm{fwd<Args>(args)...}
+    {}
+
+    /**
+     * Update the digest with the given input.
+     * @param input A memory view to read data from.
+     * @return A reference to self for a fluent interface.
+     */
+    Hasher& update(MemoryView input) {
+        // Qualified call is not dispatched through the vtable
+        _algorithm.Algorithm::update(input);
+
+        return *this;
+    }
+
+    /**
+     * Completes the hash computation by performing final operations such as padding.
+     * @return Digest of the input.
+     */
+    Digest digest() {
+        Digest result;
+        // Algorithms are final, so calls that digestInto() makes are devirtualized once it is inlined
+        auto const res = _algorithm.digestInto(result.view());
+        assertTrue(res.isOk(), "Hasher::digest()");
+
+        return result;
+    }
+
+    /** Get the algorithm as a type-erased HashingAlgorithm. */
+    HashingAlgorithm& algorithm() noexcept { return _algorithm; }
+
+private:
+
+    Algorithm   _algorithm;
+};
+
+
+/**
+ * Compute digest of the given data with a hashing algorithm known at compile time.
+ * @param data Data to hash.
+ * @param args Arguments of the algorithm constructor, i.e. a seed.
+ * @return Digest of the data.
+ *
+ * @example auto const digest = hash<Sha256>(data);
+ */
+template<typename Algorithm, typename... Args>
+FixedSizeDigest<Algorithm::kDigestSize> hash(MemoryView data, Args&&... args) {
+    return Hasher<Algorithm>{fwd<Args>(args)...}
+            .update(data)
+            .digest();
+}
+
+}  // End of namespace hashing
+}  // End of namespace Solace
+#endif  // SOLACE_HASHING_HASHER_HPP
@@ -0,0 +1,110 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/hashing/hkdf.hpp
+ *	@brief		HKDF: HMAC-based key derivation function.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_HASHING_HKDF_HPP
+#define SOLACE_HASHING_HKDF_HPP
+
+#include "solace/hashing/hmac.hpp"
+
+
+namespace Solace {
+namespace hashing {
+
+/**
+ * HMAC-based extract-and-expand key derivation function, as specified by RFC 5869.
+ * @tparam Algorithm Hash function that defines kDigestSize and kBlockSize in bytes, i.e. Sha256.
+ */
+template<typename Algorithm>
+class Hkdf {
+public:
+    using size_type = typename Algorithm::size_type;
+
+    /// Size of the pseudorandom key produced by extract() in bytes.
+    static constexpr size_type kDigestSize = Algorithm::kDigestSize;
+
+    /// Max size of the output of expand() in bytes.
+    static constexpr size_type kMaxOutputSize = 255 * kDigestSize;
+
+    /// Pseudorandom key.
+    using Digest = FixedSizeDigest<kDigestSize>;
+
+public:
+
+    /**
+     * Extract a pseudorandom key from the input keying material.
+     * @param salt Optional non-secret random value. Empty salt is the same as kDigestSize zero bytes.
+     * @param inputKey Input keying material.
+     * @return Pseudorandom key.
+     */
+    static Digest extract(MemoryView salt, MemoryView inputKey) {
+        // Zero padding of HMAC key makes an empty salt the same as a salt of zeros
+        return Hmac<Algorithm>{salt}.mac(inputKey);
+    }
+
+    /**
+     * Expand a pseudorandom key into output keying material.
+     * @param pseudorandomKey Key of at least kDigestSize bytes, usually the output of extract().
+     * @param info Optional context and application specific information.
+     * @param output Destination for the output keying material: up to kMaxOutputSize bytes.
+     * @return Error if the output is too long. Nothing is written in that case.
+     */
+    static Result<void, Error> expand(MemoryView pseudorandomKey, MemoryView info, MutableMemoryView output) {
+        if (output.size() > kMaxOutputSize) {
+            return makeError(GenericError::RANGE, "Hkdf::expand()");
+        }
+
+        Hmac<Algorithm> hmac{pseudorandomKey};
+        Digest block;
+        byte counter = 1;
+        for (size_type offset = 0; offset < output.size(); offset += kDigestSize, ++counter) {
+            if (offset > 0) {
+                hmac.update(block.view());
+            }
+            block = hmac.update(info)
+                    .update(wrapMemory(&counter, 1))
+                    .digest();
+
+            auto const n = (output.size() - offset < kDigestSize) ? output.size() - offset : kDigestSize;
+            memcpy(output.begin() + offset, block.data(), n);
+        }
+
+        return Ok();
+    }
+
+    /**
+     * Derive a key: extract() followed by expand().
+     * @param salt Optional non-secret random value.
+     * @param inputKey Input keying material.
+     * @param info Optional context and application specific information.
+     * @param output Destination for the output keying material: up to kMaxOutputSize bytes.
+     * @return Error if the output is too long. Nothing is written in that case.
+     */
+    static Result<void, Error>
+    deriveKey(MemoryView salt, MemoryView inputKey, MemoryView info, MutableMemoryView output) {
+        auto const pseudorandomKey = extract(salt, inputKey);
+
+        return expand(pseudorandomKey.view(), info, output);
+    }
+};
+
+}  // End of namespace hashing
+}  // End of namespace Solace
+#endif  // SOLACE_HASHING_HKDF_HPP
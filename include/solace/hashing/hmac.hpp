@@ -0,0 +1,180 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/hashing/hmac.hpp
+ *	@brief		HMAC: keyed-hash message authentication code.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_HASHING_HMAC_HPP
+#define SOLACE_HASHING_HMAC_HPP
+
+#include "solace/hashing/digestAlgorithm.hpp"
+
+#include <cstring>  // memcpy
+
+
+namespace Solace {
+namespace hashing {
+
+/// Zero memory that held key material. Unlike memset() it is not optimized away for a buffer going out of scope.
+inline void secureWipe(void* dest, size_t size) noexcept {
+    auto volatile* p = static_cast<byte volatile*>(dest);
+    while (size--) {
+        *p++ = 0;
+    }
+}
+
+
+/**
+ * HMAC message authentication code, as specified by RFC 2104, on top of an iterative hash function.
+ *
+ * States of the hash function after absorbing the inner and the outer padded key blocks are computed once
+ * per key, so authenticating a message with a reused key costs no extra hashing of the key.
+ * After digest() the computation starts over with the same key, ready for the next message.
+ *
+ * @tparam Algorithm Hash function that defines kDigestSize and kBlockSize in bytes, i.e. Sha256.
+ */
+template<typename Algorithm>
+class Hmac {
+public:
+    using size_type = typename Algorithm::size_type;
+
+    /// Size of the authentication code in bytes.
+    static constexpr size_type kDigestSize = Algorithm::kDigestSize;
+
+    /// Size of a block of the hash function input in bytes.
+    static constexpr size_type kBlockSize = Algorithm::kBlockSize;
+
+    /// Authentication code.
+    using Digest = FixedSizeDigest<kDigestSize>;
+
+public:
+
+    /**
+     * Construct a new computation with the given key.
+     * @param key Secret key. Keys longer than a block are hashed first.
+     */
+    explicit Hmac(MemoryView key) {
+        byte block[kBlockSize] = {};
+        if (key.size() > kBlockSize) {
+            Algorithm keyHash;
+            keyHash.Algorithm::update(key);
+            keyHash.Algorithm::digestInto(wrapMemory(block, kDigestSize));
+        } else if (key.size() > 0) {
+            memcpy(block, key.begin(), key.size());
+        }
+
+        for (auto& b : block) {
+            b ^= 0x36;
+        }
+        _innerKeyed.Algorithm::update(wrapMemory(block));
+
+        for (auto& b : block) {
+            b ^= 0x36 ^ 0x5c;
+        }
+        _outerKeyed.Algorithm::update(wrapMemory(block));
+        secureWipe(block, sizeof(block));
+
+        _inner = _innerKeyed;
+    }
+
+    /**
+     * Update the code with the given input.
+     * @param input A memory view to read data from.
+     * @return A reference to self for a fluent interface.
+     */
+    Hmac& update(MemoryView input) {
+        _inner.Algorithm::update(input);
+
+        return *this;
+    }
+
+    /**
+     * Complete computation of the authentication code of the input so far, and start over with the same key.
+     * @return Authentication code of the input.
+     */
+    Digest digest() {
+        auto const result = finish(_inner);
+        _inner = _innerKeyed;
+
+        return result;
+    }
+
+    /**
+     * Compute authentication code of a message with the same key. Ongoing computation is not affected.
+     * @param message Message to authenticate.
+     * @return Authentication code of the message.
+     */
+    Digest mac(MemoryView message) const {
+        Algorithm inner{_innerKeyed};
+        inner.Algorithm::update(message);
+
+        return finish(inner);
+    }
+
+    /**
+     * Check authentication code of a message in time that does not depend on the content of the code.
+     * @param message Message to authenticate.
+     * @param code Authentication code to check.
+     * @return True if the code is that of the message.
+     */
+    bool verify(MemoryView message, MemoryView code) const {
+        if (code.size() != kDigestSize) {
+            return false;
+        }
+
+        auto const expected = mac(message);
+        byte difference = 0;
+        for (size_type i = 0; i < kDigestSize; ++i) {
+            difference |= expected.data()[i] ^ code.begin()[i];
+        }
+
+        return (difference == 0);
+    }
+
+    /** Get state of the hash function after the inner padded key block. */
+    Algorithm const& innerKeyed() const noexcept { return _innerKeyed; }
+
+    /** Get state of the hash function after the outer padded key block. */
+    Algorithm const& outerKeyed() const noexcept { return _outerKeyed; }
+
+protected:
+
+    Digest finish(Algorithm& inner) const {
+        byte innerDigest[kDigestSize];
+        inner.Algorithm::digestInto(wrapMemory(innerDigest));
+
+        Algorithm outer{_outerKeyed};
+        outer.Algorithm::update(wrapMemory(innerDigest));
+        secureWipe(innerDigest, sizeof(innerDigest));
+
+        Digest result;
+        outer.Algorithm::digestInto(result.view());
+
+        return result;
+    }
+
+private:
+
+    Algorithm   _innerKeyed;    //!< State after the inner padded key block
+    Algorithm   _outerKeyed;    //!< State after the outer padded key block
+    Algorithm   _inner;         //!< Inner hash of the current message
+};
+
+}  // End of namespace hashing
+}  // End of namespace Solace
+#endif  // SOLACE_HASHING_HMAC_HPP
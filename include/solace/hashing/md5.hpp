@@ -37,11 +37,17 @@ namespace hashing {
  * Please @see Sha3 for a better option of hash function.
  *
  */
-class MD5 :
+class MD5 final :
         public HashingAlgorithm {
 public:
     using HashingAlgorithm::size_type;
 
+    /// Size of the digest in bytes.
+    static constexpr size_type kDigestSize = 16;
+
+    /// Size of a block of input processed at once in bytes.
+    static constexpr size_type kBlockSize = 64;
+
     struct State {
         uint32  bits[2];                /*!< number of bytes processed  */
         uint32  state[4];               /*!< intermediate digest state  */
@@ -73,11 +79,13 @@ public:
      */
     HashingAlgorithm& update(MemoryView input) override;
 
-    /*
+protected:
+
+    /**
      * Completes the hash computation by performing final operations such as padding.
-     * @return An array of bytes representing message digest.
+     * @param dest Destination for the digest of exactly getDigestLength() / 8 bytes.
      */
-    MessageDigest digest() override;
+    void digestUnchecked(MutableMemoryView dest) override;
 
 private:
 
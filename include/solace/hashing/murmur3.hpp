@@ -24,6 +24,8 @@
 
 #include "solace/hashing/digestAlgorithm.hpp"
 
+#include "solace/details/byte_swap.hpp"
+
 
 namespace Solace {
 namespace hashing {
@@ -31,19 +33,28 @@ namespace hashing {
 /**
  * Implementation of Murmur3 cryptographic hashing algorithm with 32bit digest.
  * Murmur is a family of good general purpose hashing functions, suitable for non-cryptographic usage.
+ *
+ * Hashing is incremental: input can be given in chunks of any size, with the same result as hashing it all at once.
  */
-class Murmur3_32 :
+class Murmur3_32 final :
         public HashingAlgorithm {
 public:
     using HashingAlgorithm::size_type;
 
+    /// Size of the digest in bytes.
+    static constexpr size_type kDigestSize = 4;
+
+    /// Size of a block of input mixed into the hash at once.
+    static constexpr size_type kBlockSize = 4;
+
 public:
 
     using HashingAlgorithm::update;
 
     constexpr Murmur3_32(uint32 seed) noexcept
-        : _hash{0}
-        , _seed{seed}
+        : _hash{seed}
+        , _length{0}
+        , _tail{}
     {
     }
 
@@ -66,34 +77,162 @@ public:
      */
     HashingAlgorithm& update(MemoryView input) override;
 
-    /*
+protected:
+
+    /**
      * Completes the hash computation by performing final operations such as padding.
-     * @return An array of bytes representing message digest.
+     * State is not changed: more input can be added afterwards.
+     * @param dest Destination for the digest of exactly getDigestLength() / 8 bytes.
      */
-    MessageDigest digest() override;
+    void digestUnchecked(MutableMemoryView dest) override;
 
 private:
-    uint32  _hash[1];
-    uint32  _seed;
+    uint32  _hash;                  //!< Hash of the whole blocks of input so far
+    uint64  _length;                //!< Total length of the input
+    byte    _tail[kBlockSize];      //!< Last partial block of input
+};
+
+
+/// 128 bit value of Murmur3 hash.
+struct Murmur3Hash128 {
+    uint64  h1;
+    uint64  h2;
 };
 
 
+namespace details {
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline uint64 murmur3Fmix64(uint64 k) noexcept {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+
+    return k;
+}
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline uint64 murmur3MixK1(uint64 k1) noexcept {
+    k1 *= 0x87c37b91114253d5ULL;
+    k1 = (k1 << 31) | (k1 >> 33);
+    return k1 * 0x4cf5ad432745937fULL;
+}
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline uint64 murmur3MixK2(uint64 k2) noexcept {
+    k2 *= 0x4cf5ad432745937fULL;
+    k2 = (k2 << 33) | (k2 >> 31);
+    return k2 * 0x87c37b91114253d5ULL;
+}
+
+/// Mix a 16 byte block of input into the state of x64 128 bit Murmur3.
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline void murmur3MixBlock128(uint64& h1, uint64& h2, byte const* block) noexcept {
+    h1 ^= murmur3MixK1(Solace::details::loadLE<uint64>(block));
+    h1 = (h1 << 27) | (h1 >> 37);
+    h1 += h2;
+    h1 = h1 * 5 + 0x52dce729;
+
+    h2 ^= murmur3MixK2(Solace::details::loadLE<uint64>(block + 8));
+    h2 = (h2 << 31) | (h2 >> 33);
+    h2 += h1;
+    h2 = h2 * 5 + 0x38495ab5;
+}
+
+/**
+ * Mix the last partial block into the state of x64 128 bit Murmur3 and finalize the hash.
+ * @param tail Last bytes of input, less than a block.
+ * @param tailLength Number of bytes in the tail: [0, 16).
+ * @param length Total length of the input.
+ */
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline Murmur3Hash128
+murmur3Finalize128(uint64 h1, uint64 h2, byte const* tail, uint32 tailLength, uint64 length) noexcept {
+    uint64 k1 = 0;
+    uint64 k2 = 0;
+    for (uint32 i = tailLength; i > 8; --i) {
+        k2 = (k2 << 8) | tail[i - 1];
+    }
+    for (uint32 i = (tailLength < 8) ? tailLength : 8; i > 0; --i) {
+        k1 = (k1 << 8) | tail[i - 1];
+    }
+
+    if (tailLength > 8) {
+        h2 ^= murmur3MixK2(k2);
+    }
+    if (tailLength > 0) {
+        h1 ^= murmur3MixK1(k1);
+    }
+
+    h1 ^= length;
+    h2 ^= length;
+
+    h1 += h2;
+    h2 += h1;
+
+    h1 = murmur3Fmix64(h1);
+    h2 = murmur3Fmix64(h2);
+
+    h1 += h2;
+    h2 += h1;
+
+    return {h1, h2};
+}
+
+}  // End of namespace details
+
+
+/**
+ * Compute x64 variant of 128 bit Murmur3 hash of the given data.
+ * This is a stateless fast path for hash tables: no virtual calls and no allocation of the digest.
+ * Result is the same as that of Murmur3_128.
+ *
+ * @param data Data to hash.
+ * @param seed Seed of the hash.
+ * @return Hash value.
+ */
+inline Murmur3Hash128 murmur3_x64_128(MemoryView data, uint32 seed = 0) noexcept {
+    uint64 h1 = seed;
+    uint64 h2 = seed;
+
+    auto block = data.begin();
+    auto const nblocks = data.size() / 16;
+    for (MemoryView::size_type i = 0; i < nblocks; ++i, block += 16) {
+        details::murmur3MixBlock128(h1, h2, block);
+    }
+
+    return details::murmur3Finalize128(h1, h2, block, static_cast<uint32>(data.size() % 16), data.size());
+}
+
+
 /**
  * Implementation of Murmur3 cryptographic hashing algorithm with 128bit digest.
  * Murmur is a family of good general purpose hashing functions, suitable for non-cryptographic usage.
+ *
+ * This is the x64 variant of the algorithm on all platforms.
+ * Hashing is incremental: input can be given in chunks of any size, with the same result as hashing it all at once.
  */
-class Murmur3_128 :
+class Murmur3_128 final :
         public HashingAlgorithm {
 public:
     using HashingAlgorithm::size_type;
 
+    /// Size of the digest in bytes.
+    static constexpr size_type kDigestSize = 16;
+
+    /// Size of a block of input mixed into the hash at once.
+    static constexpr size_type kBlockSize = 16;
+
 public:
 
     using HashingAlgorithm::update;
 
-    Murmur3_128(uint32 seed) noexcept
-        : _hash{0, 0}
-        , _seed{seed}
+    constexpr Murmur3_128(uint32 seed) noexcept
+        : _hash{seed, seed}
+        , _length{0}
+        , _tail{}
     {}
 
     /**
@@ -115,15 +254,28 @@ public:
      */
     HashingAlgorithm& update(MemoryView input) override;
 
-    /*
+    /**
+     * Get the hash of the input so far as a value.
+     * State is not changed: more input can be added afterwards.
+     */
+    Murmur3Hash128 value() const noexcept {
+        return details::murmur3Finalize128(_hash[0], _hash[1], _tail,
+                                           static_cast<uint32>(_length % kBlockSize), _length);
+    }
+
+protected:
+
+    /**
      * Completes the hash computation by performing final operations such as padding.
-     * @return An array of bytes representing message digest.
+     * State is not changed: more input can be added afterwards.
+     * @param dest Destination for the digest of exactly getDigestLength() / 8 bytes.
      */
-    MessageDigest digest() override;
+    void digestUnchecked(MutableMemoryView dest) override;
 
 private:
-    uint64  _hash[2];
-    uint32  _seed;
+    uint64  _hash[2];               //!< Hash of the whole blocks of input so far
+    uint64  _length;                //!< Total length of the input
+    byte    _tail[kBlockSize];      //!< Last partial block of input
 };
 
 
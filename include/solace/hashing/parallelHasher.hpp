@@ -0,0 +1,135 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/hashing/parallelHasher.hpp
+ *	@brief		Hashing of large buffers and files using several threads.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_HASHING_PARALLELHASHER_HPP
+#define SOLACE_HASHING_PARALLELHASHER_HPP
+
+
+#include "solace/hashing/digestAlgorithm.hpp"
+#include "solace/hashing/fixedSizeDigest.hpp"
+
+#include "solace/stringView.hpp"
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
+
+namespace Solace {
+namespace hashing {
+
+/**
+ * Hashing of large buffers and files using several threads.
+ *
+ * There are two kinds of modes:
+ *  - Tree modes split input between threads, so they scale with the number of cores:
+ *    BLAKE3, and a SHA-256 Merkle tree of fixed size chunks.
+ *  - Pipeline modes are for sequential algorithms, i.e. Sha256, that can only use one core for hashing:
+ *    a helper thread reads the file, or faults in pages of the memory, ahead of the hashing one.
+ *
+ * SHA-256 Merkle tree is that of RFC 6962: a leaf is SHA-256(0x00 || chunk), and a node is
+ * SHA-256(0x01 || left || right), where the left subtree has the largest power of 2 number of leaves
+ * that is less than the number of leaves of the node. Root of empty input is SHA-256 of the empty string.
+ * Result does not depend on the number of threads, but does depend on the chunk size.
+ *
+ * File modes map the file into memory for tree hashing, and read it with read() in pipeline modes.
+ * When threads can not be started, work is done in the calling thread.
+ */
+class ParallelHasher {
+public:
+    using size_type = MemoryView::size_type;
+
+    /// Digest of the tree modes.
+    using Digest = FixedSizeDigest<32>;
+
+    /// Default size of a leaf of SHA-256 Merkle tree in bytes.
+    static constexpr size_type kDefaultChunkSize = 1024 * 1024;
+
+    /// Size of a piece of input prepared by the helper thread in pipeline modes.
+    static constexpr size_type kWindowSize = 1024 * 1024;
+
+    /// Max number of windows the helper thread may prepare ahead of hashing.
+    static constexpr size_type kPipelineDepth = 4;
+
+public:
+
+    /**
+     * Construct a hasher.
+     * @param maxThreads Max number of threads to use, including the calling one. 0 to use all hardware threads.
+     */
+    explicit ParallelHasher(uint32 maxThreads = 0) noexcept;
+
+    /** Get max number of threads used, including the calling one. */
+    uint32 threads() const noexcept { return _threads; }
+
+    /**
+     * Compute BLAKE3 digest of the input.
+     * @param input Data to hash.
+     * @return Digest, the same as that of Blake3::update().
+     */
+    Digest blake3(MemoryView input) const;
+
+    /**
+     * Compute BLAKE3 digest of a file.
+     * @param path Path of the file to hash.
+     * @return Digest or an error if the file can not be read.
+     */
+    Result<Digest, Error> blake3File(StringView path) const;
+
+    /**
+     * Compute root of SHA-256 Merkle tree of the input.
+     * @param input Data to hash.
+     * @param chunkSize Size of a leaf of the tree in bytes: last leaf may be shorter.
+     * @return Root of the tree or an error if the chunk size is 0.
+     */
+    Result<Digest, Error> sha256Merkle(MemoryView input, size_type chunkSize = kDefaultChunkSize) const;
+
+    /**
+     * Compute root of SHA-256 Merkle tree of a file.
+     * @param path Path of the file to hash.
+     * @param chunkSize Size of a leaf of the tree in bytes: last leaf may be shorter.
+     * @return Root of the tree or an error if the file can not be read or the chunk size is 0.
+     */
+    Result<Digest, Error> sha256MerkleFile(StringView path, size_type chunkSize = kDefaultChunkSize) const;
+
+    /**
+     * Update a sequential hashing algorithm with the input, faulting pages of the input in ahead of hashing.
+     * Useful for memory mapped files, where page faults would otherwise stall hashing.
+     * @param algorithm Algorithm to update.
+     * @param input Data to hash.
+     * @return A reference to the algorithm.
+     */
+    HashingAlgorithm& pipelined(HashingAlgorithm& algorithm, MemoryView input) const;
+
+    /**
+     * Update a sequential hashing algorithm with content of a file, reading it ahead of hashing.
+     * @param algorithm Algorithm to update.
+     * @param path Path of the file to hash.
+     * @return Error if the file can not be read. Algorithm may have been updated with part of the file in that case.
+     */
+    Result<void, Error> pipelinedFile(HashingAlgorithm& algorithm, StringView path) const;
+
+private:
+
+    uint32  _threads;
+};
+
+}  // End of namespace hashing
+}  // End of namespace Solace
+#endif  // SOLACE_HASHING_PARALLELHASHER_HPP
@@ -0,0 +1,196 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/hashing/pbkdf2.hpp
+ *	@brief		PBKDF2: password-based key derivation function.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_HASHING_PBKDF2_HPP
+#define SOLACE_HASHING_PBKDF2_HPP
+
+#include "solace/hashing/hmac.hpp"
+#include "solace/hashing/sha2.hpp"
+#include "solace/details/byte_swap.hpp"
+
+#include <algorithm>  // std::min
+#include <type_traits>
+
+
+namespace Solace {
+namespace hashing {
+
+/**
+ * Password-based key derivation function PBKDF2, as specified by RFC 8018, with HMAC as the pseudorandom function.
+ *
+ * HMAC states of the password key are computed once, so each iteration costs two runs of the hash function
+ * compression on a single block.
+ * Iterations of a block of the output depend on each other, but blocks do not: with Sha256, blocks of a key
+ * longer than a digest are computed in lanes of multi-buffer SHA-256, Sha256xN.
+ *
+ * @tparam Algorithm Hash function that defines kDigestSize and kBlockSize in bytes, i.e. Sha256.
+ */
+template<typename Algorithm>
+class Pbkdf2 {
+public:
+    using size_type = typename Algorithm::size_type;
+
+    /// Size of a block of the output in bytes.
+    static constexpr size_type kDigestSize = Algorithm::kDigestSize;
+
+public:
+
+    /**
+     * Derive a key from a password.
+     * @param password Password to derive the key from.
+     * @param salt Salt, unique for each password.
+     * @param iterations Number of iterations, at least 1.
+     * @param output Destination for the derived key. Its size determines the length of the key.
+     * @return Error if the number of iterations is zero. Nothing is written in that case.
+     */
+    static Result<void, Error>
+    deriveKey(MemoryView password, MemoryView salt, uint32 iterations, MutableMemoryView output) {
+        if (iterations == 0) {
+            return makeError(GenericError::RANGE, "Pbkdf2::deriveKey()");
+        }
+        if (output.size() / kDigestSize >= 0xFFFFFFFF) {
+            return makeError(GenericError::RANGE, "Pbkdf2::deriveKey()");
+        }
+
+        Hmac<Algorithm> const prf{password};
+
+        if constexpr (std::is_same<Algorithm, Sha256>::value) {
+            if (output.size() > kDigestSize && Sha256xN::lanes() > 1) {
+                deriveBlocksInLanes(prf, salt, iterations, output);
+
+                return Ok();
+            }
+        }
+
+        uint32 blockIndex = 1;
+        for (size_type offset = 0; offset < output.size(); offset += kDigestSize, ++blockIndex) {
+            auto u = firstIteration(prf, salt, blockIndex);
+
+            byte block[kDigestSize];
+            memcpy(block, u.data(), kDigestSize);
+            for (uint32 i = 1; i < iterations; ++i) {
+                u = prf.mac(u.view());
+                for (size_type j = 0; j < kDigestSize; ++j) {
+                    block[j] ^= u.data()[j];
+                }
+            }
+
+            auto const n = (output.size() - offset < kDigestSize) ? output.size() - offset : kDigestSize;
+            memcpy(output.begin() + offset, block, n);
+            secureWipe(block, sizeof(block));
+            secureWipe(u.view().begin(), kDigestSize);
+        }
+
+        return Ok();
+    }
+
+protected:
+
+    /// Compute U_1 of the block with the given 1-based index: MAC of the salt followed by the index.
+    static typename Hmac<Algorithm>::Digest
+    firstIteration(Hmac<Algorithm> const& prf, MemoryView salt, uint32 blockIndex) {
+        byte counter[4];
+        details::storeBE(counter, blockIndex);
+
+        Hmac<Algorithm> first{prf};
+
+        return first.update(salt)
+                .update(wrapMemory(counter))
+                .digest();
+    }
+
+    /**
+     * Derive blocks of the output in batches, one block per lane of multi-buffer SHA-256.
+     * Every iteration after the first is one block of the inner and one of the outer hash,
+     * compressed from the keyed states of HMAC.
+     */
+    static void
+    deriveBlocksInLanes(Hmac<Sha256> const& prf, MemoryView salt, uint32 iterations, MutableMemoryView output) {
+        constexpr size_type kBatchSize = 16;
+        constexpr size_type kBlockSize = Sha256::kBlockSize;
+
+        auto const innerKeyed = prf.innerKeyed().chainingValue().unwrap();
+        auto const outerKeyed = prf.outerKeyed().chainingValue().unwrap();
+
+        Sha256::ChainingValue states[kBatchSize];
+        byte blocks[kBatchSize][kBlockSize];
+        byte result[kBatchSize][kDigestSize];
+
+        // Message of both hashes is a digest, so padding after it is the same for every iteration
+        for (auto& block : blocks) {
+            block[kDigestSize] = 0x80;
+            memset(block + kDigestSize + 1, 0, kBlockSize - kDigestSize - 1 - 8);
+            details::storeBE<uint64>(block + kBlockSize - 8, uint64{kBlockSize + kDigestSize} * 8);
+        }
+
+        uint32 blockIndex = 1;
+        for (size_type offset = 0; offset < output.size(); ) {
+            auto const batchBytes = std::min<size_type>(output.size() - offset, kBatchSize * kDigestSize);
+            auto const batch = (batchBytes + kDigestSize - 1) / kDigestSize;
+
+            for (size_type lane = 0; lane < batch; ++lane) {
+                auto u = firstIteration(prf, salt, blockIndex + static_cast<uint32>(lane));
+                memcpy(blocks[lane], u.data(), kDigestSize);
+                memcpy(result[lane], u.data(), kDigestSize);
+                secureWipe(u.view().begin(), kDigestSize);
+            }
+
+            // Hash digests in the blocks from the keyed state, replacing them with the new digests
+            auto hashLanes = [&](Sha256::ChainingValue const& keyed) {
+                for (size_type lane = 0; lane < batch; ++lane) {
+                    states[lane] = keyed;
+                }
+
+                auto const res = Sha256xN::compress(arrayView(states, batch), wrapMemory(blocks, batch * kBlockSize));
+                assertTrue(res.isOk(), "Pbkdf2::deriveKey()");
+
+                for (size_type lane = 0; lane < batch; ++lane) {
+                    for (size_type w = 0; w < 8; ++w) {
+                        details::storeBE(blocks[lane] + 4 * w, states[lane].words[w]);
+                    }
+                }
+            };
+
+            for (uint32 i = 1; i < iterations; ++i) {
+                hashLanes(innerKeyed);
+                hashLanes(outerKeyed);
+
+                for (size_type lane = 0; lane < batch; ++lane) {
+                    for (size_type j = 0; j < kDigestSize; ++j) {
+                        result[lane][j] ^= blocks[lane][j];
+                    }
+                }
+            }
+
+            memcpy(output.begin() + offset, result, batchBytes);
+            offset += batchBytes;
+            blockIndex += static_cast<uint32>(batch);
+        }
+
+        secureWipe(states, sizeof(states));
+        secureWipe(blocks, sizeof(blocks));
+        secureWipe(result, sizeof(result));
+    }
+};
+
+}  // End of namespace hashing
+}  // End of namespace Solace
+#endif  // SOLACE_HASHING_PBKDF2_HPP
@@ -33,11 +33,17 @@ namespace hashing {
  * Implementation of Sha-1 cryptographic hashing algorithm.
  * SHA-1 produces a 160-bit (20-bytes) hash.
  */
-class Sha1 :
+class Sha1 final :
         public HashingAlgorithm {
 public:
     using HashingAlgorithm::size_type;
 
+    /// Size of the digest in bytes.
+    static constexpr size_type kDigestSize = 20;
+
+    /// Size of a block of input processed at once in bytes.
+    static constexpr size_type kBlockSize = 64;
+
     struct State {
         uint32  total[2];
         uint32  state[5];               /*!< intermediate digest state  */
@@ -69,11 +75,13 @@ public:
      */
     HashingAlgorithm& update(MemoryView input) override;
 
-    /*
+protected:
+
+    /**
      * Completes the hash computation by performing final operations such as padding.
-     * @return An array of bytes representing message digest.
+     * @param dest Destination for the digest of exactly getDigestLength() / 8 bytes.
      */
-    MessageDigest digest() override;
+    void digestUnchecked(MutableMemoryView dest) override;
 
 private:
 
@@ -25,6 +25,11 @@
 
 #include "solace/hashing/digestAlgorithm.hpp"
 
+#include "solace/arrayView.hpp"
+#include "solace/mutableMemoryView.hpp"
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
 
 namespace Solace {
 namespace hashing {
@@ -33,23 +38,40 @@ namespace hashing {
  * Implementation of Sha-2 cryptographic hashing algorithm.
  * This is SHA-256 with 256-bit (32 bytes) digest.
  */
-class Sha256 :
+class Sha256 final :
         public HashingAlgorithm {
 public:
     using HashingAlgorithm::size_type;
 
+    /// Size of the digest in bytes.
+    static constexpr size_type kDigestSize = 32;
+
+    /// Size of a block of input processed at once in bytes.
+    static constexpr size_type kBlockSize = 64;
+
     struct State {
         uint32  total[2];
         uint32  state[8];               /*!< intermediate digest state  */
         byte    buffer[64];             /*!< data block being processed */
     };
 
+    /// Intermediate digest state after a whole number of blocks.
+    struct ChainingValue {
+        uint32  words[8];
+    };
+
 public:
 
     using HashingAlgorithm::update;
 
     Sha256() noexcept;
 
+    /**
+     * Get the intermediate digest state, to continue hashing from it with Sha256xN::compress().
+     * @return Chaining value or an error if the input so far is not a whole number of blocks.
+     */
+    Result<ChainingValue, Error> chainingValue() const;
+
     /**
      * Get a string name of the hashing algorithm.
      * @return A string name of the hashing algorithm.
@@ -69,11 +91,13 @@ public:
      */
     HashingAlgorithm& update(MemoryView input) override;
 
-    /*
+protected:
+
+    /**
      * Completes the hash computation by performing final operations such as padding.
-     * @return An array of bytes representing message digest.
+     * @param dest Destination for the digest of exactly getDigestLength() / 8 bytes.
      */
-    MessageDigest digest() override;
+    void digestUnchecked(MutableMemoryView dest) override;
 
 private:
 
@@ -81,6 +105,48 @@ private:
 };
 
 
+/**
+ * Multi-buffer SHA-256: computes digests of a batch of independent messages.
+ *
+ * Messages are hashed several at a time, one per SIMD lane: 16 with AVX-512, 8 with AVX2.
+ * When there are many short messages, such as tokens or cache keys, this keeps vector units busy
+ * where hashing each message on its own is bound by serial rounds and per-message overhead.
+ * Last few messages of a batch are finished one at a time rather than with mostly idle lanes.
+ * On CPUs with SHA extensions but no AVX-512 messages are hashed one at a time, as that is faster.
+ */
+class Sha256xN {
+public:
+    using size_type = Sha256::size_type;
+
+    /// Size of a digest in bytes.
+    static constexpr size_type kDigestSize = 32;
+
+    using ChainingValue = Sha256::ChainingValue;
+
+public:
+
+    /** Get number of messages hashed in parallel on this CPU: 1 if there is no multi-buffer implementation for it. */
+    static size_type lanes() noexcept;
+
+    /**
+     * Compress one block into each of the states, as many at a time as there are lanes.
+     * This is for many short messages that start from the same precomputed state, i.e. iterations of HMAC.
+     * @param states Intermediate digest states to update.
+     * @param blocks Blocks to compress: Sha256::kBlockSize bytes per state, in the same order as states.
+     * @return Error if there are fewer blocks than states. Nothing is changed in that case.
+     */
+    static Result<void, Error> compress(ArrayView<ChainingValue> states, MemoryView blocks) noexcept;
+
+    /**
+     * Compute digests of all the messages.
+     * @param messages Messages to hash.
+     * @param digests Destination for digests: kDigestSize bytes per message, in the same order as messages.
+     * @return Error if the destination is too small to hold all the digests. Nothing is written in that case.
+     */
+    static Result<void, Error> digest(ArrayView<MemoryView const> messages, MutableMemoryView digests) noexcept;
+};
+
+
 }  // End of namespace hashing
 }  // End of namespace Solace
 #endif  // SOLACE_HASHING_SHA2_HPP
@@ -25,31 +25,76 @@
 
 #include "solace/hashing/digestAlgorithm.hpp"
 
+#include "solace/arrayView.hpp"
+#include "solace/mutableMemoryView.hpp"
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
 
 namespace Solace {
 namespace hashing {
 
 /**
- * Implementation of Sha-2 cryptographic hashing algorithm.
- * This is SHA-256 with 256 bit digest.
+ * Keccak sponge construction over Keccak-f[1600] permutation, as specified by FIPS 202.
+ * This is the core of SHA-3 hash functions and SHAKE extendable-output functions.
+ */
+class KeccakSponge {
+public:
+    using size_type = MemoryView::size_type;
+
+    /// Size of the sponge state in bytes.
+    static constexpr size_type kStateSize = 200;
+
+public:
+
+    /**
+     * Construct an empty sponge.
+     * @param rate Number of bytes absorbed or squeezed per permutation: kStateSize less twice the security strength.
+     * @param domain Domain separation suffix followed by the first padding bit: 0x06 for SHA-3, 0x1F for SHAKE.
+     */
+    KeccakSponge(size_type rate, byte domain) noexcept;
+
+    /** Get number of bytes absorbed or squeezed per permutation. */
+    size_type rate() const noexcept { return _rate; }
+
+    /** Check if the sponge has been padded and switched to squeezing. */
+    bool isSqueezing() const noexcept { return _squeezing; }
+
+    /**
+     * Absorb input data.
+     * @note Must not be called after squeeze().
+     */
+    void absorb(MemoryView input) noexcept;
+
+    /**
+     * Squeeze output from the sponge. First call pads the input absorbed so far.
+     * It can be called repeatedly to get the output stream in parts.
+     */
+    void squeeze(MutableMemoryView output) noexcept;
+
+private:
+
+    uint64      _lanes[25];
+    size_type   _rate;
+    size_type   _offset{0};     //!< Bytes absorbed into / squeezed from the current block
+    byte        _domain;
+    bool        _squeezing{false};
+};
+
+
+/**
+ * Implementation of SHA-3 cryptographic hash algorithm, as specified by FIPS 202.
+ * Use one of the fixed digest length variants: Sha3_224, Sha3_256, Sha3_384 or Sha3_512.
  */
 class Sha3 :
         public HashingAlgorithm {
 public:
     using HashingAlgorithm::size_type;
 
-    struct State {
-        uint32  total[2];
-        uint32  state[8];               /*!< intermediate digest state  */
-        byte    buffer[64];             /*!< data block being processed */
-    };
-
 public:
 
     using HashingAlgorithm::update;
 
-    Sha3() noexcept;
-
     /**
      * Get a string name of the hashing algorithm.
      * @return A string name of the hashing algorithm.
@@ -57,7 +102,7 @@ public:
     StringView getAlgorithm() const override;
 
     /**
-     * Get a length of the digest in bytes.
+     * Get a length of the digest in bits.
      * @return Length of the digest produced by this algorithm.
      */
     size_type getDigestLength() const override;
@@ -69,17 +114,181 @@ public:
      */
     HashingAlgorithm& update(MemoryView input) override;
 
-    /*
+protected:
+
+    /**
      * Completes the hash computation by performing final operations such as padding.
-     * @return An array of bytes representing message digest.
+     * @param dest Destination for the digest of exactly getDigestLength() / 8 bytes.
+     */
+    void digestUnchecked(MutableMemoryView dest) override;
+
+    /**
+     * Construct a new hash computation.
+     * @param digestLength Length of the digest in bits: 224, 256, 384 or 512.
      */
-    MessageDigest digest() override;
+    explicit Sha3(size_type digestLength) noexcept;
 
 private:
 
-    State _state;
+    KeccakSponge    _sponge;
+    size_type       _digestLength;
+};
+
+
+/** SHA3-224: SHA-3 with 224 bit digest. */
+class Sha3_224 final : public Sha3 {
+public:
+    /// Size of the digest in bytes.
+    static constexpr size_type kDigestSize = 28;
+
+    /// Size of a block of input processed at once, the rate of the sponge, in bytes.
+    static constexpr size_type kBlockSize = 144;
+
+    Sha3_224() noexcept : Sha3{224} {}
 };
 
+/** SHA3-256: SHA-3 with 256 bit digest. */
+class Sha3_256 final : public Sha3 {
+public:
+    /// Size of the digest in bytes.
+    static constexpr size_type kDigestSize = 32;
+
+    /// Size of a block of input processed at once, the rate of the sponge, in bytes.
+    static constexpr size_type kBlockSize = 136;
+
+    Sha3_256() noexcept : Sha3{256} {}
+};
+
+/** SHA3-384: SHA-3 with 384 bit digest. */
+class Sha3_384 final : public Sha3 {
+public:
+    /// Size of the digest in bytes.
+    static constexpr size_type kDigestSize = 48;
+
+    /// Size of a block of input processed at once, the rate of the sponge, in bytes.
+    static constexpr size_type kBlockSize = 104;
+
+    Sha3_384() noexcept : Sha3{384} {}
+};
+
+/** SHA3-512: SHA-3 with 512 bit digest. */
+class Sha3_512 final : public Sha3 {
+public:
+    /// Size of the digest in bytes.
+    static constexpr size_type kDigestSize = 64;
+
+    /// Size of a block of input processed at once, the rate of the sponge, in bytes.
+    static constexpr size_type kBlockSize = 72;
+
+    Sha3_512() noexcept : Sha3{512} {}
+};
+
+
+/**
+ * SHAKE extendable-output function, as specified by FIPS 202: produces output of any requested length.
+ * digest() returns output of twice the security strength, that gives collision resistance of the full strength.
+ * Use squeeze() for output of other lengths.
+ */
+class Shake :
+        public HashingAlgorithm {
+public:
+    using HashingAlgorithm::size_type;
+
+public:
+
+    using HashingAlgorithm::update;
+
+    /**
+     * Get a string name of the hashing algorithm.
+     * @return A string name of the hashing algorithm.
+     */
+    StringView getAlgorithm() const override;
+
+    /**
+     * Get a length of the output digest() produces in bits.
+     * @return Twice the security strength of the function.
+     */
+    size_type getDigestLength() const override;
+
+    /**
+     * Update the digest with the given input.
+     * @param input A memory view to read data from.
+     * @return A reference to self for a fluent interface.
+     * @note Raises InvalidStateError if output has already been squeezed.
+     */
+    HashingAlgorithm& update(MemoryView input) override;
+
+    /**
+     * Get the next part of the output. No more input can be added after the first call.
+     * @param output Buffer to fill with output bytes.
+     * @return A reference to self for a fluent interface.
+     */
+    Shake& squeeze(MutableMemoryView output) noexcept;
+
+protected:
+
+    /**
+     * Completes the hash computation and gets getDigestLength() bits of the output.
+     * @param dest Destination for the digest of exactly getDigestLength() / 8 bytes.
+     */
+    void digestUnchecked(MutableMemoryView dest) override;
+
+    /**
+     * Construct a new computation.
+     * @param securityStrength Security strength in bits: 128 or 256.
+     */
+    explicit Shake(size_type securityStrength) noexcept;
+
+private:
+
+    KeccakSponge    _sponge;
+    size_type       _securityStrength;
+};
+
+
+/** SHAKE128: SHAKE with 128 bit security strength. */
+class Shake128 final : public Shake {
+public:
+    /// Size of the digest() output in bytes.
+    static constexpr size_type kDigestSize = 32;
+
+    Shake128() noexcept : Shake{128} {}
+};
+
+/** SHAKE256: SHAKE with 256 bit security strength. */
+class Shake256 final : public Shake {
+public:
+    /// Size of the digest() output in bytes.
+    static constexpr size_type kDigestSize = 64;
+
+    Shake256() noexcept : Shake{256} {}
+};
+
+
+/**
+ * Batch SHA-3: computes digests of a batch of independent messages.
+ * With AVX2 four messages are hashed at a time, with permutations of all four states interleaved in SIMD lanes.
+ */
+class Sha3xN {
+public:
+    using size_type = Sha3::size_type;
+
+public:
+
+    /** Get number of messages hashed in parallel on this CPU: 1 if there is no multi-buffer implementation for it. */
+    static size_type lanes() noexcept;
+
+    /**
+     * Compute digests of all the messages.
+     * @param messages Messages to hash.
+     * @param digests Destination for digests: digestLength / 8 bytes per message, in the same order as messages.
+     * @param digestLength Length of each digest in bits: 224, 256, 384 or 512.
+     * @return Error if the digest length is not supported or the destination is too small to hold all the digests.
+     * Nothing is written in that case.
+     */
+    static Result<void, Error> digest(ArrayView<MemoryView const> messages, MutableMemoryView digests,
+                                      size_type digestLength = 256) noexcept;
+};
 
 }  // End of namespace hashing
 }  // End of namespace Solace
@@ -0,0 +1,292 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/hashing/siphash.hpp
+ *	@brief		SipHash and HalfSipHash keyed hash functions.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_HASHING_SIPHASH_HPP
+#define SOLACE_HASHING_SIPHASH_HPP
+
+#include "solace/hashing/digestAlgorithm.hpp"
+
+#include "solace/stringView.hpp"
+#include "solace/details/byte_swap.hpp"
+
+
+namespace Solace {
+namespace hashing {
+
+/// 128 bit key of SipHash.
+struct SipHashKey {
+    uint64  k0;
+    uint64  k1;
+
+    /**
+     * Get the random key generated once per process.
+     * Hashed containers that use it for keys from untrusted sources are not open to collision flooding:
+     * an attacker can't precompute colliding keys without knowing the hash key.
+     */
+    static SipHashKey const& processKey() noexcept;
+};
+
+/// 64 bit key of HalfSipHash.
+struct HalfSipHashKey {
+    uint32  k0;
+    uint32  k1;
+
+    /// Get the random key generated once per process. @see SipHashKey::processKey
+    static HalfSipHashKey const& processKey() noexcept;
+};
+
+
+namespace details {
+
+/// State of SipHash: v0..v3 are either 64 bit words (SipHash) or 32 bit words (HalfSipHash).
+template<typename Word>
+struct SipState {
+    Word v0;
+    Word v1;
+    Word v2;
+    Word v3;
+};
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline void sipRound(SipState<uint64>& s) noexcept {
+    s.v0 += s.v1; s.v1 = (s.v1 << 13) | (s.v1 >> 51); s.v1 ^= s.v0; s.v0 = (s.v0 << 32) | (s.v0 >> 32);
+    s.v2 += s.v3; s.v3 = (s.v3 << 16) | (s.v3 >> 48); s.v3 ^= s.v2;
+    s.v0 += s.v3; s.v3 = (s.v3 << 21) | (s.v3 >> 43); s.v3 ^= s.v0;
+    s.v2 += s.v1; s.v1 = (s.v1 << 17) | (s.v1 >> 47); s.v1 ^= s.v2; s.v2 = (s.v2 << 32) | (s.v2 >> 32);
+}
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline void sipRound(SipState<uint32>& s) noexcept {
+    s.v0 += s.v1; s.v1 = (s.v1 << 5) | (s.v1 >> 27); s.v1 ^= s.v0; s.v0 = (s.v0 << 16) | (s.v0 >> 16);
+    s.v2 += s.v3; s.v3 = (s.v3 << 8) | (s.v3 >> 24); s.v3 ^= s.v2;
+    s.v0 += s.v3; s.v3 = (s.v3 << 7) | (s.v3 >> 25); s.v3 ^= s.v0;
+    s.v2 += s.v1; s.v1 = (s.v1 << 13) | (s.v1 >> 19); s.v1 ^= s.v2; s.v2 = (s.v2 << 16) | (s.v2 >> 16);
+}
+
+inline SipState<uint64> sipInit(SipHashKey const& key) noexcept {
+    return {key.k0 ^ 0x736f6d6570736575ULL, key.k1 ^ 0x646f72616e646f6dULL,
+            key.k0 ^ 0x6c7967656e657261ULL, key.k1 ^ 0x7465646279746573ULL};
+}
+
+inline SipState<uint32> sipInit(HalfSipHashKey const& key) noexcept {
+    return {key.k0, key.k1, key.k0 ^ 0x6c796765U, key.k1 ^ 0x74656462U};
+}
+
+/// Mix a word of input into the state with CRounds rounds.
+template<int CRounds, typename Word>
+inline void sipCompress(SipState<Word>& s, Word m) noexcept {
+    s.v3 ^= m;
+    for (int i = 0; i < CRounds; ++i) {
+        sipRound(s);
+    }
+    s.v0 ^= m;
+}
+
+/**
+ * Mix the last partial word of input and finalize the hash.
+ * @param tail Last bytes of input, less than a word.
+ * @param tailLength Number of bytes in the tail.
+ * @param length Total length of the input.
+ */
+template<int CRounds, int DRounds, typename Word>
+inline Word sipFinalize(SipState<Word> s, byte const* tail, uint32 tailLength, uint64 length) noexcept {
+    auto b = static_cast<Word>(static_cast<Word>(length & 0xff) << (8 * sizeof(Word) - 8));
+    for (uint32 i = 0; i < tailLength; ++i) {
+        b |= static_cast<Word>(tail[i]) << (8 * i);
+    }
+
+    sipCompress<CRounds>(s, b);
+
+    s.v2 ^= 0xff;
+    for (int i = 0; i < DRounds; ++i) {
+        sipRound(s);
+    }
+
+    return (sizeof(Word) == 8)
+            ? s.v0 ^ s.v1 ^ s.v2 ^ s.v3
+            : s.v1 ^ s.v3;
+}
+
+/// One-shot SipHash-c-d or HalfSipHash-c-d of the data.
+template<int CRounds, int DRounds, typename Key>
+inline auto sipHash(Key const& key, MemoryView data) noexcept {
+    auto s = sipInit(key);
+    using Word = decltype(s.v0);
+
+    auto p = data.begin();
+    auto const nwords = data.size() / sizeof(Word);
+    for (MemoryView::size_type i = 0; i < nwords; ++i, p += sizeof(Word)) {
+        sipCompress<CRounds>(s, Solace::details::loadLE<Word>(p));
+    }
+
+    return sipFinalize<CRounds, DRounds>(s, p, static_cast<uint32>(data.size() % sizeof(Word)), data.size());
+}
+
+}  // End of namespace details
+
+
+/** Compute SipHash-2-4 of the data: the standard variant of SipHash. */
+inline uint64 sipHash24(SipHashKey const& key, MemoryView data) noexcept {
+    return details::sipHash<2, 4>(key, data);
+}
+
+/** Compute SipHash-1-3 of the data: faster variant with fewer rounds, good for hash tables. */
+inline uint64 sipHash13(SipHashKey const& key, MemoryView data) noexcept {
+    return details::sipHash<1, 3>(key, data);
+}
+
+/** Compute 32 bit HalfSipHash-2-4 of the data. */
+inline uint32 halfSipHash24(HalfSipHashKey const& key, MemoryView data) noexcept {
+    return details::sipHash<2, 4>(key, data);
+}
+
+/** Compute 32 bit HalfSipHash-1-3 of the data. */
+inline uint32 halfSipHash13(HalfSipHashKey const& key, MemoryView data) noexcept {
+    return details::sipHash<1, 3>(key, data);
+}
+
+
+/**
+ * Keyed hash function object for hashed containers with keys that come from untrusted sources.
+ * Uses SipHash-1-3 with the per-process random key by default.
+ */
+struct SipHasher {
+    SipHashKey  key;
+
+    SipHasher() noexcept
+        : key{SipHashKey::processKey()}
+    {}
+
+    explicit SipHasher(SipHashKey hashKey) noexcept
+        : key{hashKey}
+    {}
+
+    uint64 operator() (MemoryView data) const noexcept {
+        return sipHash13(key, data);
+    }
+
+    uint64 operator() (StringView str) const noexcept {
+        return sipHash13(key, str.view());
+    }
+};
+
+
+/**
+ * Implementation of SipHash-c-d keyed hash function with 64 bit digest, and of its 32 bit HalfSipHash-c-d variant.
+ * SipHash is a pseudorandom function, fast on short inputs. It is meant to protect hashed containers against
+ * collision flooding attacks, and for authentication of short messages.
+ *
+ * Use one of SipHash24, SipHash13, HalfSipHash24 or HalfSipHash13.
+ *
+ * @tparam Key SipHashKey for SipHash, or HalfSipHashKey for HalfSipHash.
+ * @tparam CRounds Number of compression rounds per word of input.
+ * @tparam DRounds Number of finalization rounds.
+ */
+template<typename Key, int CRounds, int DRounds>
+class SipHash final :
+        public HashingAlgorithm {
+public:
+    using HashingAlgorithm::size_type;
+    using Word = decltype(Key::k0);
+
+    /// Size of the digest in bytes.
+    static constexpr size_type kDigestSize = sizeof(Word);
+
+    /// Size of a block of input processed at once in bytes.
+    static constexpr size_type kBlockSize = sizeof(Word);
+
+public:
+
+    using HashingAlgorithm::update;
+
+    /** Construct a new hash computation with the per-process random key. */
+    SipHash() noexcept
+        : SipHash{Key::processKey()}
+    {}
+
+    /**
+     * Construct a new hash computation.
+     * @param key Secret key.
+     */
+    explicit SipHash(Key const& key) noexcept
+        : _state{details::sipInit(key)}
+    {}
+
+    /**
+     * Get a string name of the hashing algorithm.
+     * @return A string name of the hashing algorithm.
+     */
+    StringView getAlgorithm() const override;
+
+    /**
+     * Get a length of the digest in bits.
+     * @return Length of the digest produced by this algorithm.
+     */
+    size_type getDigestLength() const override;
+
+    /**
+     * Update the digest with the given input.
+     * @param input A memory view to read data from.
+     * @return A reference to self for a fluent interface.
+     */
+    HashingAlgorithm& update(MemoryView input) override;
+
+    /** Get hash value of the data so far. State is not changed: more input can be added afterwards. */
+    Word value() const noexcept {
+        return details::sipFinalize<CRounds, DRounds>(_state, _tail,
+                                                      static_cast<uint32>(_length % kBlockSize), _length);
+    }
+
+protected:
+
+    /**
+     * Completes the hash computation. Digest is the little-endian hash value, as in the reference implementation.
+     * @param dest Destination for the digest of exactly getDigestLength() / 8 bytes.
+     */
+    void digestUnchecked(MutableMemoryView dest) override;
+
+private:
+    details::SipState<Word> _state;
+    uint64                  _length{0};
+    byte                    _tail[kBlockSize];  //!< Last partial word of input
+};
+
+
+/// SipHash-2-4: the standard SipHash.
+using SipHash24 = SipHash<SipHashKey, 2, 4>;
+
+/// SipHash-1-3: faster SipHash with fewer rounds, good for hash tables.
+using SipHash13 = SipHash<SipHashKey, 1, 3>;
+
+/// HalfSipHash-2-4: SipHash on 32 bit words with 32 bit digest.
+using HalfSipHash24 = SipHash<HalfSipHashKey, 2, 4>;
+
+/// HalfSipHash-1-3: HalfSipHash with fewer rounds.
+using HalfSipHash13 = SipHash<HalfSipHashKey, 1, 3>;
+
+extern template class SipHash<SipHashKey, 2, 4>;
+extern template class SipHash<SipHashKey, 1, 3>;
+extern template class SipHash<HalfSipHashKey, 2, 4>;
+extern template class SipHash<HalfSipHashKey, 1, 3>;
+
+}  // End of namespace hashing
+}  // End of namespace Solace
+#endif  // SOLACE_HASHING_SIPHASH_HPP
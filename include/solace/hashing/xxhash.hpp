@@ -0,0 +1,157 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: xxHash
+ *	@file		solace/hashing/xxhash.hpp
+ *	@brief		Defines xxHash family of non-cryptographic hash algorithms
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_HASHING_XXHASH_HPP
+#define SOLACE_HASHING_XXHASH_HPP
+
+#include "solace/hashing/digestAlgorithm.hpp"
+
+
+namespace Solace {
+namespace hashing {
+
+/**
+ * Implementation of XXH64 hashing algorithm with 64bit digest.
+ * xxHash is an extremely fast non-cryptographic hash, suitable for checksums and hash tables.
+ * Digest is the hash value in big-endian byte order, the canonical representation of xxHash.
+ */
+class XxHash64 final :
+        public HashingAlgorithm {
+public:
+    using HashingAlgorithm::size_type;
+
+    /// Size of the digest in bytes.
+    static constexpr size_type kDigestSize = 8;
+
+public:
+
+    using HashingAlgorithm::update;
+
+    XxHash64(uint64 seed = 0) noexcept;
+
+    /**
+     * Get a string name of the hashing algorithm.
+     * @return A string name of the hashing algorithm.
+     */
+    StringView getAlgorithm() const override;
+
+    /**
+     * Get a length of the digest in bits.
+     * @return Length of the digest produced by this algorithm.
+     */
+    size_type getDigestLength() const override;
+
+    /**
+     * Update the digest with the given input.
+     * @param input A memory view to read data from.
+     * @return A reference to self for a fluent interface.
+     */
+    HashingAlgorithm& update(MemoryView input) override;
+
+    /** Get hash value of the data so far. Does not change the state: more data can be added after. */
+    uint64 value() const noexcept;
+
+protected:
+
+    /**
+     * Completes the hash computation.
+     * @param dest Destination for the digest of exactly getDigestLength() / 8 bytes.
+     */
+    void digestUnchecked(MutableMemoryView dest) override;
+
+private:
+    uint64  _acc[4];
+    uint64  _seed;
+    uint64  _totalLength{0};
+    byte    _buffer[32];
+    uint32  _bufferSize{0};
+};
+
+
+/**
+ * Implementation of XXH3 hashing algorithm with 64bit digest.
+ * XXH3 is a successor of XXH64: faster on both small and large inputs, it is vectorized with AVX2 where available.
+ * Digest is the hash value in big-endian byte order, the canonical representation of xxHash.
+ */
+class XxHash3 final :
+        public HashingAlgorithm {
+public:
+    using HashingAlgorithm::size_type;
+
+    /// Size of the digest in bytes.
+    static constexpr size_type kDigestSize = 8;
+
+    /// Size of the secret XXH3 mixes input with.
+    static constexpr size_type kSecretSize = 192;
+
+public:
+
+    using HashingAlgorithm::update;
+
+    XxHash3(uint64 seed = 0) noexcept;
+
+    /**
+     * Get a string name of the hashing algorithm.
+     * @return A string name of the hashing algorithm.
+     */
+    StringView getAlgorithm() const override;
+
+    /**
+     * Get a length of the digest in bits.
+     * @return Length of the digest produced by this algorithm.
+     */
+    size_type getDigestLength() const override;
+
+    /**
+     * Update the digest with the given input.
+     * @param input A memory view to read data from.
+     * @return A reference to self for a fluent interface.
+     */
+    HashingAlgorithm& update(MemoryView input) override;
+
+    /** Get hash value of the data so far. Does not change the state: more data can be added after. */
+    uint64 value() const noexcept;
+
+protected:
+
+    /**
+     * Completes the hash computation.
+     * @param dest Destination for the digest of exactly getDigestLength() / 8 bytes.
+     */
+    void digestUnchecked(MutableMemoryView dest) override;
+
+private:
+    /// Long inputs are consumed in stripes of 64 bytes; input is buffered until there is more than a buffer full.
+    static constexpr uint32 kBufferSize = 256;
+
+    uint64  _acc[8];
+    uint64  _seed;
+    uint64  _totalLength{0};
+    uint32  _stripesInBlock{0};     //!< Number of stripes consumed in the current block
+    uint32  _bufferSize{0};
+    byte    _secret[kSecretSize];   //!< Secret derived from the seed
+    byte    _buffer[kBufferSize];
+};
+
+
+}  // End of namespace hashing
+}  // End of namespace Solace
+#endif  // SOLACE_HASHING_XXHASH_HPP
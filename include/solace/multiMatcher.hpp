@@ -0,0 +1,239 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/multiMatcher.hpp
+ *	@brief		Search for multiple literal patterns in a single pass.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_MULTIMATCHER_HPP
+#define SOLACE_MULTIMATCHER_HPP
+
+#include "solace/stringView.hpp"
+#include "solace/arrayView.hpp"
+#include "solace/memoryResource.hpp"
+#include "solace/memoryManager.hpp"
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
+#include <type_traits>
+
+
+namespace Solace {
+
+/**
+ * A compiled set of literal patterns that can be searched for in a single pass over the data.
+ *
+ * Small pattern sets are searched using a SIMD 'Teddy' prefilter that finds candidate positions by the first few bytes
+ * of the patterns and then verifies candidates. Larger sets as well as streamed data use an Aho-Corasick automaton.
+ * Every occurrence of every pattern is reported, including overlapping ones.
+ * Empty patterns never match.
+ *
+ * Use makeMultiMatcher() to create an instance.
+ */
+class MultiMatcher {
+public:
+	using size_type = MemoryView::size_type;
+	using PatternId = uint32;
+
+	/// An occurrence of a pattern in the data.
+	struct Match {
+		/// Index of the pattern in the array the matcher has been built from.
+		PatternId	pattern;
+		/// Offset of the first byte of the occurrence.
+		size_type	offset;
+	};
+
+	class Stream;
+
+public:
+
+	MultiMatcher(MultiMatcher const&) = delete;
+	MultiMatcher& operator= (MultiMatcher const&) = delete;
+
+	MultiMatcher(MultiMatcher&&) noexcept = default;
+	MultiMatcher& operator= (MultiMatcher&&) noexcept = default;
+
+	/** Get the number of patterns this matcher has been built from. */
+	constexpr uint32 patternsCount() const noexcept {
+		return _patternsCount;
+	}
+
+	/** Get the length in bytes of the pattern with the given id. */
+	size_type patternLength(PatternId id) const;
+
+	/**
+	 * Find all the occurrences of the patterns in the given data.
+	 * @param data The data to search.
+	 * @param onMatch A callback invoked with Match for each occurrence of each pattern.
+	 * Order in which matches are reported is unspecified.
+	 * @return Number of matches found.
+	 */
+	template<typename F>
+	size_type scan(MemoryView data, F&& onMatch) const {
+		return scan(data, toContext(onMatch), &invoke<std::remove_reference_t<F>>);
+	}
+
+	template<typename F>
+	size_type scan(StringView data, F&& onMatch) const {
+		return scan(data.view(), fwd<F>(onMatch));
+	}
+
+	/** Check if the data contains any of the patterns. */
+	bool containsAny(MemoryView data) const;
+
+	bool containsAny(StringView data) const {
+		return containsAny(data.view());
+	}
+
+	/**
+	 * Start searching data that comes in a sequence of chunks.
+	 * @return A new stream state attached to this matcher.
+	 */
+	Stream stream() const noexcept;
+
+private:
+	friend Result<MultiMatcher, Error> makeMultiMatcher(MemoryManager& memManager, ArrayView<StringView const> patterns);
+
+	/// Max number of leading bytes of patterns used by the prefilter.
+	static constexpr uint32 kMaxFingerprintLength = 3;
+
+	using MatchCallback = void (*)(void* context, Match const& match);
+
+	template<typename F>
+	static void invoke(void* context, Match const& match) {
+		(*static_cast<F*>(context))(match);
+	}
+
+	template<typename F>
+	static void* toContext(F& f) noexcept {
+		return const_cast<void*>(static_cast<void const*>(&f));
+	}
+
+	MultiMatcher() noexcept = default;
+
+	size_type scan(MemoryView data, void* context, MatchCallback onMatch) const;
+	size_type feed(uint32& state, size_type position, MemoryView data, void* context, MatchCallback onMatch) const;
+	size_type verify(byte const* data, size_type size, size_type offset, uint32 buckets,
+					 void* context, MatchCallback onMatch) const;
+
+private:
+
+	MemoryResource	_memory;
+	uint32			_patternsCount{0};
+
+	// Aho-Corasick automaton: a dense DFA over a compressed alphabet.
+	uint32			_classCount{1};
+	uint32 const*	_next{nullptr};
+	uint32 const*	_terminal{nullptr};		//!< Per state: first pattern that ends in the state.
+	uint32 const*	_report{nullptr};		//!< Per state: the longest suffix state that is a terminal.
+	uint32 const*	_dictLink{nullptr};		//!< Per state: the longest proper suffix state that is a terminal.
+	uint32 const*	_sameAs{nullptr};		//!< Per pattern: next duplicate of the pattern.
+
+	// Copy of the patterns
+	uint32 const*	_patternOffset{nullptr};
+	uint32 const*	_patternLength{nullptr};
+	byte const*		_patternBytes{nullptr};
+
+	byte			_classOf[256]{};
+
+	// Teddy prefilter: used if fingerprint length is not zero.
+	uint32			_fingerprintLength{0};
+	byte			_fingerprintMasks[kMaxFingerprintLength][2][16]{};
+};
+
+
+/**
+ * State of a search over a data stream.
+ * Chunks of the data are fed in order and matches spanning chunk boundaries are found.
+ * Matches are reported as soon as the last byte of an occurrence is fed,
+ * i.e. in order of the end of the occurrences, longest first.
+ *
+ * @note The stream refers to the matcher it was created from which must outlive it.
+ */
+class MultiMatcher::Stream {
+public:
+
+	explicit Stream(MultiMatcher const& matcher) noexcept
+		: _matcher{&matcher}
+	{}
+
+	/** Get the number of bytes fed so far. */
+	constexpr size_type position() const noexcept {
+		return _position;
+	}
+
+	/** Forget all the data fed so far and start a new search. */
+	void reset() noexcept {
+		_state = 0;
+		_position = 0;
+	}
+
+	/**
+	 * Search the next chunk of the data.
+	 * @param chunk The data that follows data fed previously.
+	 * @param onMatch A callback invoked with Match for each occurrence.
+	 * Offset of the match is relative to the start of the stream.
+	 * @return Number of matches found in this chunk.
+	 */
+	template<typename F>
+	size_type feed(MemoryView chunk, F&& onMatch) {
+		auto const count = _matcher->feed(_state, _position, chunk,
+										  toContext(onMatch), &invoke<std::remove_reference_t<F>>);
+		_position += chunk.size();
+
+		return count;
+	}
+
+	template<typename F>
+	size_type feed(StringView chunk, F&& onMatch) {
+		return feed(chunk.view(), fwd<F>(onMatch));
+	}
+
+private:
+	MultiMatcher const*	_matcher;
+	uint32				_state{0};
+	size_type			_position{0};
+};
+
+
+inline
+MultiMatcher::Stream
+MultiMatcher::stream() const noexcept {
+	return Stream{*this};
+}
+
+
+/**
+ * Compile a set of literal patterns into a matcher.
+ * @param memManager Memory manager to allocate matcher's tables.
+ * @param patterns Patterns to search for. Pattern id reported with a match is the index of the pattern in this array.
+ * Patterns are copied and need not outlive the matcher.
+ * @return Matcher or an error.
+ */
+Result<MultiMatcher, Error>
+makeMultiMatcher(MemoryManager& memManager, ArrayView<StringView const> patterns);
+
+/**
+ * Compile a set of literal patterns into a matcher using system heap memory.
+ * @param patterns Patterns to search for.
+ * @return Matcher or an error.
+ */
+Result<MultiMatcher, Error>
+makeMultiMatcher(ArrayView<StringView const> patterns);
+
+}  // End of namespace Solace
+#endif  // SOLACE_MULTIMATCHER_HPP
@@ -30,6 +30,7 @@
 #include "solace/dialstring.hpp"
 #include "solace/optional.hpp"
 #include "solace/hashing/messageDigest.hpp"
+#include "solace/hashing/fixedSizeDigest.hpp"
 
 #include "solace/base16.hpp"
 
@@ -111,6 +112,12 @@ operator<< (std::ostream& ostr, hashing::MessageDigest const& a) {
     return ostr;
 }
 
+template<size_t Size>
+std::ostream& operator<< (std::ostream& ostr, hashing::FixedSizeDigest<Size> const& a) {
+    auto const hex = a.toHex().view();
+    return ostr.write(hex.data(), hex.size());
+}
+
 
 inline std::ostream& operator<< (std::ostream& ostr, Path const& v) {
     return ostr << v.toString();
@@ -618,6 +618,19 @@ Result<String, Error> makeStringReplace(StringView str, String::value_type what,
  */
 Result<String, Error> makeStringReplace(StringView str, StringView what, StringView with);
 
+/**
+ * Returns a new string with all occurrences of any of the given substrings replaced with corresponding values.
+ * All patterns are searched for in a single scan of the source string, which makes it suitable for templating.
+ * Replaced occurrences never overlap: the earliest ending occurrence is replaced first,
+ * and of the occurrences ending at the same position the longest one is chosen.
+ *
+ * @param what Sub-strings to be replaced in the original string. Empty patterns are ignored.
+ * @param with Replacement strings, one per each pattern in `what`.
+ * @return A new string with all occurrences of what[i] replaced with with[i].
+ */
+Result<String, Error>
+makeStringReplace(StringView str, ArrayView<StringView const> what, ArrayView<StringView const> with);
+
 inline auto makeStringReplace(String const& str, String::value_type what, String::value_type with) {
     return makeStringReplace(str.view(), what, with);
 }
@@ -122,6 +122,23 @@ struct LIFETIME_HINT_POINTER(char) StringView {
 		return compareTo(StringView{other});
     }
 
+    /** Test if values are equal ignoring the case of ASCII letters.
+     * Only 'A'..'Z' / 'a'..'z' are folded, thus the comparison is locale independent
+     * and suitable for protocol tokens such as header names.
+     *
+     * @param other A string to compare this one with.
+     * @return True if both strings are equal when case is ignored.
+     */
+    bool equalsIgnoreCase(StringView other) const noexcept;
+
+    /** Compares two strings lexicographically ignoring the case of ASCII letters.
+     *
+     * @return The value 0 if strings are equal ignoring case;
+     * a value less than 0 if this string is lexicographically less than the argument;
+     * and a value greater than 0 otherwise.
+     */
+    int compareToIgnoreCase(StringView other) const noexcept;
+
     /**
      * Tests if the string starts with the specified prefix.
      *
@@ -142,6 +159,14 @@ struct LIFETIME_HINT_POINTER(char) StringView {
      */
     bool startsWith(StringView prefix) const noexcept;
 
+    /**
+     * Tests if the string starts with the specified prefix ignoring the case of ASCII letters.
+     *
+     * @param prefix The prefix to check.
+     * @return True if the string starts with the given prefix when case is ignored, false otherwise.
+     */
+    bool startsWithIgnoreCase(StringView prefix) const noexcept;
+
     /**
      * Tests if the string ends with the specified suffix.
      *
@@ -402,6 +427,14 @@ struct LIFETIME_HINT_POINTER(char) StringView {
      */
     uint64 hashCode() const noexcept;
 
+    /** Returns a hash code for this string with ASCII letters folded to lower case.
+     * Strings that are equalsIgnoreCase() have the same case-folded hash code.
+     * Hash code of a string in lower case is equal to its hashCode().
+     *
+     * @return A case-insensitive hash code value for the string.
+     */
+    uint64 hashCodeIgnoreCase() const noexcept;
+
     const_iterator begin() const noexcept {
         return empty()
                 ? nullptr
@@ -559,6 +592,21 @@ bool operator>= (StringView const& lhs, StringView const& rhs) {
 }
 
 
+/// Case-insensitive hash function object for use as a key hash of hashed containers.
+struct HashIgnoreCase {
+    uint64 operator() (StringView key) const noexcept {
+        return key.hashCodeIgnoreCase();
+    }
+};
+
+/// Case-insensitive equality function object to go along with HashIgnoreCase.
+struct EqualsIgnoreCase {
+    bool operator() (StringView lhs, StringView rhs) const noexcept {
+        return lhs.equalsIgnoreCase(rhs);
+    }
+};
+
+
 }  // namespace Solace
 
 /*
@@ -24,6 +24,7 @@
 #include "solace/types.hpp"
 
 #include "solace/memoryView.hpp"
+#include "solace/arrayView.hpp"
 #include "solace/string.hpp"
 #include "solace/result.hpp"
 #include "solace/error.hpp"
@@ -202,8 +203,90 @@ inline void swap(UUID& lhs, UUID& rhs) noexcept {
 [[nodiscard]] UUID makeUUID(uint32 a0, uint32 a1, uint32 a2, uint32 a3) noexcept;
 
 
+/**
+ * Generator of random, version 4, UUIDs as per RFC 4122.
+ *
+ * Random bytes are a ChaCha20 keystream produced several blocks at a time. The first bytes of each batch
+ * of blocks replace the key, and bytes are wiped from the buffer once used, so that UUIDs generated earlier
+ * can not be recovered from the state of the generator.
+ * Generator is seeded from the system's random number generator when constructed,
+ * and again in a child process after fork().
+ *
+ * A generator is not thread safe: use the instance of the calling thread, threadLocal(),
+ * which is what makeRandomUUID() does.
+ */
+class UUIDGenerator {
+public:
+    using size_type = UUID::size_type;
+
+    /// Size of the seed of a deterministic generator in bytes.
+    static constexpr size_type kSeedSize = 32;
+
+public:
+
+    /**
+     * Create a deterministic generator: the same seed gives the same sequence of UUIDs.
+     * It is not reseeded after fork(). Useful for tests and reproducible simulations.
+     * @param seed Secret seed of exactly kSeedSize bytes.
+     * @return A generator or an error if the seed is of wrong size.
+     */
+    static Result<UUIDGenerator, Error> seeded(MemoryView seed) noexcept;
+
+    /** Get generator of the calling thread, seeded on first use in the thread. */
+    static UUIDGenerator& threadLocal() noexcept;
+
+public:
+
+    /** Construct a generator seeded from the system's random number generator */
+    UUIDGenerator() noexcept;
+
+    /** Move-construct a generator. The moved-from one is reseeded from the system if used again. */
+    UUIDGenerator(UUIDGenerator&& rhs) noexcept;
+
+    UUIDGenerator(UUIDGenerator const&) = delete;
+    UUIDGenerator& operator= (UUIDGenerator const&) = delete;
+
+    /** Destroy the generator, wiping its state */
+    ~UUIDGenerator();
+
+    /** Generate a random UUID */
+    [[nodiscard]] UUID generate() noexcept;
+
+    /**
+     * Generate a batch of random UUIDs.
+     * @param uuids Destination to fill with new UUIDs.
+     */
+    void generate(ArrayView<UUID> uuids) noexcept;
+
+protected:
+
+    UUIDGenerator(MemoryView seed, bool reseedOnFork) noexcept;
+
+    /// Reseed from the system if the process has forked since the generator was seeded.
+    void checkFork() noexcept;
+
+    /// Seed from the system's random number generator.
+    void reseed() noexcept;
+
+    /// Produce the next batch of keystream blocks, and replace the key with the first bytes of it.
+    void refill() noexcept;
+
+private:
+
+    static constexpr size_type kBlockSize = 64;
+    static constexpr size_type kBlocks = 8;
+    static constexpr size_type kBufferSize = kBlocks * kBlockSize;
+
+    uint32      _key[8];
+    byte        _buffer[kBufferSize];
+    size_type   _position;          //!< Offset of the first unused byte of the buffer
+    uint32      _forkGeneration;    //!< Number of forks seen when the generator was seeded
+    bool        _reseedOnFork;
+};
+
+
 /** Create random UUID
- * This method uses system's random number generator to generate a new random UUID.
+ * This method uses generator of the calling thread to generate a new random, version 4, UUID.
  */
 [[nodiscard]] UUID makeRandomUUID() noexcept;
 
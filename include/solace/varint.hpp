@@ -0,0 +1,64 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/varint.hpp
+ *	@brief		Variable length integer encoding helpers.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_VARINT_HPP
+#define SOLACE_VARINT_HPP
+
+#include "solace/types.hpp"
+
+
+namespace Solace {
+
+/// Max number of bytes unsigned LEB128 encoding of a 64 bit value takes.
+constexpr uint32 kMaxVarintSize = 10;
+
+
+/**
+ * Get number of bytes unsigned LEB128 encoding of the value takes.
+ * Each byte carries 7 bits of the value, least significant first; high bit of a byte is set if more bytes follow.
+ */
+constexpr uint32 varintSize(uint64 value) noexcept {
+    uint32 size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+
+    return size;
+}
+
+
+/**
+ * Map a signed value to unsigned so that values of small magnitude have small encodings:
+ * 0 -> 0, -1 -> 1, 1 -> 2, -2 -> 3 ...
+ */
+constexpr uint64 zigZagEncode(int64 value) noexcept {
+    return (static_cast<uint64>(value) << 1) ^ static_cast<uint64>(value >> 63);
+}
+
+
+/** Reverse of zigZagEncode(). */
+constexpr int64 zigZagDecode(uint64 value) noexcept {
+    return static_cast<int64>(value >> 1) ^ -static_cast<int64>(value & 1);
+}
+
+}  // End of namespace Solace
+#endif  // SOLACE_VARINT_HPP
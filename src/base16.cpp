@@ -20,12 +20,20 @@
  ******************************************************************************/
 #include "solace/base16.hpp"
 #include "solace/posixErrorDomain.hpp"
+#include "solace/details/cpu_features.hpp"
+
+#include <algorithm>  // std::min
+#include <cstring>  // memcpy
+
+#if defined(SOLACE_X86_DISPATCH)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 
 using namespace Solace;
 
-// Not used
-/*
 static const char kBase16Alphabet_u[256][3] = {
     "00", "01", "02", "03", "04", "05", "06", "07", "08", "09", "0A", "0B", "0C", "0D", "0E", "0F",
     "10", "11", "12", "13", "14", "15", "16", "17", "18", "19", "1A", "1B", "1C", "1D", "1E", "1F",
@@ -44,7 +52,6 @@ static const char kBase16Alphabet_u[256][3] = {
     "E0", "E1", "E2", "E3", "E4", "E5", "E6", "E7", "E8", "E9", "EA", "EB", "EC", "ED", "EE", "EF",
     "F0", "F1", "F2", "F3", "F4", "F5", "F6", "F7", "F8", "F9", "FA", "FB", "FC", "FD", "FE", "FF"
 };
-*/
 
 static const char kBase16Alphabet_l[256][3] = {
     "00", "01", "02", "03", "04", "05", "06", "07", "08", "09", "0a", "0b", "0c", "0d", "0e", "0f",
@@ -79,9 +86,144 @@ static const signed char kHexToBin[128] = {
 
 
 
+static int hexToBin(byte c) noexcept {
+    return (c < sizeof(kHexToBin)) ? kHexToBin[c] : -1;
+}
+
+
+namespace /* anonymous */ {
+
+constexpr char kDigitsLower[] = "0123456789abcdef";
+constexpr char kDigitsUpper[] = "0123456789ABCDEF";
+
+
+#if defined(SOLACE_X86_DISPATCH)
+
+/** Encode whole blocks of 16 bytes: both nibbles of each byte are mapped to digits with PSHUFB and interleaved.
+ * @return Number of input bytes consumed.
+ */
+SOLACE_TARGET("ssse3")
+size_t encodeBlocksSsse3(byte const* src, size_t len, byte* dest, char const* digits) noexcept {
+	auto const lut = _mm_loadu_si128(reinterpret_cast<__m128i const*>(digits));
+	auto const nibbleMask = _mm_set1_epi8(0x0F);
+
+	size_t i = 0;
+	for (; i + 16 <= len; i += 16, dest += 32) {
+		auto const in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+		auto const high = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(in, 4), nibbleMask));
+		auto const low = _mm_shuffle_epi8(lut, _mm_and_si128(in, nibbleMask));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_unpacklo_epi8(high, low));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 16), _mm_unpackhi_epi8(high, low));
+	}
+
+	return i;
+}
+
+
+SOLACE_TARGET("avx2")
+size_t encodeBlocksAvx2(byte const* src, size_t len, byte* dest, char const* digits) noexcept {
+	auto const lut = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(digits)));
+	auto const nibbleMask = _mm256_set1_epi8(0x0F);
+
+	size_t i = 0;
+	for (; i + 32 <= len; i += 32, dest += 64) {
+		auto const in = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i));
+		auto const high = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(in, 4), nibbleMask));
+		auto const low = _mm256_shuffle_epi8(lut, _mm256_and_si256(in, nibbleMask));
+
+		// Unpack works within 128 bit lanes: put the lanes back in order.
+		auto const first = _mm256_unpacklo_epi8(high, low);
+		auto const second = _mm256_unpackhi_epi8(high, low);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), _mm256_permute2x128_si256(first, second, 0x20));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + 32), _mm256_permute2x128_si256(first, second, 0x31));
+	}
+
+	return i;
+}
+
+#endif  // SOLACE_X86_DISPATCH
+
+
+/**
+ * Encode src into dest that has been checked to have space for 2 * len bytes.
+ */
+void base16encodeUnchecked(byte* dest, byte const* src, size_t len, Base16Case letterCase) noexcept {
+	auto const pairs = (letterCase == Base16Case::Upper) ? kBase16Alphabet_u : kBase16Alphabet_l;
+	size_t i = 0;
+
+#if defined(SOLACE_X86_DISPATCH)
+	auto const digits = (letterCase == Base16Case::Upper) ? kDigitsUpper : kDigitsLower;
+	auto const& cpu = details::cpuFeatures();
+	if (cpu.avx2) {
+		i = encodeBlocksAvx2(src, len, dest, digits);
+	} else if (cpu.ssse3) {
+		i = encodeBlocksSsse3(src, len, dest, digits);
+	}
+	dest += 2 * i;
+#endif
+
+	for (; i < len; ++i, dest += 2) {
+		memcpy(dest, pairs[src[i]], 2);
+	}
+}
+
+
+/**
+ * Decode pairs of hex digits until the end of input or until a character that is not a hex digit.
+ * @param dest Output buffer that has been checked to have space for len / 2 bytes.
+ * @return Number of input characters decoded, always even.
+ */
+size_t base16decodePrefix(byte* dest, byte const* src, size_t len) noexcept {
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	for (; i + 16 <= len; i += 16, dest += 8) {
+		auto const in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+		auto inRange = [in](char lo, char hi) {
+			return _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8(static_cast<char>(lo - 1))),
+								 _mm_cmplt_epi8(in, _mm_set1_epi8(static_cast<char>(hi + 1))));
+		};
+
+		auto const digit = inRange('0', '9');
+		auto const upper = inRange('A', 'F');
+		auto const lower = inRange('a', 'f');
+		auto const valid = _mm_or_si128(digit, _mm_or_si128(upper, lower));
+		if (_mm_movemask_epi8(valid) != 0xFFFF) {
+			break;
+		}
+
+		auto const shift = _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(-'0')),
+										_mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(10 - 'A')),
+													 _mm_and_si128(lower, _mm_set1_epi8(10 - 'a'))));
+		auto const nibbles = _mm_add_epi8(in, shift);
+
+		// Even bytes hold high nibbles, odd bytes - low ones.
+		auto const pairs = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4),
+										_mm_srli_epi16(nibbles, 8));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dest), _mm_packus_epi16(pairs, pairs));
+	}
+#endif
+
+	for (; i + 2 <= len; i += 2) {
+		auto const high = hexToBin(src[i]);
+		auto const low = hexToBin(src[i + 1]);
+		if ((high | low) < 0) {
+			break;
+		}
+
+		*dest++ = static_cast<byte>((high << 4) | low);
+	}
+
+	return i;
+}
+
+}  // namespace
+
+
 Result<byte, Error>
 charToBin(byte c) {
-    auto const value = kHexToBin[c];
+    auto const value = hexToBin(c);
 
     if (value < 0) {
 		return makeError(SystemErrors::ILSEQ, "charToBin");
@@ -107,15 +249,14 @@ Base16Encoder::encodedSize(MemoryView data) const {
 Result<void, Error>
 Base16Encoder::encode(MemoryView src) {
     auto& dest = *getDestBuffer();
-
-    for (auto value : src) {
-        auto res = dest.write(wrapMemory(kBase16Alphabet_l[value], 2));
-        if (!res) {
-			return res.moveError();
-        }
+    auto const outputLen = encodedSize(src.size());
+    if (dest.remaining() < outputLen) {
+		return makeError(SystemErrors::Overflow, "Base16Encoder::encode");
     }
 
-    return Ok();
+    base16encodeUnchecked(dest.viewRemaining().begin(), src.begin(), src.size(), _letterCase);
+
+    return dest.advance(outputLen);
 }
 
 
@@ -140,23 +281,16 @@ Base16Decoder::encode(MemoryView src) {
     }
 
     auto& dest = *getDestBuffer();
+    auto const outputLen = encodedSize(src.size());
+    if (dest.remaining() < outputLen) {
+		return makeError(SystemErrors::Overflow, "Base16Decoder::encode");
+    }
 
-    for (size_type i = 0; i < src.size(); i += 2) {
-        auto high = charToBin(src[i]);
-        auto low =  charToBin(src[i + 1]);
-
-        if (!high)
-			return high.moveError();
-        if (!low)
-			return low.moveError();
-
-		auto const value = narrow_cast<byte>((high.unwrap() << 4) + low.unwrap());
-        auto res = dest.write(value);
-        if (!res)
-			return res.moveError();
+    if (base16decodePrefix(dest.viewRemaining().begin(), src.begin(), src.size()) != src.size()) {
+		return makeError(SystemErrors::ILSEQ, "Base16Decoder::encode");
     }
 
-    return Ok();
+    return dest.advance(outputLen);
 }
 
 
@@ -227,3 +361,141 @@ Base16Decoded_Iterator::operator++ () {
 
     return *this;
 }
+
+
+Base16StreamEncoder::size_type
+Base16StreamEncoder::encodedSize(MemoryView data) const {
+    if (data.empty()) {
+        return 0;
+    }
+
+    // A line break goes before every pair that would start at a positive multiple of the line length.
+    auto const lineBreaks = (_lineLength == 0)
+            ? 0
+            : (_column + 2 * (data.size() - 1)) / _lineLength;
+
+    return Base16Encoder::encodedSize(data.size()) + lineBreaks * _lineBreak.size();
+}
+
+
+Result<void, Error>
+Base16StreamEncoder::encode(MemoryView src) {
+    auto& dest = *getDestBuffer();
+    auto const outputLen = encodedSize(src);
+    if (dest.remaining() < outputLen) {
+		return makeError(SystemErrors::Overflow, "Base16StreamEncoder::encode");
+    }
+
+    auto out = dest.viewRemaining().begin();
+    auto in = src.begin();
+    auto len = src.size();
+    if (_lineLength == 0) {
+        base16encodeUnchecked(out, in, len, _letterCase);
+        return dest.advance(outputLen);
+    }
+
+    while (len > 0) {
+        if (_column == _lineLength) {
+            memcpy(out, _lineBreak.data(), _lineBreak.size());
+            out += _lineBreak.size();
+            _column = 0;
+        }
+
+        auto const lineLen = std::min(len, (_lineLength - _column) / 2);
+        base16encodeUnchecked(out, in, lineLen, _letterCase);
+        out += 2 * lineLen;
+        in += lineLen;
+        len -= lineLen;
+        _column += 2 * lineLen;
+    }
+
+    return dest.advance(outputLen);
+}
+
+
+Result<void, Error>
+Base16StreamEncoder::finish() {
+    reset();
+
+    return Ok();
+}
+
+
+void
+Base16StreamEncoder::reset() noexcept {
+    _column = 0;
+}
+
+
+Base16StreamDecoder::size_type
+Base16StreamDecoder::encodedSize(MemoryView data) const {
+    return (data.size() + (_hasHighNibble ? 1 : 0)) / 2;
+}
+
+
+Result<void, Error>
+Base16StreamDecoder::encode(MemoryView src) {
+    auto& dest = *getDestBuffer();
+    auto out = dest.viewRemaining();
+    size_type written = 0;
+
+    auto const in = src.begin();
+    for (size_type i = 0; i < src.size(); ++i) {
+        if (!_hasHighNibble) {  // Decode a run of complete pairs in bulk
+            auto const maxLen = std::min(src.size() - i, 2 * (out.size() - written));
+            auto const decodedLen = base16decodePrefix(out.begin() + written, in + i, maxLen);
+            written += decodedLen / 2;
+            i += decodedLen;
+            if (i == src.size()) {
+                break;
+            }
+        }
+
+        auto const c = in[i];
+        auto const value = hexToBin(c);
+        if (value < 0) {
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                continue;
+            }
+
+            dest.advance(written);
+            return makeError(SystemErrors::ILSEQ, "Base16StreamDecoder::encode");
+        }
+
+        if (!_hasHighNibble) {
+            _highNibble = static_cast<byte>(value);
+            _hasHighNibble = true;
+            continue;
+        }
+
+        if (written == out.size()) {
+            dest.advance(written);
+            return makeError(SystemErrors::Overflow, "Base16StreamDecoder::encode");
+        }
+
+        out[written++] = static_cast<byte>((_highNibble << 4) | value);
+        _hasHighNibble = false;
+    }
+
+    return dest.advance(written);
+}
+
+
+Result<void, Error>
+Base16StreamDecoder::finish() {
+    auto const incomplete = _hasHighNibble;
+    reset();
+
+    if (incomplete) {
+        return makeError(GenericError::DOM, "Base16StreamDecoder::finish(): Incomplete pair");
+    }
+
+    return Ok();
+}
+
+
+void
+Base16StreamDecoder::reset() noexcept {
+    _hasHighNibble = false;
+    _highNibble = 0;
+}
@@ -0,0 +1,612 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		base32.cpp
+ *	@brief		Implementation of Base32 encoders and decoders.
+ ******************************************************************************/
+#include "solace/base32.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include "solace/details/cpu_features.hpp"
+
+#include <algorithm>  // std::min
+#include <cstring>  // memcpy
+#include <initializer_list>
+
+#if defined(SOLACE_X86_DISPATCH)
+#include <immintrin.h>
+#endif
+
+
+using namespace Solace;
+
+
+namespace Solace { namespace details {
+
+/// Encoding and decoding tables of a Base32 variant.
+struct Base32Alphabet {
+	/// A run of consecutive characters that decode to consecutive values.
+	struct Range {
+		byte	first;
+		byte	last;
+		byte	value;		//!< Value of the first character of the range.
+	};
+
+	byte	encoding[32];
+	byte	decoding[256];	//!< Character value or one of the kInvalid, kSkip markers.
+	Range	ranges[3];		//!< All characters of the alphabet as ranges, for the vectorized decoder.
+	uint32	rangesCount;	//!< Zero if alphabet has aliases that do not fit into ranges.
+	bool	padding;
+};
+
+}  // End of namespace details
+}  // End of namespace Solace
+
+
+namespace /* anonymous */ {
+
+using size_type = Encoder::size_type;
+using details::Base32Alphabet;
+
+constexpr byte kPad = '=';
+constexpr byte kInvalid = 0xFF;
+constexpr byte kSkip = 0xFE;
+
+
+constexpr Base32Alphabet
+makeAlphabet(char const (&chars)[33], bool padding,
+			 std::initializer_list<Base32Alphabet::Range> ranges) noexcept {
+	Base32Alphabet alphabet{};
+	alphabet.padding = padding;
+
+	for (auto& value : alphabet.decoding) {
+		value = kInvalid;
+	}
+
+	for (uint32 i = 0; i < 32; ++i) {
+		auto const c = static_cast<byte>(chars[i]);
+		alphabet.encoding[i] = c;
+		alphabet.decoding[c] = static_cast<byte>(i);
+		if (c >= 'A' && c <= 'Z') {  // Decoding is case insensitive
+			alphabet.decoding[c + ('a' - 'A')] = static_cast<byte>(i);
+		}
+	}
+
+	for (auto const& range : ranges) {
+		alphabet.ranges[alphabet.rangesCount++] = range;
+	}
+
+	return alphabet;
+}
+
+
+constexpr Base32Alphabet
+makeCrockfordAlphabet() noexcept {
+	auto alphabet = makeAlphabet("0123456789ABCDEFGHJKMNPQRSTVWXYZ", false, {});
+	for (auto c : {'O', 'o'}) {
+		alphabet.decoding[static_cast<byte>(c)] = 0;
+	}
+	for (auto c : {'I', 'i', 'L', 'l'}) {
+		alphabet.decoding[static_cast<byte>(c)] = 1;
+	}
+	alphabet.decoding[static_cast<byte>('-')] = kSkip;
+
+	return alphabet;
+}
+
+
+constexpr Base32Alphabet kBase32Alphabet = makeAlphabet("ABCDEFGHIJKLMNOPQRSTUVWXYZ234567", true,
+														{{'A', 'Z', 0}, {'a', 'z', 0}, {'2', '7', 26}});
+constexpr Base32Alphabet kBase32HexAlphabet = makeAlphabet("0123456789ABCDEFGHIJKLMNOPQRSTUV", true,
+														   {{'0', '9', 0}, {'A', 'V', 10}, {'a', 'v', 10}});
+constexpr Base32Alphabet kCrockfordAlphabet = makeCrockfordAlphabet();
+
+
+constexpr bool isSpace(byte c) noexcept {
+	return (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+}
+
+
+/// Number of characters encoding of the given number of bytes takes.
+constexpr size_type encodedLength(size_type len, bool padding) noexcept {
+	return padding
+			? (len + 4) / 5 * 8
+			: (len * 8 + 4) / 5;
+}
+
+
+#if defined(SOLACE_X86_DISPATCH)
+
+/**
+ * Encode 10 bytes into 16 characters per iteration.
+ * Each 5-bit field is loaded into a 16-bit lane together with the byte that follows it,
+ * aligned to the top of the lane with a multiplication and shifted down.
+ * @return Number of bytes encoded, a multiple of 10.
+ */
+SOLACE_TARGET("ssse3")
+size_type encodeBlocksSsse3(byte* dest, byte const* src, size_type len, byte const* alphabet) noexcept {
+	auto const shuffle0 = _mm_setr_epi8(1, 0, 1, 0, 2, 1, 2, 1, 3, 2, 4, 3, 4, 3, 5, 4);
+	auto const shuffle1 = _mm_add_epi8(shuffle0, _mm_set1_epi8(5));
+	auto const multiplier = _mm_setr_epi16(1 << 0, 1 << 5, 1 << 2, 1 << 7, 1 << 4, 1 << 1, 1 << 6, 1 << 3);
+
+	auto const lutLow = _mm_loadu_si128(reinterpret_cast<__m128i const*>(alphabet));
+	auto const lutHigh = _mm_loadu_si128(reinterpret_cast<__m128i const*>(alphabet + 16));
+
+	size_type i = 0;
+	for (; i + 16 <= len; i += 10, dest += 16) {
+		auto const in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+		auto const fields0 = _mm_srli_epi16(_mm_mullo_epi16(_mm_shuffle_epi8(in, shuffle0), multiplier), 11);
+		auto const fields1 = _mm_srli_epi16(_mm_mullo_epi16(_mm_shuffle_epi8(in, shuffle1), multiplier), 11);
+		auto const values = _mm_packus_epi16(fields0, fields1);
+
+		// 32 entry table lookup as two 16 entry lookups
+		auto const isHigh = _mm_cmpgt_epi8(values, _mm_set1_epi8(15));
+		auto const low = _mm_shuffle_epi8(lutLow, values);
+		auto const high = _mm_shuffle_epi8(lutHigh, _mm_sub_epi8(values, _mm_set1_epi8(16)));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+						 _mm_or_si128(_mm_andnot_si128(isHigh, low), _mm_and_si128(isHigh, high)));
+	}
+
+	return i;
+}
+
+
+inline __m128i inRange(__m128i in, byte first, byte last) noexcept {
+	// Signed comparison: characters above 0x7F are never in range.
+	return _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8(static_cast<char>(first - 1))),
+						 _mm_cmplt_epi8(in, _mm_set1_epi8(static_cast<char>(last + 1))));
+}
+
+
+/**
+ * Decode 16 characters into 10 bytes per iteration until a character outside of the alphabet ranges is met.
+ * @return Number of characters decoded, a multiple of 16.
+ */
+SOLACE_TARGET("ssse3")
+size_type decodeBlocksSsse3(byte* dest, byte const* src, size_type len, Base32Alphabet const& alphabet) noexcept {
+	auto const packShuffle = _mm_setr_epi8(4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1);
+	auto const lowHalves = _mm_set_epi32(0, -1, 0, -1);
+
+	size_type i = 0;
+	for (; i + 16 <= len; i += 16, dest += 10) {
+		auto const in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+
+		auto valid = _mm_setzero_si128();
+		auto shift = _mm_setzero_si128();
+		for (uint32 r = 0; r < alphabet.rangesCount; ++r) {
+			auto const& range = alphabet.ranges[r];
+			auto const isIn = inRange(in, range.first, range.last);
+			valid = _mm_or_si128(valid, isIn);
+			shift = _mm_or_si128(shift,
+								 _mm_and_si128(isIn, _mm_set1_epi8(static_cast<char>(range.value - range.first))));
+		}
+
+		if (_mm_movemask_epi8(valid) != 0xFFFF) {
+			break;
+		}
+
+		auto const values = _mm_add_epi8(in, shift);
+		// 5-bit values -> 10-bit pairs -> 20-bit quads -> 40-bit blocks
+		auto const pairs = _mm_maddubs_epi16(values, _mm_set1_epi16(0x0120));
+		auto const quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00010400));
+		auto const blocks = _mm_or_si128(_mm_slli_epi64(_mm_and_si128(quads, lowHalves), 20),
+										 _mm_srli_epi64(quads, 32));
+		auto const out = _mm_shuffle_epi8(blocks, packShuffle);
+
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dest), out);
+		auto const tail = static_cast<uint16>(_mm_extract_epi16(out, 4));
+		memcpy(dest + 8, &tail, sizeof(tail));
+	}
+
+	return i;
+}
+
+#endif  // SOLACE_X86_DISPATCH
+
+
+/// Encode a block of 5 bytes into 8 characters.
+inline void encodeBlock(byte* dest, byte const* src, byte const* alphabet) noexcept {
+	uint64 block = 0;
+	for (size_type k = 0; k < 5; ++k) {
+		block = (block << 8) | src[k];
+	}
+
+	for (size_type k = 0; k < 8; ++k) {
+		dest[k] = alphabet[(block >> (35 - 5 * k)) & 0x1F];
+	}
+}
+
+
+/**
+ * Decode a block of 8 characters into 5 bytes.
+ * @return False if any of the characters is not in the alphabet. Destination is not written in that case.
+ */
+inline bool decodeBlock(byte* dest, byte const* src, byte const* decodingTable) noexcept {
+	uint64 block = 0;
+	byte check = 0;
+	for (size_type k = 0; k < 8; ++k) {
+		auto const value = decodingTable[src[k]];
+		check |= value;
+		block = (block << 5) | value;
+	}
+
+	if (check > 31) {
+		return false;
+	}
+
+	for (size_type k = 0; k < 5; ++k) {
+		dest[k] = static_cast<byte>(block >> (32 - 8 * k));
+	}
+
+	return true;
+}
+
+
+/**
+ * Encode data into destination that is known to have enough space.
+ * The final incomplete group is padded if the alphabet uses padding.
+ */
+void base32encodeUnchecked(byte* dest, byte const* src, size_type len, Base32Alphabet const& alphabet) noexcept {
+	size_type i = 0;
+#if defined(SOLACE_X86_DISPATCH)
+	if (len >= 16 && details::cpuFeatures().ssse3) {
+		i = encodeBlocksSsse3(dest, src, len, alphabet.encoding);
+		dest += i / 5 * 8;
+	}
+#endif
+
+	for (; i + 5 <= len; i += 5, dest += 8) {
+		encodeBlock(dest, src + i, alphabet.encoding);
+	}
+
+	auto const tail = len - i;
+	if (tail == 0) {
+		return;
+	}
+
+	byte block[5] = {0, 0, 0, 0, 0};
+	byte chars[8];
+	memcpy(block, src + i, tail);
+	encodeBlock(chars, block, alphabet.encoding);
+
+	auto const nChars = encodedLength(tail, false);
+	memcpy(dest, chars, nChars);
+	if (alphabet.padding) {
+		memset(dest + nChars, kPad, 8 - nChars);
+	}
+}
+
+
+/**
+ * Decode the longest prefix of the data made of complete groups of alphabet characters.
+ * Destination must have space for len / 8 * 5 bytes.
+ * @return Number of characters decoded, a multiple of 8.
+ */
+size_type base32decodeBlocks(byte* dest, byte const* src, size_type len, Base32Alphabet const& alphabet) noexcept {
+	size_type i = 0;
+#if defined(SOLACE_X86_DISPATCH)
+	if (alphabet.rangesCount != 0 && len >= 16 && details::cpuFeatures().ssse3) {
+		i = decodeBlocksSsse3(dest, src, len, alphabet);
+		dest += i / 8 * 5;
+	}
+#endif
+
+	for (; i + 8 <= len && decodeBlock(dest, src + i, alphabet.decoding); i += 8, dest += 5) {
+	}
+
+	return i;
+}
+
+
+/// Write bytes decoded from carried over characters of a group.
+Result<void, Error>
+flushCarry(ByteWriter& dest, byte const* carry, size_type carryCount) {
+	// Only these numbers of characters encode a whole number of bytes
+	if (carryCount != 2 && carryCount != 4 && carryCount != 5 && carryCount != 7 && carryCount != 8) {
+		return makeError(GenericError::DOM, "base32decode: Incomplete group");
+	}
+
+	uint64 block = 0;
+	for (size_type k = 0; k < 8; ++k) {
+		block = (block << 5) | ((k < carryCount) ? carry[k] : 0);
+	}
+
+	byte const decoded[] = {
+		static_cast<byte>(block >> 32),
+		static_cast<byte>(block >> 24),
+		static_cast<byte>(block >> 16),
+		static_cast<byte>(block >> 8),
+		static_cast<byte>(block)
+	};
+
+	return dest.write(wrapMemory(decoded, carryCount * 5 / 8));
+}
+
+
+/**
+ * Decode data carrying over characters of an incomplete group.
+ * @param skipSpace If true, white space characters are ignored.
+ */
+Result<void, Error>
+base32decode(ByteWriter& dest, MemoryView src, Base32Alphabet const& alphabet,
+			 byte* carry, size_type& carryCount, bool& padded, bool skipSpace) {
+	auto const in = src.begin();
+	auto const len = src.size();
+
+	size_type i = 0;
+	while (i < len) {
+		auto const c = in[i];
+		auto const value = alphabet.decoding[c];
+
+		if (value <= 31 && !padded) {
+			if (carryCount == 0) {  // Decode a run of complete groups in bulk
+				auto const maxLen = std::min(len - i, dest.remaining() / 5 * 8);
+				auto const bulkLen = base32decodeBlocks(dest.viewRemaining().begin(), in + i, maxLen, alphabet);
+				if (bulkLen > 0) {
+					auto res = dest.advance(bulkLen / 8 * 5);
+					if (!res) {
+						return res;
+					}
+
+					i += bulkLen;
+					continue;
+				}
+			}
+
+			carry[carryCount++] = value;
+			if (carryCount == 8) {
+				auto res = flushCarry(dest, carry, carryCount);
+				if (!res) {
+					--carryCount;  // This character is to be fed again
+					return res;
+				}
+
+				carryCount = 0;
+			}
+		} else if (c == kPad && alphabet.padding) {
+			if (!padded) {
+				// Carry is only dropped once written, so that nothing is lost if the destination is full
+				auto res = flushCarry(dest, carry, carryCount);
+				if (!res) {
+					return res;
+				}
+
+				carryCount = 0;
+				padded = true;
+			}
+		} else if (value != kSkip && !(skipSpace && isSpace(c))) {
+			return makeError(SystemErrors::ILSEQ, "base32decode");
+		}
+
+		++i;
+	}
+
+	return Ok();
+}
+
+}  // namespace
+
+
+Base32Encoder::size_type
+Base32Encoder::encodedSize(size_type len) {
+	return encodedLength(len, true);
+}
+
+
+Base32Encoder::Base32Encoder(ByteWriter& dest)
+	: Base32Encoder(dest, kBase32Alphabet)
+{}
+
+
+Base32Encoder::size_type
+Base32Encoder::encodedSize(MemoryView data) const {
+	return encodedLength(data.size(), _alphabet->padding);
+}
+
+
+Result<void, Error>
+Base32Encoder::encode(MemoryView src) {
+	auto& dest = *getDestBuffer();
+	auto const encodedLen = encodedSize(src);
+	if (dest.remaining() < encodedLen) {
+		return makeError(SystemErrors::Overflow, "Base32Encoder::encode");
+	}
+
+	if (encodedLen != 0) {
+		base32encodeUnchecked(dest.viewRemaining().begin(), src.begin(), src.size(), *_alphabet);
+	}
+
+	return dest.advance(encodedLen);
+}
+
+
+Base32Decoder::Base32Decoder(ByteWriter& dest)
+	: Base32Decoder(dest, kBase32Alphabet)
+{}
+
+
+Base32Decoder::size_type
+Base32Decoder::encodedSize(MemoryView data) const {
+	return data.size() * 5 / 8;
+}
+
+
+Result<void, Error>
+Base32Decoder::encode(MemoryView src) {
+	auto& dest = *getDestBuffer();
+	byte carry[8];
+	size_type carryCount = 0;
+	bool padded = false;
+
+	auto res = base32decode(dest, src, *_alphabet, carry, carryCount, padded, false);
+	if (!res) {
+		return res;
+	}
+
+	return (carryCount == 0)
+			? Ok()
+			: flushCarry(dest, carry, carryCount);
+}
+
+
+Base32HexEncoder::Base32HexEncoder(ByteWriter& dest)
+	: Base32Encoder(dest, kBase32HexAlphabet)
+{}
+
+
+Base32HexDecoder::Base32HexDecoder(ByteWriter& dest)
+	: Base32Decoder(dest, kBase32HexAlphabet)
+{}
+
+
+CrockfordBase32Encoder::CrockfordBase32Encoder(ByteWriter& dest)
+	: Base32Encoder(dest, kCrockfordAlphabet)
+{}
+
+
+CrockfordBase32Decoder::CrockfordBase32Decoder(ByteWriter& dest)
+	: Base32Decoder(dest, kCrockfordAlphabet)
+{}
+
+
+Base32StreamEncoder::Base32StreamEncoder(ByteWriter& dest)
+	: Base32StreamEncoder(dest, kBase32Alphabet)
+{}
+
+
+Base32StreamEncoder::size_type
+Base32StreamEncoder::encodedSize(MemoryView data) const {
+	return (_carryCount + data.size()) / 5 * 8;
+}
+
+
+Result<void, Error>
+Base32StreamEncoder::encode(MemoryView src) {
+	auto& dest = *getDestBuffer();
+	auto const outputLen = encodedSize(src);
+	if (dest.remaining() < outputLen) {
+		return makeError(SystemErrors::Overflow, "Base32StreamEncoder::encode");
+	}
+
+	auto out = dest.viewRemaining().begin();
+	auto in = src.begin();
+	auto len = src.size();
+
+	if (_carryCount > 0) {  // Complete the group carried over from the previous call
+		while (_carryCount < 5 && len > 0) {
+			_carry[_carryCount++] = *in++;
+			--len;
+		}
+
+		if (_carryCount < 5) {
+			return Ok();
+		}
+
+		base32encodeUnchecked(out, _carry, 5, *_alphabet);
+		out += 8;
+		_carryCount = 0;
+	}
+
+	auto const bulkLen = len / 5 * 5;
+	base32encodeUnchecked(out, in, bulkLen, *_alphabet);
+
+	for (auto i = bulkLen; i < len; ++i) {
+		_carry[_carryCount++] = in[i];
+	}
+
+	return dest.advance(outputLen);
+}
+
+
+Result<void, Error>
+Base32StreamEncoder::finish() {
+	auto& dest = *getDestBuffer();
+	auto const outputLen = encodedLength(_carryCount, _alphabet->padding);
+	if (dest.remaining() < outputLen) {
+		return makeError(SystemErrors::Overflow, "Base32StreamEncoder::finish");
+	}
+
+	base32encodeUnchecked(dest.viewRemaining().begin(), _carry, _carryCount, *_alphabet);
+	reset();
+
+	return dest.advance(outputLen);
+}
+
+
+void
+Base32StreamEncoder::reset() noexcept {
+	_carryCount = 0;
+}
+
+
+Base32StreamDecoder::Base32StreamDecoder(ByteWriter& dest)
+	: Base32StreamDecoder(dest, kBase32Alphabet)
+{}
+
+
+Base32StreamDecoder::size_type
+Base32StreamDecoder::encodedSize(MemoryView data) const {
+	return (_carryCount + data.size()) * 5 / 8;
+}
+
+
+Result<void, Error>
+Base32StreamDecoder::encode(MemoryView src) {
+	return base32decode(*getDestBuffer(), src, *_alphabet, _carry, _carryCount, _padded, true);
+}
+
+
+Result<void, Error>
+Base32StreamDecoder::finish() {
+	if (_carryCount == 0) {
+		reset();
+		return Ok();
+	}
+
+	auto res = flushCarry(*getDestBuffer(), _carry, _carryCount);
+	reset();
+
+	return res;
+}
+
+
+void
+Base32StreamDecoder::reset() noexcept {
+	_carryCount = 0;
+	_padded = false;
+}
+
+
+Base32HexStreamEncoder::Base32HexStreamEncoder(ByteWriter& dest)
+	: Base32StreamEncoder(dest, kBase32HexAlphabet)
+{}
+
+
+Base32HexStreamDecoder::Base32HexStreamDecoder(ByteWriter& dest)
+	: Base32StreamDecoder(dest, kBase32HexAlphabet)
+{}
+
+
+CrockfordBase32StreamEncoder::CrockfordBase32StreamEncoder(ByteWriter& dest)
+	: Base32StreamEncoder(dest, kCrockfordAlphabet)
+{}
+
+
+CrockfordBase32StreamDecoder::CrockfordBase32StreamDecoder(ByteWriter& dest)
+	: Base32StreamDecoder(dest, kCrockfordAlphabet)
+{}
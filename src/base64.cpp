@@ -21,7 +21,17 @@
 #include "solace/base64.hpp"
 #include "solace/posixErrorDomain.hpp"
 
+#include "solace/details/cpu_features.hpp"
+
 #include <climits>
+#include <algorithm>  // std::min
+#include <cstring>  // memcpy
+
+#if defined(SOLACE_X86_DISPATCH)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 
 using namespace Solace;
@@ -31,42 +41,161 @@ static constexpr byte kBase64Alphabet[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghi
 static constexpr byte kBase64UrlAlphabet[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
 
 
+namespace /* anonymous */ {
+
+constexpr byte kPad = '=';
+
+
+#if defined(SOLACE_X86_DISPATCH)
+
+/**
+ * Expand 12 bytes in the low 12 bytes of the input into 16 sextets, one per byte.
+ * See W. Mula, D. Lemire "Faster Base64 Encoding and Decoding using AVX2 Instructions".
+ */
+SOLACE_TARGET("ssse3")
+inline __m128i unpackSextets(__m128i in) noexcept {
+	in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+	auto const t0 = _mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00));
+	auto const t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+	auto const t2 = _mm_and_si128(in, _mm_set1_epi32(0x003F03F0));
+	auto const t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+
+	return _mm_or_si128(t1, t3);
+}
+
+
+/// Map sextets to alphabet characters by adding a per-range offset looked up with PSHUFB.
+SOLACE_TARGET("ssse3")
+inline __m128i sextetsToAscii(__m128i sextets, byte c62, byte c63) noexcept {
+	// 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+	auto reduced = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+	auto const less = _mm_cmpgt_epi8(_mm_set1_epi8(26), sextets);
+	reduced = _mm_or_si128(reduced, _mm_and_si128(less, _mm_set1_epi8(13)));
+
+	auto const shiftLut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+										'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+										static_cast<char>(c62 - 62), static_cast<char>(c63 - 63), 'A', 0, 0);
+
+	return _mm_add_epi8(sextets, _mm_shuffle_epi8(shiftLut, reduced));
+}
+
+
+/** Encode as many whole 12 byte blocks as can be loaded 16 bytes at a time.
+ * @return Number of input bytes consumed.
+ */
+SOLACE_TARGET("ssse3")
+size_t encodeBlocksSsse3(byte const* src, size_t len, byte* dest, byte c62, byte c63) noexcept {
+	size_t i = 0;
+	for (; i + 16 <= len; i += 12, dest += 16) {
+		auto const in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), sextetsToAscii(unpackSextets(in), c62, c63));
+	}
+
+	return i;
+}
+
+
+SOLACE_TARGET("avx2")
+size_t encodeBlocksAvx2(byte const* src, size_t len, byte* dest, byte c62, byte c63) noexcept {
+	auto const shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+										 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	auto const shiftLut = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+										   '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+										   static_cast<char>(c62 - 62), static_cast<char>(c63 - 63), 'A', 0, 0,
+										   'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+										   '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+										   static_cast<char>(c62 - 62), static_cast<char>(c63 - 63), 'A', 0, 0);
+
+	size_t i = 0;
+	for (; i + 28 <= len; i += 24, dest += 32) {
+		auto in = _mm256_inserti128_si256(
+					_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i))),
+					_mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i + 12)), 1);
+		in = _mm256_shuffle_epi8(in, shuffle);
+
+		auto const t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00));
+		auto const t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+		auto const t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0));
+		auto const t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+		auto const sextets = _mm256_or_si256(t1, t3);
+
+		auto reduced = _mm256_subs_epu8(sextets, _mm256_set1_epi8(51));
+		auto const less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), sextets);
+		reduced = _mm256_or_si256(reduced, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest),
+							_mm256_add_epi8(sextets, _mm256_shuffle_epi8(shiftLut, reduced)));
+	}
+
+	return i;
+}
+
+#endif  // SOLACE_X86_DISPATCH
+
+
+/**
+ * Encode src into dest that has been checked to have enough space for the result.
+ * Bulk of the input is processed by the widest available vector code, then 6 bytes at a time, then padded tail.
+ */
+void base64encodeUnchecked(byte* dest, byte const* src, size_t len, byte const alphabet[65]) noexcept {
+	size_t i = 0;
+
+#if defined(SOLACE_X86_DISPATCH)
+	auto const& cpu = details::cpuFeatures();
+	if (cpu.avx2) {
+		i = encodeBlocksAvx2(src, len, dest, alphabet[62], alphabet[63]);
+	} else if (cpu.ssse3) {
+		i = encodeBlocksSsse3(src, len, dest, alphabet[62], alphabet[63]);
+	}
+	dest += i / 3 * 4;
+#endif
+
+	// Two groups of 3 bytes per iteration
+	for (; i + 6 <= len; i += 6, dest += 8) {
+		uint64 const w = (uint64{src[i]} << 40)     | (uint64{src[i + 1]} << 32) | (uint64{src[i + 2]} << 24) |
+						 (uint64{src[i + 3]} << 16) | (uint64{src[i + 4]} << 8)  |  uint64{src[i + 5]};
+		for (int k = 0; k < 8; ++k) {
+			dest[k] = alphabet[(w >> (42 - 6 * k)) & 0x3F];
+		}
+	}
+
+	for (; i + 3 <= len; i += 3, dest += 4) {
+		uint32 const w = (uint32{src[i]} << 16) | (uint32{src[i + 1]} << 8) | uint32{src[i + 2]};
+		dest[0] = alphabet[(w >> 18) & 0x3F];
+		dest[1] = alphabet[(w >> 12) & 0x3F];
+		dest[2] = alphabet[(w >> 6) & 0x3F];
+		dest[3] = alphabet[w & 0x3F];
+	}
+
+	if (i < len) {
+		dest[0] = alphabet[(src[i] >> 2) & 0x3F];
+		if (i + 1 == len) {
+			dest[1] = alphabet[((src[i] & 0x3) << 4)];
+			dest[2] = kPad;
+		} else {
+			dest[1] = alphabet[((src[i] & 0x3) << 4) | (src[i + 1] >> 4)];
+			dest[2] = alphabet[((src[i + 1] & 0xF) << 2)];
+		}
+
+		dest[3] = kPad;
+	}
+}
+
+}  // namespace
+
+
 Result<void, Error>
 base64encode(ByteWriter& dest, MemoryView const& src, byte const alphabet[65]) {
-    MemoryView::size_type i = 0;
-
-    for (; i + 2 < src.size(); i += 3) {
-        byte const encoded[] = {
-            alphabet[ (src[i] >> 2) & 0x3F],
-            alphabet[((src[i] & 0x3) << 4)     | (static_cast<int>(src[i + 1] & 0xF0) >> 4)],
-            alphabet[((src[i + 1] & 0xF) << 2) | (static_cast<int>(src[i + 2] & 0xC0) >> 6)],
-            alphabet[  src[i + 2] & 0x3F]
-        };
-
-        auto res = dest.write(wrapMemory(encoded));
-        if (!res)
-			return res.moveError();
-    }
+	auto const encodedLen = Base64Encoder::encodedSize(src.size());
+	if (dest.remaining() < encodedLen) {
+		return makeError(SystemErrors::Overflow, "base64encode");
+	}
 
+	if (encodedLen != 0) {
+		base64encodeUnchecked(dest.viewRemaining().begin(), src.begin(), src.size(), alphabet);
+	}
 
-    if (i < src.size()) {
-        byte encoded[4];
-        encoded[0] = alphabet[(src[i] >> 2) & 0x3F];
-        if (i + 1 == src.size()) {
-            encoded[1] = alphabet[((src[i] & 0x3) << 4)];
-            encoded[2] = '=';
-        } else {
-            encoded[1] = alphabet[((src[i] & 0x3) << 4) | (static_cast<int>(src[i + 1] & 0xF0) >> 4)];
-            encoded[2] = alphabet[((src[i + 1] & 0xF) << 2)];
-        }
-
-        encoded[3] = '=';
-        auto res = dest.write(wrapMemory(encoded));
-        if (!res)
-			return res.moveError();
-    }
-
-    return Ok();
+	return dest.advance(encodedLen);
 }
 
 
@@ -117,52 +246,204 @@ static const byte prUrl2six[256] = {
 
 
 
-Result<void, Error>
-base64decode(ByteWriter& dest, MemoryView src, byte const* decodingTable) {
-	if (src.empty()) {
-		return makeError(SystemErrors::NODATA, "base64decode");
-    }
+namespace /* anonymous */ {
 
-	byte const* bufin = src.begin();
-	while (decodingTable[*(bufin++)] <= 63)  // Count decodable bytes
-    {}
+#if defined(__SSE2__)
 
-	auto nprbytes = (bufin - src.begin()) - 1;
-	bufin = src.begin();
+/**
+ * Classify 16 characters against the alphabet: 'A'-'Z', 'a'-'z', '0'-'9', c62 and c63.
+ * @param shift Set to the offsets that turn the characters into their sextet values.
+ * @return Mask of valid alphabet characters.
+ */
+inline __m128i classify(__m128i in, byte c62, byte c63, __m128i& shift) noexcept {
+	auto inRange = [in](char lo, char hi) {
+		return _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8(static_cast<char>(lo - 1))),
+							 _mm_cmplt_epi8(in, _mm_set1_epi8(static_cast<char>(hi + 1))));
+	};
 
-    while (nprbytes > 4) {
-        byte const encoded[] = {
-            static_cast<byte>(decodingTable[bufin[0]] << 2 | decodingTable[bufin[1]] >> 4),
-            static_cast<byte>(decodingTable[bufin[1]] << 4 | decodingTable[bufin[2]] >> 2),
-            static_cast<byte>(decodingTable[bufin[2]] << 6 | decodingTable[bufin[3]])
-        };
+	auto const upper = inRange('A', 'Z');
+	auto const lower = inRange('a', 'z');
+	auto const digit = inRange('0', '9');
+	auto const is62 = _mm_cmpeq_epi8(in, _mm_set1_epi8(static_cast<char>(c62)));
+	auto const is63 = _mm_cmpeq_epi8(in, _mm_set1_epi8(static_cast<char>(c63)));
 
-        auto res = dest.write(wrapMemory(encoded));
-        if (!res)
-			return res.moveError();
+	shift = _mm_or_si128(_mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+									  _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+						 _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+									  _mm_or_si128(_mm_and_si128(is62, _mm_set1_epi8(static_cast<char>(62 - c62))),
+												   _mm_and_si128(is63, _mm_set1_epi8(static_cast<char>(63 - c63))))));
 
-        bufin += 4;
-        nprbytes -= 4;
-    }
+	return _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(is62, is63)));
+}
 
-    /* Note: (nprbytes == 1) would be an error, so just ingore that case */
-    if (nprbytes > 1) {
-        auto res = dest.write(static_cast<byte>(decodingTable[bufin[0]] << 2 | decodingTable[bufin[1]] >> 4));
-        if (!res)
-			return res.moveError();
-    }
-    if (nprbytes > 2) {
-        auto res = dest.write(static_cast<byte>(decodingTable[bufin[1]] << 4 | decodingTable[bufin[2]] >> 2));
-        if (!res)
-			return res.moveError();
-    }
-    if (nprbytes > 3) {
-        auto res = dest.write(static_cast<byte>(decodingTable[bufin[2]] << 6 | decodingTable[bufin[3]]));
-        if (!res)
-			return res.moveError();
-    }
+#endif  // __SSE2__
+
+
+/// Count leading characters of the input that belong to the alphabet.
+size_t countDecodable(byte const* src, size_t len, byte const* decodingTable) noexcept {
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	auto const c62 = static_cast<byte>((decodingTable['+'] == 62) ? '+' : '-');
+	auto const c63 = static_cast<byte>((decodingTable['/'] == 63) ? '/' : '_');
+	for (; i + 16 <= len; i += 16) {
+		__m128i shift;
+		auto const valid = classify(_mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i)), c62, c63, shift);
+		auto const invalidMask = static_cast<uint32>(_mm_movemask_epi8(valid)) ^ 0xFFFF;
+		if (invalidMask) {
+			return i + static_cast<size_t>(__builtin_ctz(invalidMask));
+		}
+	}
+#endif
+
+	while (i < len && decodingTable[src[i]] <= 63) {
+		++i;
+	}
+
+	return i;
+}
+
+
+/// Number of bytes produced by decoding given number of alphabet characters.
+constexpr size_t decodedLength(size_t nChars) noexcept {
+	return (nChars / 4) * 3 + ((nChars % 4 > 1) ? (nChars % 4 - 1) : 0);
+}
+
+
+#if defined(SOLACE_X86_DISPATCH)
+
+/// Pack 16 sextets into 12 bytes in the low part of the register.
+SOLACE_TARGET("ssse3")
+inline __m128i packSextets(__m128i values) noexcept {
+	auto const mergedPairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+	auto const merged = _mm_madd_epi16(mergedPairs, _mm_set1_epi32(0x00011000));
+
+	return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+
+SOLACE_TARGET("ssse3")
+inline void store12(byte* dest, __m128i packed) noexcept {
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(dest), packed);
+	auto const high = static_cast<uint32>(_mm_cvtsi128_si32(_mm_srli_si128(packed, 8)));
+	memcpy(dest + 8, &high, sizeof(high));
+}
+
+
+/** Decode whole blocks of 16 characters, all of which are known to belong to the alphabet.
+ * @return Number of input characters consumed.
+ */
+SOLACE_TARGET("ssse3")
+size_t decodeBlocksSsse3(byte const* src, size_t len, byte* dest, byte c62, byte c63) noexcept {
+	size_t i = 0;
+	for (; i + 16 <= len; i += 16, dest += 12) {
+		__m128i shift;
+		auto const in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+		classify(in, c62, c63, shift);
+		store12(dest, packSextets(_mm_add_epi8(in, shift)));
+	}
+
+	return i;
+}
+
+
+SOLACE_TARGET("avx2")
+inline __m256i inRange(__m256i in, char lo, char hi) noexcept {
+	return _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+							_mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), in));
+}
+
+
+SOLACE_TARGET("avx2")
+size_t decodeBlocksAvx2(byte const* src, size_t len, byte* dest, byte c62, byte c63) noexcept {
+	auto const pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+									   2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+	size_t i = 0;
+	for (; i + 32 <= len; i += 32, dest += 24) {
+		auto const in = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i));
+		auto const shift =
+			_mm256_or_si256(
+				_mm256_or_si256(_mm256_and_si256(inRange(in, 'A', 'Z'), _mm256_set1_epi8(-'A')),
+								_mm256_and_si256(inRange(in, 'a', 'z'), _mm256_set1_epi8(26 - 'a'))),
+				_mm256_or_si256(_mm256_and_si256(inRange(in, '0', '9'), _mm256_set1_epi8(52 - '0')),
+					_mm256_or_si256(
+						_mm256_and_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8(static_cast<char>(c62))),
+										 _mm256_set1_epi8(static_cast<char>(62 - c62))),
+						_mm256_and_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8(static_cast<char>(c63))),
+										 _mm256_set1_epi8(static_cast<char>(63 - c63))))));
+
+		auto const values = _mm256_add_epi8(in, shift);
+		auto const mergedPairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+		auto const merged = _mm256_madd_epi16(mergedPairs, _mm256_set1_epi32(0x00011000));
+		auto const packed = _mm256_shuffle_epi8(merged, pack);
+
+		store12(dest, _mm256_castsi256_si128(packed));
+		store12(dest + 12, _mm256_extracti128_si256(packed, 1));
+	}
+
+	return i;
+}
+
+#endif  // SOLACE_X86_DISPATCH
+
+
+/**
+ * Decode nChars of alphabet characters into dest that has been checked to have enough space for the result.
+ */
+void base64decodeUnchecked(byte* dest, byte const* src, size_t nChars, byte const* decodingTable) noexcept {
+	size_t i = 0;
+
+#if defined(SOLACE_X86_DISPATCH)
+	auto const c62 = static_cast<byte>((decodingTable['+'] == 62) ? '+' : '-');
+	auto const c63 = static_cast<byte>((decodingTable['/'] == 63) ? '/' : '_');
+	auto const& cpu = details::cpuFeatures();
+	if (cpu.avx2) {
+		i = decodeBlocksAvx2(src, nChars, dest, c62, c63);
+	} else if (cpu.ssse3) {
+		i = decodeBlocksSsse3(src, nChars, dest, c62, c63);
+	}
+	dest += i / 4 * 3;
+#endif
+
+	for (; i + 4 <= nChars; i += 4, dest += 3) {
+		uint32 const w = (uint32{decodingTable[src[i]]} << 18)     | (uint32{decodingTable[src[i + 1]]} << 12) |
+						 (uint32{decodingTable[src[i + 2]]} << 6)  |  uint32{decodingTable[src[i + 3]]};
+		dest[0] = static_cast<byte>(w >> 16);
+		dest[1] = static_cast<byte>(w >> 8);
+		dest[2] = static_cast<byte>(w);
+	}
+
+	/* Note: a single trailing character would be an error, so just ingore that case */
+	auto const tail = nChars - i;
+	if (tail > 1) {
+		dest[0] = static_cast<byte>(decodingTable[src[i]] << 2 | decodingTable[src[i + 1]] >> 4);
+	}
+	if (tail > 2) {
+		dest[1] = static_cast<byte>(decodingTable[src[i + 1]] << 4 | decodingTable[src[i + 2]] >> 2);
+	}
+}
+
+}  // namespace
 
-    return Ok();
+
+Result<void, Error>
+base64decode(ByteWriter& dest, MemoryView src, byte const* decodingTable) {
+	if (src.empty()) {
+		return makeError(SystemErrors::NODATA, "base64decode");
+	}
+
+	auto const nChars = countDecodable(src.begin(), src.size(), decodingTable);
+	auto const decodedLen = decodedLength(nChars);
+	if (dest.remaining() < decodedLen) {
+		return makeError(SystemErrors::Overflow, "base64decode");
+	}
+
+	if (decodedLen != 0) {
+		base64decodeUnchecked(dest.viewRemaining().begin(), src.begin(), nChars, decodingTable);
+	}
+
+	return dest.advance(decodedLen);
 }
 
 
@@ -182,16 +463,7 @@ Base64Decoder::decodedSize(MemoryView data) {
         return 0;  // FIXME: Probably throw!
     }
 
-    size_type nprbytes = 0;
-    for (const auto& b : data) {
-        if (pr2six[b] <= 63) {
-            ++nprbytes;
-        } else {
-            break;
-        }
-    }
-
-    return (nprbytes * 3 / 4);
+    return countDecodable(data.begin(), data.size(), pr2six) * 3 / 4;
 }
 
 
@@ -220,3 +492,291 @@ Result<void, Error>
 Base64UrlDecoder::encode(MemoryView src) {
     return base64decode(*getDestBuffer(), src, prUrl2six);
 }
+
+
+namespace /* anonymous */ {
+
+constexpr bool isSpace(byte c) noexcept {
+	return (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+}
+
+}  // namespace
+
+
+Base64StreamEncoder::Base64StreamEncoder(ByteWriter& dest, size_type lineLength, StringLiteral lineBreak)
+	: Base64StreamEncoder(dest, kBase64Alphabet, lineLength, lineBreak)
+{}
+
+
+Base64StreamEncoder::Base64StreamEncoder(ByteWriter& dest, byte const* alphabet,
+										 size_type lineLength, StringLiteral lineBreak)
+	: StreamEncoder(dest)
+	, _alphabet{alphabet}
+	, _lineLength{lineLength & ~size_type{3}}
+	, _lineBreak{lineBreak}
+{}
+
+
+Base64StreamEncoder::size_type
+Base64StreamEncoder::wrappedSize(size_type groupsCount) const noexcept {
+	if (groupsCount == 0) {
+		return 0;
+	}
+
+	// A line break goes before every group that would start at a positive multiple of the line length.
+	auto const lineBreaks = (_lineLength == 0)
+			? 0
+			: (_column + 4 * (groupsCount - 1)) / _lineLength;
+
+	return 4 * groupsCount + lineBreaks * _lineBreak.size();
+}
+
+
+Base64StreamEncoder::size_type
+Base64StreamEncoder::encodedSize(MemoryView data) const {
+	return wrappedSize((_carryCount + data.size()) / 3);
+}
+
+
+byte*
+Base64StreamEncoder::writeGroups(byte* dest, byte const* src, size_type len) noexcept {
+	if (_lineLength == 0) {
+		base64encodeUnchecked(dest, src, len, _alphabet);
+		return dest + len / 3 * 4;
+	}
+
+	while (len > 0) {
+		if (_column == _lineLength) {
+			memcpy(dest, _lineBreak.data(), _lineBreak.size());
+			dest += _lineBreak.size();
+			_column = 0;
+		}
+
+		auto const groupsCount = std::min(len / 3, (_lineLength - _column) / 4);
+		base64encodeUnchecked(dest, src, groupsCount * 3, _alphabet);
+		dest += groupsCount * 4;
+		src += groupsCount * 3;
+		len -= groupsCount * 3;
+		_column += groupsCount * 4;
+	}
+
+	return dest;
+}
+
+
+Result<void, Error>
+Base64StreamEncoder::encode(MemoryView src) {
+	auto& dest = *getDestBuffer();
+	auto const outputLen = encodedSize(src);
+	if (dest.remaining() < outputLen) {
+		return makeError(SystemErrors::Overflow, "Base64StreamEncoder::encode");
+	}
+
+	auto out = dest.viewRemaining().begin();
+	auto in = src.begin();
+	auto len = src.size();
+
+	if (_carryCount > 0) {  // Complete the group carried over from the previous call
+		while (_carryCount < 3 && len > 0) {
+			_carry[_carryCount++] = *in++;
+			--len;
+		}
+
+		if (_carryCount < 3) {
+			return Ok();
+		}
+
+		out = writeGroups(out, _carry, 3);
+		_carryCount = 0;
+	}
+
+	auto const bulkLen = len / 3 * 3;
+	writeGroups(out, in, bulkLen);
+
+	for (auto i = bulkLen; i < len; ++i) {
+		_carry[_carryCount++] = in[i];
+	}
+
+	return dest.advance(outputLen);
+}
+
+
+Result<void, Error>
+Base64StreamEncoder::finish() {
+	if (_carryCount == 0) {
+		reset();
+		return Ok();
+	}
+
+	auto& dest = *getDestBuffer();
+	auto const outputLen = wrappedSize(1);
+	if (dest.remaining() < outputLen) {
+		return makeError(SystemErrors::Overflow, "Base64StreamEncoder::finish");
+	}
+
+	auto out = dest.viewRemaining().begin();
+	if (outputLen > 4) {
+		memcpy(out, _lineBreak.data(), _lineBreak.size());
+		out += _lineBreak.size();
+	}
+
+	base64encodeUnchecked(out, _carry, _carryCount, _alphabet);
+	reset();
+
+	return dest.advance(outputLen);
+}
+
+
+void
+Base64StreamEncoder::reset() noexcept {
+	_column = 0;
+	_carryCount = 0;
+}
+
+
+Base64UrlStreamEncoder::Base64UrlStreamEncoder(ByteWriter& dest, size_type lineLength, StringLiteral lineBreak)
+	: Base64StreamEncoder(dest, kBase64UrlAlphabet, lineLength, lineBreak)
+{}
+
+
+Base64StreamDecoder::Base64StreamDecoder(ByteWriter& dest)
+	: Base64StreamDecoder(dest, pr2six)
+{}
+
+
+Base64StreamDecoder::Base64StreamDecoder(ByteWriter& dest, byte const* decodingTable)
+	: StreamEncoder(dest)
+	, _decodingTable{decodingTable}
+{}
+
+
+Base64StreamDecoder::size_type
+Base64StreamDecoder::encodedSize(MemoryView data) const {
+	return (_carryCount + data.size() + 3) / 4 * 3;
+}
+
+
+Result<void, Error>
+Base64StreamDecoder::flushCarry() {
+	uint32 group = 0;
+	for (size_type i = 0; i < 4; ++i) {
+		group = (group << 6) | ((i < _carryCount) ? _carry[i] : 0);
+	}
+
+	byte const decoded[] = {
+		static_cast<byte>(group >> 16),
+		static_cast<byte>(group >> 8),
+		static_cast<byte>(group)
+	};
+
+	// Carry is only dropped once written, so that nothing is lost if the destination is full
+	auto res = getDestBuffer()->write(wrapMemory(decoded, _carryCount - 1));
+	if (res) {
+		_carryCount = 0;
+	}
+
+	return res;
+}
+
+
+Result<void, Error>
+Base64StreamDecoder::encode(MemoryView src) {
+	auto& dest = *getDestBuffer();
+	auto const in = src.begin();
+	auto const len = src.size();
+
+	size_type i = 0;
+	while (i < len) {
+		auto const c = in[i];
+		auto const value = _decodingTable[c];
+
+		if (value <= 63 && !_padded) {
+			if (_carryCount == 0) {  // Decode a run of alphabet characters in bulk
+				auto const bulkLen = countDecodable(in + i, len - i, _decodingTable) / 4 * 4;
+				if (bulkLen > 0) {
+					auto const decodedLen = bulkLen / 4 * 3;
+					if (dest.remaining() < decodedLen) {
+						return makeError(SystemErrors::Overflow, "Base64StreamDecoder::encode");
+					}
+
+					base64decodeUnchecked(dest.viewRemaining().begin(), in + i, bulkLen, _decodingTable);
+					auto res = dest.advance(decodedLen);
+					if (!res) {
+						return res;
+					}
+
+					i += bulkLen;
+					continue;
+				}
+			}
+
+			_carry[_carryCount++] = value;
+			if (_carryCount == 4) {
+				auto res = flushCarry();
+				if (!res) {
+					--_carryCount;  // This character is to be fed again
+					return res;
+				}
+			}
+		} else if (c == '=') {
+			if (!_padded) {
+				if (_carryCount < 2) {
+					return makeError(SystemErrors::ILSEQ, "Base64StreamDecoder::encode");
+				}
+
+				auto const paddingLeft = 3 - _carryCount;
+				auto res = flushCarry();
+				if (!res) {
+					return res;
+				}
+
+				_padded = true;
+				_paddingLeft = paddingLeft;
+			} else if (_paddingLeft == 0) {
+				return makeError(SystemErrors::ILSEQ, "Base64StreamDecoder::encode");
+			} else {
+				--_paddingLeft;
+			}
+		} else if (!isSpace(c)) {
+			return makeError(SystemErrors::ILSEQ, "Base64StreamDecoder::encode");
+		}
+
+		++i;
+	}
+
+	return Ok();
+}
+
+
+Result<void, Error>
+Base64StreamDecoder::finish() {
+	if (_carryCount == 0) {
+		reset();
+		return Ok();
+	}
+
+	if (_carryCount == 1) {
+		reset();
+		return makeError(GenericError::DOM, "Base64StreamDecoder::finish(): Incomplete group");
+	}
+
+	auto res = flushCarry();
+	if (res) {
+		reset();
+	}
+
+	return res;
+}
+
+
+void
+Base64StreamDecoder::reset() noexcept {
+	_carryCount = 0;
+	_padded = false;
+	_paddingLeft = 0;
+}
+
+
+Base64UrlStreamDecoder::Base64UrlStreamDecoder(ByteWriter& dest)
+	: Base64StreamDecoder(dest, prUrl2six)
+{}
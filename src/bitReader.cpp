@@ -0,0 +1,211 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		bitReader.cpp
+ *	@brief		Implementation of BitReader
+ ******************************************************************************/
+#include "solace/bitReader.hpp"
+
+#include "solace/details/cpu_features.hpp"
+
+#if defined(SOLACE_X86_DISPATCH)
+#include <immintrin.h>
+#endif
+
+using namespace Solace;
+
+
+namespace /* anonymous */ {
+
+#if defined(SOLACE_X86_DISPATCH)
+
+/**
+ * Unpack 4 values of width [26, 32] bits: a value with its bit offset within a byte takes up to 39 bits,
+ * so each one is gathered as a 64 bit word.
+ */
+SOLACE_TARGET("avx2")
+__m128i unpack4x64(byte const* base, __m128i byteIndex, __m128i bitShift, uint32 width, bool msbFirst) {
+	auto const shift = _mm256_cvtepu32_epi64(bitShift);
+	auto words = _mm256_i32gather_epi64(reinterpret_cast<long long const*>(base), byteIndex, 1);
+	if (msbFirst) {
+		auto const bswap64 = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+											  7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+		words = _mm256_shuffle_epi8(words, bswap64);
+		words = _mm256_srlv_epi64(words, _mm256_sub_epi64(_mm256_set1_epi64x(64 - width), shift));
+	} else {
+		words = _mm256_srlv_epi64(words, shift);
+	}
+
+	// Values fit into low 32 bits of each word: only the mask and the pack are left.
+	words = _mm256_and_si256(words, _mm256_set1_epi64x(static_cast<long long>((uint64{1} << width) - 1)));
+	auto const packed = _mm256_permutevar8x32_epi32(words, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+
+	return _mm256_castsi256_si128(packed);
+}
+
+
+/**
+ * Unpack values of the given width 8 at a time: each lane gathers the word that contains its value
+ * and shifts the value down. Stops early rather than read past the end of data.
+ * @return Number of values unpacked.
+ */
+SOLACE_TARGET("avx2")
+uint64 unpackAvx2(uint32* dest, uint64 count, byte const* data, uint64 dataSize, uint64 bitOffset,
+				  uint32 width, bool msbFirst) {
+	auto const laneOffsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+												_mm256_set1_epi32(static_cast<int>(width)));
+	auto const seven = _mm256_set1_epi32(7);
+	// Narrow values with their bit offsets fit into 32 bit words.
+	auto const wordSize = (width <= 25) ? 4 : 8;
+
+	uint64 i = 0;
+	for (; i + 8 <= count; i += 8) {
+		auto const bit = bitOffset + i * width;
+		if ((bit + 7 * width) / 8 + wordSize > dataSize) {
+			break;
+		}
+
+		auto const base = data + bit / 8;
+		auto const rel = _mm256_add_epi32(laneOffsets, _mm256_set1_epi32(static_cast<int>(bit & 7)));
+		auto const byteIndex = _mm256_srli_epi32(rel, 3);
+		auto const bitShift = _mm256_and_si256(rel, seven);
+
+		if (wordSize == 4) {
+			auto words = _mm256_i32gather_epi32(reinterpret_cast<int const*>(base), byteIndex, 1);
+			if (msbFirst) {
+				auto const bswap32 = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+													  3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+				words = _mm256_shuffle_epi8(words, bswap32);
+				words = _mm256_srlv_epi32(words,
+										  _mm256_sub_epi32(_mm256_set1_epi32(static_cast<int>(32 - width)), bitShift));
+			} else {
+				words = _mm256_srlv_epi32(words, bitShift);
+			}
+
+			words = _mm256_and_si256(words, _mm256_set1_epi32(static_cast<int>((uint32{1} << width) - 1)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), words);
+		} else {
+			auto const lo = unpack4x64(base, _mm256_castsi256_si128(byteIndex), _mm256_castsi256_si128(bitShift),
+									   width, msbFirst);
+			auto const hi = unpack4x64(base, _mm256_extracti128_si256(byteIndex, 1),
+									   _mm256_extracti128_si256(bitShift, 1), width, msbFirst);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), lo);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i + 4), hi);
+		}
+	}
+
+	return i;
+}
+
+#endif  // SOLACE_X86_DISPATCH
+
+}  // anonymous namespace
+
+
+void
+BitReader::refillTail() noexcept {
+	while (_bitsAvailable <= 56 && _next != _end) {
+		auto const value = static_cast<uint64>(*_next++);
+		_buffer |= (_order == BitOrder::MsbFirst)
+				? value << (56 - _bitsAvailable)
+				: value << _bitsAvailable;
+		_bitsAvailable += 8;
+	}
+}
+
+
+Result<void, Error>
+BitReader::bitPosition(size_type newPosition) noexcept {
+	if (limit() < newPosition) {
+		return makeError(SystemErrors::Overflow, "BitReader::bitPosition()");
+	}
+
+	_next = _begin + newPosition / 8;
+	_buffer = 0;
+	_bitsAvailable = 0;
+	refill();
+	consumeUnchecked(newPosition % 8);
+
+	return Ok();
+}
+
+
+Result<uint64, Error>
+BitReader::readWide(uint32 count) noexcept {
+	if (count > 64) {
+		return makeError(GenericError::RANGE, "BitReader::readBits()");
+	}
+	if (remainingBits() < count) {
+		return makeError(SystemErrors::Overflow, "BitReader::readBits()");
+	}
+
+	// Value is read in two parts: first one is the high part in MSB mode, and the low part in LSB mode.
+	auto const firstCount = (_order == BitOrder::MsbFirst) ? count - 32 : 32;
+	refill();
+	auto const first = peekUnchecked(firstCount);
+	consumeUnchecked(firstCount);
+
+	auto const secondCount = count - firstCount;
+	refill();
+	auto const second = peekUnchecked(secondCount);
+	consumeUnchecked(secondCount);
+
+	return Ok((_order == BitOrder::MsbFirst)
+			  ? (first << 32) | second
+			  : first | (second << 32));
+}
+
+
+Result<void, Error>
+BitReader::readPacked(ArrayView<uint32> values, uint32 bitWidth) noexcept {
+	if (bitWidth > 32) {
+		return makeError(GenericError::RANGE, "BitReader::readPacked()");
+	}
+
+	auto const count = values.size();
+	if (bitWidth == 0) {
+		for (auto& value : values) {
+			value = 0;
+		}
+
+		return Ok();
+	}
+
+	if (remainingBits() / bitWidth < count) {
+		return makeError(SystemErrors::Overflow, "BitReader::readPacked()");
+	}
+
+	size_type i = 0;
+#if defined(SOLACE_X86_DISPATCH)
+	if (details::cpuFeatures().avx2 && count >= 8) {
+		auto const startPosition = bitPosition();
+		i = unpackAvx2(values.begin(), count, _begin, limit() / 8, startPosition, bitWidth,
+					   _order == BitOrder::MsbFirst);
+		if (i > 0) {
+			bitPosition(startPosition + i * bitWidth);
+		}
+	}
+#endif
+
+	for (; i < count; ++i) {
+		refill();
+		values[i] = static_cast<uint32>(peekUnchecked(bitWidth));
+		consumeUnchecked(bitWidth);
+	}
+
+	return Ok();
+}
@@ -0,0 +1,82 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		bitWriter.cpp
+ *	@brief		Implementation of BitWriter
+ ******************************************************************************/
+#include "solace/bitWriter.hpp"
+
+using namespace Solace;
+
+
+void
+BitWriter::storeTail() noexcept {
+	while (_bitsUsed >= 8) {
+		if (_order == BitOrder::MsbFirst) {
+			*_next++ = static_cast<byte>(_buffer >> 56);
+			_buffer <<= 8;
+		} else {
+			*_next++ = static_cast<byte>(_buffer);
+			_buffer >>= 8;
+		}
+
+		_bitsUsed -= 8;
+	}
+}
+
+
+Result<void, Error>
+BitWriter::writeWide(uint64 value, uint32 count) noexcept {
+	if (count > 64) {
+		return makeError(GenericError::RANGE, "BitWriter::writeBits()");
+	}
+	if (remainingBits() < count) {
+		return makeError(SystemErrors::Overflow, "BitWriter::writeBits()");
+	}
+
+	// Value is written in two parts: high part first in MSB mode, and low part first in LSB mode.
+	if (_order == BitOrder::MsbFirst) {
+		writeUnchecked(value >> 32, count - 32);
+		writeUnchecked(value, 32);
+	} else {
+		writeUnchecked(value, 32);
+		writeUnchecked(value >> 32, count - 32);
+	}
+
+	return Ok();
+}
+
+
+Result<void, Error>
+BitWriter::writePacked(ArrayView<uint32 const> values, uint32 bitWidth) noexcept {
+	if (bitWidth > 32) {
+		return makeError(GenericError::RANGE, "BitWriter::writePacked()");
+	}
+	if (bitWidth == 0) {
+		return Ok();
+	}
+
+	if (remainingBits() / bitWidth < values.size()) {
+		return makeError(SystemErrors::Overflow, "BitWriter::writePacked()");
+	}
+
+	for (auto value : values) {
+		writeUnchecked(value, bitWidth);
+	}
+
+	return Ok();
+}
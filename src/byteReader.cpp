@@ -21,7 +21,18 @@
 #include "solace/byteReader.hpp"
 #include "solace/posixErrorDomain.hpp"
 
+#include "solace/details/byte_swap.hpp"
+#include "solace/details/cpu_features.hpp"
+
+#include <algorithm>  // std::min
 #include <cstring>  // memmove
+#include <limits>
+
+#if defined(SOLACE_X86_DISPATCH)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 using namespace Solace;
 
@@ -81,6 +92,16 @@ ByteReader::get(size_type pos) const noexcept {
 }
 
 
+Result<ByteReader::Cursor, Error>
+ByteReader::ensure(size_type size) noexcept {
+	if (remaining() < size) {
+		return makeError(SystemErrors::Overflow, "ByteReader::ensure()");
+	}
+
+	return Ok(Cursor{*this, viewRemaining().begin(), size});
+}
+
+
 Result<void, Error>
 ByteReader::read(MemoryView::MutableMemoryAddress dest, size_type bytesToRead) noexcept {
 	if (remaining() < bytesToRead) {
@@ -99,6 +120,27 @@ ByteReader::read(MemoryView::MutableMemoryAddress dest, size_type bytesToRead) n
 }
 
 
+Result<void, Error>
+ByteReader::readArray(MemoryView::MutableMemoryAddress dest, size_type count, size_type valueSize,
+					  bool bigEndian) noexcept {
+	if (remaining() / valueSize < count) {
+		return makeError(SystemErrors::Overflow, "ByteReader::read()");
+	}
+
+	auto const bytesToRead = count * valueSize;
+	auto const src = viewRemaining().dataAddress();
+	if (bigEndian != isBigendian()) {
+		details::copyByteSwapped(dest, src, count, valueSize);
+	} else {
+		std::memmove(dest, src, bytesToRead);
+	}
+
+	_position += bytesToRead;
+
+	return Ok();
+}
+
+
 Result<void, Error>
 ByteReader::read(size_type offset, MutableMemoryView dest) const noexcept {
 	auto const bytesToRead = dest.size();
@@ -229,3 +271,309 @@ ByteReader::readBE(uint64& value) noexcept {
                 }
     });
 }
+
+
+namespace /* anonymous */ {
+
+using size_type = ByteReader::size_type;
+
+/// Returned by decodeVarint() for encodings longer than a 64 bit value can take.
+constexpr size_type kMalformedVarint = kMaxVarintSize + 1;
+
+
+/**
+ * Decode an unsigned LEB128 integer.
+ * @return Number of bytes the integer takes, 0 if data ends before the integer does
+ * or kMalformedVarint if the encoding is too long.
+ */
+inline size_type decodeVarint(byte const* src, size_type available, uint64& value) noexcept {
+	uint64 result = 0;
+	auto const maxLen = std::min<size_type>(available, kMaxVarintSize);
+	for (size_type i = 0; i < maxLen; ++i) {
+		auto const b = src[i];
+		result |= uint64{b & 0x7FU} << (7 * i);
+
+		if (b < 0x80) {
+			if (i == kMaxVarintSize - 1 && b > 1) {  // Bits beyond 64
+				return kMalformedVarint;
+			}
+
+			value = result;
+			return i + 1;
+		}
+	}
+
+	return (available < kMaxVarintSize) ? 0 : kMalformedVarint;
+}
+
+
+Result<void, Error>
+varintError(size_type decodedLen, StringLiteral tag) {
+	return (decodedLen == 0)
+			? makeError(SystemErrors::Overflow, tag)
+			: makeError(SystemErrors::ILSEQ, tag);
+}
+
+
+#if defined(__SSE2__)
+
+/**
+ * Decode a varint of up to 8 bytes from a little endian word without a loop:
+ * 7 bit groups are packed pairwise into 14, 28 and then 56 bit fields.
+ */
+inline uint64 packVarint(uint64 word, size_type len) noexcept {
+	auto x = word & (~uint64{0} >> (64 - 8 * len)) & 0x7F7F7F7F7F7F7F7FULL;
+	x = ((x & 0x7F007F007F007F00ULL) >> 1) | (x & 0x007F007F007F007FULL);
+	x = ((x & 0x3FFF00003FFF0000ULL) >> 2) | (x & 0x00003FFF00003FFFULL);
+
+	return ((x & 0x0FFFFFFF00000000ULL) >> 4) | (x & 0x000000000FFFFFFFULL);
+}
+
+
+/// Zero extend 16 bytes into 16 64 bit values.
+inline void widenBytes(uint64* dest, __m128i bytes) noexcept {
+	auto const zero = _mm_setzero_si128();
+	__m128i const words[] = {_mm_unpacklo_epi8(bytes, zero), _mm_unpackhi_epi8(bytes, zero)};
+
+	for (auto w : words) {
+		__m128i const dwords[] = {_mm_unpacklo_epi16(w, zero), _mm_unpackhi_epi16(w, zero)};
+		for (auto d : dwords) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_unpacklo_epi32(d, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 2), _mm_unpackhi_epi32(d, zero));
+			dest += 4;
+		}
+	}
+}
+
+#endif  // __SSE2__
+
+
+#if defined(SOLACE_X86_DISPATCH)
+
+/// Shuffle masks to expand a group of 4 varints into 4 32-bit values, indexed by the group's tag.
+struct GroupVarintTables {
+	byte	shuffle[256][16];
+	byte	dataSize[256];		//!< Number of bytes following the tag.
+};
+
+
+constexpr GroupVarintTables
+makeGroupVarintTables() noexcept {
+	GroupVarintTables tables{};
+	for (uint32 tag = 0; tag < 256; ++tag) {
+		uint32 offset = 0;
+		for (uint32 k = 0; k < 4; ++k) {
+			auto const len = ((tag >> (2 * k)) & 3) + 1;
+			for (uint32 j = 0; j < 4; ++j) {
+				tables.shuffle[tag][4 * k + j] = (j < len) ? static_cast<byte>(offset + j) : 0x80;
+			}
+			offset += len;
+		}
+
+		tables.dataSize[tag] = static_cast<byte>(offset);
+	}
+
+	return tables;
+}
+
+constexpr GroupVarintTables kGroupVarintTables = makeGroupVarintTables();
+
+
+/**
+ * Decode complete groups while there are at least 16 bytes of data after the tag.
+ * @return Number of values decoded, a multiple of 4.
+ */
+SOLACE_TARGET("ssse3")
+size_type decodeGroupVarintSsse3(uint32* dest, size_type count,
+								 byte const* src, size_type available, size_type& offset) noexcept {
+	size_type i = 0;
+	for (; i + 4 <= count && offset + 17 <= available; i += 4) {
+		auto const tag = src[offset];
+		auto const data = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + offset + 1));
+		auto const mask = _mm_loadu_si128(reinterpret_cast<__m128i const*>(kGroupVarintTables.shuffle[tag]));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_shuffle_epi8(data, mask));
+		offset += 1 + kGroupVarintTables.dataSize[tag];
+	}
+
+	return i;
+}
+
+#endif  // SOLACE_X86_DISPATCH
+
+}  // namespace
+
+
+Result<void, Error>
+ByteReader::readVarint(uint64& value) noexcept {
+	uint64 result = 0;
+	auto const len = decodeVarint(viewRemaining().begin(), remaining(), result);
+	if (len == 0 || len == kMalformedVarint) {
+		return varintError(len, "ByteReader::readVarint()");
+	}
+
+	value = result;
+	_position += len;
+
+	return Ok();
+}
+
+
+Result<void, Error>
+ByteReader::readVarint(uint32& value) noexcept {
+	uint64 result = 0;
+	auto const len = decodeVarint(viewRemaining().begin(), remaining(), result);
+	if (len == 0 || len == kMalformedVarint) {
+		return varintError(len, "ByteReader::readVarint()");
+	}
+
+	if (result > std::numeric_limits<uint32>::max()) {
+		return makeError(GenericError::RANGE, "ByteReader::readVarint()");
+	}
+
+	value = static_cast<uint32>(result);
+	_position += len;
+
+	return Ok();
+}
+
+
+Result<void, Error>
+ByteReader::readVarint(int64& value) noexcept {
+	uint64 result = 0;
+	auto const len = decodeVarint(viewRemaining().begin(), remaining(), result);
+	if (len == 0 || len == kMalformedVarint) {
+		return varintError(len, "ByteReader::readVarint()");
+	}
+
+	value = zigZagDecode(result);
+	_position += len;
+
+	return Ok();
+}
+
+
+Result<void, Error>
+ByteReader::readVarint(int32& value) noexcept {
+	uint64 result = 0;
+	auto const len = decodeVarint(viewRemaining().begin(), remaining(), result);
+	if (len == 0 || len == kMalformedVarint) {
+		return varintError(len, "ByteReader::readVarint()");
+	}
+
+	// ZigZag encoding of a 32 bit value fits into 32 bits
+	if (result > std::numeric_limits<uint32>::max()) {
+		return makeError(GenericError::RANGE, "ByteReader::readVarint()");
+	}
+
+	value = static_cast<int32>(zigZagDecode(result));
+	_position += len;
+
+	return Ok();
+}
+
+
+Result<void, Error>
+ByteReader::readVarints(ArrayView<uint64> values) noexcept {
+	auto const src = viewRemaining().begin();
+	auto const available = remaining();
+	auto const count = values.size();
+	auto dest = values.begin();
+
+	size_type offset = 0;
+	size_type i = 0;
+	while (i < count) {
+#if defined(__SSE2__)
+		if (available - offset >= 16) {
+			// Locate ends of all the varints in the next 16 bytes at once: bytes with the high bit clear.
+			auto const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + offset));
+			auto ends = ~static_cast<uint32>(_mm_movemask_epi8(chunk)) & 0xFFFF;
+
+			if (ends == 0xFFFF && count - i >= 16) {  // Run of single byte values
+				widenBytes(dest + i, chunk);
+				i += 16;
+				offset += 16;
+				continue;
+			}
+
+			size_type start = 0;
+			for (; ends != 0 && i < count; ++i) {
+				auto const end = static_cast<size_type>(__builtin_ctz(ends)) + 1;
+				auto const len = end - start;
+				if (len <= 8 && offset + start + 8 <= available) {
+					uint64 word;
+					memcpy(&word, src + offset + start, sizeof(word));
+					dest[i] = packVarint(word, len);
+				} else if (decodeVarint(src + offset + start, available - offset - start, dest[i]) != len) {
+					return makeError(SystemErrors::ILSEQ, "ByteReader::readVarints()");
+				}
+
+				start = end;
+				ends &= ends - 1;
+			}
+
+			if (start == 0) {  // 16 bytes without an end of a varint
+				return makeError(SystemErrors::ILSEQ, "ByteReader::readVarints()");
+			}
+
+			offset += start;
+			continue;
+		}
+#endif
+
+		auto const len = decodeVarint(src + offset, available - offset, dest[i]);
+		if (len == 0 || len == kMalformedVarint) {
+			return varintError(len, "ByteReader::readVarints()");
+		}
+
+		offset += len;
+		++i;
+	}
+
+	_position += offset;
+
+	return Ok();
+}
+
+
+Result<void, Error>
+ByteReader::readGroupVarint(ArrayView<uint32> values) noexcept {
+	auto const src = viewRemaining().begin();
+	auto const available = remaining();
+	auto const count = values.size();
+	auto dest = values.begin();
+
+	size_type offset = 0;
+	size_type i = 0;
+#if defined(SOLACE_X86_DISPATCH)
+	if (details::cpuFeatures().ssse3) {
+		i = decodeGroupVarintSsse3(dest, count, src, available, offset);
+	}
+#endif
+
+	while (i < count) {
+		if (offset >= available) {
+			return makeError(SystemErrors::Overflow, "ByteReader::readGroupVarint()");
+		}
+
+		auto const tag = src[offset++];
+		for (uint32 k = 0; k < 4 && i < count; ++k, ++i) {
+			auto const len = ((tag >> (2 * k)) & 3U) + 1;
+			if (available - offset < len) {
+				return makeError(SystemErrors::Overflow, "ByteReader::readGroupVarint()");
+			}
+
+			uint32 value = 0;
+			for (uint32 j = 0; j < len; ++j) {
+				value |= uint32{src[offset + j]} << (8 * j);
+			}
+
+			dest[i] = value;
+			offset += len;
+		}
+	}
+
+	_position += offset;
+
+	return Ok();
+}
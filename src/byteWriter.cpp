@@ -21,6 +21,8 @@
 #include "solace/byteWriter.hpp"
 #include "solace/posixErrorDomain.hpp"
 
+#include "solace/details/byte_swap.hpp"
+
 #include <cstring>  // memmove
 
 
@@ -63,6 +65,16 @@ ByteWriter::advance(size_type increment) noexcept {
 }
 
 
+Result<ByteWriter::Cursor, Error>
+ByteWriter::reserve(size_type size) noexcept {
+    if (remaining() < size) {
+        return makeError(SystemErrors::Overflow, "ByteWriter::reserve()");
+    }
+
+    return Ok(Cursor{*this, viewRemaining().begin(), size});
+}
+
+
 Result<void, Error>
 ByteWriter::write(MemoryView::MemoryAddress srcAddr, size_type count) noexcept {
     if (count == 0) {  // It's always ok to write 0 bytes :)
@@ -81,6 +93,25 @@ ByteWriter::write(MemoryView::MemoryAddress srcAddr, size_type count) noexcept {
 }
 
 
+Result<void, Error>
+ByteWriter::writeArray(MemoryView::MemoryAddress srcAddr, size_type count, size_type valueSize,
+                       bool bigEndian) noexcept {
+    if (remaining() / valueSize < count) {
+        return makeError(SystemErrors::Overflow, "ByteWriter::write()");
+    }
+
+    auto const bytesToWrite = count * valueSize;
+    auto const dest = viewRemaining().dataAddress();
+    if (bigEndian != isBigendian()) {
+        details::copyByteSwapped(dest, srcAddr, count, valueSize);
+    } else {
+        std::memmove(dest, srcAddr, bytesToWrite);
+    }
+
+    return advance(bytesToWrite);
+}
+
+
 Result<void, Error>
 ByteWriter::writeLE(uint16 value) noexcept {
     constexpr auto valueSize = sizeof(value);
@@ -191,3 +222,66 @@ ByteWriter::writeBE(uint64 value) noexcept {
 
     return write(&result, valueSize);
 }
+
+
+Result<void, Error>
+ByteWriter::writeVarint(uint64 value) noexcept {
+    auto maybeCursor = reserve(varintSize(value));
+    if (!maybeCursor) {
+        return maybeCursor.moveError();
+    }
+
+    auto& cursor = maybeCursor.unwrap();
+    while (value >= 0x80) {
+        cursor.write(static_cast<byte>(value | 0x80));
+        value >>= 7;
+    }
+    cursor.write(static_cast<byte>(value));
+
+    return Ok();
+}
+
+
+namespace /* anonymous */ {
+
+/// Number of bytes a value takes in group varint encoding.
+inline uint32 groupVarintSize(uint32 value) noexcept {
+    return (value < (1U << 8)) ? 1
+         : (value < (1U << 16)) ? 2
+         : (value < (1U << 24)) ? 3
+         : 4;
+}
+
+}  // namespace
+
+
+Result<void, Error>
+ByteWriter::writeGroupVarint(ArrayView<uint32 const> values) noexcept {
+    auto const count = values.size();
+    size_type encodedSize = (count + 3) / 4;  // Tag bytes
+    for (auto value : values) {
+        encodedSize += groupVarintSize(value);
+    }
+
+    if (remaining() < encodedSize) {
+        return makeError(SystemErrors::Overflow, "ByteWriter::writeGroupVarint()");
+    }
+
+    auto dest = viewRemaining().begin();
+    for (size_type i = 0; i < count; i += 4) {
+        auto& tag = *dest++;
+        tag = 0;
+
+        for (size_type k = 0; k < 4 && i + k < count; ++k) {
+            auto value = values[i + k];
+            auto const size = groupVarintSize(value);
+            tag |= static_cast<byte>((size - 1) << (2 * k));
+
+            for (uint32 j = 0; j < size; ++j, value >>= 8) {
+                *dest++ = static_cast<byte>(value);
+            }
+        }
+    }
+
+    return advance(encodedSize);
+}
@@ -0,0 +1,189 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		chainReader.cpp
+ *	@brief		Implementation of ChainReader
+ ******************************************************************************/
+#include "solace/chainReader.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include "solace/details/byte_swap.hpp"
+
+#include <algorithm>  // std::min
+#include <cstring>  // memcpy
+
+using namespace Solace;
+
+
+namespace /* anonymous */ {
+
+template<typename T>
+Result<void, Error> readValue(ChainReader& reader, T& value, bool bigEndian) noexcept {
+	byte buffer[sizeof(T)];
+	auto maybeView = reader.readView(sizeof(T), wrapMemory(buffer));
+	if (!maybeView) {
+		return maybeView.moveError();
+	}
+
+	auto const src = maybeView.unwrap().begin();
+	value = bigEndian
+			? details::loadBE<T>(src)
+			: details::loadLE<T>(src);
+
+	return Ok();
+}
+
+}  // anonymous namespace
+
+
+ChainReader::ChainReader(ArrayView<MemoryView const> segments) noexcept
+	: _segments{segments}
+{
+	for (auto const& segment : segments) {
+		_limit += segment.size();
+	}
+}
+
+
+void
+ChainReader::consume(byte* dest, size_type count) noexcept {
+	while (count > 0) {
+		auto const& segment = _segments[_segmentIndex];
+		auto const chunk = std::min(count, segment.size() - _segmentOffset);
+		if (dest && chunk > 0) {
+			memcpy(dest, segment.begin() + _segmentOffset, chunk);
+			dest += chunk;
+		}
+
+		_segmentOffset += chunk;
+		_position += chunk;
+		count -= chunk;
+
+		if (_segmentOffset == segment.size()) {  // Exhausted, empty segments are passed over too
+			_segmentIndex += 1;
+			_segmentOffset = 0;
+		}
+	}
+}
+
+
+ChainReader&
+ChainReader::rewind() noexcept {
+	_segmentIndex = 0;
+	_segmentOffset = 0;
+	_position = 0;
+
+	return *this;
+}
+
+
+Result<void, Error>
+ChainReader::position(size_type newPosition) noexcept {
+	if (limit() < newPosition) {
+		return makeError(SystemErrors::Overflow, "ChainReader::position()");
+	}
+
+	if (newPosition < _position) {
+		rewind();
+	}
+
+	consume(nullptr, newPosition - _position);
+
+	return Ok();
+}
+
+
+Result<void, Error>
+ChainReader::advance(size_type increment) noexcept {
+	if (remaining() < increment) {
+		return makeError(SystemErrors::Overflow, "ChainReader::advance()");
+	}
+
+	consume(nullptr, increment);
+
+	return Ok();
+}
+
+
+MemoryView
+ChainReader::viewRemaining() const noexcept {
+	// Skip empty segments to not return an empty view while there is data left
+	for (auto i = _segmentIndex, offset = _segmentOffset; i < _segments.size(); ++i, offset = 0) {
+		auto const& segment = _segments[i];
+		if (offset < segment.size()) {
+			return segment.slice(offset, segment.size());
+		}
+	}
+
+	return {};
+}
+
+
+Result<MemoryView, Error>
+ChainReader::readView(size_type size, MutableMemoryView scratch) noexcept {
+	if (remaining() < size) {
+		return makeError(SystemErrors::Overflow, "ChainReader::readView()");
+	}
+
+	auto const view = viewRemaining();
+	if (size <= view.size()) {
+		consume(nullptr, size);
+		return Ok(view.slice(0, size));
+	}
+
+	if (scratch.size() < size) {
+		return makeError(SystemErrors::Overflow, "ChainReader::readView()");
+	}
+
+	consume(scratch.begin(), size);
+
+	return Ok(scratch.slice(0, size));
+}
+
+
+Result<byte, Error>
+ChainReader::get() noexcept {
+	if (remaining() < 1) {
+		return makeError(SystemErrors::Overflow, "ChainReader::get()");
+	}
+
+	byte value;
+	consume(&value, 1);
+
+	return Ok(value);
+}
+
+
+Result<void, Error>
+ChainReader::read(void* dest, size_type bytesToRead) noexcept {
+	if (remaining() < bytesToRead) {
+		return makeError(SystemErrors::Overflow, "ChainReader::read()");
+	}
+
+	consume(static_cast<byte*>(dest), bytesToRead);
+
+	return Ok();
+}
+
+
+Result<void, Error> ChainReader::readLE(uint16& value) noexcept { return readValue(*this, value, false); }
+Result<void, Error> ChainReader::readLE(uint32& value) noexcept { return readValue(*this, value, false); }
+Result<void, Error> ChainReader::readLE(uint64& value) noexcept { return readValue(*this, value, false); }
+
+Result<void, Error> ChainReader::readBE(uint16& value) noexcept { return readValue(*this, value, true); }
+Result<void, Error> ChainReader::readBE(uint32& value) noexcept { return readValue(*this, value, true); }
+Result<void, Error> ChainReader::readBE(uint64& value) noexcept { return readValue(*this, value, true); }
@@ -0,0 +1,159 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		gatherWriter.cpp
+ *	@brief		Implementation of GatherWriter
+ ******************************************************************************/
+#include "solace/gatherWriter.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include "solace/details/byte_swap.hpp"
+
+#include <cstring>  // memcpy
+
+using namespace Solace;
+
+
+namespace /* anonymous */ {
+
+template<typename T>
+Result<void, Error> writeStored(GatherWriter& writer, T value, bool bigEndian) noexcept {
+	byte buffer[sizeof(T)];
+	if (bigEndian) {
+		details::storeBE(buffer, value);
+	} else {
+		details::storeLE(buffer, value);
+	}
+
+	return writer.copy(wrapMemory(buffer, sizeof(T)));
+}
+
+}  // anonymous namespace
+
+
+GatherWriter::GatherWriter(MemoryResource&& memory, size_type maxSegments, size_type copyThreshold) noexcept
+	: _memory{mv(memory)}
+	, _segments{static_cast<iovec*>(_memory.view().dataAddress())}
+	, _maxSegments{maxSegments}
+	, _scratch{static_cast<byte*>(_memory.view().dataAddress()) + maxSegments * sizeof(iovec)}
+	, _scratchSize{_memory.size() - maxSegments * sizeof(iovec)}
+	, _copyThreshold{copyThreshold}
+{
+}
+
+
+Result<void, Error>
+GatherWriter::append(byte const* data, size_type size, StringLiteral tag) noexcept {
+	if (_segmentsCount > 0) {
+		auto& last = _segments[_segmentsCount - 1];
+		if (static_cast<byte const*>(last.iov_base) + last.iov_len == data) {
+			last.iov_len += size;
+			_size += size;
+			return Ok();
+		}
+	}
+
+	if (_segmentsCount >= _maxSegments) {
+		return makeError(SystemErrors::Overflow, tag);
+	}
+
+	// iovec is shared by readv and writev hence non-const base; writev never writes through it.
+	auto& segment = _segments[_segmentsCount++];
+	segment.iov_base = const_cast<byte*>(data);
+	segment.iov_len = size;
+	_size += size;
+
+	return Ok();
+}
+
+
+Result<void, Error>
+GatherWriter::copy(MemoryView data) noexcept {
+	auto const size = data.size();
+	if (size == 0) {
+		return Ok();
+	}
+
+	if (scratchRemaining() < size) {
+		return makeError(SystemErrors::Overflow, "GatherWriter::copy()");
+	}
+
+	auto const dest = _scratch + _scratchUsed;
+	auto result = append(dest, size, "GatherWriter::copy()");
+	if (!result) {
+		return result;
+	}
+
+	memcpy(dest, data.dataAddress(), size);
+	_scratchUsed += size;
+
+	return Ok();
+}
+
+
+Result<void, Error>
+GatherWriter::reference(MemoryView data) noexcept {
+	if (data.empty()) {
+		return Ok();
+	}
+
+	return append(data.begin(), data.size(), "GatherWriter::reference()");
+}
+
+
+Result<void, Error> GatherWriter::writeLE(uint16 value) noexcept { return writeStored(*this, value, false); }
+Result<void, Error> GatherWriter::writeLE(uint32 value) noexcept { return writeStored(*this, value, false); }
+Result<void, Error> GatherWriter::writeLE(uint64 value) noexcept { return writeStored(*this, value, false); }
+
+Result<void, Error> GatherWriter::writeBE(uint16 value) noexcept { return writeStored(*this, value, true); }
+Result<void, Error> GatherWriter::writeBE(uint32 value) noexcept { return writeStored(*this, value, true); }
+Result<void, Error> GatherWriter::writeBE(uint64 value) noexcept { return writeStored(*this, value, true); }
+
+
+Result<void, Error>
+GatherWriter::copyTo(ByteWriter& dest) const noexcept {
+	auto maybeCursor = dest.reserve(_size);
+	if (!maybeCursor) {
+		return maybeCursor.moveError();
+	}
+
+	auto& cursor = maybeCursor.unwrap();
+	for (auto const& segment : iovecs()) {
+		cursor.write(wrapMemory(segment.iov_base, segment.iov_len));
+	}
+
+	return Ok();
+}
+
+
+Result<GatherWriter, Error>
+Solace::makeGatherWriter(MemoryManager& memManager, GatherWriter::size_type maxSegments,
+						 GatherWriter::size_type scratchSize, GatherWriter::size_type copyThreshold) {
+	auto maybeBuffer = memManager.allocate(maxSegments * sizeof(iovec) + scratchSize);
+	if (!maybeBuffer) {
+		return maybeBuffer.moveError();
+	}
+
+	return Ok(GatherWriter{maybeBuffer.moveResult(), maxSegments, copyThreshold});
+}
+
+
+Result<GatherWriter, Error>
+Solace::makeGatherWriter(GatherWriter::size_type maxSegments, GatherWriter::size_type scratchSize,
+						 GatherWriter::size_type copyThreshold) {
+	return makeGatherWriter(getSystemHeapMemoryManager(), maxSegments, scratchSize, copyThreshold);
+}
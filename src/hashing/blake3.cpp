@@ -0,0 +1,1069 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		hashing/blake3.cpp
+ *	@brief		Implementation of BLAKE3 hash function.
+ ******************************************************************************/
+#include "solace/hashing/blake3.hpp"
+
+#include "solace/posixErrorDomain.hpp"
+
+#include "solace/details/byte_swap.hpp"
+#include "solace/details/cpu_features.hpp"
+
+#include <algorithm>  // std::min
+#include <cstring>  // memcpy
+#include <exception>
+#include <thread>
+
+#if defined(SOLACE_X86_DISPATCH)
+#include <immintrin.h>
+#endif
+
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+
+static const StringLiteral BLAKE3_NAME = "BLAKE3";
+
+
+namespace /* anonymous */ {
+
+constexpr uint32 kIV[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+/// Order of message words used by each of 7 rounds.
+constexpr uint8 kMsgSchedule[7][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8},
+    {3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1},
+    {10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6},
+    {12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4},
+    {9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7},
+    {11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13},
+};
+
+// Domain separation flags
+constexpr uint32 kChunkStart        = 1 << 0;
+constexpr uint32 kChunkEnd          = 1 << 1;
+constexpr uint32 kParent            = 1 << 2;
+constexpr uint32 kRoot              = 1 << 3;
+constexpr uint32 kKeyedHash         = 1 << 4;
+constexpr uint32 kDeriveKeyContext  = 1 << 5;
+constexpr uint32 kDeriveKeyMaterial = 1 << 6;
+
+constexpr size_t kBlockSize = 64;
+constexpr size_t kChunkSize = Blake3::kChunkSize;
+constexpr size_t kCvSize = 32;
+
+/// Max number of inputs hashed at once by SIMD kernels: that of AVX-512.
+constexpr size_t kMaxSimdDegree = 16;
+
+/// Subtrees smaller than that are not worth a thread of their own.
+constexpr size_t kMinParallelSize = 256 * 1024;
+
+
+inline uint32 rotr32(uint32 x, int n) noexcept {
+    return (x >> n) | (x << (32 - n));
+}
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline void g(uint32 v[16], int a, int b, int c, int d, uint32 x, uint32 y) noexcept {
+    v[a] = v[a] + v[b] + x;
+    v[d] = rotr32(v[d] ^ v[a], 16);
+    v[c] = v[c] + v[d];
+    v[b] = rotr32(v[b] ^ v[c], 12);
+    v[a] = v[a] + v[b] + y;
+    v[d] = rotr32(v[d] ^ v[a], 8);
+    v[c] = v[c] + v[d];
+    v[b] = rotr32(v[b] ^ v[c], 7);
+}
+
+/**
+ * Compress a block. Output is the full 16 words of the state that the extendable output needs,
+ * its first 8 words are the new chaining value.
+ */
+void compressPortable(uint32 out[16], uint32 const cv[8], byte const* block, uint32 blockLength,
+                      uint64 counter, uint32 flags) noexcept {
+    uint32 m[16];
+    for (size_t i = 0; i < 16; ++i) {
+        m[i] = details::loadLE<uint32>(block + 4 * i);
+    }
+
+    uint32 v[16] = {
+        cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+        kIV[0], kIV[1], kIV[2], kIV[3],
+        static_cast<uint32>(counter), static_cast<uint32>(counter >> 32), blockLength, flags
+    };
+
+    for (auto const& s : kMsgSchedule) {
+        g(v, 0, 4,  8, 12, m[s[0]],  m[s[1]]);
+        g(v, 1, 5,  9, 13, m[s[2]],  m[s[3]]);
+        g(v, 2, 6, 10, 14, m[s[4]],  m[s[5]]);
+        g(v, 3, 7, 11, 15, m[s[6]],  m[s[7]]);
+        g(v, 0, 5, 10, 15, m[s[8]],  m[s[9]]);
+        g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        g(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+        g(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+    }
+
+    for (size_t i = 0; i < 8; ++i) {
+        out[i] = v[i] ^ v[i + 8];
+        out[i + 8] = v[i + 8] ^ cv[i];
+    }
+}
+
+
+#if defined(SOLACE_X86_DISPATCH)
+
+SOLACE_TARGET("sse4.1")
+inline __m128i rotr16(__m128i x) noexcept {
+    return _mm_shuffle_epi8(x, _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13));
+}
+
+SOLACE_TARGET("sse4.1")
+inline __m128i rotr12(__m128i x) noexcept {
+    return _mm_or_si128(_mm_srli_epi32(x, 12), _mm_slli_epi32(x, 20));
+}
+
+SOLACE_TARGET("sse4.1")
+inline __m128i rotr8(__m128i x) noexcept {
+    return _mm_shuffle_epi8(x, _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12));
+}
+
+SOLACE_TARGET("sse4.1")
+inline __m128i rotr7(__m128i x) noexcept {
+    return _mm_or_si128(_mm_srli_epi32(x, 7), _mm_slli_epi32(x, 25));
+}
+
+/// G function applied to all four columns (or diagonals) of the state at once: one row per vector.
+SOLACE_TARGET("sse4.1")
+inline void gRows(__m128i& a, __m128i& b, __m128i& c, __m128i& d, __m128i x, __m128i y) noexcept {
+    a = _mm_add_epi32(_mm_add_epi32(a, b), x);
+    d = rotr16(_mm_xor_si128(d, a));
+    c = _mm_add_epi32(c, d);
+    b = rotr12(_mm_xor_si128(b, c));
+    a = _mm_add_epi32(_mm_add_epi32(a, b), y);
+    d = rotr8(_mm_xor_si128(d, a));
+    c = _mm_add_epi32(c, d);
+    b = rotr7(_mm_xor_si128(b, c));
+}
+
+/// Same as compressPortable() with the state held in four row vectors.
+SOLACE_TARGET("sse4.1")
+void compressSse41(uint32 out[16], uint32 const cv[8], byte const* block, uint32 blockLength,
+                   uint64 counter, uint32 flags) noexcept {
+    uint32 m[16];
+    for (size_t i = 0; i < 16; ++i) {
+        m[i] = details::loadLE<uint32>(block + 4 * i);
+    }
+
+    auto const cv0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(cv));
+    auto const cv1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(cv + 4));
+    auto r0 = cv0;
+    auto r1 = cv1;
+    auto r2 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(kIV));
+    auto r3 = _mm_setr_epi32(static_cast<int>(counter), static_cast<int>(counter >> 32),
+                             static_cast<int>(blockLength), static_cast<int>(flags));
+
+    for (auto const& s : kMsgSchedule) {
+        gRows(r0, r1, r2, r3,
+              _mm_setr_epi32(static_cast<int>(m[s[0]]), static_cast<int>(m[s[2]]),
+                             static_cast<int>(m[s[4]]), static_cast<int>(m[s[6]])),
+              _mm_setr_epi32(static_cast<int>(m[s[1]]), static_cast<int>(m[s[3]]),
+                             static_cast<int>(m[s[5]]), static_cast<int>(m[s[7]])));
+
+        // Rotate rows so that diagonals line up in columns
+        r1 = _mm_shuffle_epi32(r1, _MM_SHUFFLE(0, 3, 2, 1));
+        r2 = _mm_shuffle_epi32(r2, _MM_SHUFFLE(1, 0, 3, 2));
+        r3 = _mm_shuffle_epi32(r3, _MM_SHUFFLE(2, 1, 0, 3));
+
+        gRows(r0, r1, r2, r3,
+              _mm_setr_epi32(static_cast<int>(m[s[8]]), static_cast<int>(m[s[10]]),
+                             static_cast<int>(m[s[12]]), static_cast<int>(m[s[14]])),
+              _mm_setr_epi32(static_cast<int>(m[s[9]]), static_cast<int>(m[s[11]]),
+                             static_cast<int>(m[s[13]]), static_cast<int>(m[s[15]])));
+
+        r1 = _mm_shuffle_epi32(r1, _MM_SHUFFLE(2, 1, 0, 3));
+        r2 = _mm_shuffle_epi32(r2, _MM_SHUFFLE(1, 0, 3, 2));
+        r3 = _mm_shuffle_epi32(r3, _MM_SHUFFLE(0, 3, 2, 1));
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),      _mm_xor_si128(r0, r2));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4),  _mm_xor_si128(r1, r3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8),  _mm_xor_si128(r2, cv0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_xor_si128(r3, cv1));
+}
+
+
+/*
+ * Kernels below hash a number of inputs at once: vector v[i] holds state word i of all the inputs.
+ */
+
+/// G function on one column (or diagonal) of 4 states.
+SOLACE_TARGET("sse4.1")
+inline void g(__m128i v[16], int a, int b, int c, int d, __m128i x, __m128i y) noexcept {
+    gRows(v[a], v[b], v[c], v[d], x, y);
+}
+
+SOLACE_TARGET("sse4.1")
+inline void roundWide(__m128i v[16], __m128i const m[16], uint8 const s[16]) noexcept {
+    g(v, 0, 4,  8, 12, m[s[0]],  m[s[1]]);
+    g(v, 1, 5,  9, 13, m[s[2]],  m[s[3]]);
+    g(v, 2, 6, 10, 14, m[s[4]],  m[s[5]]);
+    g(v, 3, 7, 11, 15, m[s[6]],  m[s[7]]);
+    g(v, 0, 5, 10, 15, m[s[8]],  m[s[9]]);
+    g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+    g(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+    g(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+}
+
+/// Transpose 4x4 matrix of 32 bit words: row i becomes column i.
+SOLACE_TARGET("sse4.1")
+inline void transpose4x4(__m128i r[4]) noexcept {
+    auto const ab01 = _mm_unpacklo_epi32(r[0], r[1]);
+    auto const ab23 = _mm_unpackhi_epi32(r[0], r[1]);
+    auto const cd01 = _mm_unpacklo_epi32(r[2], r[3]);
+    auto const cd23 = _mm_unpackhi_epi32(r[2], r[3]);
+
+    r[0] = _mm_unpacklo_epi64(ab01, cd01);
+    r[1] = _mm_unpackhi_epi64(ab01, cd01);
+    r[2] = _mm_unpacklo_epi64(ab23, cd23);
+    r[3] = _mm_unpackhi_epi64(ab23, cd23);
+}
+
+/// Hash the same number of blocks of 4 inputs.
+SOLACE_TARGET("sse4.1")
+void hashMany4(byte const* const inputs[4], size_t blocks, uint32 const key[8],
+               uint64 counter, bool incrementCounter, uint32 flags, uint32 flagsStart, uint32 flagsEnd,
+               byte* out) noexcept {
+    constexpr size_t kLanes = 4;
+
+    alignas(16) uint32 counterLow[kLanes];
+    alignas(16) uint32 counterHigh[kLanes];
+    for (size_t i = 0; i < kLanes; ++i) {
+        auto const laneCounter = counter + (incrementCounter ? i : 0);
+        counterLow[i] = static_cast<uint32>(laneCounter);
+        counterHigh[i] = static_cast<uint32>(laneCounter >> 32);
+    }
+
+    __m128i h[8];
+    for (size_t i = 0; i < 8; ++i) {
+        h[i] = _mm_set1_epi32(static_cast<int>(key[i]));
+    }
+
+    for (size_t block = 0; block < blocks; ++block) {
+        __m128i m[16];
+        for (size_t quarter = 0; quarter < 4; ++quarter) {
+            for (size_t i = 0; i < kLanes; ++i) {
+                m[4 * quarter + i] = _mm_loadu_si128(
+                            reinterpret_cast<__m128i const*>(inputs[i] + block * kBlockSize + 16 * quarter));
+            }
+            transpose4x4(m + 4 * quarter);
+        }
+
+        auto const blockFlags = flags | ((block == 0) ? flagsStart : 0) | ((block + 1 == blocks) ? flagsEnd : 0);
+        __m128i v[16] = {
+            h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7],
+            _mm_set1_epi32(static_cast<int>(kIV[0])), _mm_set1_epi32(static_cast<int>(kIV[1])),
+            _mm_set1_epi32(static_cast<int>(kIV[2])), _mm_set1_epi32(static_cast<int>(kIV[3])),
+            _mm_load_si128(reinterpret_cast<__m128i const*>(counterLow)),
+            _mm_load_si128(reinterpret_cast<__m128i const*>(counterHigh)),
+            _mm_set1_epi32(static_cast<int>(kBlockSize)),
+            _mm_set1_epi32(static_cast<int>(blockFlags))
+        };
+
+        for (auto const& s : kMsgSchedule) {
+            roundWide(v, m, s);
+        }
+
+        for (size_t i = 0; i < 8; ++i) {
+            h[i] = _mm_xor_si128(v[i], v[i + 8]);
+        }
+    }
+
+    alignas(16) uint32 cvs[8][kLanes];
+    for (size_t i = 0; i < 8; ++i) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(cvs[i]), h[i]);
+    }
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        for (size_t i = 0; i < 8; ++i) {
+            details::storeLE(out + lane * kCvSize + 4 * i, cvs[i][lane]);
+        }
+    }
+}
+
+
+SOLACE_TARGET("avx2")
+inline __m256i rotr16(__m256i x) noexcept {
+    return _mm256_shuffle_epi8(x, _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                                   2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13));
+}
+
+SOLACE_TARGET("avx2")
+inline __m256i rotr12(__m256i x) noexcept {
+    return _mm256_or_si256(_mm256_srli_epi32(x, 12), _mm256_slli_epi32(x, 20));
+}
+
+SOLACE_TARGET("avx2")
+inline __m256i rotr8(__m256i x) noexcept {
+    return _mm256_shuffle_epi8(x, _mm256_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12,
+                                                   1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12));
+}
+
+SOLACE_TARGET("avx2")
+inline __m256i rotr7(__m256i x) noexcept {
+    return _mm256_or_si256(_mm256_srli_epi32(x, 7), _mm256_slli_epi32(x, 25));
+}
+
+SOLACE_TARGET("avx2")
+inline void g(__m256i v[16], int a, int b, int c, int d, __m256i x, __m256i y) noexcept {
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), x);
+    v[d] = rotr16(_mm256_xor_si256(v[d], v[a]));
+    v[c] = _mm256_add_epi32(v[c], v[d]);
+    v[b] = rotr12(_mm256_xor_si256(v[b], v[c]));
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), y);
+    v[d] = rotr8(_mm256_xor_si256(v[d], v[a]));
+    v[c] = _mm256_add_epi32(v[c], v[d]);
+    v[b] = rotr7(_mm256_xor_si256(v[b], v[c]));
+}
+
+SOLACE_TARGET("avx2")
+inline void roundWide(__m256i v[16], __m256i const m[16], uint8 const s[16]) noexcept {
+    g(v, 0, 4,  8, 12, m[s[0]],  m[s[1]]);
+    g(v, 1, 5,  9, 13, m[s[2]],  m[s[3]]);
+    g(v, 2, 6, 10, 14, m[s[4]],  m[s[5]]);
+    g(v, 3, 7, 11, 15, m[s[6]],  m[s[7]]);
+    g(v, 0, 5, 10, 15, m[s[8]],  m[s[9]]);
+    g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+    g(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+    g(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+}
+
+/// Transpose 8x8 matrix of 32 bit words: row i becomes column i.
+SOLACE_TARGET("avx2")
+inline void transpose8x8(__m256i r[8]) noexcept {
+    __m256i t[8];
+    for (size_t i = 0; i < 8; i += 2) {
+        t[i]     = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+    }
+
+    __m256i u[8];
+    for (size_t i = 0; i < 8; i += 4) {
+        u[i]     = _mm256_unpacklo_epi64(t[i],     t[i + 2]);
+        u[i + 1] = _mm256_unpackhi_epi64(t[i],     t[i + 2]);
+        u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+
+    for (size_t i = 0; i < 4; ++i) {
+        r[i]     = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+        r[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+}
+
+/// Hash the same number of blocks of 8 inputs.
+SOLACE_TARGET("avx2")
+void hashMany8(byte const* const inputs[8], size_t blocks, uint32 const key[8],
+               uint64 counter, bool incrementCounter, uint32 flags, uint32 flagsStart, uint32 flagsEnd,
+               byte* out) noexcept {
+    constexpr size_t kLanes = 8;
+
+    alignas(32) uint32 counterLow[kLanes];
+    alignas(32) uint32 counterHigh[kLanes];
+    for (size_t i = 0; i < kLanes; ++i) {
+        auto const laneCounter = counter + (incrementCounter ? i : 0);
+        counterLow[i] = static_cast<uint32>(laneCounter);
+        counterHigh[i] = static_cast<uint32>(laneCounter >> 32);
+    }
+
+    __m256i h[8];
+    for (size_t i = 0; i < 8; ++i) {
+        h[i] = _mm256_set1_epi32(static_cast<int>(key[i]));
+    }
+
+    for (size_t block = 0; block < blocks; ++block) {
+        __m256i m[16];
+        for (size_t half = 0; half < 2; ++half) {
+            for (size_t i = 0; i < kLanes; ++i) {
+                m[8 * half + i] = _mm256_loadu_si256(
+                            reinterpret_cast<__m256i const*>(inputs[i] + block * kBlockSize + 32 * half));
+            }
+            transpose8x8(m + 8 * half);
+        }
+
+        auto const blockFlags = flags | ((block == 0) ? flagsStart : 0) | ((block + 1 == blocks) ? flagsEnd : 0);
+        __m256i v[16] = {
+            h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7],
+            _mm256_set1_epi32(static_cast<int>(kIV[0])), _mm256_set1_epi32(static_cast<int>(kIV[1])),
+            _mm256_set1_epi32(static_cast<int>(kIV[2])), _mm256_set1_epi32(static_cast<int>(kIV[3])),
+            _mm256_load_si256(reinterpret_cast<__m256i const*>(counterLow)),
+            _mm256_load_si256(reinterpret_cast<__m256i const*>(counterHigh)),
+            _mm256_set1_epi32(static_cast<int>(kBlockSize)),
+            _mm256_set1_epi32(static_cast<int>(blockFlags))
+        };
+
+        for (auto const& s : kMsgSchedule) {
+            roundWide(v, m, s);
+        }
+
+        for (size_t i = 0; i < 8; ++i) {
+            h[i] = _mm256_xor_si256(v[i], v[i + 8]);
+        }
+    }
+
+    // Chaining values are 8 words: transposing them back gives all 8 words of an input per vector.
+    transpose8x8(h);
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + lane * kCvSize), h[lane]);
+    }
+}
+
+
+// GCC 12 warns of uninitialized __Y in AVX-512 intrinsics inlined into the kernel: a false positive, GCC bug 105593.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+SOLACE_TARGET("avx512f")
+inline void g(__m512i v[16], int a, int b, int c, int d, __m512i x, __m512i y) noexcept {
+    v[a] = _mm512_add_epi32(_mm512_add_epi32(v[a], v[b]), x);
+    v[d] = _mm512_ror_epi32(_mm512_xor_si512(v[d], v[a]), 16);
+    v[c] = _mm512_add_epi32(v[c], v[d]);
+    v[b] = _mm512_ror_epi32(_mm512_xor_si512(v[b], v[c]), 12);
+    v[a] = _mm512_add_epi32(_mm512_add_epi32(v[a], v[b]), y);
+    v[d] = _mm512_ror_epi32(_mm512_xor_si512(v[d], v[a]), 8);
+    v[c] = _mm512_add_epi32(v[c], v[d]);
+    v[b] = _mm512_ror_epi32(_mm512_xor_si512(v[b], v[c]), 7);
+}
+
+SOLACE_TARGET("avx512f")
+inline void roundWide(__m512i v[16], __m512i const m[16], uint8 const s[16]) noexcept {
+    g(v, 0, 4,  8, 12, m[s[0]],  m[s[1]]);
+    g(v, 1, 5,  9, 13, m[s[2]],  m[s[3]]);
+    g(v, 2, 6, 10, 14, m[s[4]],  m[s[5]]);
+    g(v, 3, 7, 11, 15, m[s[6]],  m[s[7]]);
+    g(v, 0, 5, 10, 15, m[s[8]],  m[s[9]]);
+    g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+    g(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+    g(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+}
+
+/// Transpose 16x16 matrix of 32 bit words: row i becomes column i.
+SOLACE_TARGET("avx512f")
+inline void transpose16x16(__m512i r[16]) noexcept {
+    // Transpose 4x4 blocks within each 128 bit lane: u[4 * g + k] lane j holds word 4 * j + k of rows 4 * g ..
+    __m512i t[16];
+    for (size_t i = 0; i < 16; i += 2) {
+        t[i]     = _mm512_unpacklo_epi32(r[i], r[i + 1]);
+        t[i + 1] = _mm512_unpackhi_epi32(r[i], r[i + 1]);
+    }
+
+    __m512i u[16];
+    for (size_t i = 0; i < 16; i += 4) {
+        u[i]     = _mm512_unpacklo_epi64(t[i],     t[i + 2]);
+        u[i + 1] = _mm512_unpackhi_epi64(t[i],     t[i + 2]);
+        u[i + 2] = _mm512_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm512_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+
+    // Then transpose the 4x4 matrix of 128 bit lanes
+    for (size_t k = 0; k < 4; ++k) {
+        auto const ab01 = _mm512_shuffle_i32x4(u[k],     u[k + 4],  0x44);
+        auto const ab23 = _mm512_shuffle_i32x4(u[k],     u[k + 4],  0xEE);
+        auto const cd01 = _mm512_shuffle_i32x4(u[k + 8], u[k + 12], 0x44);
+        auto const cd23 = _mm512_shuffle_i32x4(u[k + 8], u[k + 12], 0xEE);
+
+        r[k]      = _mm512_shuffle_i32x4(ab01, cd01, 0x88);
+        r[k + 4]  = _mm512_shuffle_i32x4(ab01, cd01, 0xDD);
+        r[k + 8]  = _mm512_shuffle_i32x4(ab23, cd23, 0x88);
+        r[k + 12] = _mm512_shuffle_i32x4(ab23, cd23, 0xDD);
+    }
+}
+
+/// Hash the same number of blocks of 16 inputs.
+SOLACE_TARGET("avx512f")
+void hashMany16(byte const* const inputs[16], size_t blocks, uint32 const key[8],
+                uint64 counter, bool incrementCounter, uint32 flags, uint32 flagsStart, uint32 flagsEnd,
+                byte* out) noexcept {
+    constexpr size_t kLanes = 16;
+
+    alignas(64) uint32 counterLow[kLanes];
+    alignas(64) uint32 counterHigh[kLanes];
+    for (size_t i = 0; i < kLanes; ++i) {
+        auto const laneCounter = counter + (incrementCounter ? i : 0);
+        counterLow[i] = static_cast<uint32>(laneCounter);
+        counterHigh[i] = static_cast<uint32>(laneCounter >> 32);
+    }
+
+    __m512i h[8];
+    for (size_t i = 0; i < 8; ++i) {
+        h[i] = _mm512_set1_epi32(static_cast<int>(key[i]));
+    }
+
+    for (size_t block = 0; block < blocks; ++block) {
+        __m512i m[16];
+        for (size_t i = 0; i < kLanes; ++i) {
+            m[i] = _mm512_loadu_si512(inputs[i] + block * kBlockSize);
+        }
+        transpose16x16(m);
+
+        auto const blockFlags = flags | ((block == 0) ? flagsStart : 0) | ((block + 1 == blocks) ? flagsEnd : 0);
+        __m512i v[16] = {
+            h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7],
+            _mm512_set1_epi32(static_cast<int>(kIV[0])), _mm512_set1_epi32(static_cast<int>(kIV[1])),
+            _mm512_set1_epi32(static_cast<int>(kIV[2])), _mm512_set1_epi32(static_cast<int>(kIV[3])),
+            _mm512_load_si512(counterLow),
+            _mm512_load_si512(counterHigh),
+            _mm512_set1_epi32(static_cast<int>(kBlockSize)),
+            _mm512_set1_epi32(static_cast<int>(blockFlags))
+        };
+
+        for (auto const& s : kMsgSchedule) {
+            roundWide(v, m, s);
+        }
+
+        for (size_t i = 0; i < 8; ++i) {
+            h[i] = _mm512_xor_si512(v[i], v[i + 8]);
+        }
+    }
+
+    alignas(64) uint32 cvs[8][kLanes];
+    for (size_t i = 0; i < 8; ++i) {
+        _mm512_store_si512(cvs[i], h[i]);
+    }
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        for (size_t i = 0; i < 8; ++i) {
+            details::storeLE(out + lane * kCvSize + 4 * i, cvs[i][lane]);
+        }
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif  // SOLACE_X86_DISPATCH
+
+
+/// Compress a block with the best implementation CPU supports.
+void compress(uint32 out[16], uint32 const cv[8], byte const* block, uint32 blockLength,
+              uint64 counter, uint32 flags) noexcept {
+#if defined(SOLACE_X86_DISPATCH)
+    if (details::cpuFeatures().sse41) {
+        compressSse41(out, cv, block, blockLength, counter, flags);
+        return;
+    }
+#endif
+
+    compressPortable(out, cv, block, blockLength, counter, flags);
+}
+
+void compressInPlace(uint32 cv[8], byte const* block, uint32 blockLength, uint64 counter, uint32 flags) noexcept {
+    uint32 out[16];
+    compress(out, cv, block, blockLength, counter, flags);
+    memcpy(cv, out, 8 * sizeof(uint32));
+}
+
+void storeCv(byte* dest, uint32 const cv[8]) noexcept {
+    for (size_t i = 0; i < 8; ++i) {
+        details::storeLE(dest + 4 * i, cv[i]);
+    }
+}
+
+
+/// Number of inputs hashMany() processes at once.
+size_t simdDegree() noexcept {
+#if defined(SOLACE_X86_DISPATCH)
+    auto const& features = details::cpuFeatures();
+    if (features.avx512f) {
+        return 16;
+    }
+    if (features.avx2) {
+        return 8;
+    }
+    if (features.sse41) {
+        return 4;
+    }
+#endif
+
+    return 1;
+}
+
+/**
+ * Hash a number of inputs of the same size: either whole chunks or pairs of chaining values of parent nodes.
+ * Chaining value of each input is written to the output, kCvSize bytes per input.
+ */
+void hashMany(byte const* const* inputs, size_t count, size_t blocks, uint32 const key[8],
+              uint64 counter, bool incrementCounter, uint32 flags, uint32 flagsStart, uint32 flagsEnd,
+              byte* out) noexcept {
+    auto const counterStep = incrementCounter ? 1 : 0;
+
+#if defined(SOLACE_X86_DISPATCH)
+    auto const& features = details::cpuFeatures();
+    if (features.avx512f) {
+        for (; count >= 16; count -= 16, inputs += 16, out += 16 * kCvSize, counter += 16 * counterStep) {
+            hashMany16(inputs, blocks, key, counter, incrementCounter, flags, flagsStart, flagsEnd, out);
+        }
+    }
+    if (features.avx2) {
+        for (; count >= 8; count -= 8, inputs += 8, out += 8 * kCvSize, counter += 8 * counterStep) {
+            hashMany8(inputs, blocks, key, counter, incrementCounter, flags, flagsStart, flagsEnd, out);
+        }
+    }
+    if (features.sse41) {
+        for (; count >= 4; count -= 4, inputs += 4, out += 4 * kCvSize, counter += 4 * counterStep) {
+            hashMany4(inputs, blocks, key, counter, incrementCounter, flags, flagsStart, flagsEnd, out);
+        }
+    }
+#endif
+
+    for (; count > 0; count -= 1, inputs += 1, out += kCvSize, counter += counterStep) {
+        uint32 cv[8];
+        memcpy(cv, key, sizeof(cv));
+        for (size_t block = 0; block < blocks; ++block) {
+            auto const blockFlags = flags | ((block == 0) ? flagsStart : 0) | ((block + 1 == blocks) ? flagsEnd : 0);
+            compressInPlace(cv, *inputs + block * kBlockSize, kBlockSize, counter, blockFlags);
+        }
+        storeCv(out, cv);
+    }
+}
+
+
+/// State of the last compression of a node, that gives its chaining value or the root output.
+struct Output {
+    uint32  inputCv[8];
+    byte    block[kBlockSize];
+    uint32  blockLength;
+    uint64  counter;
+    uint32  flags;
+
+    Output(uint32 const cv[8], byte const* data, size_t size, uint64 blockCounter, uint32 blockFlags) noexcept
+        : blockLength{static_cast<uint32>(size)}
+        , counter{blockCounter}
+        , flags{blockFlags}
+    {
+        memcpy(inputCv, cv, sizeof(inputCv));
+        memcpy(block, data, size);
+        memset(block + size, 0, kBlockSize - size);
+    }
+
+    void chainingValue(byte* dest) const noexcept {
+        uint32 cv[8];
+        memcpy(cv, inputCv, sizeof(cv));
+        compressInPlace(cv, block, blockLength, counter, flags);
+        storeCv(dest, cv);
+    }
+
+    /// Root output stream is the output of compressions of the same root node with incrementing counter.
+    void rootBytes(uint64 offset, byte* dest, size_t size) const noexcept {
+        auto outputCounter = offset / kBlockSize;
+        auto offsetInBlock = static_cast<size_t>(offset % kBlockSize);
+
+        while (size > 0) {
+            uint32 words[16];
+            compress(words, inputCv, block, blockLength, outputCounter, flags | kRoot);
+
+            byte bytes[kBlockSize];
+            for (size_t i = 0; i < 16; ++i) {
+                details::storeLE(bytes + 4 * i, words[i]);
+            }
+
+            auto const n = std::min(size, kBlockSize - offsetInBlock);
+            memcpy(dest, bytes + offsetInBlock, n);
+            dest += n;
+            size -= n;
+            outputCounter += 1;
+            offsetInBlock = 0;
+        }
+    }
+};
+
+Output parentOutput(byte const block[kBlockSize], uint32 const key[8], uint32 flags) noexcept {
+    return Output{key, block, kBlockSize, 0, flags | kParent};
+}
+
+
+/// Chaining value of a chunk, possibly partial, hashed from scratch.
+void hashChunk(byte const* data, size_t size, uint32 const key[8], uint64 chunkCounter, uint32 flags,
+               byte* out) noexcept {
+    uint32 cv[8];
+    memcpy(cv, key, sizeof(cv));
+
+    auto blockFlags = flags | kChunkStart;
+    for (; size > kBlockSize; data += kBlockSize, size -= kBlockSize) {
+        compressInPlace(cv, data, kBlockSize, chunkCounter, blockFlags);
+        blockFlags = flags;
+    }
+
+    Output{cv, data, size, chunkCounter, blockFlags | kChunkEnd}.chainingValue(out);
+}
+
+
+/// Hash whole chunks several at a time, and the partial last chunk if any. @return Number of chaining values.
+size_t compressChunksParallel(byte const* input, size_t size, uint32 const key[8], uint64 chunkCounter,
+                              uint32 flags, byte* out) noexcept {
+    byte const* chunks[kMaxSimdDegree];
+    size_t count = 0;
+    for (; size >= kChunkSize; input += kChunkSize, size -= kChunkSize) {
+        chunks[count++] = input;
+    }
+
+    hashMany(chunks, count, kChunkSize / kBlockSize, key, chunkCounter, true, flags, kChunkStart, kChunkEnd, out);
+
+    if (size > 0) {
+        hashChunk(input, size, key, chunkCounter + count, flags, out + count * kCvSize);
+        count += 1;
+    }
+
+    return count;
+}
+
+/// Hash pairs of chaining values into parent nodes, passing the odd one through. @return Number of outputs.
+size_t compressParentsParallel(byte const* childCvs, size_t count, uint32 const key[8], uint32 flags,
+                               byte* out) noexcept {
+    byte const* parents[kMaxSimdDegree];
+    size_t parentsCount = 0;
+    for (; count - 2 * parentsCount >= 2; ++parentsCount) {
+        parents[parentsCount] = childCvs + 2 * parentsCount * kCvSize;
+    }
+
+    hashMany(parents, parentsCount, 1, key, 0, false, flags | kParent, 0, 0, out);
+
+    if (count > 2 * parentsCount) {
+        memcpy(out + parentsCount * kCvSize, childCvs + 2 * parentsCount * kCvSize, kCvSize);
+        return parentsCount + 1;
+    }
+
+    return parentsCount;
+}
+
+uint64 roundDownToPowerOf2(uint64 x) noexcept {
+    return uint64{1} << (63 - __builtin_clzll(x | 1));
+}
+
+/**
+ * Hash a subtree of the input, leaving up to simdDegree() (and at least 2) chaining values of its top nodes,
+ * so that the next level can also be hashed several nodes at once.
+ * Left and right halves are hashed in parallel if more threads are allowed.
+ * @return Number of chaining values.
+ */
+size_t compressSubtreeWide(byte const* input, size_t size, uint32 const key[8], uint64 chunkCounter,
+                           uint32 flags, byte* out, uint32 threads) noexcept {
+    auto degree = simdDegree();
+    if (size <= degree * kChunkSize) {
+        return compressChunksParallel(input, size, key, chunkCounter, flags, out);
+    }
+
+    // Left subtree is the largest power of 2 number of chunks that leaves some input for the right one
+    auto const leftSize = static_cast<size_t>(roundDownToPowerOf2((size - 1) / kChunkSize) * kChunkSize);
+    auto const rightSize = size - leftSize;
+    auto const rightChunkCounter = chunkCounter + leftSize / kChunkSize;
+
+    // Left subtree gives exactly degree chaining values, the right one follows them
+    if (leftSize > kChunkSize && degree == 1) {
+        degree = 2;
+    }
+
+    byte cvs[2 * kMaxSimdDegree * kCvSize];
+    auto const rightCvs = cvs + degree * kCvSize;
+
+    size_t leftCount = 0;
+    size_t rightCount = 0;
+    std::thread leftWorker;
+    if (threads > 1 && size >= kMinParallelSize) {
+        auto const leftThreads = threads - threads / 2;
+        try {
+            leftWorker = std::thread{[&, leftThreads]() noexcept {
+                leftCount = compressSubtreeWide(input, leftSize, key, chunkCounter, flags, cvs, leftThreads);
+            }};
+        } catch (std::exception const&) {
+            // Carry on in this thread
+        }
+    }
+
+    if (leftWorker.joinable()) {
+        rightCount = compressSubtreeWide(input + leftSize, rightSize, key, rightChunkCounter, flags, rightCvs,
+                                         threads / 2);
+        leftWorker.join();
+    } else {
+        leftCount = compressSubtreeWide(input, leftSize, key, chunkCounter, flags, cvs, 1);
+        rightCount = compressSubtreeWide(input + leftSize, rightSize, key, rightChunkCounter, flags, rightCvs, 1);
+    }
+
+    // Only possible with degree 1: pass the two chaining values up as they are
+    if (leftCount == 1) {
+        memcpy(out, cvs, 2 * kCvSize);
+        return 2;
+    }
+
+    return compressParentsParallel(cvs, leftCount + rightCount, key, flags, out);
+}
+
+/// Hash a subtree of more than one chunk down to the two chaining values of its root node children.
+void compressSubtreeToParentNode(byte const* input, size_t size, uint32 const key[8], uint64 chunkCounter,
+                                 uint32 flags, byte out[2 * kCvSize], uint32 threads) noexcept {
+    byte cvs[kMaxSimdDegree * kCvSize];
+    auto count = compressSubtreeWide(input, size, key, chunkCounter, flags, cvs, threads);
+
+    byte parents[kMaxSimdDegree * kCvSize / 2];
+    while (count > 2) {
+        count = compressParentsParallel(cvs, count, key, flags, parents);
+        memcpy(cvs, parents, count * kCvSize);
+    }
+
+    memcpy(out, cvs, 2 * kCvSize);
+}
+
+void loadKeyWords(uint32 words[8], byte const* key) noexcept {
+    for (size_t i = 0; i < 8; ++i) {
+        words[i] = details::loadLE<uint32>(key + 4 * i);
+    }
+}
+
+}  // anonymous namespace
+
+
+Blake3::Blake3(uint32 const key[8], uint32 flags) noexcept
+    : _flags{flags}
+{
+    memcpy(_key, key, sizeof(_key));
+    resetChunk(0);
+}
+
+
+Blake3::Blake3() noexcept
+    : Blake3{kIV, 0}
+{
+}
+
+
+Result<Blake3, Error>
+Blake3::keyed(MemoryView key) noexcept {
+    if (key.size() != kKeySize) {
+        return makeError(GenericError::INVAL, "Blake3::keyed()");
+    }
+
+    uint32 keyWords[8];
+    loadKeyWords(keyWords, key.begin());
+
+    return Ok(Blake3{keyWords, kKeyedHash});
+}
+
+
+Blake3
+Blake3::deriveKey(StringView context) noexcept {
+    Blake3 contextHasher{kIV, kDeriveKeyContext};
+    contextHasher.absorb(context.view(), 1);
+
+    byte contextKey[kKeySize];
+    contextHasher.finalize(wrapMemory(contextKey));
+
+    uint32 keyWords[8];
+    loadKeyWords(keyWords, contextKey);
+
+    return Blake3{keyWords, kDeriveKeyMaterial};
+}
+
+
+StringView
+Blake3::getAlgorithm() const {
+    return BLAKE3_NAME;
+}
+
+
+Blake3::size_type
+Blake3::getDigestLength() const {
+    return kDigestSize * 8;
+}
+
+
+HashingAlgorithm&
+Blake3::update(MemoryView input) {
+    absorb(input, 1);
+
+    return (*this);
+}
+
+
+Blake3&
+Blake3::updateParallel(MemoryView input, uint32 maxThreads) {
+    if (maxThreads == 0) {
+        maxThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    absorb(input, maxThreads);
+
+    return (*this);
+}
+
+
+void
+Blake3::digestUnchecked(MutableMemoryView dest) {
+    finalize(dest);
+}
+
+
+void
+Blake3::resetChunk(uint64 chunkCounter) noexcept {
+    memcpy(_cv, _key, sizeof(_cv));
+    _chunkCounter = chunkCounter;
+    _bufferLength = 0;
+    _blocksCompressed = 0;
+}
+
+
+void
+Blake3::updateChunk(byte const* data, size_type size) noexcept {
+    auto startFlag = [this]() {
+        return (_blocksCompressed == 0) ? kChunkStart : 0;
+    };
+
+    // Last block of a chunk is compressed differently, so a full buffer is only compressed when more input follows
+    if (_bufferLength > 0) {
+        auto const n = std::min<size_type>(kBlockSize - _bufferLength, size);
+        memcpy(_buffer + _bufferLength, data, n);
+        _bufferLength += n;
+        data += n;
+        size -= n;
+
+        if (size == 0) {
+            return;
+        }
+
+        compressInPlace(_cv, _buffer, kBlockSize, _chunkCounter, _flags | startFlag());
+        _blocksCompressed += 1;
+        _bufferLength = 0;
+    }
+
+    for (; size > kBlockSize; data += kBlockSize, size -= kBlockSize) {
+        compressInPlace(_cv, data, kBlockSize, _chunkCounter, _flags | startFlag());
+        _blocksCompressed += 1;
+    }
+
+    memcpy(_buffer, data, size);
+    _bufferLength = static_cast<uint32>(size);
+}
+
+
+void
+Blake3::mergeStack(uint64 totalChunks) noexcept {
+    // Number of completed subtrees on the left of a chunk is the number of bits set in the count of chunks before it
+    auto const mergedSize = static_cast<size_type>(__builtin_popcountll(totalChunks));
+    while (_stackSize > mergedSize) {
+        auto const parentBlock = _stack[_stackSize - 2];
+        parentOutput(parentBlock, _key, _flags).chainingValue(parentBlock);
+        _stackSize -= 1;
+    }
+}
+
+
+void
+Blake3::pushChainingValue(byte const* cv, uint64 chunkCounter) noexcept {
+    mergeStack(chunkCounter);
+    memcpy(_stack[_stackSize], cv, kCvSize);
+    _stackSize += 1;
+}
+
+
+void
+Blake3::absorb(MemoryView input, uint32 maxThreads) noexcept {
+    auto data = input.begin();
+    auto size = input.size();
+    if (size == 0) {
+        return;
+    }
+
+    // Fill the current chunk first
+    if (chunkLength() > 0) {
+        auto const n = std::min<size_type>(kChunkSize - chunkLength(), size);
+        updateChunk(data, n);
+        data += n;
+        size -= n;
+
+        if (size == 0) {
+            return;
+        }
+
+        byte cv[kCvSize];
+        Output{_cv, _buffer, _bufferLength, _chunkCounter,
+               _flags | ((_blocksCompressed == 0) ? kChunkStart : 0) | kChunkEnd}.chainingValue(cv);
+        pushChainingValue(cv, _chunkCounter);
+        resetChunk(_chunkCounter + 1);
+    }
+
+    // Hash the largest subtrees that are complete and aligned with the current position, keeping the last chunk
+    while (size > kChunkSize) {
+        auto subtreeSize = roundDownToPowerOf2(size);
+        auto const position = _chunkCounter * kChunkSize;
+        while (((subtreeSize - 1) & position) != 0) {
+            subtreeSize /= 2;
+        }
+
+        auto const subtreeChunks = subtreeSize / kChunkSize;
+        if (subtreeSize <= kChunkSize) {
+            byte cv[kCvSize];
+            hashChunk(data, subtreeSize, _key, _chunkCounter, _flags, cv);
+            pushChainingValue(cv, _chunkCounter);
+        } else {
+            byte cvPair[2 * kCvSize];
+            compressSubtreeToParentNode(data, subtreeSize, _key, _chunkCounter, _flags, cvPair, maxThreads);
+            pushChainingValue(cvPair, _chunkCounter);
+            pushChainingValue(cvPair + kCvSize, _chunkCounter + subtreeChunks / 2);
+        }
+
+        _chunkCounter += subtreeChunks;
+        data += subtreeSize;
+        size -= subtreeSize;
+    }
+
+    if (size > 0) {
+        updateChunk(data, size);
+        mergeStack(_chunkCounter);
+    }
+}
+
+
+void
+Blake3::finalize(MutableMemoryView output, uint64 offset) const noexcept {
+    auto const chunkFlags = _flags | ((_blocksCompressed == 0) ? kChunkStart : 0) | kChunkEnd;
+
+    // Root node is the current chunk if that is all the input, otherwise it's the top of the tree built
+    // by merging all the subtrees on the stack with the current chunk from right to left.
+    auto remaining = _stackSize;
+    Output node{_cv, _buffer, _bufferLength, _chunkCounter, chunkFlags};
+    if (_stackSize > 0 && chunkLength() == 0) {
+        remaining -= 2;
+        node = parentOutput(_stack[remaining], _key, _flags);
+    }
+
+    while (remaining > 0) {
+        remaining -= 1;
+
+        byte parentBlock[kBlockSize];
+        memcpy(parentBlock, _stack[remaining], kCvSize);
+        node.chainingValue(parentBlock + kCvSize);
+        node = parentOutput(parentBlock, _key, _flags);
+    }
+
+    node.rootBytes(offset, output.begin(), output.size());
+}
@@ -0,0 +1,291 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/hashing/crc32c.cpp
+ *	@brief		Implementation of CRC-32C checksum
+ ******************************************************************************/
+#include "solace/hashing/crc32c.hpp"
+#include "solace/byteWriter.hpp"
+
+#include "solace/details/byte_swap.hpp"
+#include "solace/details/cpu_features.hpp"
+
+#include <cstring>  // memcpy
+
+#if defined(SOLACE_X86_DISPATCH)
+#include <immintrin.h>
+#endif
+
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+static const StringLiteral CRC32C_NAME = "CRC32C";
+
+
+namespace /* anonymous */ {
+
+/// Castagnoli polynomial in reflected bit order.
+constexpr uint32 kPolynomial = 0x82F63B78;
+
+
+/**
+ * Multiply two polynomials modulo the CRC polynomial.
+ * Polynomials are in reflected bit order: most significant bit is the coefficient of x^0.
+ */
+constexpr uint32 multiplyModP(uint32 a, uint32 b) noexcept {
+	uint32 product = 0;
+	for (int i = 0; i < 32; ++i) {
+		if (a & 0x80000000) {
+			product ^= b;
+		}
+
+		a <<= 1;
+		b = (b & 1) ? (b >> 1) ^ kPolynomial : b >> 1;
+	}
+
+	return product;
+}
+
+
+/// Powers x^(2^k) modulo the CRC polynomial.
+struct PowersTable {
+	uint32 x2n[32];
+};
+
+constexpr PowersTable makePowersTable() noexcept {
+	PowersTable t{};
+	uint32 p = uint32{1} << 30;  // x^1
+	t.x2n[0] = p;
+	for (int k = 1; k < 32; ++k) {
+		p = multiplyModP(p, p);
+		t.x2n[k] = p;
+	}
+
+	return t;
+}
+
+constexpr PowersTable kPowers = makePowersTable();
+
+
+/// Get x^(8 * n) modulo the CRC polynomial: the operator that appends n zero bytes to a CRC register.
+constexpr uint32 zeroBytesOperator(uint64 n) noexcept {
+	uint32 p = uint32{1} << 31;  // x^0
+	for (uint32 k = 3; n != 0; n >>= 1, ++k) {
+		if (n & 1) {
+			p = multiplyModP(kPowers.x2n[k & 31], p);
+		}
+	}
+
+	return p;
+}
+
+
+/// Lookup tables for slice-by-8 algorithm: table[k][b] is the CRC of byte b followed by k zero bytes.
+struct SliceTables {
+	uint32 table[8][256];
+};
+
+constexpr SliceTables makeSliceTables() noexcept {
+	SliceTables t{};
+	for (uint32 b = 0; b < 256; ++b) {
+		uint32 crc = b;
+		for (int i = 0; i < 8; ++i) {
+			crc = (crc & 1) ? (crc >> 1) ^ kPolynomial : crc >> 1;
+		}
+		t.table[0][b] = crc;
+	}
+
+	for (uint32 b = 0; b < 256; ++b) {
+		for (int k = 1; k < 8; ++k) {
+			auto const prev = t.table[k - 1][b];
+			t.table[k][b] = (prev >> 8) ^ t.table[0][prev & 0xFF];
+		}
+	}
+
+	return t;
+}
+
+constexpr SliceTables kSlice = makeSliceTables();
+
+
+uint32 extendPortable(uint32 crc, byte const* data, size_t size) noexcept {
+	auto const& t = kSlice.table;
+	while (size >= 8) {
+		auto const lo = crc ^ details::loadLE<uint32>(data);
+		auto const hi = details::loadLE<uint32>(data + 4);
+		crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+			  t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+
+		data += 8;
+		size -= 8;
+	}
+
+	while (size-- > 0) {
+		crc = t[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+	}
+
+	return crc;
+}
+
+
+#if defined(SOLACE_X86_DISPATCH)
+
+/**
+ * Operator to append a fixed number of zero bytes to a CRC register, split by register bytes into lookup tables.
+ * Applying it is 4 lookups rather than 32 rounds of multiplyModP().
+ */
+struct ShiftTable {
+	uint32 table[4][256];
+};
+
+constexpr ShiftTable makeShiftTable(uint64 nBytes) noexcept {
+	ShiftTable t{};
+	auto const op = zeroBytesOperator(nBytes);
+	for (uint32 k = 0; k < 4; ++k) {
+		for (uint32 b = 0; b < 256; ++b) {
+			t.table[k][b] = multiplyModP(op, b << (8 * k));
+		}
+	}
+
+	return t;
+}
+
+inline uint32 shift(ShiftTable const& t, uint32 crc) noexcept {
+	return t.table[0][crc & 0xFF] ^ t.table[1][(crc >> 8) & 0xFF] ^
+		   t.table[2][(crc >> 16) & 0xFF] ^ t.table[3][crc >> 24];
+}
+
+
+/// Bytes per stream when data is split into 3 interleaved streams: long one for big inputs, short for the rest.
+constexpr size_t kLongStride = 8192;
+constexpr size_t kShortStride = 256;
+
+constexpr ShiftTable kLongShift = makeShiftTable(kLongStride);
+constexpr ShiftTable kShortShift = makeShiftTable(kShortStride);
+
+
+inline uint64 load64(byte const* p) noexcept {
+	uint64 value;
+	memcpy(&value, p, sizeof(value));
+
+	return value;
+}
+
+
+/**
+ * crc32 instruction has latency of 3 cycles and throughput of 1 per cycle: 3 independent streams keep it busy.
+ * CRCs of the 3 streams are then merged by shifting preceding ones over the length of the following.
+ */
+SOLACE_TARGET("sse4.2")
+uint64 extendInterleaved(uint64 crc, byte const*& data, size_t& size, size_t stride, ShiftTable const& t) noexcept {
+	while (size >= 3 * stride) {
+		uint64 crc1 = 0;
+		uint64 crc2 = 0;
+		auto const end = data + stride;
+		do {
+			crc = _mm_crc32_u64(crc, load64(data));
+			crc1 = _mm_crc32_u64(crc1, load64(data + stride));
+			crc2 = _mm_crc32_u64(crc2, load64(data + 2 * stride));
+			data += 8;
+		} while (data < end);
+
+		crc = shift(t, static_cast<uint32>(crc)) ^ crc1;
+		crc = shift(t, static_cast<uint32>(crc)) ^ crc2;
+
+		data += 2 * stride;
+		size -= 3 * stride;
+	}
+
+	return crc;
+}
+
+
+SOLACE_TARGET("sse4.2")
+uint32 extendSse42(uint32 crc, byte const* data, size_t size) noexcept {
+	uint64 crc0 = crc;
+	while (size > 0 && (reinterpret_cast<uintptr_t>(data) & 7) != 0) {
+		crc0 = _mm_crc32_u8(static_cast<uint32>(crc0), *data++);
+		--size;
+	}
+
+	crc0 = extendInterleaved(crc0, data, size, kLongStride, kLongShift);
+	crc0 = extendInterleaved(crc0, data, size, kShortStride, kShortShift);
+
+	while (size >= 8) {
+		crc0 = _mm_crc32_u64(crc0, load64(data));
+		data += 8;
+		size -= 8;
+	}
+
+	while (size-- > 0) {
+		crc0 = _mm_crc32_u8(static_cast<uint32>(crc0), *data++);
+	}
+
+	return static_cast<uint32>(crc0);
+}
+
+#endif  // SOLACE_X86_DISPATCH
+
+}  // anonymous namespace
+
+
+uint32
+Crc32c::compute(MemoryView data, uint32 crc) noexcept {
+	auto const raw = ~crc;
+
+#if defined(SOLACE_X86_DISPATCH)
+	if (details::cpuFeatures().sse42) {
+		return ~extendSse42(raw, data.begin(), data.size());
+	}
+#endif
+
+	return ~extendPortable(raw, data.begin(), data.size());
+}
+
+
+uint32
+Crc32c::combine(uint32 crcA, uint32 crcB, uint64 lengthB) noexcept {
+	return multiplyModP(zeroBytesOperator(lengthB), crcA) ^ crcB;
+}
+
+
+StringView
+Crc32c::getAlgorithm() const {
+	return CRC32C_NAME;
+}
+
+
+Crc32c::size_type
+Crc32c::getDigestLength() const {
+	return 32;
+}
+
+
+HashingAlgorithm&
+Crc32c::update(MemoryView input) {
+	_crc = compute(input, _crc);
+
+	return (*this);
+}
+
+
+void
+Crc32c::digestUnchecked(MutableMemoryView dest) {
+	ByteWriter writer{dest};
+	writer.writeBE(_crc);
+}
@@ -41,9 +41,7 @@ void md5_process(MD5::State& ctx, const byte data[64]) {
     uint32 X[16], A, B, C, D;
 
     ByteReader reader{wrapMemory(data, 64)};
-    for (auto& x : X) {
-        reader.readLE(x);
-    }
+    reader.readLE(X);
 
 #define S(x, n) ((x << n) | ((x & 0xFFFFFFFF) >> (32 - n)))
 #define F(x, y, z) (z ^ (x & (y ^ z)))
@@ -209,9 +207,8 @@ MD5::update(MemoryView input) {
 }
 
 
-MessageDigest MD5::digest() {
-    byte result[16];
-    ByteWriter writer{wrapMemory(result)};
+void MD5::digestUnchecked(MutableMemoryView dest) {
+    ByteWriter writer{dest};
 
     uint32 const high = (_state.bits[0] >> 29) | (_state.bits[1] <<  3);
     uint32 const low  = (_state.bits[0] <<  3);
@@ -231,6 +228,4 @@ MessageDigest MD5::digest() {
     writer.writeLE(_state.state[1]);
     writer.writeLE(_state.state[2]);
     writer.writeLE(_state.state[3]);
-
-    return MessageDigest(writer.viewWritten());
 }
@@ -0,0 +1,500 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		hashing/parallelHasher.cpp
+ *	@brief		Implementation of hashing of large buffers and files using several threads.
+ ******************************************************************************/
+#include "solace/hashing/parallelHasher.hpp"
+#include "solace/hashing/blake3.hpp"
+#include "solace/hashing/sha2.hpp"
+#include "solace/hashing/hasher.hpp"
+
+#include "solace/memoryManager.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>  // memcpy
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <climits>  // PATH_MAX
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+
+namespace {
+
+using size_type = ParallelHasher::size_type;
+using Digest = ParallelHasher::Digest;
+
+/// Input smaller than this is not worth starting a thread for.
+constexpr size_type kMinParallelSize = 256 * 1024;
+
+/// Pages are faulted in by reading a byte of each.
+constexpr size_type kPageSize = 4096;
+
+constexpr byte kLeafPrefix[] = {0x00};
+constexpr byte kNodePrefix[] = {0x01};
+
+
+/// Owner of a file descriptor.
+class FileDescriptor {
+public:
+    explicit FileDescriptor(int fd) noexcept
+        : _fd{fd}
+    {}
+
+    FileDescriptor(FileDescriptor&& rhs) noexcept
+        : _fd{std::exchange(rhs._fd, -1)}
+    {}
+
+    FileDescriptor(FileDescriptor const&) = delete;
+    FileDescriptor& operator= (FileDescriptor const&) = delete;
+
+    ~FileDescriptor() {
+        if (_fd >= 0) {
+            ::close(_fd);
+        }
+    }
+
+    int get() const noexcept { return _fd; }
+
+private:
+    int _fd;
+};
+
+
+/// Read-only memory mapping of a whole file.
+class MappedFile {
+public:
+    MappedFile(void* address, size_type size) noexcept
+        : _address{address}
+        , _size{size}
+    {}
+
+    MappedFile(MappedFile&& rhs) noexcept
+        : _address{std::exchange(rhs._address, nullptr)}
+        , _size{std::exchange(rhs._size, 0)}
+    {}
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator= (MappedFile const&) = delete;
+
+    ~MappedFile() {
+        if (_address) {
+            ::munmap(_address, _size);
+        }
+    }
+
+    MemoryView view() const noexcept { return wrapMemory(_address, _size); }
+
+private:
+    void*       _address;
+    size_type   _size;
+};
+
+
+Result<FileDescriptor, Error>
+openFile(StringView path) {
+    // Path must be NUL-terminated for open()
+    char pathBuffer[PATH_MAX];
+    if (path.size() >= sizeof(pathBuffer)) {
+        return makeError(SystemErrors::NameTooLong, "ParallelHasher: path");
+    }
+
+    memcpy(pathBuffer, path.data(), path.size());
+    pathBuffer[path.size()] = 0;
+
+    auto const fd = ::open(pathBuffer, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return makeErrno("open()");
+    }
+
+    return Ok(FileDescriptor{fd});
+}
+
+
+Result<MappedFile, Error>
+mapFile(StringView path) {
+    auto maybeFile = openFile(path);
+    if (!maybeFile) {
+        return maybeFile.moveError();
+    }
+
+    auto const fd = maybeFile.unwrap().get();
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0) {
+        return makeErrno("fstat()");
+    }
+    if (!S_ISREG(fileStat.st_mode)) {
+        return makeError(GenericError::INVAL, "ParallelHasher: not a regular file");
+    }
+
+    auto const size = static_cast<size_type>(fileStat.st_size);
+    if (size == 0) {  // Empty mapping is not allowed
+        return Ok(MappedFile{nullptr, 0});
+    }
+
+    auto const address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED) {
+        return makeErrno("mmap()");
+    }
+
+    // Start reading the file in the background: threads are going to fault in pages all over it
+    ::madvise(address, size, MADV_WILLNEED);
+
+    return Ok(MappedFile{address, size});
+}
+
+
+uint64 roundDownToPowerOf2(uint64 x) noexcept {
+    return uint64{1} << (63 - __builtin_clzll(x | 1));
+}
+
+
+Digest merkleLeaf(MemoryView chunk) {
+    Hasher<Sha256> hasher;
+    hasher.update(wrapMemory(kLeafPrefix, sizeof(kLeafPrefix)));
+    hasher.update(chunk);
+
+    return hasher.digest();
+}
+
+
+Digest merkleNode(Digest const& left, Digest const& right) {
+    Hasher<Sha256> hasher;
+    hasher.update(wrapMemory(kNodePrefix, sizeof(kNodePrefix)));
+    hasher.update(left.view());
+    hasher.update(right.view());
+
+    return hasher.digest();
+}
+
+
+/**
+ * Compute root of a subtree of at least one leaf.
+ * Left and right subtrees are hashed in parallel if more threads are allowed,
+ * with threads split between them in proportion to their size.
+ */
+Digest merkleSubtree(MemoryView input, size_type chunkSize, uint64 leafCount, uint32 threads) {
+    if (leafCount == 1) {
+        return merkleLeaf(input);
+    }
+
+    // Left subtree has the largest power of 2 number of leaves that leaves some for the right one
+    auto const leftLeaves = roundDownToPowerOf2(leafCount - 1);
+    auto const leftSize = static_cast<size_type>(leftLeaves * chunkSize);
+    auto const left = input.slice(0, leftSize);
+    auto const right = input.slice(leftSize, input.size());
+
+    Digest leftRoot;
+    Digest rightRoot;
+    std::thread leftWorker;
+    if (threads > 1 && input.size() >= kMinParallelSize) {
+        auto const share = static_cast<uint32>(static_cast<double>(threads) * leftSize / input.size() + 0.5);
+        auto const leftThreads = std::min(std::max(share, 1U), threads - 1);
+        try {
+            leftWorker = std::thread{[&, leftThreads]() noexcept {
+                leftRoot = merkleSubtree(left, chunkSize, leftLeaves, leftThreads);
+            }};
+        } catch (std::exception const&) {
+            // Carry on in this thread
+        }
+
+        if (leftWorker.joinable()) {
+            rightRoot = merkleSubtree(right, chunkSize, leafCount - leftLeaves, threads - leftThreads);
+            leftWorker.join();
+
+            return merkleNode(leftRoot, rightRoot);
+        }
+    }
+
+    leftRoot = merkleSubtree(left, chunkSize, leftLeaves, 1);
+    rightRoot = merkleSubtree(right, chunkSize, leafCount - leftLeaves, 1);
+
+    return merkleNode(leftRoot, rightRoot);
+}
+
+
+/**
+ * Run a single producer single consumer pipeline: a helper thread produces windows of input
+ * at most kPipelineDepth ahead of the calling thread that consumes them.
+ * If a thread can not be started, windows are produced and consumed in turn by the calling thread.
+ * If consume throws, the helper thread is stopped and joined before the exception is rethrown.
+ *
+ * @param produce Function that prepares window of the given index and returns its size in bytes,
+ * 0 at the end of input or -errno on failure.
+ * @param consume Function that consumes window of the given index and size.
+ * @return 0 or errno of the failure to produce a window.
+ */
+template<typename Produce, typename Consume>
+int runPipeline(uint32 threads, Produce&& produce, Consume&& consume) {
+    constexpr auto kDepth = ParallelHasher::kPipelineDepth;
+
+    std::mutex mutex;
+    std::condition_variable windowReady;
+    std::condition_variable slotFree;
+    uint64 produced = 0;
+    uint64 consumed = 0;
+    bool finished = false;
+    bool cancelled = false;
+    int64 status = 0;
+    size_type sizes[kDepth];
+
+    std::thread producer;
+    if (threads > 1) {
+        try {
+            producer = std::thread{[&]() {
+                for (uint64 i = 0; ; ++i) {
+                    {
+                        std::unique_lock<std::mutex> lock{mutex};
+                        slotFree.wait(lock, [&]() { return produced - consumed < kDepth || cancelled; });
+                        if (cancelled) {
+                            break;
+                        }
+                    }
+
+                    auto const result = produce(i);
+                    {
+                        std::lock_guard<std::mutex> lock{mutex};
+                        if (result > 0) {
+                            sizes[i % kDepth] = static_cast<size_type>(result);
+                            produced = i + 1;
+                        } else {
+                            status = result;
+                            finished = true;
+                        }
+                    }
+                    windowReady.notify_one();
+
+                    if (result <= 0) {
+                        break;
+                    }
+                }
+            }};
+        } catch (std::exception const&) {
+            // Carry on in this thread
+        }
+    }
+
+    if (!producer.joinable()) {
+        for (uint64 i = 0; ; ++i) {
+            auto const result = produce(i);
+            if (result <= 0) {
+                return static_cast<int>(-result);
+            }
+
+            consume(i, static_cast<size_type>(result));
+        }
+    }
+
+    for (uint64 i = 0; ; ++i) {
+        size_type size;
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            windowReady.wait(lock, [&]() { return produced > i || finished; });
+            if (produced <= i) {
+                break;
+            }
+            size = sizes[i % kDepth];
+        }
+
+        try {
+            consume(i, size);
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                cancelled = true;
+                finished = true;
+            }
+            slotFree.notify_all();
+            windowReady.notify_all();
+            producer.join();
+            throw;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            consumed = i + 1;
+        }
+        slotFree.notify_one();
+    }
+
+    producer.join();
+
+    return static_cast<int>(-status);
+}
+
+
+/// Read up to size bytes, less only at the end of file. @return Number of bytes read or -errno.
+int64 readFully(int fd, byte* dest, size_type size) noexcept {
+    size_type total = 0;
+    while (total < size) {
+        auto const result = ::read(fd, dest + total, size - total);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -errno;
+        }
+        if (result == 0) {
+            break;
+        }
+
+        total += static_cast<size_type>(result);
+    }
+
+    return static_cast<int64>(total);
+}
+
+}  // namespace
+
+
+ParallelHasher::ParallelHasher(uint32 maxThreads) noexcept
+    : _threads{(maxThreads != 0) ? maxThreads : std::max(std::thread::hardware_concurrency(), 1U)}
+{
+}
+
+
+ParallelHasher::Digest
+ParallelHasher::blake3(MemoryView input) const {
+    Blake3 algorithm;
+    algorithm.updateParallel(input, _threads);
+
+    return fixedDigest(algorithm);
+}
+
+
+Result<ParallelHasher::Digest, Error>
+ParallelHasher::blake3File(StringView path) const {
+    auto maybeMapping = mapFile(path);
+    if (!maybeMapping) {
+        return maybeMapping.moveError();
+    }
+
+    return Ok(blake3(maybeMapping.unwrap().view()));
+}
+
+
+Result<ParallelHasher::Digest, Error>
+ParallelHasher::sha256Merkle(MemoryView input, size_type chunkSize) const {
+    if (chunkSize == 0) {
+        return makeError(GenericError::INVAL, "ParallelHasher::sha256Merkle(): chunkSize");
+    }
+
+    if (input.empty()) {
+        return Ok(hash<Sha256>(input));
+    }
+
+    auto const leafCount = uint64{input.size() / chunkSize} + ((input.size() % chunkSize) != 0);
+
+    return Ok(merkleSubtree(input, chunkSize, leafCount, _threads));
+}
+
+
+Result<ParallelHasher::Digest, Error>
+ParallelHasher::sha256MerkleFile(StringView path, size_type chunkSize) const {
+    if (chunkSize == 0) {
+        return makeError(GenericError::INVAL, "ParallelHasher::sha256MerkleFile(): chunkSize");
+    }
+
+    auto maybeMapping = mapFile(path);
+    if (!maybeMapping) {
+        return maybeMapping.moveError();
+    }
+
+    return sha256Merkle(maybeMapping.unwrap().view(), chunkSize);
+}
+
+
+HashingAlgorithm&
+ParallelHasher::pipelined(HashingAlgorithm& algorithm, MemoryView input) const {
+    if (_threads < 2 || input.size() < 2 * kWindowSize) {
+        return algorithm.update(input);
+    }
+
+    auto const size = input.size();
+    auto const data = static_cast<byte const*>(input.dataAddress());
+    runPipeline(_threads,
+                [size, data](uint64 index) -> int64 {
+                    auto const offset = index * kWindowSize;
+                    if (offset >= size) {
+                        return 0;
+                    }
+
+                    auto const end = std::min<size_type>(offset + kWindowSize, size);
+                    for (auto page = offset; page < end; page += kPageSize) {
+                        static_cast<void>(*static_cast<byte const volatile*>(data + page));
+                    }
+
+                    return static_cast<int64>(end - offset);
+                },
+                [&algorithm, input](uint64 index, size_type windowSize) {
+                    auto const offset = index * kWindowSize;
+                    algorithm.update(input.slice(offset, offset + windowSize));
+                });
+
+    return algorithm;
+}
+
+
+Result<void, Error>
+ParallelHasher::pipelinedFile(HashingAlgorithm& algorithm, StringView path) const {
+    auto maybeFile = openFile(path);
+    if (!maybeFile) {
+        return maybeFile.moveError();
+    }
+
+    auto maybeBuffer = getSystemHeapMemoryManager().allocate(kPipelineDepth * kWindowSize);
+    if (!maybeBuffer) {
+        return maybeBuffer.moveError();
+    }
+
+    auto const fd = maybeFile.unwrap().get();
+#if defined(POSIX_FADV_SEQUENTIAL)
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#elif defined(F_RDAHEAD)  // Darwin has no posix_fadvise()
+    ::fcntl(fd, F_RDAHEAD, 1);
+#endif
+
+    auto buffer = maybeBuffer.unwrap().view();
+    auto const errorCode = runPipeline(_threads,
+                [fd, &buffer](uint64 index) {
+                    auto const slot = (index % kPipelineDepth) * kWindowSize;
+                    return readFully(fd, static_cast<byte*>(buffer.dataAddress()) + slot, kWindowSize);
+                },
+                [&algorithm, &buffer](uint64 index, size_type windowSize) {
+                    auto const slot = (index % kPipelineDepth) * kWindowSize;
+                    algorithm.update(buffer.slice(slot, slot + windowSize));
+                });
+
+    if (errorCode != 0) {
+        return makeSystemError(errorCode, "read()");
+    }
+
+    return Ok();
+}
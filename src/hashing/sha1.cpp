@@ -20,8 +20,15 @@
  ******************************************************************************/
 #include "solace/hashing/sha1.hpp"
 
+#include "solace/details/byte_swap.hpp"
+#include "solace/details/cpu_features.hpp"
+
 #include <cstring>  // memcpy
 
+#if defined(SOLACE_X86_DISPATCH)
+#include <immintrin.h>
+#endif
+
 
 using namespace Solace;
 using namespace Solace::hashing;
@@ -37,13 +44,14 @@ static const byte sha1_padding[64] = {
 };
 
 
+namespace /* anonymous */ {
+
 SOLACE_NO_SANITIZE("unsigned-integer-overflow")
-void sha1_process(Sha1::State& ctx, byte const data[64]) {
+void sha1ProcessBlock(uint32 state[5], byte const* data) noexcept {
     uint32 temp, W[16], A, B, C, D, E;
 
-    ByteReader reader{wrapMemory(data, 64)};
-    for (auto& x : W) {
-        reader.readBE(x);
+    for (uint32 i = 0; i < 16; ++i) {
+        W[i] = details::loadBE<uint32>(data + 4 * i);
     }
 
 
@@ -59,11 +67,11 @@ void sha1_process(Sha1::State& ctx, byte const data[64]) {
 #define P(a, b, c, d, e, x)                                  \
 { e += S(a, 5) + F(b, c, d) + K + x; b = S(b, 30); }
 
-    A = ctx.state[0];
-    B = ctx.state[1];
-    C = ctx.state[2];
-    D = ctx.state[3];
-    E = ctx.state[4];
+    A = state[0];
+    B = state[1];
+    C = state[2];
+    D = state[3];
+    E = state[4];
 
 #define F(x, y, z) (z ^ (x & (y ^ z)))
 #define K 0x5A827999
@@ -173,11 +181,253 @@ void sha1_process(Sha1::State& ctx, byte const data[64]) {
 #undef K
 #undef F
 
-    ctx.state[0] += A;
-    ctx.state[1] += B;
-    ctx.state[2] += C;
-    ctx.state[3] += D;
-    ctx.state[4] += E;
+    state[0] += A;
+    state[1] += B;
+    state[2] += C;
+    state[3] += D;
+    state[4] += E;
+}
+
+
+#if defined(SOLACE_X86_DISPATCH)
+
+static const uint32 kRoundConstants[4] = {0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6};
+
+/**
+ * Run 80 rounds over a message schedule computed in advance, with round constants already added.
+ * Rounds are inherently serial, so vector units only help to compute the schedule.
+ */
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+void sha1Rounds(uint32 state[5], uint32 const WK[80]) noexcept {
+    uint32 A = state[0];
+    uint32 B = state[1];
+    uint32 C = state[2];
+    uint32 D = state[3];
+    uint32 E = state[4];
+
+#define K 0
+#define F(x, y, z) (z ^ (x & (y ^ z)))
+    for (uint32 i = 0; i < 20; i += 5) {
+        P(A, B, C, D, E, WK[i + 0]);
+        P(E, A, B, C, D, WK[i + 1]);
+        P(D, E, A, B, C, WK[i + 2]);
+        P(C, D, E, A, B, WK[i + 3]);
+        P(B, C, D, E, A, WK[i + 4]);
+    }
+#undef F
+
+#define F(x, y, z) (x ^ y ^ z)
+    for (uint32 i = 20; i < 40; i += 5) {
+        P(A, B, C, D, E, WK[i + 0]);
+        P(E, A, B, C, D, WK[i + 1]);
+        P(D, E, A, B, C, WK[i + 2]);
+        P(C, D, E, A, B, WK[i + 3]);
+        P(B, C, D, E, A, WK[i + 4]);
+    }
+#undef F
+
+#define F(x, y, z) ((x & y) | (z & (x | y)))
+    for (uint32 i = 40; i < 60; i += 5) {
+        P(A, B, C, D, E, WK[i + 0]);
+        P(E, A, B, C, D, WK[i + 1]);
+        P(D, E, A, B, C, WK[i + 2]);
+        P(C, D, E, A, B, WK[i + 3]);
+        P(B, C, D, E, A, WK[i + 4]);
+    }
+#undef F
+
+#define F(x, y, z) (x ^ y ^ z)
+    for (uint32 i = 60; i < 80; i += 5) {
+        P(A, B, C, D, E, WK[i + 0]);
+        P(E, A, B, C, D, WK[i + 1]);
+        P(D, E, A, B, C, WK[i + 2]);
+        P(C, D, E, A, B, WK[i + 3]);
+        P(B, C, D, E, A, WK[i + 4]);
+    }
+#undef F
+#undef K
+
+    state[0] += A;
+    state[1] += B;
+    state[2] += C;
+    state[3] += D;
+    state[4] += E;
+}
+
+
+SOLACE_TARGET("ssse3")
+inline __m128i rotl1(__m128i x) noexcept {
+    return _mm_or_si128(_mm_slli_epi32(x, 1), _mm_srli_epi32(x, 31));
+}
+
+/// Compute the next 4 schedule words W[t..t+3] from the previous 16 held in w0 (oldest) to w3.
+SOLACE_TARGET("ssse3")
+inline __m128i nextWords(__m128i w0, __m128i w1, __m128i w2, __m128i w3) noexcept {
+    // rol1(W[t-16] ^ W[t-14] ^ W[t-8] ^ W[t-3]), where W[t-3] of the last word is the first word of the same group.
+    // As rotation distributes over xor, that term is added once the first word is known.
+    auto const x = rotl1(_mm_xor_si128(_mm_xor_si128(w0, _mm_alignr_epi8(w1, w0, 8)),
+                                       _mm_xor_si128(w2, _mm_srli_si128(w3, 4))));
+    return _mm_xor_si128(x, rotl1(_mm_slli_si128(x, 12)));
+}
+
+SOLACE_TARGET("ssse3")
+void sha1ScheduleSsse3(uint32 WK[80], byte const* data) noexcept {
+    __m128i const bswapMask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i w[20];
+    for (int i = 0; i < 4; ++i) {
+        w[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 16 * i)), bswapMask);
+    }
+    for (int i = 4; i < 20; ++i) {
+        w[i] = nextWords(w[i - 4], w[i - 3], w[i - 2], w[i - 1]);
+    }
+
+    for (int i = 0; i < 20; ++i) {
+        auto const k = _mm_set1_epi32(static_cast<int>(kRoundConstants[i / 5]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(WK + 4 * i), _mm_add_epi32(w[i], k));
+    }
+}
+
+
+SOLACE_TARGET("avx2")
+inline __m256i rotl1(__m256i x) noexcept {
+    return _mm256_or_si256(_mm256_slli_epi32(x, 1), _mm256_srli_epi32(x, 31));
+}
+
+/// Same as the SSSE3 version: AVX2 byte shifts and alignr work within 128 bit lanes, one block per lane.
+SOLACE_TARGET("avx2")
+inline __m256i nextWords(__m256i w0, __m256i w1, __m256i w2, __m256i w3) noexcept {
+    auto const x = rotl1(_mm256_xor_si256(_mm256_xor_si256(w0, _mm256_alignr_epi8(w1, w0, 8)),
+                                          _mm256_xor_si256(w2, _mm256_srli_si256(w3, 4))));
+    return _mm256_xor_si256(x, rotl1(_mm256_slli_si256(x, 12)));
+}
+
+/// Compute message schedules of two blocks at once.
+SOLACE_TARGET("avx2")
+void sha1ScheduleAvx2(uint32 WK0[80], uint32 WK1[80], byte const* data) noexcept {
+    __m256i const bswapMask = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL,
+                                                0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m256i w[20];
+    for (int i = 0; i < 4; ++i) {
+        auto const lo = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 16 * i));
+        auto const hi = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 64 + 16 * i));
+        w[i] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), bswapMask);
+    }
+    for (int i = 4; i < 20; ++i) {
+        w[i] = nextWords(w[i - 4], w[i - 3], w[i - 2], w[i - 1]);
+    }
+
+    for (int i = 0; i < 20; ++i) {
+        auto const wk = _mm256_add_epi32(w[i], _mm256_set1_epi32(static_cast<int>(kRoundConstants[i / 5])));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(WK0 + 4 * i), _mm256_castsi256_si128(wk));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(WK1 + 4 * i), _mm256_extracti128_si256(wk, 1));
+    }
+}
+
+void sha1ProcessScheduled(uint32 state[5], byte const* data, size_t blocks, bool useAvx2) noexcept {
+    uint32 WK[2][80];
+
+    if (useAvx2) {
+        for (; blocks >= 2; blocks -= 2, data += 128) {
+            sha1ScheduleAvx2(WK[0], WK[1], data);
+            sha1Rounds(state, WK[0]);
+            sha1Rounds(state, WK[1]);
+        }
+    }
+
+    for (; blocks > 0; --blocks, data += 64) {
+        sha1ScheduleSsse3(WK[0], data);
+        sha1Rounds(state, WK[0]);
+    }
+}
+
+
+/// Four rounds with SHA extensions. E for the next four rounds is derived from A before these ones.
+template<int Func>
+SOLACE_TARGET("sha,sse4.1")
+inline void sha1Rounds4(__m128i& abcd, __m128i& e, __m128i w) noexcept {
+    auto const ew = _mm_sha1nexte_epu32(e, w);
+    e = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, ew, Func);
+}
+
+SOLACE_TARGET("sha,sse4.1")
+inline __m128i sha1NextWords(__m128i w0, __m128i w1, __m128i w2, __m128i w3) noexcept {
+    return _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(w0, w1), w2), w3);
+}
+
+SOLACE_TARGET("sha,sse4.1")
+void sha1ProcessShaNi(uint32 state[5], byte const* data, size_t blocks) noexcept {
+    // SHA instructions expect the first word in the most significant lane, so reverse words order as well
+    __m128i const bswapMask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0x1B);
+    auto e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+
+    for (; blocks > 0; --blocks, data += 64) {
+        auto const abcdSaved = abcd;
+        auto const e0Saved = e0;
+
+        auto w0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data +  0)), bswapMask);
+        auto w1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 16)), bswapMask);
+        auto w2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 32)), bswapMask);
+        auto w3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 48)), bswapMask);
+
+        // Rounds 0-3 use E of the state directly
+        auto e = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, _mm_add_epi32(e0, w0), 0);
+        sha1Rounds4<0>(abcd, e, w1);
+        sha1Rounds4<0>(abcd, e, w2);
+        sha1Rounds4<0>(abcd, e, w3);
+        w0 = sha1NextWords(w0, w1, w2, w3);     sha1Rounds4<0>(abcd, e, w0);
+
+        w1 = sha1NextWords(w1, w2, w3, w0);     sha1Rounds4<1>(abcd, e, w1);
+        w2 = sha1NextWords(w2, w3, w0, w1);     sha1Rounds4<1>(abcd, e, w2);
+        w3 = sha1NextWords(w3, w0, w1, w2);     sha1Rounds4<1>(abcd, e, w3);
+        w0 = sha1NextWords(w0, w1, w2, w3);     sha1Rounds4<1>(abcd, e, w0);
+        w1 = sha1NextWords(w1, w2, w3, w0);     sha1Rounds4<1>(abcd, e, w1);
+
+        w2 = sha1NextWords(w2, w3, w0, w1);     sha1Rounds4<2>(abcd, e, w2);
+        w3 = sha1NextWords(w3, w0, w1, w2);     sha1Rounds4<2>(abcd, e, w3);
+        w0 = sha1NextWords(w0, w1, w2, w3);     sha1Rounds4<2>(abcd, e, w0);
+        w1 = sha1NextWords(w1, w2, w3, w0);     sha1Rounds4<2>(abcd, e, w1);
+        w2 = sha1NextWords(w2, w3, w0, w1);     sha1Rounds4<2>(abcd, e, w2);
+
+        w3 = sha1NextWords(w3, w0, w1, w2);     sha1Rounds4<3>(abcd, e, w3);
+        w0 = sha1NextWords(w0, w1, w2, w3);     sha1Rounds4<3>(abcd, e, w0);
+        w1 = sha1NextWords(w1, w2, w3, w0);     sha1Rounds4<3>(abcd, e, w1);
+        w2 = sha1NextWords(w2, w3, w0, w1);     sha1Rounds4<3>(abcd, e, w2);
+        w3 = sha1NextWords(w3, w0, w1, w2);     sha1Rounds4<3>(abcd, e, w3);
+
+        e0 = _mm_sha1nexte_epu32(e, e0Saved);
+        abcd = _mm_add_epi32(abcd, abcdSaved);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = static_cast<uint32>(_mm_extract_epi32(e0, 3));
+}
+
+#endif  // SOLACE_X86_DISPATCH
+
+
+/// Process whole 64 byte blocks with the best implementation CPU supports.
+void sha1_process(Sha1::State& ctx, byte const* data, size_t blocks) noexcept {
+#if defined(SOLACE_X86_DISPATCH)
+    auto const& cpu = details::cpuFeatures();
+    if (cpu.sha && cpu.sse41) {
+        sha1ProcessShaNi(ctx.state, data, blocks);
+        return;
+    }
+    if (cpu.ssse3) {
+        sha1ProcessScheduled(ctx.state, data, blocks, cpu.avx2);
+        return;
+    }
+#endif
+
+    for (; blocks > 0; --blocks, data += 64) {
+        sha1ProcessBlock(ctx.state, data);
+    }
 }
 
 
@@ -197,17 +447,17 @@ void sha1_update(Sha1::State& ctx, const byte input[], Sha1::size_type ilen) {
 
     if (left && ilen >= fill) {
         memcpy((ctx.buffer + left), input, fill);
-        sha1_process(ctx, ctx.buffer);
+        sha1_process(ctx, ctx.buffer, 1);
 
         input += fill;
         ilen  -= fill;
         left = 0;
     }
 
-    while (ilen >= 64) {
-        sha1_process(ctx, input);
-        input += 64;
-        ilen  -= 64;
+    if (ilen >= 64) {
+        sha1_process(ctx, input, ilen / 64);
+        input += ilen & ~Sha1::size_type{0x3F};
+        ilen  &= 0x3F;
     }
 
     if (ilen > 0) {
@@ -215,6 +465,8 @@ void sha1_update(Sha1::State& ctx, const byte input[], Sha1::size_type ilen) {
     }
 }
 
+}  // anonymous namespace
+
 
 Sha1::Sha1() noexcept {
     /* SHA1 initialization constants */
@@ -246,9 +498,8 @@ HashingAlgorithm& Sha1::update(MemoryView input) {
 }
 
 
-MessageDigest Sha1::digest() {
-    byte result[20];
-    ByteWriter writer{wrapMemory(result)};
+void Sha1::digestUnchecked(MutableMemoryView dest) {
+    ByteWriter writer{dest};
 
     uint32 const high = (_state.total[0] >> 29) | (_state.total[1] <<  3);
     uint32 const low = (_state.total[0] <<  3);
@@ -267,6 +518,4 @@ MessageDigest Sha1::digest() {
     for (auto s : _state.state) {
         writer.writeBE(s);
     }
-
-    return MessageDigest(writer.viewWritten());
 }
@@ -20,8 +20,18 @@
  ******************************************************************************/
 #include "solace/hashing/sha2.hpp"
 
+#include "solace/posixErrorDomain.hpp"
+
+#include "solace/details/byte_swap.hpp"
+#include "solace/details/cpu_features.hpp"
+
+#include <algorithm>
 #include <cstring>  // memcpy
 
+#if defined(SOLACE_X86_DISPATCH)
+#include <immintrin.h>
+#endif
+
 
 using namespace Solace;
 using namespace Solace::hashing;
@@ -86,66 +96,290 @@ static const uint32 K[64] = {
 }
 
 
+namespace /* anonymous */ {
+
 SOLACE_NO_SANITIZE("unsigned-integer-overflow")
-void sha256_process(Sha256::State& ctx, byte const data[64]) {
+void sha256ProcessPortable(uint32 state[8], byte const* data, size_t blocks) noexcept {
     uint32 temp1, temp2, W[64];
     uint32 A[8];
     uint32 i;
 
-//    memcpy(A, ctx.state, 8 * sizeof(A));
-    for (i = 0; i < 8; ++i) {
-        A[i] = ctx.state[i];
-    }
+    for (; blocks > 0; --blocks, data += 64) {
+        for (i = 0; i < 8; ++i) {
+            A[i] = state[i];
+        }
 
-    ByteReader reader{wrapMemory(data, 64)};
+        for (i = 0; i < 16; ++i) {
+            W[i] = details::loadBE<uint32>(data + 4 * i);
+        }
 
 #if defined(SOLACE_SHA256_SMALLER)
-    for (i = 0; i < 64; i++) {
-        if (i < 16) {
-            reader.readBE(W[i]);
-        } else {
-            R(i);
+        for (i = 0; i < 64; i++) {
+            if (i >= 16) {
+                R(i);
+            }
+
+            P(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], W[i], K[i]);
+
+            temp1 = A[7]; A[7] = A[6]; A[6] = A[5]; A[5] = A[4]; A[4] = A[3];
+            A[3] = A[2]; A[2] = A[1]; A[1] = A[0]; A[0] = temp1;
         }
+#else /* SOLACE_SHA256_SMALLER */
 
-        P(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], W[i], K[i]);
+        for (i = 0; i < 16; i += 8) {
+            P(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], W[i+0], K[i+0]);
+            P(A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], W[i+1], K[i+1]);
+            P(A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], W[i+2], K[i+2]);
+            P(A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], W[i+3], K[i+3]);
+            P(A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], W[i+4], K[i+4]);
+            P(A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], W[i+5], K[i+5]);
+            P(A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], W[i+6], K[i+6]);
+            P(A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], W[i+7], K[i+7]);
+        }
+
+        for (i = 16; i < 64; i += 8) {
+            P(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], R(i+0), K[i+0]);
+            P(A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], R(i+1), K[i+1]);
+            P(A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], R(i+2), K[i+2]);
+            P(A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], R(i+3), K[i+3]);
+            P(A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], R(i+4), K[i+4]);
+            P(A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], R(i+5), K[i+5]);
+            P(A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], R(i+6), K[i+6]);
+            P(A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], R(i+7), K[i+7]);
+        }
+#endif /* SOLACE_SHA256_SMALLER */
 
-        temp1 = A[7]; A[7] = A[6]; A[6] = A[5]; A[5] = A[4]; A[4] = A[3];
-        A[3] = A[2]; A[2] = A[1]; A[1] = A[0]; A[0] = temp1;
+        for (i = 0; i < 8; ++i) {
+            state[i] += A[i];
+        }
     }
-#else /* SOLACE_SHA256_SMALLER */
+}
+
+
+#if defined(SOLACE_X86_DISPATCH)
+
+/**
+ * Run 64 rounds over a message schedule computed in advance, with round constants already added.
+ * Rounds are inherently serial, so vector units only help to compute the schedule.
+ */
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+void sha256Rounds(uint32 state[8], uint32 const WK[64]) noexcept {
+    uint32 temp1, temp2;
+    uint32 A[8];
 
-    for (i = 0; i < 16; ++i) {
-        reader.readBE(W[i]);
+    for (uint32 i = 0; i < 8; ++i) {
+        A[i] = state[i];
     }
 
-    for (i = 0; i < 16; i += 8) {
-        P(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], W[i+0], K[i+0]);
-        P(A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], W[i+1], K[i+1]);
-        P(A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], W[i+2], K[i+2]);
-        P(A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], W[i+3], K[i+3]);
-        P(A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], W[i+4], K[i+4]);
-        P(A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], W[i+5], K[i+5]);
-        P(A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], W[i+6], K[i+6]);
-        P(A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], W[i+7], K[i+7]);
+    for (uint32 i = 0; i < 64; i += 8) {
+        P(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], WK[i+0], 0);
+        P(A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], WK[i+1], 0);
+        P(A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], WK[i+2], 0);
+        P(A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], WK[i+3], 0);
+        P(A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], WK[i+4], 0);
+        P(A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], WK[i+5], 0);
+        P(A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], WK[i+6], 0);
+        P(A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], WK[i+7], 0);
     }
 
-    for (i = 16; i < 64; i += 8) {
-        P(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], R(i+0), K[i+0]);
-        P(A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], R(i+1), K[i+1]);
-        P(A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], R(i+2), K[i+2]);
-        P(A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], R(i+3), K[i+3]);
-        P(A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], R(i+4), K[i+4]);
-        P(A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], R(i+5), K[i+5]);
-        P(A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], R(i+6), K[i+6]);
-        P(A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], R(i+7), K[i+7]);
+    for (uint32 i = 0; i < 8; ++i) {
+        state[i] += A[i];
+    }
+}
+
+
+SOLACE_TARGET("ssse3")
+inline __m128i rotr32(__m128i x, int n) noexcept {
+    return _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - n));
+}
+
+SOLACE_TARGET("ssse3")
+inline __m128i sigma0(__m128i x) noexcept {
+    return _mm_xor_si128(_mm_xor_si128(rotr32(x, 7), rotr32(x, 18)), _mm_srli_epi32(x, 3));
+}
+
+SOLACE_TARGET("ssse3")
+inline __m128i sigma1(__m128i x) noexcept {
+    return _mm_xor_si128(_mm_xor_si128(rotr32(x, 17), rotr32(x, 19)), _mm_srli_epi32(x, 10));
+}
+
+/// Compute the next 4 schedule words W[t..t+3] from the previous 16 held in w0 (oldest) to w3.
+SOLACE_TARGET("ssse3")
+inline __m128i nextWords(__m128i w0, __m128i w1, __m128i w2, __m128i w3) noexcept {
+    // W[t-16] + s0(W[t-15]) + W[t-7]
+    auto x = _mm_add_epi32(_mm_add_epi32(w0, sigma0(_mm_alignr_epi8(w1, w0, 4))), _mm_alignr_epi8(w3, w2, 4));
+
+    // s1(W[t-2]) term of the last two words depends on the first two words of the same group.
+    x = _mm_add_epi32(x, sigma1(_mm_srli_si128(w3, 8)));
+    return _mm_add_epi32(x, sigma1(_mm_slli_si128(x, 8)));
+}
+
+SOLACE_TARGET("ssse3")
+void sha256ScheduleSsse3(uint32 WK[64], byte const* data) noexcept {
+    __m128i const bswapMask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i w[16];
+    for (int i = 0; i < 4; ++i) {
+        w[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 16 * i)), bswapMask);
+    }
+    for (int i = 4; i < 16; ++i) {
+        w[i] = nextWords(w[i - 4], w[i - 3], w[i - 2], w[i - 1]);
+    }
+
+    for (int i = 0; i < 16; ++i) {
+        auto const k = _mm_loadu_si128(reinterpret_cast<__m128i const*>(K + 4 * i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(WK + 4 * i), _mm_add_epi32(w[i], k));
+    }
+}
+
+
+SOLACE_TARGET("avx2")
+inline __m256i rotr32(__m256i x, int n) noexcept {
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+SOLACE_TARGET("avx2")
+inline __m256i sigma0(__m256i x) noexcept {
+    return _mm256_xor_si256(_mm256_xor_si256(rotr32(x, 7), rotr32(x, 18)), _mm256_srli_epi32(x, 3));
+}
+
+SOLACE_TARGET("avx2")
+inline __m256i sigma1(__m256i x) noexcept {
+    return _mm256_xor_si256(_mm256_xor_si256(rotr32(x, 17), rotr32(x, 19)), _mm256_srli_epi32(x, 10));
+}
+
+/// Same as the SSSE3 version: AVX2 byte shifts and alignr work within 128 bit lanes, one block per lane.
+SOLACE_TARGET("avx2")
+inline __m256i nextWords(__m256i w0, __m256i w1, __m256i w2, __m256i w3) noexcept {
+    auto x = _mm256_add_epi32(_mm256_add_epi32(w0, sigma0(_mm256_alignr_epi8(w1, w0, 4))),
+                              _mm256_alignr_epi8(w3, w2, 4));
+
+    x = _mm256_add_epi32(x, sigma1(_mm256_srli_si256(w3, 8)));
+    return _mm256_add_epi32(x, sigma1(_mm256_slli_si256(x, 8)));
+}
+
+/// Compute message schedules of two blocks at once.
+SOLACE_TARGET("avx2")
+void sha256ScheduleAvx2(uint32 WK0[64], uint32 WK1[64], byte const* data) noexcept {
+    __m256i const bswapMask = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL,
+                                                0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m256i w[16];
+    for (int i = 0; i < 4; ++i) {
+        auto const lo = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 16 * i));
+        auto const hi = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 64 + 16 * i));
+        w[i] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), bswapMask);
+    }
+    for (int i = 4; i < 16; ++i) {
+        w[i] = nextWords(w[i - 4], w[i - 3], w[i - 2], w[i - 1]);
     }
-#endif /* SOLACE_SHA256_SMALLER */
 
-    for (i = 0; i < 8; ++i) {
-        ctx.state[i] += A[i];
+    for (int i = 0; i < 16; ++i) {
+        auto const k = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(K + 4 * i)));
+        auto const wk = _mm256_add_epi32(w[i], k);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(WK0 + 4 * i), _mm256_castsi256_si128(wk));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(WK1 + 4 * i), _mm256_extracti128_si256(wk, 1));
     }
 }
 
+void sha256ProcessScheduled(uint32 state[8], byte const* data, size_t blocks, bool useAvx2) noexcept {
+    uint32 WK[2][64];
+
+    if (useAvx2) {
+        for (; blocks >= 2; blocks -= 2, data += 128) {
+            sha256ScheduleAvx2(WK[0], WK[1], data);
+            sha256Rounds(state, WK[0]);
+            sha256Rounds(state, WK[1]);
+        }
+    }
+
+    for (; blocks > 0; --blocks, data += 64) {
+        sha256ScheduleSsse3(WK[0], data);
+        sha256Rounds(state, WK[0]);
+    }
+}
+
+
+/// Four rounds with SHA extensions. State is kept as ABEF / CDGH pairs as sha256rnds2 expects.
+SOLACE_TARGET("sha,sse4.1")
+inline void sha256Rounds4(__m128i& abef, __m128i& cdgh, __m128i w, uint32 const* k) noexcept {
+    auto const wk = _mm_add_epi32(w, _mm_loadu_si128(reinterpret_cast<__m128i const*>(k)));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0E));
+}
+
+SOLACE_TARGET("sha,sse4.1")
+inline __m128i sha256NextWords(__m128i w0, __m128i w1, __m128i w2, __m128i w3) noexcept {
+    auto const x = _mm_add_epi32(_mm_sha256msg1_epu32(w0, w1), _mm_alignr_epi8(w3, w2, 4));
+    return _mm_sha256msg2_epu32(x, w3);
+}
+
+SOLACE_TARGET("sha,sse4.1")
+void sha256ProcessShaNi(uint32 state[8], byte const* data, size_t blocks) noexcept {
+    __m128i const bswapMask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // Rearrange state from ABCD EFGH into ABEF CDGH
+    auto const dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0xB1);
+    auto const efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state + 4)), 0x1B);
+    auto abef = _mm_alignr_epi8(dcba, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, dcba, 0xF0);
+
+    for (; blocks > 0; --blocks, data += 64) {
+        auto const abefSaved = abef;
+        auto const cdghSaved = cdgh;
+
+        auto w0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data +  0)), bswapMask);
+        auto w1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 16)), bswapMask);
+        auto w2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 32)), bswapMask);
+        auto w3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 48)), bswapMask);
+
+        for (int i = 0; i < 48; i += 16) {
+            sha256Rounds4(abef, cdgh, w0, K + i +  0);
+            w0 = sha256NextWords(w0, w1, w2, w3);
+            sha256Rounds4(abef, cdgh, w1, K + i +  4);
+            w1 = sha256NextWords(w1, w2, w3, w0);
+            sha256Rounds4(abef, cdgh, w2, K + i +  8);
+            w2 = sha256NextWords(w2, w3, w0, w1);
+            sha256Rounds4(abef, cdgh, w3, K + i + 12);
+            w3 = sha256NextWords(w3, w0, w1, w2);
+        }
+
+        sha256Rounds4(abef, cdgh, w0, K + 48);
+        sha256Rounds4(abef, cdgh, w1, K + 52);
+        sha256Rounds4(abef, cdgh, w2, K + 56);
+        sha256Rounds4(abef, cdgh, w3, K + 60);
+
+        abef = _mm_add_epi32(abef, abefSaved);
+        cdgh = _mm_add_epi32(cdgh, cdghSaved);
+    }
+
+    // Rearrange state back into ABCD EFGH
+    auto const feba = _mm_shuffle_epi32(abef, 0x1B);
+    auto const dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+#endif  // SOLACE_X86_DISPATCH
+
+
+/// Process whole 64 byte blocks with the best implementation CPU supports.
+void sha256_process(uint32 state[8], byte const* data, size_t blocks) noexcept {
+#if defined(SOLACE_X86_DISPATCH)
+    auto const& cpu = details::cpuFeatures();
+    if (cpu.sha && cpu.sse41) {
+        sha256ProcessShaNi(state, data, blocks);
+        return;
+    }
+    if (cpu.ssse3) {
+        sha256ProcessScheduled(state, data, blocks, cpu.avx2);
+        return;
+    }
+#endif
+
+    sha256ProcessPortable(state, data, blocks);
+}
+
 
 void sha256_update(Sha256::State& ctx, const byte input[], Sha256::size_type ilen) {
 	if (ilen == 0)
@@ -162,17 +396,17 @@ void sha256_update(Sha256::State& ctx, const byte input[], Sha256::size_type ile
 
     if (left && ilen >= fill) {
         memcpy((ctx.buffer + left), input, fill);
-        sha256_process(ctx, ctx.buffer);
+        sha256_process(ctx.state, ctx.buffer, 1);
 
         input += fill;
         ilen  -= fill;
         left = 0;
     }
 
-    while (ilen >= 64) {
-        sha256_process(ctx, input);
-        input += 64;
-        ilen  -= 64;
+    if (ilen >= 64) {
+        sha256_process(ctx.state, input, ilen / 64);
+        input += ilen & ~Sha256::size_type{0x3F};
+        ilen  &= 0x3F;
     }
 
     if (ilen > 0) {
@@ -181,6 +415,356 @@ void sha256_update(Sha256::State& ctx, const byte input[], Sha256::size_type ile
 }
 
 
+/**************************** MULTI-BUFFER *****************************/
+
+static const uint32 kInitialState[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+
+void storeDigest(byte* dest, uint32 const state[8]) noexcept {
+    for (uint32 i = 0; i < 8; ++i) {
+        details::storeBE(dest + 4 * i, state[i]);
+    }
+}
+
+
+/// Message assigned to a lane of multi-buffer hashing, with its padded tail prepared in advance.
+struct LaneJob {
+    byte const* next;           //!< Next whole block of the message data
+    size_t      dataBlocks;     //!< Number of whole blocks of message data left
+    byte const* tailNext;       //!< Next block of the tail
+    uint32      tailBlocks;     //!< Number of tail blocks left: message remainder followed by padding
+    size_t      index;          //!< Index of the message in the batch
+    byte        tail[128];
+
+    void start(MemoryView message, size_t messageIndex) noexcept {
+        auto const size = message.size();
+        auto const remainder = size % 64;
+
+        next = message.begin();
+        dataBlocks = size / 64;
+        index = messageIndex;
+
+        if (remainder > 0) {
+            memcpy(tail, next + 64 * dataBlocks, remainder);
+        }
+        tailBlocks = (remainder < 56) ? 1 : 2;
+        tail[remainder] = 0x80;
+        memset(tail + remainder + 1, 0, 64 * tailBlocks - remainder - 1 - 8);
+        details::storeBE<uint64>(tail + 64 * tailBlocks - 8, uint64{size} * 8);
+        tailNext = tail;
+    }
+
+    bool done() const noexcept {
+        return (dataBlocks == 0 && tailBlocks == 0);
+    }
+
+    byte const* nextBlock() noexcept {
+        byte const* block;
+        if (dataBlocks > 0) {
+            block = next;
+            next += 64;
+            dataBlocks -= 1;
+        } else {
+            block = tailNext;
+            tailNext += 64;
+            tailBlocks -= 1;
+        }
+
+        return block;
+    }
+
+    /// Process the rest of the message with single-buffer code.
+    void finish(uint32 state[8]) noexcept {
+        sha256_process(state, next, dataBlocks);
+        sha256_process(state, tailNext, tailBlocks);
+        dataBlocks = 0;
+        tailBlocks = 0;
+    }
+};
+
+
+#if defined(SOLACE_X86_DISPATCH)
+
+SOLACE_TARGET("avx2")
+inline __m256i bigSigma0(__m256i x) noexcept {
+    return _mm256_xor_si256(_mm256_xor_si256(rotr32(x, 2), rotr32(x, 13)), rotr32(x, 22));
+}
+
+SOLACE_TARGET("avx2")
+inline __m256i bigSigma1(__m256i x) noexcept {
+    return _mm256_xor_si256(_mm256_xor_si256(rotr32(x, 6), rotr32(x, 11)), rotr32(x, 25));
+}
+
+/// Transpose 8x8 matrix of 32 bit words: row i becomes column i.
+SOLACE_TARGET("avx2")
+inline void transpose8x8(__m256i r[8]) noexcept {
+    __m256i t[8];
+    for (int i = 0; i < 8; i += 2) {
+        t[i + 0] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+    }
+
+    __m256i u[8];
+    for (int i = 0; i < 8; i += 4) {
+        u[i + 0] = _mm256_unpacklo_epi64(t[i + 0], t[i + 2]);
+        u[i + 1] = _mm256_unpackhi_epi64(t[i + 0], t[i + 2]);
+        u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        r[i + 0] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+        r[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+}
+
+/// Load 8 words of 8 blocks, so that each vector holds the same word of all the blocks.
+SOLACE_TARGET("avx2")
+inline void loadTransposed8(__m256i w[8], byte const* const blocks[8], int offset) noexcept {
+    __m256i const bswapMask = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL,
+                                                0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    for (int i = 0; i < 8; ++i) {
+        w[i] = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(blocks[i] + offset));
+    }
+
+    transpose8x8(w);
+
+    for (int i = 0; i < 8; ++i) {
+        w[i] = _mm256_shuffle_epi8(w[i], bswapMask);
+    }
+}
+
+/// Compress one block of each of 8 messages. State word i of lane j is state[i][j].
+SOLACE_TARGET("avx2")
+void sha256x8Compress(uint32 (*state)[8], byte const* const blocks[8]) noexcept {
+    __m256i w[16];
+    loadTransposed8(w, blocks, 0);
+    loadTransposed8(w + 8, blocks, 32);
+
+    __m256i s[8];
+    for (int i = 0; i < 8; ++i) {
+        s[i] = _mm256_load_si256(reinterpret_cast<__m256i const*>(state[i]));
+    }
+
+    auto a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    for (int t = 0; t < 64; ++t) {
+        if (t >= 16) {
+            w[t & 15] = _mm256_add_epi32(_mm256_add_epi32(w[t & 15], sigma0(w[(t + 1) & 15])),
+                                         _mm256_add_epi32(w[(t + 9) & 15], sigma1(w[(t + 14) & 15])));
+        }
+
+        auto const ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        auto const maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        auto const temp1 = _mm256_add_epi32(_mm256_add_epi32(h, bigSigma1(e)),
+                                            _mm256_add_epi32(_mm256_add_epi32(ch, w[t & 15]),
+                                                             _mm256_set1_epi32(static_cast<int>(K[t]))));
+        auto const temp2 = _mm256_add_epi32(bigSigma0(a), maj);
+
+        h = g; g = f; f = e; e = _mm256_add_epi32(d, temp1);
+        d = c; c = b; b = a; a = _mm256_add_epi32(temp1, temp2);
+    }
+
+    s[0] = _mm256_add_epi32(s[0], a); s[1] = _mm256_add_epi32(s[1], b);
+    s[2] = _mm256_add_epi32(s[2], c); s[3] = _mm256_add_epi32(s[3], d);
+    s[4] = _mm256_add_epi32(s[4], e); s[5] = _mm256_add_epi32(s[5], f);
+    s[6] = _mm256_add_epi32(s[6], g); s[7] = _mm256_add_epi32(s[7], h);
+    for (int i = 0; i < 8; ++i) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(state[i]), s[i]);
+    }
+}
+
+
+// GCC 12 warns of uninitialized __Y in AVX-512 intrinsics inlined into the kernel: a false positive, GCC bug 105593.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+template<int N>
+SOLACE_TARGET("avx512f")
+inline __m512i rotr32x16(__m512i x) noexcept {
+    return _mm512_ror_epi32(x, N);
+}
+
+/// Xor of three values in one instruction.
+SOLACE_TARGET("avx512f")
+inline __m512i xor3(__m512i x, __m512i y, __m512i z) noexcept {
+    return _mm512_ternarylogic_epi32(x, y, z, 0x96);
+}
+
+/// Compress one block of each of 16 messages. State word i of lane j is state[i][j].
+SOLACE_TARGET("avx512f")
+void sha256x16Compress(uint32 (*state)[16], byte const* const blocks[16]) noexcept {
+    // Transpose as four 8x8 quarters: first and second half of the words, of the first and second 8 lanes.
+    __m512i w[16];
+    for (int half = 0; half < 2; ++half) {
+        __m256i lo[8];
+        __m256i hi[8];
+        loadTransposed8(lo, blocks, 32 * half);
+        loadTransposed8(hi, blocks + 8, 32 * half);
+        for (int i = 0; i < 8; ++i) {
+            w[8 * half + i] = _mm512_inserti64x4(_mm512_castsi256_si512(lo[i]), hi[i], 1);
+        }
+    }
+
+    __m512i s[8];
+    for (int i = 0; i < 8; ++i) {
+        s[i] = _mm512_load_si512(state[i]);
+    }
+
+    auto a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    for (int t = 0; t < 64; ++t) {
+        if (t >= 16) {
+            auto const w15 = w[(t + 1) & 15];
+            auto const w2 = w[(t + 14) & 15];
+            auto const s0 = xor3(rotr32x16<7>(w15), rotr32x16<18>(w15), _mm512_srli_epi32(w15, 3));
+            auto const s1 = xor3(rotr32x16<17>(w2), rotr32x16<19>(w2), _mm512_srli_epi32(w2, 10));
+            w[t & 15] = _mm512_add_epi32(_mm512_add_epi32(w[t & 15], s0), _mm512_add_epi32(w[(t + 9) & 15], s1));
+        }
+
+        auto const ch = _mm512_ternarylogic_epi32(e, f, g, 0xCA);
+        auto const maj = _mm512_ternarylogic_epi32(a, b, c, 0xE8);
+        auto const S1 = xor3(rotr32x16<6>(e), rotr32x16<11>(e), rotr32x16<25>(e));
+        auto const S0 = xor3(rotr32x16<2>(a), rotr32x16<13>(a), rotr32x16<22>(a));
+        auto const temp1 = _mm512_add_epi32(_mm512_add_epi32(h, S1),
+                                            _mm512_add_epi32(_mm512_add_epi32(ch, w[t & 15]),
+                                                             _mm512_set1_epi32(static_cast<int>(K[t]))));
+        auto const temp2 = _mm512_add_epi32(S0, maj);
+
+        h = g; g = f; f = e; e = _mm512_add_epi32(d, temp1);
+        d = c; c = b; b = a; a = _mm512_add_epi32(temp1, temp2);
+    }
+
+    s[0] = _mm512_add_epi32(s[0], a); s[1] = _mm512_add_epi32(s[1], b);
+    s[2] = _mm512_add_epi32(s[2], c); s[3] = _mm512_add_epi32(s[3], d);
+    s[4] = _mm512_add_epi32(s[4], e); s[5] = _mm512_add_epi32(s[5], f);
+    s[6] = _mm512_add_epi32(s[6], g); s[7] = _mm512_add_epi32(s[7], h);
+    for (int i = 0; i < 8; ++i) {
+        _mm512_store_si512(state[i], s[i]);
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+
+/**
+ * Hash messages Lanes at a time: each lane takes the next message as soon as it's done with the previous one.
+ * Once the batch runs out of messages and half of the lanes are idle, the rest are finished one at a time.
+ */
+template<size_t Lanes>
+void digestMultiBuffer(ArrayView<MemoryView const> messages, byte* digests,
+                       void (*compress)(uint32 (*)[Lanes], byte const* const*)) noexcept {
+    alignas(64) uint32 state[8][Lanes];
+    LaneJob jobs[Lanes];
+    bool busy[Lanes];
+    byte const* blocks[Lanes];
+
+    size_t nextMessage = 0;
+    size_t active = 0;
+
+    auto startLane = [&](size_t lane) {
+        if (nextMessage < messages.size()) {
+            jobs[lane].start(messages[nextMessage], nextMessage);
+            nextMessage += 1;
+            for (uint32 i = 0; i < 8; ++i) {
+                state[i][lane] = kInitialState[i];
+            }
+        } else {
+            busy[lane] = false;
+            active -= 1;
+            blocks[lane] = sha256_padding;  // Any valid block to keep idle lane busy with
+        }
+    };
+
+    active = Lanes;
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        busy[lane] = true;
+        startLane(lane);
+    }
+
+    while (2 * active > Lanes) {
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            if (busy[lane]) {
+                blocks[lane] = jobs[lane].nextBlock();
+            }
+        }
+
+        compress(state, blocks);
+
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            if (busy[lane] && jobs[lane].done()) {
+                uint32 laneState[8];
+                for (uint32 i = 0; i < 8; ++i) {
+                    laneState[i] = state[i][lane];
+                }
+
+                storeDigest(digests + Sha256xN::kDigestSize * jobs[lane].index, laneState);
+                startLane(lane);
+            }
+        }
+    }
+
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        if (busy[lane]) {
+            uint32 laneState[8];
+            for (uint32 i = 0; i < 8; ++i) {
+                laneState[i] = state[i][lane];
+            }
+
+            jobs[lane].finish(laneState);
+            storeDigest(digests + Sha256xN::kDigestSize * jobs[lane].index, laneState);
+        }
+    }
+}
+
+
+/**
+ * Compress a block into each of the states Lanes at a time.
+ * Once fewer than half of the lanes would be busy, the rest are compressed one at a time.
+ */
+template<size_t Lanes>
+void compressMultiBuffer(Sha256::ChainingValue* states, byte const* blocks, size_t count,
+                         void (*compress)(uint32 (*)[Lanes], byte const* const*)) noexcept {
+    alignas(64) uint32 state[8][Lanes];
+    byte const* laneBlocks[Lanes];
+
+    size_t first = 0;
+    while (2 * (count - first) > Lanes) {
+        auto const n = std::min(Lanes, count - first);
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            auto const busy = (lane < n);
+            laneBlocks[lane] = busy ? blocks + 64 * (first + lane) : sha256_padding;
+            for (uint32 i = 0; i < 8; ++i) {
+                state[i][lane] = busy ? states[first + lane].words[i] : 0;
+            }
+        }
+
+        compress(state, laneBlocks);
+
+        for (size_t lane = 0; lane < n; ++lane) {
+            for (uint32 i = 0; i < 8; ++i) {
+                states[first + lane].words[i] = state[i][lane];
+            }
+        }
+
+        first += n;
+    }
+
+    for (; first < count; ++first) {
+        sha256_process(states[first].words, blocks + 64 * first, 1);
+    }
+}
+
+#endif  // SOLACE_X86_DISPATCH
+
+}  // anonymous namespace
+
+
 
 Sha256::Sha256() noexcept
     : _state {
@@ -201,6 +785,19 @@ Sha256::Sha256() noexcept
 }
 
 
+Result<Sha256::ChainingValue, Error>
+Sha256::chainingValue() const {
+    if ((_state.total[0] & 0x3F) != 0) {
+        return makeError(GenericError::INVAL, "Sha256::chainingValue(): Incomplete block");
+    }
+
+    ChainingValue result;
+    memcpy(result.words, _state.state, sizeof(result.words));
+
+    return Ok(result);
+}
+
+
 StringView Sha256::getAlgorithm() const {
     return SHA_256_NAME;
 }
@@ -218,9 +815,8 @@ HashingAlgorithm& Sha256::update(MemoryView input) {
 }
 
 
-MessageDigest Sha256::digest() {
-    byte result[32];
-    ByteWriter writer{wrapMemory(result)};
+void Sha256::digestUnchecked(MutableMemoryView dest) {
+    ByteWriter writer{dest};
 
     uint32 const high = (_state.total[0] >> 29) | (_state.total[1] <<  3);
     uint32 const low  = (_state.total[0] <<  3);
@@ -239,6 +835,81 @@ MessageDigest Sha256::digest() {
     for (auto s : _state.state) {
         writer.writeBE(s);
     }
+}
+
+
+Sha256xN::size_type
+Sha256xN::lanes() noexcept {
+#if defined(SOLACE_X86_DISPATCH)
+    auto const& cpu = details::cpuFeatures();
+    if (cpu.avx512f) {
+        return 16;
+    }
+    if (cpu.avx2 && !cpu.sha) {
+        return 8;
+    }
+#endif
+
+    return 1;
+}
+
+
+Result<void, Error>
+Sha256xN::digest(ArrayView<MemoryView const> messages, MutableMemoryView digests) noexcept {
+    if (digests.size() / kDigestSize < messages.size()) {
+        return makeError(SystemErrors::Overflow, "Sha256xN::digest()");
+    }
+
+#if defined(SOLACE_X86_DISPATCH)
+    auto const& cpu = details::cpuFeatures();
+    if (cpu.avx512f) {
+        digestMultiBuffer<16>(messages, digests.begin(), sha256x16Compress);
+        return Ok();
+    }
+    // Single-buffer SHA extensions are faster than 8 lanes of AVX2 for all but the shortest messages
+    if (cpu.avx2 && !cpu.sha) {
+        digestMultiBuffer<8>(messages, digests.begin(), sha256x8Compress);
+        return Ok();
+    }
+#endif
+
+    for (size_t i = 0; i < messages.size(); ++i) {
+        uint32 state[8];
+        for (uint32 j = 0; j < 8; ++j) {
+            state[j] = kInitialState[j];
+        }
+
+        LaneJob job;
+        job.start(messages[i], i);
+        job.finish(state);
+        storeDigest(digests.begin() + kDigestSize * i, state);
+    }
+
+    return Ok();
+}
+
+
+Result<void, Error>
+Sha256xN::compress(ArrayView<ChainingValue> states, MemoryView blocks) noexcept {
+    if (blocks.size() / Sha256::kBlockSize < states.size()) {
+        return makeError(GenericError::INVAL, "Sha256xN::compress(): blocks");
+    }
+
+#if defined(SOLACE_X86_DISPATCH)
+    auto const& cpu = details::cpuFeatures();
+    if (cpu.avx512f) {
+        compressMultiBuffer<16>(states.begin(), blocks.begin(), states.size(), sha256x16Compress);
+        return Ok();
+    }
+    if (cpu.avx2 && !cpu.sha) {
+        compressMultiBuffer<8>(states.begin(), blocks.begin(), states.size(), sha256x8Compress);
+        return Ok();
+    }
+#endif
+
+    for (size_t i = 0; i < states.size(); ++i) {
+        sha256_process(states[i].words, blocks.begin() + Sha256::kBlockSize * i, 1);
+    }
 
-    return MessageDigest(writer.viewWritten());
+    return Ok();
 }
@@ -20,51 +20,582 @@
  ******************************************************************************/
 #include "solace/hashing/sha3.hpp"
 
+#include "solace/assert.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include "solace/details/byte_swap.hpp"
+#include "solace/details/cpu_features.hpp"
+
+#include <algorithm>  // std::min
+#include <cstring>  // memcpy
+
+#if defined(SOLACE_X86_DISPATCH)
+#include <immintrin.h>
+#endif
+
+
 using namespace Solace;
 using namespace Solace::hashing;
 
 
-static const StringLiteral SHA_3_NAME = "SHA3";
+static const StringLiteral SHA3_224_NAME = "SHA3-224";
+static const StringLiteral SHA3_256_NAME = "SHA3-256";
+static const StringLiteral SHA3_384_NAME = "SHA3-384";
+static const StringLiteral SHA3_512_NAME = "SHA3-512";
+static const StringLiteral SHAKE_128_NAME = "SHAKE128";
+static const StringLiteral SHAKE_256_NAME = "SHAKE256";
+
+
+namespace /* anonymous */ {
+
+/// Domain separation suffix of SHA-3 followed by the first bit of pad10*1.
+constexpr byte kSha3Domain = 0x06;
+
+/// Domain separation suffix of SHAKE followed by the first bit of pad10*1.
+constexpr byte kShakeDomain = 0x1F;
+
+/// Largest rate of SHA-3 functions: that of SHA3-224.
+constexpr KeccakSponge::size_type kMaxSha3Rate = 144;
+
+constexpr uint64 kRoundConstants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+
+inline uint64 rotl64(uint64 x, int n) noexcept {
+    return (x << n) | (x >> (64 - n));
+}
+
+
+/**
+ * One round of Keccak-f[1600] from lanes A.. into lanes E..
+ * Lanes are named by row (b, g, k, m, s for y = 0..4) and column (a, e, i, o, u for x = 0..4).
+ *
+ * State is kept lane-complemented: lanes be, bi, go, ki, mi and sa hold the complement of their value.
+ * Complement passes through theta, rho and pi unchanged and, with the right choice of lanes,
+ * lets chi step use only five NOT operations per round instead of twenty five.
+ */
+#define KECCAK_ROUND(A, E, i)                                \
+{                                                            \
+    uint64 const Ca = A##ba ^ A##ga ^ A##ka ^ A##ma ^ A##sa; \
+    uint64 const Ce = A##be ^ A##ge ^ A##ke ^ A##me ^ A##se; \
+    uint64 const Ci = A##bi ^ A##gi ^ A##ki ^ A##mi ^ A##si; \
+    uint64 const Co = A##bo ^ A##go ^ A##ko ^ A##mo ^ A##so; \
+    uint64 const Cu = A##bu ^ A##gu ^ A##ku ^ A##mu ^ A##su; \
+                                                             \
+    uint64 const Da = Cu ^ rotl64(Ce, 1);                    \
+    uint64 const De = Ca ^ rotl64(Ci, 1);                    \
+    uint64 const Di = Ce ^ rotl64(Co, 1);                    \
+    uint64 const Do = Ci ^ rotl64(Cu, 1);                    \
+    uint64 const Du = Co ^ rotl64(Ca, 1);                    \
+                                                             \
+    uint64 const Bba = A##ba ^ Da;                           \
+    uint64 const Bbe = rotl64(A##ge ^ De, 44);               \
+    uint64 const Bbi = rotl64(A##ki ^ Di, 43);               \
+    uint64 const Bbo = rotl64(A##mo ^ Do, 21);               \
+    uint64 const Bbu = rotl64(A##su ^ Du, 14);               \
+    E##ba = Bba ^ (Bbe | Bbi) ^ kRoundConstants[i];          \
+    E##be = Bbe ^ (~Bbi | Bbo);                              \
+    E##bi = Bbi ^ (Bbo & Bbu);                               \
+    E##bo = Bbo ^ (Bbu | Bba);                               \
+    E##bu = Bbu ^ (Bba & Bbe);                               \
+                                                             \
+    uint64 const Bga = rotl64(A##bo ^ Do, 28);               \
+    uint64 const Bge = rotl64(A##gu ^ Du, 20);               \
+    uint64 const Bgi = rotl64(A##ka ^ Da, 3);                \
+    uint64 const Bgo = rotl64(A##me ^ De, 45);               \
+    uint64 const Bgu = rotl64(A##si ^ Di, 61);               \
+    E##ga = Bga ^ (Bge | Bgi);                               \
+    E##ge = Bge ^ (Bgi & Bgo);                               \
+    E##gi = Bgi ^ (Bgo | ~Bgu);                              \
+    E##go = Bgo ^ (Bgu | Bga);                               \
+    E##gu = Bgu ^ (Bga & Bge);                               \
+                                                             \
+    uint64 const Bka = rotl64(A##be ^ De, 1);                \
+    uint64 const Bke = rotl64(A##gi ^ Di, 6);                \
+    uint64 const Bki = rotl64(A##ko ^ Do, 25);               \
+    uint64 const Bko = rotl64(A##mu ^ Du, 8);                \
+    uint64 const Bku = rotl64(A##sa ^ Da, 18);               \
+    E##ka = Bka ^ (Bke | Bki);                               \
+    E##ke = Bke ^ (Bki & Bko);                               \
+    E##ki = Bki ^ (~Bko & Bku);                              \
+    E##ko = ~Bko ^ (Bku | Bka);                              \
+    E##ku = Bku ^ (Bka & Bke);                               \
+                                                             \
+    uint64 const Bma = rotl64(A##bu ^ Du, 27);               \
+    uint64 const Bme = rotl64(A##ga ^ Da, 36);               \
+    uint64 const Bmi = rotl64(A##ke ^ De, 10);               \
+    uint64 const Bmo = rotl64(A##mi ^ Di, 15);               \
+    uint64 const Bmu = rotl64(A##so ^ Do, 56);               \
+    E##ma = Bma ^ (Bme & Bmi);                               \
+    E##me = Bme ^ (Bmi | Bmo);                               \
+    E##mi = Bmi ^ (~Bmo | Bmu);                              \
+    E##mo = ~Bmo ^ (Bmu & Bma);                              \
+    E##mu = Bmu ^ (Bma | Bme);                               \
+                                                             \
+    uint64 const Bsa = rotl64(A##bi ^ Di, 62);               \
+    uint64 const Bse = rotl64(A##go ^ Do, 55);               \
+    uint64 const Bsi = rotl64(A##ku ^ Du, 39);               \
+    uint64 const Bso = rotl64(A##ma ^ Da, 41);               \
+    uint64 const Bsu = rotl64(A##se ^ De, 2);                \
+    E##sa = Bsa ^ (~Bse & Bsi);                              \
+    E##se = ~Bse ^ (Bsi | Bso);                              \
+    E##si = Bsi ^ (Bso & Bsu);                               \
+    E##so = Bso ^ (Bsu | Bsa);                               \
+    E##su = Bsu ^ (Bsa & Bse);                               \
+}
+
+
+/// Keccak-f[1600] permutation of the state of 25 lanes, lane index is x + 5 * y.
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+void keccakF1600(uint64 state[25]) noexcept {
+    uint64 Aba =  state[ 0], Abe = ~state[ 1], Abi = ~state[ 2], Abo =  state[ 3], Abu =  state[ 4];
+    uint64 Aga =  state[ 5], Age =  state[ 6], Agi =  state[ 7], Ago = ~state[ 8], Agu =  state[ 9];
+    uint64 Aka =  state[10], Ake =  state[11], Aki = ~state[12], Ako =  state[13], Aku =  state[14];
+    uint64 Ama =  state[15], Ame =  state[16], Ami = ~state[17], Amo =  state[18], Amu =  state[19];
+    uint64 Asa = ~state[20], Ase =  state[21], Asi =  state[22], Aso =  state[23], Asu =  state[24];
+    uint64 Eba, Ebe, Ebi, Ebo, Ebu, Ega, Ege, Egi, Ego, Egu, Eka, Eke, Eki,
+           Eko, Eku, Ema, Eme, Emi, Emo, Emu, Esa, Ese, Esi, Eso, Esu;
+
+    for (int i = 0; i < 24; i += 2) {
+        KECCAK_ROUND(A, E, i)
+        KECCAK_ROUND(E, A, i + 1)
+    }
+
+    state[ 0] =  Aba; state[ 1] = ~Abe; state[ 2] = ~Abi; state[ 3] =  Abo; state[ 4] =  Abu;
+    state[ 5] =  Aga; state[ 6] =  Age; state[ 7] =  Agi; state[ 8] = ~Ago; state[ 9] =  Agu;
+    state[10] =  Aka; state[11] =  Ake; state[12] = ~Aki; state[13] =  Ako; state[14] =  Aku;
+    state[15] =  Ama; state[16] =  Ame; state[17] = ~Ami; state[18] =  Amo; state[19] =  Amu;
+    state[20] = ~Asa; state[21] =  Ase; state[22] =  Asi; state[23] =  Aso; state[24] =  Asu;
+}
+
+
+/// Xor bytes into the state, starting at the given byte offset.
+void xorBytes(uint64 lanes[25], size_t offset, byte const* data, size_t size) noexcept {
+    for (size_t i = 0; i < size; ++i, ++offset) {
+        lanes[offset / 8] ^= uint64{data[i]} << (8 * (offset % 8));
+    }
+}
+
+/// Xor a whole block into the state. Rate is a multiple of the lane size.
+void xorBlock(uint64 lanes[25], byte const* data, size_t rate) noexcept {
+    for (size_t i = 0; i < rate / 8; ++i) {
+        lanes[i] ^= details::loadLE<uint64>(data + 8 * i);
+    }
+}
+
+/// Copy bytes out of the state, starting at the given byte offset.
+void extractBytes(byte* dest, uint64 const lanes[25], size_t offset, size_t size) noexcept {
+    for (size_t i = 0; i < size; ++i, ++offset) {
+        dest[i] = static_cast<byte>(lanes[offset / 8] >> (8 * (offset % 8)));
+    }
+}
+
+
+/// Message assigned to a lane of batch hashing, with its padded last block prepared in advance.
+struct SpongeJob {
+    byte const* next;           //!< Next whole block of the message data
+    size_t      dataBlocks;     //!< Number of whole blocks of message data left
+    bool        tailLeft;       //!< If the last padded block is yet to be absorbed
+    size_t      index;          //!< Index of the message in the batch
+    byte        tail[kMaxSha3Rate];
+
+    void start(MemoryView message, size_t messageIndex, size_t rate) noexcept {
+        auto const remainder = message.size() % rate;
+
+        next = message.begin();
+        dataBlocks = message.size() / rate;
+        index = messageIndex;
+
+        if (remainder > 0) {
+            memcpy(tail, next + rate * dataBlocks, remainder);
+        }
+        memset(tail + remainder, 0, rate - remainder);
+        tail[remainder] ^= kSha3Domain;
+        tail[rate - 1] ^= 0x80;
+        tailLeft = true;
+    }
+
+    bool done() const noexcept {
+        return (dataBlocks == 0 && !tailLeft);
+    }
+
+    byte const* nextBlock(size_t rate) noexcept {
+        if (dataBlocks > 0) {
+            auto const block = next;
+            next += rate;
+            dataBlocks -= 1;
+
+            return block;
+        }
+
+        tailLeft = false;
+        return tail;
+    }
+
+    /// Absorb the rest of the message with single-buffer code.
+    void finish(uint64 lanes[25], size_t rate) noexcept {
+        while (!done()) {
+            xorBlock(lanes, nextBlock(rate), rate);
+            keccakF1600(lanes);
+        }
+    }
+};
+
+
+bool isValidSha3Length(KeccakSponge::size_type digestLength) noexcept {
+    return (digestLength == 224 || digestLength == 256 || digestLength == 384 || digestLength == 512);
+}
+
+constexpr KeccakSponge::size_type rateOf(KeccakSponge::size_type securityBits) noexcept {
+    return KeccakSponge::kStateSize - 2 * (securityBits / 8);
+}
+
+
+#if defined(SOLACE_X86_DISPATCH)
+
+/// Rotation offsets of rho step by lane index.
+constexpr int kRho[25] = {
+     0,  1, 62, 28, 27,
+    36, 44,  6, 55, 20,
+     3, 10, 43, 25, 39,
+    41, 45, 15, 21,  8,
+    18,  2, 61, 56, 14
+};
+
+/// Destination of each lane in pi step by lane index.
+constexpr int kPi[25] = {
+     0, 10, 20,  5, 15,
+    16,  1, 11, 21,  6,
+     7, 17,  2, 12, 22,
+    23,  8, 18,  3, 13,
+    14, 24,  9, 19,  4
+};
+
+SOLACE_TARGET("avx2")
+inline __m256i rotl64x4(__m256i x, int n) noexcept {
+    return _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n));
+}
+
+/**
+ * Keccak-f[1600] permutation of four independent states at once.
+ * Lane i of state j is state[i][j], so that each lane of all four states is one vector.
+ * AVX2 has and-not instruction, so chi does not benefit from complemented lanes here.
+ */
+SOLACE_TARGET("avx2")
+void keccakF1600x4(uint64 (*state)[4]) noexcept {
+    __m256i a[25];
+    for (int i = 0; i < 25; ++i) {
+        a[i] = _mm256_load_si256(reinterpret_cast<__m256i const*>(state[i]));
+    }
+
+    for (int round = 0; round < 24; ++round) {
+        __m256i c[5];
+        for (int x = 0; x < 5; ++x) {
+            c[x] = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(a[x], a[x + 5]),
+                                                     _mm256_xor_si256(a[x + 10], a[x + 15])),
+                                    a[x + 20]);
+        }
+
+        __m256i b[25];
+        for (int x = 0; x < 5; ++x) {
+            auto const d = _mm256_xor_si256(c[(x + 4) % 5], rotl64x4(c[(x + 1) % 5], 1));
+            for (int y = 0; y < 25; y += 5) {
+                b[kPi[x + y]] = rotl64x4(_mm256_xor_si256(a[x + y], d), kRho[x + y]);
+            }
+        }
+
+        for (int y = 0; y < 25; y += 5) {
+            for (int x = 0; x < 5; ++x) {
+                a[x + y] = _mm256_xor_si256(b[x + y], _mm256_andnot_si256(b[(x + 1) % 5 + y], b[(x + 2) % 5 + y]));
+            }
+        }
+
+        a[0] = _mm256_xor_si256(a[0], _mm256_set1_epi64x(static_cast<int64>(kRoundConstants[round])));
+    }
+
+    for (int i = 0; i < 25; ++i) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(state[i]), a[i]);
+    }
+}
+
+
+/**
+ * Hash messages four at a time: each lane takes the next message as soon as it's done with the previous one.
+ * Once the batch runs out of messages and half of the lanes are idle, the rest are finished one at a time.
+ */
+void sha3DigestX4(ArrayView<MemoryView const> messages, byte* digests, size_t rate, size_t digestSize) noexcept {
+    constexpr size_t kLanes = 4;
+
+    alignas(32) uint64 state[25][kLanes];
+    SpongeJob jobs[kLanes];
+    bool busy[kLanes];
+
+    size_t nextMessage = 0;
+    size_t active = kLanes;
+
+    auto startLane = [&](size_t lane) {
+        if (nextMessage < messages.size()) {
+            jobs[lane].start(messages[nextMessage], nextMessage, rate);
+            nextMessage += 1;
+            for (size_t i = 0; i < 25; ++i) {
+                state[i][lane] = 0;
+            }
+        } else {
+            busy[lane] = false;
+            active -= 1;
+        }
+    };
+
+    auto laneState = [&](size_t lane, uint64 lanes[25]) {
+        for (size_t i = 0; i < 25; ++i) {
+            lanes[i] = state[i][lane];
+        }
+    };
+
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        busy[lane] = true;
+        startLane(lane);
+    }
+
+    while (2 * active > kLanes) {
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            if (busy[lane]) {
+                auto const block = jobs[lane].nextBlock(rate);
+                for (size_t i = 0; i < rate / 8; ++i) {
+                    state[i][lane] ^= details::loadLE<uint64>(block + 8 * i);
+                }
+            }
+        }
+
+        keccakF1600x4(state);
+
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            if (busy[lane] && jobs[lane].done()) {
+                uint64 lanes[25];
+                laneState(lane, lanes);
+                extractBytes(digests + digestSize * jobs[lane].index, lanes, 0, digestSize);
+                startLane(lane);
+            }
+        }
+    }
+
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        if (busy[lane]) {
+            uint64 lanes[25];
+            laneState(lane, lanes);
+            jobs[lane].finish(lanes, rate);
+            extractBytes(digests + digestSize * jobs[lane].index, lanes, 0, digestSize);
+        }
+    }
+}
+
+#endif  // SOLACE_X86_DISPATCH
+
+}  // anonymous namespace
+
+
+KeccakSponge::KeccakSponge(size_type rate, byte domain) noexcept
+    : _lanes{}
+    , _rate{rate}
+    , _domain{domain}
+{
+}
+
+
+void
+KeccakSponge::absorb(MemoryView input) noexcept {
+    auto data = input.begin();
+    auto size = input.size();
+
+    if (_offset > 0) {
+        auto const n = std::min(size, _rate - _offset);
+        xorBytes(_lanes, _offset, data, n);
+        data += n;
+        size -= n;
+        _offset += n;
+
+        if (_offset < _rate) {
+            return;
+        }
+
+        keccakF1600(_lanes);
+        _offset = 0;
+    }
+
+    for (; size >= _rate; data += _rate, size -= _rate) {
+        xorBlock(_lanes, data, _rate);
+        keccakF1600(_lanes);
+    }
+
+    if (size > 0) {
+        xorBytes(_lanes, 0, data, size);
+        _offset = size;
+    }
+}
+
+
+void
+KeccakSponge::squeeze(MutableMemoryView output) noexcept {
+    if (!_squeezing) {
+        byte const domain = _domain;
+        byte const lastBit = 0x80;
+        xorBytes(_lanes, _offset, &domain, 1);
+        xorBytes(_lanes, _rate - 1, &lastBit, 1);
+        keccakF1600(_lanes);
 
+        _offset = 0;
+        _squeezing = true;
+    }
 
-Sha3::Sha3() noexcept
-    : _state {
-          {0, 0},
-          {0},
-          {0}
-      }
+    auto dest = output.begin();
+    auto size = output.size();
+    while (size > 0) {
+        if (_offset == _rate) {
+            keccakF1600(_lanes);
+            _offset = 0;
+        }
+
+        auto const n = std::min(size, _rate - _offset);
+        extractBytes(dest, _lanes, _offset, n);
+        dest += n;
+        size -= n;
+        _offset += n;
+    }
+}
+
+
+Sha3::Sha3(size_type digestLength) noexcept
+    : _sponge{rateOf(digestLength), kSha3Domain}
+    , _digestLength{digestLength}
 {
 }
 
 
 StringView
 Sha3::getAlgorithm() const {
-    return SHA_3_NAME;
+    switch (_digestLength) {
+    case 224: return SHA3_224_NAME;
+    case 256: return SHA3_256_NAME;
+    case 384: return SHA3_384_NAME;
+    default:  return SHA3_512_NAME;
+    }
 }
 
 
 Sha3::size_type
 Sha3::getDigestLength() const {
-    return 256;
+    return _digestLength;
+}
+
+
+HashingAlgorithm&
+Sha3::update(MemoryView input) {
+    if (_sponge.isSqueezing()) {
+        raiseInvalidStateError("Sha3::update() after digest()");
+    }
+
+    _sponge.absorb(input);
+
+    return (*this);
+}
+
+
+void
+Sha3::digestUnchecked(MutableMemoryView dest) {
+    _sponge.squeeze(dest);
+}
+
+
+Shake::Shake(size_type securityStrength) noexcept
+    : _sponge{rateOf(securityStrength), kShakeDomain}
+    , _securityStrength{securityStrength}
+{
+}
+
+
+StringView
+Shake::getAlgorithm() const {
+    return (_securityStrength == 128)
+            ? SHAKE_128_NAME
+            : SHAKE_256_NAME;
+}
+
+
+Shake::size_type
+Shake::getDigestLength() const {
+    return 2 * _securityStrength;
 }
 
 
 HashingAlgorithm&
-Sha3::update(MemoryView SOLACE_UNUSED(input)) {
-    // TODO(abbyssoul): Not implemented yet.
+Shake::update(MemoryView input) {
+    if (_sponge.isSqueezing()) {
+        raiseInvalidStateError("Shake::update() after squeeze()");
+    }
+
+    _sponge.absorb(input);
 
     return (*this);
 }
 
 
-MessageDigest
-Sha3::digest() {
-    byte result[32];
-    ByteWriter writer{wrapMemory(result)};
+void
+Shake::digestUnchecked(MutableMemoryView dest) {
+    _sponge.squeeze(dest);
+}
+
+
+Shake&
+Shake::squeeze(MutableMemoryView output) noexcept {
+    _sponge.squeeze(output);
+
+    return (*this);
+}
+
+
+Sha3xN::size_type
+Sha3xN::lanes() noexcept {
+#if defined(SOLACE_X86_DISPATCH)
+    if (details::cpuFeatures().avx2) {
+        return 4;
+    }
+#endif
+
+    return 1;
+}
+
+
+Result<void, Error>
+Sha3xN::digest(ArrayView<MemoryView const> messages, MutableMemoryView digests, size_type digestLength) noexcept {
+    if (!isValidSha3Length(digestLength)) {
+        return makeError(GenericError::RANGE, "Sha3xN::digest()");
+    }
+
+    auto const digestSize = digestLength / 8;
+    if (digests.size() / digestSize < messages.size()) {
+        return makeError(SystemErrors::Overflow, "Sha3xN::digest()");
+    }
+
+    auto const rate = rateOf(digestLength);
+
+#if defined(SOLACE_X86_DISPATCH)
+    if (details::cpuFeatures().avx2) {
+        sha3DigestX4(messages, digests.begin(), rate, digestSize);
+        return Ok();
+    }
+#endif
 
-    for (auto s : _state.state) {
-        writer.writeBE(s);
+    for (size_t i = 0; i < messages.size(); ++i) {
+        KeccakSponge sponge{rate, kSha3Domain};
+        sponge.absorb(messages[i]);
+        sponge.squeeze(digests.slice(i * digestSize, (i + 1) * digestSize));
     }
 
-    return MessageDigest(writer.viewWritten());
+    return Ok();
 }
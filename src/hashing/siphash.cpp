@@ -0,0 +1,170 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		hashing/siphash.cpp
+ *	@brief		Implementation of SipHash and HalfSipHash.
+ ******************************************************************************/
+#include "solace/hashing/siphash.hpp"
+
+#include <chrono>
+#include <cstdint>  // uintptr_t
+#include <cstring>  // memcpy
+#include <exception>
+#include <random>
+
+#include <unistd.h>  // getpid
+
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+static const StringLiteral SIPHASH_24_NAME = "SIPHASH-2-4";
+static const StringLiteral SIPHASH_13_NAME = "SIPHASH-1-3";
+static const StringLiteral HALFSIPHASH_24_NAME = "HALFSIPHASH-2-4";
+static const StringLiteral HALFSIPHASH_13_NAME = "HALFSIPHASH-1-3";
+
+
+namespace {
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+uint64 splitMix64(uint64& state) noexcept {
+    auto z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+/**
+ * Get random words for a process key from std::random_device.
+ * When the entropy source is not available, the key is derived from the clock, process id and address space layout:
+ * it is guessable, but hashing keeps working rather than terminating the process.
+ */
+void randomWords(uint64* words, size_t count) noexcept {
+    try {
+        std::random_device rd;
+        for (size_t i = 0; i < count; ++i) {
+            words[i] = (static_cast<uint64>(rd()) << 32) | static_cast<uint32>(rd());
+        }
+
+        return;
+    } catch (std::exception const&) {
+        // No entropy source: fall back to the weak key below
+    }
+
+    auto state = static_cast<uint64>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    state ^= static_cast<uint64>(::getpid()) << 32;
+    state ^= static_cast<uint64>(reinterpret_cast<uintptr_t>(words));
+    for (size_t i = 0; i < count; ++i) {
+        words[i] = splitMix64(state);
+    }
+}
+
+}  // namespace
+
+
+SipHashKey const&
+SipHashKey::processKey() noexcept {
+    static SipHashKey const key = [] {
+        uint64 words[2];
+        randomWords(words, 2);
+
+        return SipHashKey{words[0], words[1]};
+    }();
+
+    return key;
+}
+
+
+HalfSipHashKey const&
+HalfSipHashKey::processKey() noexcept {
+    static HalfSipHashKey const key = [] {
+        uint64 word;
+        randomWords(&word, 1);
+
+        return HalfSipHashKey{static_cast<uint32>(word), static_cast<uint32>(word >> 32)};
+    }();
+
+    return key;
+}
+
+
+namespace Solace { namespace hashing {
+
+template<typename Key, int CRounds, int DRounds>
+StringView SipHash<Key, CRounds, DRounds>::getAlgorithm() const {
+    if (sizeof(Word) == 8) {
+        return (CRounds == 2) ? SIPHASH_24_NAME : SIPHASH_13_NAME;
+    }
+
+    return (CRounds == 2) ? HALFSIPHASH_24_NAME : HALFSIPHASH_13_NAME;
+}
+
+
+template<typename Key, int CRounds, int DRounds>
+typename SipHash<Key, CRounds, DRounds>::size_type
+SipHash<Key, CRounds, DRounds>::getDigestLength() const {
+    return kDigestSize * 8;
+}
+
+
+template<typename Key, int CRounds, int DRounds>
+HashingAlgorithm&
+SipHash<Key, CRounds, DRounds>::update(MemoryView input) {
+    auto data = input.begin();
+    auto size = input.size();
+    auto const tailLength = static_cast<size_type>(_length % kBlockSize);
+    _length += size;
+
+    if (tailLength > 0) {
+        auto const n = (size < kBlockSize - tailLength) ? size : kBlockSize - tailLength;
+        memcpy(_tail + tailLength, data, n);
+        if (tailLength + n < kBlockSize) {
+            return *this;
+        }
+
+        details::sipCompress<CRounds>(_state, Solace::details::loadLE<Word>(_tail));
+        data += n;
+        size -= n;
+    }
+
+    for (; size >= kBlockSize; size -= kBlockSize, data += kBlockSize) {
+        details::sipCompress<CRounds>(_state, Solace::details::loadLE<Word>(data));
+    }
+
+    if (size > 0) {
+        memcpy(_tail, data, size);
+    }
+
+    return *this;
+}
+
+
+template<typename Key, int CRounds, int DRounds>
+void
+SipHash<Key, CRounds, DRounds>::digestUnchecked(MutableMemoryView dest) {
+    Solace::details::storeLE(dest.begin(), value());
+}
+
+
+template class SipHash<SipHashKey, 2, 4>;
+template class SipHash<SipHashKey, 1, 3>;
+template class SipHash<HalfSipHashKey, 2, 4>;
+template class SipHash<HalfSipHashKey, 1, 3>;
+
+}  // End of namespace hashing
+}  // End of namespace Solace
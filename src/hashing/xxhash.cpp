@@ -0,0 +1,583 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		solace/hashing/xxhash.cpp
+ *	@brief		Implementation of XXH64 and XXH3 hashing algorithms
+ ******************************************************************************/
+#include "solace/hashing/xxhash.hpp"
+#include "solace/byteWriter.hpp"
+
+#include "solace/details/byte_swap.hpp"
+#include "solace/details/cpu_features.hpp"
+
+#include <algorithm>  // std::min
+#include <cstring>  // memcpy
+
+#if defined(SOLACE_X86_DISPATCH)
+#include <immintrin.h>
+#endif
+
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+static const StringLiteral XXH64_NAME = "XXH64";
+static const StringLiteral XXH3_NAME = "XXH3";
+
+
+namespace /* anonymous */ {
+
+constexpr uint32 kPrime32_1 = 0x9E3779B1U;
+constexpr uint32 kPrime32_2 = 0x85EBCA77U;
+constexpr uint32 kPrime32_3 = 0xC2B2AE3DU;
+
+constexpr uint64 kPrime64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64 kPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64 kPrime64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64 kPrime64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64 kPrime64_5 = 0x27D4EB2F165667C5ULL;
+
+constexpr uint64 kPrimeMx1 = 0x165667919E3779F9ULL;
+constexpr uint64 kPrimeMx2 = 0x9FB21C651E98DF25ULL;
+
+
+inline uint64 rotl64(uint64 x, int r) noexcept {
+	return (x << r) | (x >> (64 - r));
+}
+
+inline uint64 read64(byte const* p) noexcept { return details::loadLE<uint64>(p); }
+inline uint32 read32(byte const* p) noexcept { return details::loadLE<uint32>(p); }
+
+
+//-----------------------------------------------------------------------------
+// XXH64
+//-----------------------------------------------------------------------------
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline uint64 xxh64Round(uint64 acc, uint64 input) noexcept {
+	acc += input * kPrime64_2;
+	acc = rotl64(acc, 31);
+	acc *= kPrime64_1;
+
+	return acc;
+}
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline uint64 xxh64MergeRound(uint64 acc, uint64 value) noexcept {
+	acc ^= xxh64Round(0, value);
+	acc = acc * kPrime64_1 + kPrime64_4;
+
+	return acc;
+}
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline uint64 xxh64Avalanche(uint64 h) noexcept {
+	h ^= h >> 33;
+	h *= kPrime64_2;
+	h ^= h >> 29;
+	h *= kPrime64_3;
+	h ^= h >> 32;
+
+	return h;
+}
+
+/// Consume 32 byte stripes of input.
+inline byte const* xxh64Stripes(uint64 acc[4], byte const* p, size_t count) noexcept {
+	for (size_t i = 0; i < count; ++i, p += 32) {
+		acc[0] = xxh64Round(acc[0], read64(p));
+		acc[1] = xxh64Round(acc[1], read64(p + 8));
+		acc[2] = xxh64Round(acc[2], read64(p + 16));
+		acc[3] = xxh64Round(acc[3], read64(p + 24));
+	}
+
+	return p;
+}
+
+
+//-----------------------------------------------------------------------------
+// XXH3
+//-----------------------------------------------------------------------------
+
+constexpr byte kSecret[XxHash3::kSecretSize] = {
+	0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+	0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+	0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+	0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+	0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+	0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+	0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+	0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+	0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+	0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+	0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+	0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+constexpr size_t kStripeLength = 64;
+constexpr size_t kSecretConsumeRate = 8;      //!< Secret bytes consumed by each stripe
+constexpr size_t kSecretLimit = XxHash3::kSecretSize - kStripeLength;
+constexpr size_t kStripesPerBlock = kSecretLimit / kSecretConsumeRate;
+constexpr size_t kSecretLastAccStart = 7;
+constexpr size_t kSecretMergeAccsStart = 11;
+constexpr size_t kMidSizeMax = 240;
+
+
+/// Multiply two 64 bit values into 128 bit product and fold it by XOR-ing its halves.
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline uint64 mul128Fold64(uint64 lhs, uint64 rhs) noexcept {
+#if defined(__SIZEOF_INT128__)
+	__extension__ typedef unsigned __int128 uint128;
+	auto const product = static_cast<uint128>(lhs) * rhs;
+
+	return static_cast<uint64>(product) ^ static_cast<uint64>(product >> 64);
+#else
+	auto const loLo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+	auto const hiLo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+	auto const loHi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+	auto const hiHi = (lhs >> 32) * (rhs >> 32);
+	auto const cross = (loLo >> 32) + (hiLo & 0xFFFFFFFF) + loHi;
+	auto const upper = (hiLo >> 32) + (cross >> 32) + hiHi;
+	auto const lower = (cross << 32) | (loLo & 0xFFFFFFFF);
+
+	return lower ^ upper;
+#endif
+}
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline uint64 xxh3Avalanche(uint64 h) noexcept {
+	h ^= h >> 37;
+	h *= kPrimeMx1;
+	h ^= h >> 32;
+
+	return h;
+}
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline uint64 rrmxmx(uint64 h, uint64 length) noexcept {
+	h ^= rotl64(h, 49) ^ rotl64(h, 24);
+	h *= kPrimeMx2;
+	h ^= (h >> 35) + length;
+	h *= kPrimeMx2;
+
+	return h ^ (h >> 28);
+}
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline uint64 mix16(byte const* input, byte const* secret, uint64 seed) noexcept {
+	return mul128Fold64(read64(input) ^ (read64(secret) + seed),
+						read64(input + 8) ^ (read64(secret + 8) - seed));
+}
+
+
+/// Hash inputs of up to kMidSizeMax bytes: these are mixed with the default secret and the seed directly.
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+uint64 xxh3HashShort(byte const* input, size_t length, uint64 seed) noexcept {
+	auto const secret = kSecret;
+
+	if (length == 0) {
+		return xxh64Avalanche(seed ^ (read64(secret + 56) ^ read64(secret + 64)));
+	}
+
+	if (length <= 3) {
+		auto const combined = (static_cast<uint32>(input[0]) << 16) | (static_cast<uint32>(input[length >> 1]) << 24) |
+							  static_cast<uint32>(input[length - 1]) | (static_cast<uint32>(length) << 8);
+		auto const bitflip = (read32(secret) ^ read32(secret + 4)) + seed;
+
+		return xxh64Avalanche(combined ^ bitflip);
+	}
+
+	if (length <= 8) {
+		seed ^= static_cast<uint64>(__builtin_bswap32(static_cast<uint32>(seed))) << 32;
+		auto const bitflip = (read64(secret + 8) ^ read64(secret + 16)) - seed;
+		auto const input64 = read32(input + length - 4) + (static_cast<uint64>(read32(input)) << 32);
+
+		return rrmxmx(input64 ^ bitflip, length);
+	}
+
+	if (length <= 16) {
+		auto const bitflip1 = (read64(secret + 24) ^ read64(secret + 32)) + seed;
+		auto const bitflip2 = (read64(secret + 40) ^ read64(secret + 48)) - seed;
+		auto const lo = read64(input) ^ bitflip1;
+		auto const hi = read64(input + length - 8) ^ bitflip2;
+
+		return xxh3Avalanche(length + __builtin_bswap64(lo) + hi + mul128Fold64(lo, hi));
+	}
+
+	uint64 acc = length * kPrime64_1;
+	if (length <= 128) {
+		// Pairs of 16 byte lanes from the start and the end of input, overlapping for lengths not multiple of 32
+		auto const rounds = (length - 1) / 32;
+		for (size_t i = 0; i <= rounds; ++i) {
+			acc += mix16(input + 16 * i, secret + 32 * i, seed);
+			acc += mix16(input + length - 16 * (i + 1), secret + 32 * i + 16, seed);
+		}
+
+		return xxh3Avalanche(acc);
+	}
+
+	constexpr size_t kMidSizeStartOffset = 3;
+	constexpr size_t kMidSizeLastOffset = 17;
+	constexpr size_t kSecretSizeMin = 136;
+
+	for (size_t i = 0; i < 8; ++i) {
+		acc += mix16(input + 16 * i, secret + 16 * i, seed);
+	}
+	acc = xxh3Avalanche(acc);
+
+	auto accEnd = mix16(input + length - 16, secret + kSecretSizeMin - kMidSizeLastOffset, seed);
+	for (size_t i = 8; i < length / 16; ++i) {
+		accEnd += mix16(input + 16 * i, secret + 16 * (i - 8) + kMidSizeStartOffset, seed);
+	}
+
+	return xxh3Avalanche(acc + accEnd);
+}
+
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+void accumulatePortable(uint64* acc, byte const* input, byte const* secret, size_t stripes) noexcept {
+	for (size_t n = 0; n < stripes; ++n, input += kStripeLength, secret += kSecretConsumeRate) {
+		for (size_t lane = 0; lane < 8; ++lane) {
+			auto const data = read64(input + 8 * lane);
+			auto const key = data ^ read64(secret + 8 * lane);
+			acc[lane ^ 1] += data;  // Swap adjacent lanes
+			acc[lane] += (key & 0xFFFFFFFF) * (key >> 32);
+		}
+	}
+}
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+void scramblePortable(uint64* acc, byte const* secret) noexcept {
+	for (size_t lane = 0; lane < 8; ++lane) {
+		auto a = acc[lane];
+		a ^= a >> 47;
+		a ^= read64(secret + 8 * lane);
+		a *= kPrime32_1;
+		acc[lane] = a;
+	}
+}
+
+
+#if defined(SOLACE_X86_DISPATCH)
+
+SOLACE_TARGET("avx2")
+void accumulateAvx2(uint64* acc, byte const* input, byte const* secret, size_t stripes) noexcept {
+	auto const accPtr = reinterpret_cast<__m256i*>(acc);
+	auto acc0 = _mm256_loadu_si256(accPtr);
+	auto acc1 = _mm256_loadu_si256(accPtr + 1);
+
+	for (size_t n = 0; n < stripes; ++n, input += kStripeLength, secret += kSecretConsumeRate) {
+		auto const data0 = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(input));
+		auto const data1 = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(input + 32));
+		auto const key0 = _mm256_xor_si256(data0, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(secret)));
+		auto const key1 = _mm256_xor_si256(data1, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(secret + 32)));
+
+		// Low half of each key times its high half, plus input with adjacent lanes swapped.
+		auto const product0 = _mm256_mul_epu32(key0, _mm256_srli_epi64(key0, 32));
+		auto const product1 = _mm256_mul_epu32(key1, _mm256_srli_epi64(key1, 32));
+		acc0 = _mm256_add_epi64(acc0, _mm256_add_epi64(product0, _mm256_shuffle_epi32(data0, _MM_SHUFFLE(1, 0, 3, 2))));
+		acc1 = _mm256_add_epi64(acc1, _mm256_add_epi64(product1, _mm256_shuffle_epi32(data1, _MM_SHUFFLE(1, 0, 3, 2))));
+	}
+
+	_mm256_storeu_si256(accPtr, acc0);
+	_mm256_storeu_si256(accPtr + 1, acc1);
+}
+
+SOLACE_TARGET("avx2")
+void scrambleAvx2(uint64* acc, byte const* secret) noexcept {
+	auto const accPtr = reinterpret_cast<__m256i*>(acc);
+	auto const prime = _mm256_set1_epi32(static_cast<int>(kPrime32_1));
+
+	for (int i = 0; i < 2; ++i) {
+		auto a = _mm256_loadu_si256(accPtr + i);
+		a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+		a = _mm256_xor_si256(a, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(secret + 32 * i)));
+
+		// 64 bit multiply by a 32 bit prime out of two 32x32 multiplies
+		auto const productLo = _mm256_mul_epu32(a, prime);
+		auto const productHi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+		_mm256_storeu_si256(accPtr + i, _mm256_add_epi64(productLo, _mm256_slli_epi64(productHi, 32)));
+	}
+}
+
+#endif  // SOLACE_X86_DISPATCH
+
+
+void accumulate(uint64* acc, byte const* input, byte const* secret, size_t stripes) noexcept {
+#if defined(SOLACE_X86_DISPATCH)
+	if (details::cpuFeatures().avx2) {
+		accumulateAvx2(acc, input, secret, stripes);
+		return;
+	}
+#endif
+
+	accumulatePortable(acc, input, secret, stripes);
+}
+
+void scramble(uint64* acc, byte const* secret) noexcept {
+#if defined(SOLACE_X86_DISPATCH)
+	if (details::cpuFeatures().avx2) {
+		scrambleAvx2(acc, secret);
+		return;
+	}
+#endif
+
+	scramblePortable(acc, secret);
+}
+
+
+/**
+ * Consume stripes of input, scrambling accumulators at the end of every block.
+ * @return Pointer past the last consumed stripe.
+ */
+byte const* consumeStripes(uint64* acc, uint32& stripesInBlock, byte const* input, size_t stripes,
+						   byte const* secret) noexcept {
+	while (stripes > 0) {
+		auto const count = std::min<size_t>(stripes, kStripesPerBlock - stripesInBlock);
+		accumulate(acc, input, secret + stripesInBlock * kSecretConsumeRate, count);
+		input += count * kStripeLength;
+		stripes -= count;
+		stripesInBlock += static_cast<uint32>(count);
+
+		if (stripesInBlock == kStripesPerBlock) {
+			scramble(acc, secret + kSecretLimit);
+			stripesInBlock = 0;
+		}
+	}
+
+	return input;
+}
+
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+uint64 mergeAccumulators(uint64 const* acc, byte const* secret, uint64 start) noexcept {
+	auto result = start;
+	for (size_t i = 0; i < 4; ++i) {
+		result += mul128Fold64(acc[2 * i] ^ read64(secret + 16 * i),
+							   acc[2 * i + 1] ^ read64(secret + 16 * i + 8));
+	}
+
+	return xxh3Avalanche(result);
+}
+
+}  // anonymous namespace
+
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+XxHash64::XxHash64(uint64 seed) noexcept
+	: _acc{seed + kPrime64_1 + kPrime64_2, seed + kPrime64_2, seed, seed - kPrime64_1}
+	, _seed{seed}
+{
+}
+
+
+StringView
+XxHash64::getAlgorithm() const {
+	return XXH64_NAME;
+}
+
+
+XxHash64::size_type
+XxHash64::getDigestLength() const {
+	return 64;
+}
+
+
+HashingAlgorithm&
+XxHash64::update(MemoryView input) {
+	auto p = input.begin();
+	auto size = input.size();
+	_totalLength += size;
+
+	if (_bufferSize + size < sizeof(_buffer)) {
+		if (size > 0) {
+			memcpy(_buffer + _bufferSize, p, size);
+			_bufferSize += static_cast<uint32>(size);
+		}
+
+		return (*this);
+	}
+
+	if (_bufferSize > 0) {
+		auto const fill = sizeof(_buffer) - _bufferSize;
+		memcpy(_buffer + _bufferSize, p, fill);
+		xxh64Stripes(_acc, _buffer, 1);
+		p += fill;
+		size -= fill;
+		_bufferSize = 0;
+	}
+
+	p = xxh64Stripes(_acc, p, size / 32);
+	_bufferSize = static_cast<uint32>(size % 32);
+	if (_bufferSize > 0) {
+		memcpy(_buffer, p, _bufferSize);
+	}
+
+	return (*this);
+}
+
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+uint64
+XxHash64::value() const noexcept {
+	uint64 h;
+	if (_totalLength >= 32) {
+		h = rotl64(_acc[0], 1) + rotl64(_acc[1], 7) + rotl64(_acc[2], 12) + rotl64(_acc[3], 18);
+		for (auto acc : _acc) {
+			h = xxh64MergeRound(h, acc);
+		}
+	} else {
+		h = _seed + kPrime64_5;
+	}
+
+	h += _totalLength;
+
+	auto p = _buffer;
+	auto size = _bufferSize;
+	for (; size >= 8; size -= 8, p += 8) {
+		h ^= xxh64Round(0, read64(p));
+		h = rotl64(h, 27) * kPrime64_1 + kPrime64_4;
+	}
+
+	if (size >= 4) {
+		h ^= read32(p) * kPrime64_1;
+		h = rotl64(h, 23) * kPrime64_2 + kPrime64_3;
+		p += 4;
+		size -= 4;
+	}
+
+	for (; size > 0; --size, ++p) {
+		h ^= *p * kPrime64_5;
+		h = rotl64(h, 11) * kPrime64_1;
+	}
+
+	return xxh64Avalanche(h);
+}
+
+
+void
+XxHash64::digestUnchecked(MutableMemoryView dest) {
+	ByteWriter writer{dest};
+	writer.writeBE(value());
+}
+
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+XxHash3::XxHash3(uint64 seed) noexcept
+	: _acc{kPrime32_3, kPrime64_1, kPrime64_2, kPrime64_3, kPrime64_4, kPrime32_2, kPrime64_5, kPrime32_1}
+	, _seed{seed}
+{
+	// Long inputs are hashed with a secret derived from the seed
+	for (size_t i = 0; i < kSecretSize; i += 16) {
+		details::storeLE(_secret + i, read64(kSecret + i) + seed);
+		details::storeLE(_secret + i + 8, read64(kSecret + i + 8) - seed);
+	}
+}
+
+
+StringView
+XxHash3::getAlgorithm() const {
+	return XXH3_NAME;
+}
+
+
+XxHash3::size_type
+XxHash3::getDigestLength() const {
+	return 64;
+}
+
+
+HashingAlgorithm&
+XxHash3::update(MemoryView input) {
+	auto p = input.begin();
+	auto size = input.size();
+	_totalLength += size;
+
+	if (size <= kBufferSize - _bufferSize) {
+		if (size > 0) {
+			memcpy(_buffer + _bufferSize, p, size);
+			_bufferSize += static_cast<uint32>(size);
+		}
+
+		return (*this);
+	}
+
+	// At least one byte is always left buffered: the last stripe is processed differently by value().
+	if (_bufferSize > 0) {
+		auto const fill = kBufferSize - _bufferSize;
+		memcpy(_buffer + _bufferSize, p, fill);
+		p += fill;
+		size -= fill;
+		consumeStripes(_acc, _stripesInBlock, _buffer, kBufferSize / kStripeLength, _secret);
+		_bufferSize = 0;
+	}
+
+	if (size > kBufferSize) {
+		p = consumeStripes(_acc, _stripesInBlock, p, (size - 1) / kStripeLength, _secret);
+		size = static_cast<size_type>(input.end() - p);
+
+		// Keep the last consumed stripe: it may be needed to complete the last stripe of the input
+		memcpy(_buffer + kBufferSize - kStripeLength, p - kStripeLength, kStripeLength);
+	}
+
+	memcpy(_buffer, p, size);
+	_bufferSize = static_cast<uint32>(size);
+
+	return (*this);
+}
+
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+uint64
+XxHash3::value() const noexcept {
+	if (_totalLength <= kMidSizeMax) {
+		return xxh3HashShort(_buffer, _totalLength, _seed);
+	}
+
+	uint64 acc[8];
+	memcpy(acc, _acc, sizeof(acc));
+
+	byte lastStripe[kStripeLength];
+	byte const* lastStripePtr;
+	if (_bufferSize >= kStripeLength) {
+		auto stripesInBlock = _stripesInBlock;
+		consumeStripes(acc, stripesInBlock, _buffer, (_bufferSize - 1) / kStripeLength, _secret);
+		lastStripePtr = _buffer + _bufferSize - kStripeLength;
+	} else {
+		// Complete the last stripe with the tail of previously consumed data
+		auto const catchup = kStripeLength - _bufferSize;
+		memcpy(lastStripe, _buffer + kBufferSize - catchup, catchup);
+		memcpy(lastStripe + catchup, _buffer, _bufferSize);
+		lastStripePtr = lastStripe;
+	}
+
+	accumulate(acc, lastStripePtr, _secret + kSecretLimit - kSecretLastAccStart, 1);
+
+	return mergeAccumulators(acc, _secret + kSecretMergeAccsStart, _totalLength * kPrime64_1);
+}
+
+
+void
+XxHash3::digestUnchecked(MutableMemoryView dest) {
+	ByteWriter writer{dest};
+	writer.writeBE(value());
+}
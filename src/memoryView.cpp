@@ -24,10 +24,17 @@
 #include "solace/error.hpp"
 #include "solace/posixErrorDomain.hpp"
 
+#include "solace/details/byte_swap.hpp"
+#include "solace/details/cpu_features.hpp"
+
 #include <cstring>		// memcmp
 #include <algorithm>    // std::min/max
 #include <sys/mman.h>   // mlock/munlock
 
+#if defined(SOLACE_X86_DISPATCH)
+#include <immintrin.h>
+#endif
+
 
 using namespace Solace;
 
@@ -92,3 +99,79 @@ bool MemoryView::equals(MemoryView const& other) const noexcept {
 	return (std::memcmp(_dataAddress, other._dataAddress, _size) == 0);
 }
 
+
+
+
+namespace /* anonymous */ {
+
+#if defined(SOLACE_X86_DISPATCH)
+
+/// PSHUFB mask reversing bytes of each valueSize bytes long value in a 16 byte lane.
+inline void byteSwapMask(byte mask[16], size_t valueSize) noexcept {
+	for (size_t i = 0; i < 16; ++i) {
+		mask[i] = static_cast<byte>(i / valueSize * valueSize + (valueSize - 1 - i % valueSize));
+	}
+}
+
+
+/** @return Number of bytes copied, a multiple of 16. */
+SOLACE_TARGET("ssse3")
+size_t copyByteSwappedSsse3(byte* dest, byte const* src, size_t len, size_t valueSize) noexcept {
+	byte maskBytes[16];
+	byteSwapMask(maskBytes, valueSize);
+	auto const mask = _mm_loadu_si128(reinterpret_cast<__m128i const*>(maskBytes));
+
+	size_t i = 0;
+	for (; i + 16 <= len; i += 16) {
+		auto const in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_shuffle_epi8(in, mask));
+	}
+
+	return i;
+}
+
+
+/** @return Number of bytes copied, a multiple of 32. */
+SOLACE_TARGET("avx2")
+size_t copyByteSwappedAvx2(byte* dest, byte const* src, size_t len, size_t valueSize) noexcept {
+	byte maskBytes[16];
+	byteSwapMask(maskBytes, valueSize);
+	auto const mask = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(maskBytes)));
+
+	size_t i = 0;
+	for (; i + 32 <= len; i += 32) {
+		auto const in = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), _mm256_shuffle_epi8(in, mask));
+	}
+
+	return i;
+}
+
+#endif  // SOLACE_X86_DISPATCH
+
+}  // namespace
+
+
+void
+Solace::details::copyByteSwapped(void* dest, void const* src, size_t count, size_t valueSize) noexcept {
+	auto out = static_cast<byte*>(dest);
+	auto in = static_cast<byte const*>(src);
+	auto const len = count * valueSize;
+
+	size_t i = 0;
+#if defined(SOLACE_X86_DISPATCH)
+	auto const& cpu = cpuFeatures();
+	if (cpu.avx2 && len >= 32) {
+		i = copyByteSwappedAvx2(out, in, len, valueSize);
+	}
+	if (cpu.ssse3 && len - i >= 16) {
+		i += copyByteSwappedSsse3(out + i, in + i, len - i, valueSize);
+	}
+#endif
+
+	for (; i < len; i += valueSize) {
+		for (size_t k = 0; k < valueSize; ++k) {
+			out[i + k] = in[i + valueSize - 1 - k];
+		}
+	}
+}
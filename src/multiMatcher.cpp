@@ -0,0 +1,387 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ *	@file		solace/multiMatcher.cpp
+ *	@brief		Implementation of multiple literal patterns matcher.
+ ******************************************************************************/
+#include "solace/multiMatcher.hpp"
+#include "solace/posixErrorDomain.hpp"
+#include "solace/details/cpu_features.hpp"
+
+#include <algorithm>  // std::fill, std::min
+#include <cstring>    // memcpy, memcmp
+
+#if defined(SOLACE_X86_DISPATCH)
+#include <tmmintrin.h>
+#endif
+
+
+using namespace Solace;
+
+
+namespace /* anonymous */ {
+
+constexpr uint32 kNone = ~uint32{0};
+
+/// Patterns are distributed among this many buckets by the prefilter. Bucket of a pattern is its index mod 8.
+constexpr uint32 kTeddyBuckets = 8;
+constexpr uint32 kAllBuckets = (1 << kTeddyBuckets) - 1;
+
+/// The prefilter is only used for pattern sets of up to this size. Larger sets produce too many false candidates.
+constexpr size_t kTeddyMaxPatterns = 32;
+
+
+#if defined(SOLACE_X86_DISPATCH)
+
+/// Position where a pattern from any of the given buckets may start.
+struct Candidate {
+	size_t	offset;
+	uint32	buckets;
+};
+
+constexpr size_t kCandidatesBatch = 64;
+
+
+/**
+ * Teddy prefilter: for each byte position compute the set of buckets whose patterns' leading bytes
+ * match data at this position. Nibbles of each byte are looked up in the per-position mask tables with PSHUFB.
+ *
+ * @return Offset at which scan stopped: either the candidates buffer is full or there are no more full blocks.
+ */
+SOLACE_TARGET("ssse3")
+size_t findCandidatesSsse3(byte const* masks, uint32 fingerprintLength,
+						   byte const* data, size_t size, size_t from,
+						   Candidate* candidates, size_t& candidatesCount) noexcept {
+	__m128i lo[3], hi[3];
+	for (uint32 k = 0; k < fingerprintLength; ++k) {
+		lo[k] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(masks + 32 * k));
+		hi[k] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(masks + 32 * k + 16));
+	}
+
+	auto const nibbleMask = _mm_set1_epi8(0x0F);
+	auto const zero = _mm_setzero_si128();
+
+	auto i = from;
+	for (; i + 16 + fingerprintLength - 1 <= size && candidatesCount + 16 <= kCandidatesBatch; i += 16) {
+		auto acc = _mm_set1_epi8(-1);
+		for (uint32 k = 0; k < fingerprintLength; ++k) {
+			auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i + k));
+			auto const loNibbles = _mm_and_si128(block, nibbleMask);
+			auto const hiNibbles = _mm_and_si128(_mm_srli_epi16(block, 4), nibbleMask);
+			acc = _mm_and_si128(acc, _mm_and_si128(_mm_shuffle_epi8(lo[k], loNibbles),
+												   _mm_shuffle_epi8(hi[k], hiNibbles)));
+		}
+
+		auto lanes = static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(acc, zero))) ^ 0xFFFF;
+		if (lanes) {
+			alignas(16) byte buckets[16];
+			_mm_store_si128(reinterpret_cast<__m128i*>(buckets), acc);
+			for (; lanes; lanes &= lanes - 1) {
+				auto const lane = static_cast<size_t>(__builtin_ctz(lanes));
+				candidates[candidatesCount++] = Candidate{i + lane, buckets[lane]};
+			}
+		}
+	}
+
+	return i;
+}
+
+#endif  // SOLACE_X86_DISPATCH
+
+}  // namespace
+
+
+MultiMatcher::size_type
+MultiMatcher::patternLength(PatternId id) const {
+	assertIndexInRange(id, _patternsCount, "MultiMatcher::patternLength");
+
+	return _patternLength[id];
+}
+
+
+MultiMatcher::size_type
+MultiMatcher::verify(byte const* data, size_type size, size_type offset, uint32 buckets,
+					 void* context, MatchCallback onMatch) const {
+	size_type count = 0;
+	for (; buckets; buckets &= buckets - 1) {
+		auto const bucket = static_cast<uint32>(__builtin_ctz(buckets));
+		for (auto id = bucket; id < _patternsCount; id += kTeddyBuckets) {
+			auto const len = _patternLength[id];
+			if (len != 0 && len <= size - offset && memcmp(data + offset, _patternBytes + _patternOffset[id], len) == 0) {
+				onMatch(context, Match{id, offset});
+				++count;
+			}
+		}
+	}
+
+	return count;
+}
+
+
+MultiMatcher::size_type
+MultiMatcher::scan(MemoryView data, void* context, MatchCallback onMatch) const {
+	if (_fingerprintLength == 0 || !details::cpuFeatures().ssse3) {
+		uint32 state = 0;
+		return feed(state, 0, data, context, onMatch);
+	}
+
+	auto const bytes = data.begin();
+	auto const size = data.size();
+	size_type count = 0;
+	size_type i = 0;
+
+#if defined(SOLACE_X86_DISPATCH)
+	Candidate candidates[kCandidatesBatch];
+	while (true) {
+		size_t candidatesCount = 0;
+		auto const scannedUpTo = findCandidatesSsse3(&_fingerprintMasks[0][0][0], _fingerprintLength,
+													 bytes, size, i, candidates, candidatesCount);
+		for (size_t c = 0; c < candidatesCount; ++c) {
+			count += verify(bytes, size, candidates[c].offset, candidates[c].buckets, context, onMatch);
+		}
+
+		if (scannedUpTo == i) {
+			break;
+		}
+
+		i = scannedUpTo;
+	}
+#endif
+
+	// Scalar tail: every pattern is at least fingerprint long, so no match can start past the last fingerprint.
+	for (; i + _fingerprintLength <= size; ++i) {
+		uint32 buckets = kAllBuckets;
+		for (uint32 k = 0; k < _fingerprintLength; ++k) {
+			auto const c = bytes[i + k];
+			buckets &= _fingerprintMasks[k][0][c & 0x0F] & _fingerprintMasks[k][1][c >> 4];
+		}
+
+		if (buckets) {
+			count += verify(bytes, size, i, buckets, context, onMatch);
+		}
+	}
+
+	return count;
+}
+
+
+MultiMatcher::size_type
+MultiMatcher::feed(uint32& state, size_type position, MemoryView data, void* context, MatchCallback onMatch) const {
+	size_type count = 0;
+	auto s = state;
+	auto const bytes = data.begin();
+	auto const size = data.size();
+	for (size_type i = 0; i < size; ++i) {
+		s = _next[s * _classCount + _classOf[bytes[i]]];
+
+		for (auto r = _report[s]; r != kNone; r = _dictLink[r]) {
+			for (auto id = _terminal[r]; id != kNone; id = _sameAs[id]) {
+				onMatch(context, Match{id, position + i + 1 - _patternLength[id]});
+				++count;
+			}
+		}
+	}
+
+	state = s;
+
+	return count;
+}
+
+
+bool
+MultiMatcher::containsAny(MemoryView data) const {
+	uint32 state = 0;
+	auto const bytes = data.begin();
+	for (size_type i = 0; i < data.size(); ++i) {
+		state = _next[state * _classCount + _classOf[bytes[i]]];
+		if (_report[state] != kNone) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+Result<MultiMatcher, Error>
+Solace::makeMultiMatcher(MemoryManager& memManager, ArrayView<StringView const> patterns) {
+	MultiMatcher matcher;
+
+	uint64 totalLen = 0;
+	uint32 classCount = 1;  // Class 0 is reserved for bytes that do not appear in any patterns
+	for (auto const& p : patterns) {
+		totalLen += p.size();
+		for (auto c : p) {
+			// When all 256 byte values occur in patterns, the last one takes class 0 that no other byte uses.
+			auto& cls = matcher._classOf[static_cast<byte>(c)];
+			if (cls == 0 && classCount < 256) {
+				cls = narrow_cast<byte>(classCount++);
+			}
+		}
+	}
+
+	if (patterns.size() >= kNone || totalLen >= kNone) {
+		return makeError(BasicError::Overflow, "makeMultiMatcher");
+	}
+
+	auto const patternsCount = narrow_cast<uint32>(patterns.size());
+	auto const maxStates = totalLen + 1;
+	auto const tableSize = maxStates * classCount;
+
+	// Memory layout: transitions table, 3 per-state arrays, 3 per-pattern arrays and then pattern bytes.
+	auto const wordsCount = tableSize + 3 * maxStates + 3 * static_cast<uint64>(patternsCount);
+	auto maybeBuffer = memManager.allocate(wordsCount * sizeof(uint32) + totalLen);
+	if (!maybeBuffer) {
+		return maybeBuffer.moveError();
+	}
+
+	// Failure links and BFS queue are only needed while building the automaton.
+	auto maybeScratch = memManager.allocate(2 * maxStates * sizeof(uint32));
+	if (!maybeScratch) {
+		return maybeScratch.moveError();
+	}
+
+	matcher._memory = maybeBuffer.moveResult();
+	auto const next = static_cast<uint32*>(matcher._memory.view().dataAddress());
+	auto const terminal = next + tableSize;
+	auto const report = terminal + maxStates;
+	auto const dictLink = report + maxStates;
+	auto const sameAs = dictLink + maxStates;
+	auto const patternOffset = sameAs + patternsCount;
+	auto const patternLength = patternOffset + patternsCount;
+	auto const patternBytes = reinterpret_cast<byte*>(patternLength + patternsCount);
+
+	auto const fail = static_cast<uint32*>(maybeScratch.unwrap().view().dataAddress());
+	auto const queue = fail + maxStates;
+
+	std::fill(next, next + tableSize, kNone);
+
+	// Build a trie of all patterns
+	uint32 stateCount = 1;
+	uint32 bytesOffset = 0;
+	terminal[0] = kNone;
+	for (uint32 id = 0; id < patternsCount; ++id) {
+		auto const& pattern = patterns[id];
+		patternOffset[id] = bytesOffset;
+		patternLength[id] = pattern.size();
+		sameAs[id] = kNone;
+		if (pattern.empty()) {
+			continue;
+		}
+
+		memcpy(patternBytes + bytesOffset, pattern.data(), pattern.size());
+		bytesOffset += pattern.size();
+
+		uint32 state = 0;
+		for (auto c : pattern) {
+			auto& edge = next[state * classCount + matcher._classOf[static_cast<byte>(c)]];
+			if (edge == kNone) {
+				terminal[stateCount] = kNone;
+				edge = stateCount++;
+			}
+
+			state = edge;
+		}
+
+		if (terminal[state] == kNone) {
+			terminal[state] = id;
+		} else {  // Duplicate pattern: append to the list of patterns ending in this state
+			auto last = terminal[state];
+			while (sameAs[last] != kNone) {
+				last = sameAs[last];
+			}
+			sameAs[last] = id;
+		}
+	}
+
+	// Compute failure links breadth first and turn the trie into a DFA
+	uint32 head = 0, tail = 0;
+	dictLink[0] = kNone;
+	for (uint32 cls = 0; cls < classCount; ++cls) {
+		auto& edge = next[cls];
+		if (edge == kNone) {
+			edge = 0;
+		} else {
+			fail[edge] = 0;
+			queue[tail++] = edge;
+		}
+	}
+
+	while (head < tail) {
+		auto const state = queue[head++];
+		auto const fallbackState = fail[state];
+		dictLink[state] = (terminal[fallbackState] != kNone) ? fallbackState : dictLink[fallbackState];
+
+		for (uint32 cls = 0; cls < classCount; ++cls) {
+			auto& edge = next[state * classCount + cls];
+			auto const fallback = next[fallbackState * classCount + cls];
+			if (edge == kNone) {
+				edge = fallback;
+			} else {
+				fail[edge] = fallback;
+				queue[tail++] = edge;
+			}
+		}
+	}
+
+	for (uint32 state = 0; state < stateCount; ++state) {
+		report[state] = (terminal[state] != kNone) ? state : dictLink[state];
+	}
+
+	matcher._patternsCount = patternsCount;
+	matcher._classCount = classCount;
+	matcher._next = next;
+	matcher._terminal = terminal;
+	matcher._report = report;
+	matcher._dictLink = dictLink;
+	matcher._sameAs = sameAs;
+	matcher._patternOffset = patternOffset;
+	matcher._patternLength = patternLength;
+	matcher._patternBytes = patternBytes;
+
+	// Set up the prefilter for small pattern sets
+	uint32 minLength = kNone;
+	for (auto const& p : patterns) {
+		if (!p.empty()) {
+			minLength = std::min<uint32>(minLength, p.size());
+		}
+	}
+
+	if (minLength != kNone && patternsCount <= kTeddyMaxPatterns) {
+		matcher._fingerprintLength = std::min(minLength, MultiMatcher::kMaxFingerprintLength);
+		for (uint32 id = 0; id < patternsCount; ++id) {
+			auto const& pattern = patterns[id];
+			if (pattern.empty()) {
+				continue;
+			}
+
+			auto const bucketBit = static_cast<byte>(1 << (id % kTeddyBuckets));
+			for (uint32 k = 0; k < matcher._fingerprintLength; ++k) {
+				auto const c = static_cast<byte>(pattern[k]);
+				matcher._fingerprintMasks[k][0][c & 0x0F] |= bucketBit;
+				matcher._fingerprintMasks[k][1][c >> 4] |= bucketBit;
+			}
+		}
+	}
+
+	return Ok(mv(matcher));
+}
+
+
+Result<MultiMatcher, Error>
+Solace::makeMultiMatcher(ArrayView<StringView const> patterns) {
+	return makeMultiMatcher(getSystemHeapMemoryManager(), patterns);
+}
@@ -18,6 +18,11 @@
  *	@brief		Implementation of fixed size String.
  ******************************************************************************/
 #include "solace/string.hpp"
+#include "solace/multiMatcher.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include <cstring>    // memcpy
+#include <limits>
 
 
 using namespace Solace;
@@ -57,62 +62,144 @@ Solace::makeStringReplace(StringView str, String::value_type what, String::value
 		return maybeBuffer.moveError();
 	}
 
-	auto bufferView = maybeBuffer.unwrap().view();
-	auto writeResult = bufferView.write(str.view());
-	if (!writeResult) {
-		return writeResult.moveError();
-	}
-
-	auto offsetValue = bufferView.begin();
-	for (String::size_type i = 0; i < totalStrLen; ++i, ++offsetValue) {
-        if (*offsetValue == what) {
-            *offsetValue = with;
-        }
+	// Single pass copy-and-substitute: a branch-free loop the compiler can vectorize.
+	auto dest = maybeBuffer.unwrap().view().begin();
+	auto const src = str.data();
+	for (String::size_type i = 0; i < totalStrLen; ++i) {
+		auto const c = src[i];
+		dest[i] = static_cast<byte>((c == what) ? with : c);
     }
 
 	return String{ maybeBuffer.moveResult(), totalStrLen };
 }
 
 
-Result<String, Error> Solace::makeStringReplace(StringView str, StringView what, StringView by) {
-    auto const srcStrLen = str.size();
-    auto const delimLength = what.size();
-    StringView::size_type delimCount = 0;
+namespace /* anonymous */ {
 
-    for (StringView::size_type i = 0; i < srcStrLen && i + delimLength <= srcStrLen; ++i) {
-        if (what.equals(str.substring(i, i + delimLength))) {
-            delimCount += 1;
-            i += delimLength - 1;
-        }
-    }
+/// A match of one of the patterns in the source string.
+struct Match {
+	StringView::size_type	offset;
+	uint32					pattern;
+};
 
-    auto const byLen = by.size();
+/// Number of matches remembered by the search pass. Strings with more matches are re-scanned while copying.
+constexpr size_t kRecordedMatchesCount = 64;
 
-    // Note:  srcStrLen >= delimLength*delimCount. Thus this should not overflow.
-    auto const newStrLen = narrow_cast<StringView::size_type>(srcStrLen + byLen * delimCount - delimLength*delimCount);
 
-	auto maybeBuffer = getSystemHeapMemoryManager().allocate(newStrLen * sizeof(StringView::value_type));
-	auto writer = ByteWriter{maybeBuffer.unwrap().view()};
+void copyBytes(byte* dest, StringView src) noexcept {
+	if (!src.empty()) {
+		memcpy(dest, src.data(), src.size());
+	}
+}
 
-    StringView::size_type from = 0;
-    for (StringView::size_type to = 0; to < srcStrLen && to + delimLength <= srcStrLen; ++to) {
-        if (what.equals(str.substring(to, to + delimLength))) {
-            auto const tokLen = narrow_cast<StringView::size_type>(to - from);
 
-            writer.write(str.substring(from, from + tokLen).view());
-            writer.write(by.view());
+/**
+ * Replace non-overlapping matches produced by forEachMatch with corresponding replacement values.
+ * Output string size is computed exactly from matches found in the first pass.
+ * All the gaps between matches are copied in bulk.
+ *
+ * @param forEachMatch A function calling its second argument with every non-overlapping match,
+ * in order, starting at or after the offset given as the first argument.
+ */
+template<typename ForEachMatch>
+Result<String, Error>
+replaceAll(StringView str, ArrayView<StringView const> what, ArrayView<StringView const> with,
+		   ForEachMatch&& forEachMatch) {
+	Match recorded[kRecordedMatchesCount];
+	size_t recordedCount = 0;
+
+	int64 newStrLen = str.size();
+	forEachMatch(0, [&](Match const& m) {
+		newStrLen += static_cast<int64>(with[m.pattern].size()) - static_cast<int64>(what[m.pattern].size());
+		if (recordedCount < kRecordedMatchesCount) {
+			recorded[recordedCount++] = m;
+		}
+	});
 
-            to += delimLength - 1;
-            from = to + 1;
-        }
-    }
+	if (newStrLen > std::numeric_limits<StringView::size_type>::max()) {
+		return makeError(BasicError::Overflow, "makeStringReplace");
+	}
+
+	auto const resultLen = narrow_cast<StringView::size_type>(newStrLen);
+	auto maybeBuffer = getSystemHeapMemoryManager().allocate(resultLen * sizeof(StringView::value_type));
+	if (!maybeBuffer) {
+		return maybeBuffer.moveError();
+	}
+
+	auto dest = maybeBuffer.unwrap().view().begin();
+	StringView::size_type copiedUpTo = 0;
+	auto emit = [&](Match const& m) {
+		auto const gap = str.substring(copiedUpTo, m.offset);
+		copyBytes(dest, gap);
+		dest += gap.size();
+
+		auto const replacement = with[m.pattern];
+		copyBytes(dest, replacement);
+		dest += replacement.size();
 
-	auto result = writer.write(str.substring(from).view());
-	if (!result) {
-		return result.moveError();
+		copiedUpTo = narrow_cast<StringView::size_type>(m.offset + what[m.pattern].size());
+	};
+
+	for (size_t i = 0; i < recordedCount; ++i) {
+		emit(recorded[i]);
 	}
 
-	return String{ maybeBuffer.moveResult(), newStrLen };
+	if (recordedCount == kRecordedMatchesCount) {  // There may be more matches than we have recorded.
+		forEachMatch(copiedUpTo, emit);
+	}
+
+	copyBytes(dest, str.substring(copiedUpTo));
+
+	return String{ maybeBuffer.moveResult(), resultLen };
+}
+
+}  // namespace
+
+
+Result<String, Error>
+Solace::makeStringReplace(StringView str, StringView what, StringView by) {
+	if (what.empty()) {
+		return makeString(str);
+	}
+
+	StringView const patterns[] = {what};
+	StringView const replacements[] = {by};
+
+	return replaceAll(str, patterns, replacements, [str, what](StringView::size_type from, auto&& onMatch) {
+		for (auto offset = str.indexOf(what, from); offset;
+			 offset = str.indexOf(what, narrow_cast<StringView::size_type>(*offset + what.size()))) {
+			onMatch(Match{*offset, 0});
+		}
+	});
+}
+
+
+Result<String, Error>
+Solace::makeStringReplace(StringView str, ArrayView<StringView const> what, ArrayView<StringView const> with) {
+	if (what.size() != with.size()) {
+		return makeError(GenericError::INVAL, "makeStringReplace: patterns and replacements count mismatch");
+	}
+
+	auto maybeMatcher = makeMultiMatcher(what);
+	if (!maybeMatcher) {
+		return maybeMatcher.moveError();
+	}
+
+	auto const& matcher = maybeMatcher.unwrap();
+
+	// Stream matches are reported by their end position, longest first. Taking the first one that does not overlap
+	// the previous replacement picks the earliest ending and then the longest match.
+	return replaceAll(str, what, with, [&](StringView::size_type from, auto&& onMatch) {
+		auto nextFree = from;
+		auto stream = matcher.stream();
+		stream.feed(str.substring(from), [&](MultiMatcher::Match const& m) {
+			auto const offset = narrow_cast<StringView::size_type>(from + m.offset);
+			if (offset >= nextFree) {
+				onMatch(Match{offset, m.pattern});
+				nextFree = narrow_cast<StringView::size_type>(offset + what[m.pattern].size());
+			}
+		});
+	});
 }
 
 
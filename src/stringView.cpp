@@ -19,13 +19,120 @@
  ******************************************************************************/
 #include "solace/stringView.hpp"
 
-#include <cstring>      // strlen
+#include <cstring>      // strlen, memchr, memcmp
 #include <algorithm>    // std::min
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 
 using namespace Solace;
 
 
+namespace /*anonymous*/ {
+
+#if defined(__SSE2__)
+
+/// Fold 16 ASCII characters to lower case at once. Bytes outside of 'A'..'Z' are left untouched.
+inline __m128i foldAscii16(__m128i x) noexcept {
+	// Shift 'A'..'Z' into [-128, -103] so that a single signed comparison selects upper case letters.
+	auto const shifted = _mm_add_epi8(x, _mm_set1_epi8(0x80 - 'A'));
+	auto const isUpper = _mm_cmplt_epi8(shifted, _mm_set1_epi8(-128 + 26));
+
+	return _mm_or_si128(x, _mm_and_si128(isUpper, _mm_set1_epi8(0x20)));
+}
+
+#endif
+
+/**
+ * Find the first position where two character sequences differ when case is ignored.
+ * @return Index of the first mismatch or len if sequences are equal.
+ */
+StringView::size_type
+mismatchIgnoreCase(char const* a, char const* b, StringView::size_type len) noexcept {
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	for (; i + 16 <= len; i += 16) {
+		auto const x = foldAscii16(_mm_loadu_si128(reinterpret_cast<__m128i const*>(a + i)));
+		auto const y = foldAscii16(_mm_loadu_si128(reinterpret_cast<__m128i const*>(b + i)));
+		auto const equalMask = _mm_movemask_epi8(_mm_cmpeq_epi8(x, y));
+		if (equalMask != 0xFFFF) {
+			return narrow_cast<StringView::size_type>(i + __builtin_ctz(~static_cast<unsigned>(equalMask)));
+		}
+	}
+#endif
+
+	for (; i < len; ++i) {
+		if (Char::foldAscii(a[i]) != Char::foldAscii(b[i])) {
+			break;
+		}
+	}
+
+	return narrow_cast<StringView::size_type>(i);
+}
+
+
+/**
+ * Find the first occurrence of a needle in the haystack.
+ * SSE2 path compares the first and the last character of the needle against 16 positions at once
+ * and only verifies candidate positions where both match.
+ * @return Offset of the first occurrence or hayLen if there is none.
+ */
+size_t
+findSubstring(char const* hay, size_t hayLen, char const* needle, size_t needleLen) noexcept {
+	if (needleLen == 0) {
+		return 0;
+	}
+
+	if (hayLen < needleLen) {
+		return hayLen;
+	}
+
+	if (needleLen == 1) {
+		auto const found = static_cast<char const*>(std::memchr(hay, needle[0], hayLen));
+		return found ? static_cast<size_t>(found - hay) : hayLen;
+	}
+
+	size_t const lastStart = hayLen - needleLen;
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	auto const firstChar = _mm_set1_epi8(needle[0]);
+	auto const lastChar = _mm_set1_epi8(needle[needleLen - 1]);
+	for (; i + 16 <= lastStart + 1; i += 16) {
+		auto const blockFirst = _mm_loadu_si128(reinterpret_cast<__m128i const*>(hay + i));
+		auto const blockLast = _mm_loadu_si128(reinterpret_cast<__m128i const*>(hay + i + needleLen - 1));
+		auto mask = static_cast<unsigned>(_mm_movemask_epi8(
+						_mm_and_si128(_mm_cmpeq_epi8(firstChar, blockFirst),
+									  _mm_cmpeq_epi8(lastChar, blockLast))));
+
+		while (mask != 0) {
+			auto const candidate = i + static_cast<size_t>(__builtin_ctz(mask));
+			if (std::memcmp(hay + candidate + 1, needle + 1, needleLen - 2) == 0) {
+				return candidate;
+			}
+
+			mask &= mask - 1;
+		}
+	}
+#endif
+
+	for (; i <= lastStart; ++i) {
+		if (hay[i] == needle[0] &&
+			hay[i + needleLen - 1] == needle[needleLen - 1] &&
+			std::memcmp(hay + i + 1, needle + 1, needleLen - 2) == 0) {
+			return i;
+		}
+	}
+
+	return hayLen;
+}
+
+}  // namespace
+
+
 StringView::StringView(const char* data) noexcept
     : StringView((data != nullptr)
                ? narrow_cast<size_type>(std::strlen(data))
@@ -52,6 +159,28 @@ StringView::equals(StringView str) const noexcept {
 }
 
 
+bool
+StringView::equalsIgnoreCase(StringView str) const noexcept {
+	auto const thisLen = size();
+
+	return (thisLen == str.size()) &&
+			(mismatchIgnoreCase(_data, str._data, thisLen) == thisLen);
+}
+
+
+int
+StringView::compareToIgnoreCase(StringView str) const noexcept {
+	auto const commonLen = std::min(size(), str.size());
+	auto const i = mismatchIgnoreCase(_data, str._data, commonLen);
+	if (i < commonLen) {
+		return static_cast<unsigned char>(Char::foldAscii(_data[i])) -
+				static_cast<unsigned char>(Char::foldAscii(str._data[i]));
+	}
+
+	return static_cast<int>(size()) - static_cast<int>(str.size());
+}
+
+
 int
 StringView::compareTo(StringView x) const noexcept {
     auto const thisSize = size();
@@ -85,17 +214,16 @@ StringView::substring(size_type from, size_type to) const noexcept {
 Optional<StringView::size_type>
 StringView::indexOf(value_type ch, size_type fromIndex) const noexcept {
     auto const thisSize = size();
-    if (thisSize < fromIndex) {
+    if (thisSize <= fromIndex) {
         return none;
     }
 
-    for (; fromIndex < thisSize; ++fromIndex) {
-        if (_data[fromIndex] == ch) {
-            return Optional<size_type>(fromIndex);
-        }
-    }
+	auto const found = static_cast<char const*>(std::memchr(_data + fromIndex, ch, thisSize - fromIndex));
+	if (!found) {
+		return none;
+	}
 
-    return none;
+	return Optional<size_type>(narrow_cast<size_type>(found - _data));
 }
 
 
@@ -109,15 +237,11 @@ StringView::indexOf(StringView str, size_type fromIndex) const noexcept {
 		return result;
     }
 
-	size_type const rem = thisSize - strSize + 1;
-	for (; fromIndex < rem; ++fromIndex) {
-        if (_data[fromIndex] == str._data[0] &&
-            str.equals(substring(fromIndex, fromIndex + strSize))) {
-
-			result = fromIndex;
-			break;
-        }
-    }
+	auto const hayLen = static_cast<size_t>(thisSize - fromIndex);
+	auto const offset = findSubstring(_data + fromIndex, hayLen, str._data, strSize);
+	if (offset < hayLen) {
+		result = narrow_cast<size_type>(fromIndex + offset);
+	}
 
 	return result;
 }
@@ -172,6 +296,15 @@ StringView::startsWith(StringView prefix) const noexcept {
 }
 
 
+bool
+StringView::startsWithIgnoreCase(StringView prefix) const noexcept {
+	auto const prefixSize = prefix.size();
+
+	return (prefixSize <= size()) &&
+			(mismatchIgnoreCase(_data, prefix._data, prefixSize) == prefixSize);
+}
+
+
 bool
 StringView::endsWith(StringView suffix) const noexcept {
     auto const thisSize = size();
@@ -230,3 +363,17 @@ StringView::hashCode() const noexcept {
 
     return result;
 }
+
+
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+uint64
+StringView::hashCodeIgnoreCase() const noexcept {
+	uint64 const prime = 31;
+
+	uint64 result = 0;
+	for (size_type i = 0; i < _size; ++i) {
+		result = static_cast<uint64>(Char::foldAscii(_data[i])) + (result * prime);
+	}
+
+	return result;
+}
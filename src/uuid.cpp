@@ -20,14 +20,296 @@
 #include "solace/uuid.hpp"
 #include "solace/base16.hpp"
 #include "solace/posixErrorDomain.hpp"
-
+#include "solace/details/byte_swap.hpp"
+#include "solace/details/cpu_features.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>  // uintptr_t
+#include <exception>
 #include <random>
+#include <cerrno>
 #include <cstring>  // memcmp (should review)
+#include <cstdlib>  // arc4random_buf
+
+#include <pthread.h>
+#include <unistd.h>  // getpid
+
+#if defined(__linux__)
+#include <sys/random.h>  // getrandom
+#endif
+
+#if defined(SOLACE_X86_DISPATCH)
+#include <immintrin.h>
+#endif
 
 
 using namespace Solace;
 
 
+namespace {
+
+constexpr uint32 kChaChaConstants[4] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+
+/// Number of forks of the process, incremented in the child.
+std::atomic<uint32> forkGeneration{0};
+
+void onForkChild() noexcept {
+    forkGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32 currentForkGeneration() noexcept {
+    // Registered before any generator is seeded, so every fork after that is counted
+    static bool const registered = (::pthread_atfork(nullptr, nullptr, onForkChild) == 0);
+    static_cast<void>(registered);
+
+    return forkGeneration.load(std::memory_order_relaxed);
+}
+
+
+/// Fill the buffer from the system's random number generator.
+void systemRandom(byte* dest, size_t size) noexcept {
+#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+    ::arc4random_buf(dest, size);  // Can not fail
+#else
+
+#if defined(__linux__)
+    while (size > 0) {
+        auto const result = ::getrandom(dest, size, 0);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        dest += result;
+        size -= static_cast<size_t>(result);
+    }
+
+    if (size == 0) {
+        return;
+    }
+#endif
+
+    try {  // No getrandom(), i.e. kernel older than 3.17, or no system generator known
+        std::random_device rd;
+        for (; size > 0; --size) {
+            *dest++ = static_cast<byte>(rd());
+        }
+
+        return;
+    } catch (std::exception const&) {
+        // No entropy source at all
+    }
+
+    // Last resort: UUIDs are predictable but still unique, as seeds differ in time, process and call.
+    static std::atomic<uint64> seedCounter{0};
+    uint64 const words[] = {
+        static_cast<uint64>(std::chrono::high_resolution_clock::now().time_since_epoch().count()),
+        static_cast<uint64>(::getpid()),
+        static_cast<uint64>(reinterpret_cast<uintptr_t>(dest)),
+        seedCounter.fetch_add(1, std::memory_order_relaxed)
+    };
+
+    for (size_t i = 0; i < size; ++i) {
+        dest[i] = static_cast<byte>(words[(i / 8) % 4] >> (8 * (i % 8)));
+    }
+#endif
+}
+
+
+inline uint32 rotl(uint32 x, int n) noexcept {
+    return (x << n) | (x >> (32 - n));
+}
+
+/// ChaCha quarter round applied to all the blocks at once.
+template<size_t Blocks>
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+inline void quarterRound(uint32 (&x)[16][Blocks], int a, int b, int c, int d) noexcept {
+    for (size_t i = 0; i < Blocks; ++i) {
+        x[a][i] += x[b][i]; x[d][i] = rotl(x[d][i] ^ x[a][i], 16);
+        x[c][i] += x[d][i]; x[b][i] = rotl(x[b][i] ^ x[c][i], 12);
+        x[a][i] += x[b][i]; x[d][i] = rotl(x[d][i] ^ x[a][i], 8);
+        x[c][i] += x[d][i]; x[b][i] = rotl(x[b][i] ^ x[c][i], 7);
+    }
+}
+
+/**
+ * Compute ChaCha20 keystream blocks with counters 0, 1, ... and a zero nonce.
+ * Blocks are computed side by side, one word of each at a time, so that the loops vectorize.
+ */
+template<size_t Blocks>
+SOLACE_NO_SANITIZE("unsigned-integer-overflow")
+void chacha20Blocks(uint32 const key[8], byte* out) noexcept {
+    uint32 x[16][Blocks];
+    for (size_t i = 0; i < Blocks; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            x[j][i] = kChaChaConstants[j];
+        }
+        for (size_t j = 0; j < 8; ++j) {
+            x[4 + j][i] = key[j];
+        }
+        x[12][i] = static_cast<uint32>(i);
+        x[13][i] = 0;
+        x[14][i] = 0;
+        x[15][i] = 0;
+    }
+
+    uint32 input[16][Blocks];
+    memcpy(input, x, sizeof(x));
+
+    for (int round = 0; round < 10; ++round) {
+        quarterRound(x, 0, 4,  8, 12);
+        quarterRound(x, 1, 5,  9, 13);
+        quarterRound(x, 2, 6, 10, 14);
+        quarterRound(x, 3, 7, 11, 15);
+        quarterRound(x, 0, 5, 10, 15);
+        quarterRound(x, 1, 6, 11, 12);
+        quarterRound(x, 2, 7,  8, 13);
+        quarterRound(x, 3, 4,  9, 14);
+    }
+
+    for (size_t i = 0; i < Blocks; ++i) {
+        for (size_t j = 0; j < 16; ++j) {
+            details::storeLE(out + 64 * i + 4 * j, x[j][i] + input[j][i]);
+        }
+    }
+}
+
+
+
+#if defined(SOLACE_X86_DISPATCH)
+
+SOLACE_TARGET("avx2")
+inline __m256i rotl16(__m256i x) noexcept {
+    return _mm256_shuffle_epi8(x, _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                                   2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13));
+}
+
+SOLACE_TARGET("avx2")
+inline __m256i rotl12(__m256i x) noexcept {
+    return _mm256_or_si256(_mm256_slli_epi32(x, 12), _mm256_srli_epi32(x, 20));
+}
+
+SOLACE_TARGET("avx2")
+inline __m256i rotl8(__m256i x) noexcept {
+    return _mm256_shuffle_epi8(x, _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                                   3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14));
+}
+
+SOLACE_TARGET("avx2")
+inline __m256i rotl7(__m256i x) noexcept {
+    return _mm256_or_si256(_mm256_slli_epi32(x, 7), _mm256_srli_epi32(x, 25));
+}
+
+SOLACE_TARGET("avx2")
+inline void quarterRound8(__m256i x[16], int a, int b, int c, int d) noexcept {
+    x[a] = _mm256_add_epi32(x[a], x[b]); x[d] = rotl16(_mm256_xor_si256(x[d], x[a]));
+    x[c] = _mm256_add_epi32(x[c], x[d]); x[b] = rotl12(_mm256_xor_si256(x[b], x[c]));
+    x[a] = _mm256_add_epi32(x[a], x[b]); x[d] = rotl8(_mm256_xor_si256(x[d], x[a]));
+    x[c] = _mm256_add_epi32(x[c], x[d]); x[b] = rotl7(_mm256_xor_si256(x[b], x[c]));
+}
+
+/// Transpose 8x8 matrix of 32 bit words: row i becomes column i.
+SOLACE_TARGET("avx2")
+inline void transpose8x8(__m256i r[8]) noexcept {
+    __m256i t[8];
+    for (size_t i = 0; i < 8; i += 2) {
+        t[i]     = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+    }
+
+    __m256i u[8];
+    for (size_t i = 0; i < 8; i += 4) {
+        u[i]     = _mm256_unpacklo_epi64(t[i],     t[i + 2]);
+        u[i + 1] = _mm256_unpackhi_epi64(t[i],     t[i + 2]);
+        u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+
+    for (size_t i = 0; i < 4; ++i) {
+        r[i]     = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+        r[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+}
+
+/// Compute 8 ChaCha20 keystream blocks at once, one block per lane.
+SOLACE_TARGET("avx2")
+void chacha20Blocks8(uint32 const key[8], byte* out) noexcept {
+    __m256i x[16];
+    for (size_t j = 0; j < 4; ++j) {
+        x[j] = _mm256_set1_epi32(static_cast<int>(kChaChaConstants[j]));
+    }
+    for (size_t j = 0; j < 8; ++j) {
+        x[4 + j] = _mm256_set1_epi32(static_cast<int>(key[j]));
+    }
+    x[12] = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    x[13] = _mm256_setzero_si256();
+    x[14] = _mm256_setzero_si256();
+    x[15] = _mm256_setzero_si256();
+
+    __m256i input[16];
+    memcpy(input, x, sizeof(x));
+
+    for (int round = 0; round < 10; ++round) {
+        quarterRound8(x, 0, 4,  8, 12);
+        quarterRound8(x, 1, 5,  9, 13);
+        quarterRound8(x, 2, 6, 10, 14);
+        quarterRound8(x, 3, 7, 11, 15);
+        quarterRound8(x, 0, 5, 10, 15);
+        quarterRound8(x, 1, 6, 11, 12);
+        quarterRound8(x, 2, 7,  8, 13);
+        quarterRound8(x, 3, 4,  9, 14);
+    }
+
+    for (size_t j = 0; j < 16; ++j) {
+        x[j] = _mm256_add_epi32(x[j], input[j]);
+    }
+
+    // Row j holds word j of all blocks: transpose so that a row holds half a block
+    transpose8x8(x);
+    transpose8x8(x + 8);
+    for (size_t i = 0; i < 8; ++i) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 64 * i), x[i]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 64 * i + 32), x[8 + i]);
+    }
+}
+
+#endif
+
+
+/// Compute 8 ChaCha20 keystream blocks with the widest instruction set the CPU supports.
+void chacha20Blocks8Dispatch(uint32 const key[8], byte* out) noexcept {
+#if defined(SOLACE_X86_DISPATCH)
+    if (details::cpuFeatures().avx2) {
+        chacha20Blocks8(key, out);
+        return;
+    }
+#endif
+
+    chacha20Blocks<8>(key, out);
+}
+
+
+/// Set version 4 (random) and RFC 4122 variant bits.
+inline void setVersion4(byte* bytes) noexcept {
+    bytes[6] = static_cast<byte>((bytes[6] & 0x0F) | 0x40);
+    bytes[8] = static_cast<byte>((bytes[8] & 0x3F) | 0x80);
+}
+
+/// Wipe memory in a way that is not optimized away.
+void secureWipe(void* dest, size_t size) noexcept {
+    auto volatile* p = static_cast<byte volatile*>(dest);
+    while (size--) {
+        *p++ = 0;
+    }
+}
+
+}  // namespace
+
+
 UUID::UUID() noexcept
     : _bytes{0}
 {
@@ -183,25 +465,150 @@ Solace::makeUUID(uint32 a0, uint32 a1, uint32 a2, uint32 a3) noexcept {
 }
 
 
+UUIDGenerator::UUIDGenerator() noexcept
+    : _key{}
+    , _position{kBufferSize}
+    , _forkGeneration{0}
+    , _reseedOnFork{true}
+{
+    reseed();
+}
+
+
+UUIDGenerator::UUIDGenerator(MemoryView seed, bool reseedOnFork) noexcept
+    : _position{kBufferSize}
+    , _forkGeneration{0}
+    , _reseedOnFork{reseedOnFork}
+{
+    for (size_type i = 0; i < 8; ++i) {
+        _key[i] = details::loadLE<uint32>(static_cast<byte const*>(seed.dataAddress()) + 4 * i);
+    }
+
+    refill();
+}
+
+
+UUIDGenerator::UUIDGenerator(UUIDGenerator&& rhs) noexcept
+    : _position{rhs._position}
+    , _forkGeneration{rhs._forkGeneration}
+    , _reseedOnFork{rhs._reseedOnFork}
+{
+    memcpy(_key, rhs._key, sizeof(_key));
+    memcpy(_buffer, rhs._buffer, sizeof(_buffer));
+
+    // Never let two generators give the same sequence: the moved-from one is to be seeded from the system again
+    secureWipe(rhs._key, sizeof(rhs._key));
+    secureWipe(rhs._buffer, sizeof(rhs._buffer));
+    rhs._position = kBufferSize;
+    rhs._reseedOnFork = true;
+    rhs._forkGeneration = currentForkGeneration() - 1;
+}
+
+
+UUIDGenerator::~UUIDGenerator() {
+    secureWipe(_key, sizeof(_key));
+    secureWipe(_buffer, sizeof(_buffer));
+}
+
+
+Result<UUIDGenerator, Error>
+UUIDGenerator::seeded(MemoryView seed) noexcept {
+    if (seed.size() != kSeedSize) {
+        return makeError(GenericError::INVAL, "UUIDGenerator::seeded()");
+    }
+
+    return Ok(UUIDGenerator{seed, false});
+}
+
+
+UUIDGenerator&
+UUIDGenerator::threadLocal() noexcept {
+    thread_local UUIDGenerator generator;
+
+    return generator;
+}
+
+
+void
+UUIDGenerator::reseed() noexcept {
+    _forkGeneration = currentForkGeneration();
+
+    byte seed[kSeedSize];
+    systemRandom(seed, sizeof(seed));
+    for (size_type i = 0; i < 8; ++i) {
+        _key[i] = details::loadLE<uint32>(seed + 4 * i);
+    }
+    secureWipe(seed, sizeof(seed));
+
+    refill();
+}
+
+
+void
+UUIDGenerator::checkFork() noexcept {
+    if (_reseedOnFork && _forkGeneration != currentForkGeneration()) {
+        reseed();
+    }
+}
+
+
+void
+UUIDGenerator::refill() noexcept {
+    static_assert(kBlocks == 8, "Keystream is produced 8 blocks at a time");
+    chacha20Blocks8Dispatch(_key, _buffer);
+
+    // Fast key erasure: the next key is the first part of the output, which is never handed out
+    for (size_type i = 0; i < 8; ++i) {
+        _key[i] = details::loadLE<uint32>(_buffer + 4 * i);
+    }
+    secureWipe(_buffer, sizeof(_key));
+    _position = sizeof(_key);
+}
+
+
 UUID
-Solace::makeRandomUUID() noexcept {
-	std::random_device rd;
-	std::default_random_engine randomGen{rd()};
+UUIDGenerator::generate() noexcept {
+    checkFork();
+    if (_position == kBufferSize) {
+        refill();
+    }
 
-	byte bytes[UUID::StaticSize];
+    auto const bytes = _buffer + _position;
+    setVersion4(bytes);
+    UUID result{bytes};
+    memset(bytes, 0, UUID::StaticSize);
+    _position += UUID::StaticSize;
+
+    return result;
+}
 
-	auto const step = sizeof(decltype(randomGen()));
 
-	UUID::size_type i = 0;
-	for (; i + step <= UUID::StaticSize; i += step) {
-		auto const rndValue = randomGen();
-		memcpy(bytes + i, &rndValue, step);
+void
+UUIDGenerator::generate(ArrayView<UUID> uuids) noexcept {
+    checkFork();
+
+    auto dest = uuids.begin();
+    auto const end = uuids.end();
+    while (dest != end) {
+        if (_position == kBufferSize) {
+            refill();
+        }
+
+        auto const count = std::min<size_type>((kBufferSize - _position) / UUID::StaticSize,
+                                               static_cast<size_type>(end - dest));
+        auto const begin = _position;
+        for (size_type i = 0; i < count; ++i, ++dest) {
+            auto const bytes = _buffer + _position;
+            setVersion4(bytes);
+            memcpy(dest->begin(), bytes, UUID::StaticSize);
+            _position += UUID::StaticSize;
+        }
+        memset(_buffer + begin, 0, _position - begin);
     }
+}
 
-	if (i < UUID::StaticSize) {
-		auto const rndValue = randomGen();
-		memcpy(bytes + i, &rndValue, UUID::StaticSize - i);
-	}
 
-    return {bytes};
+UUID
+Solace::makeRandomUUID() noexcept {
+    return UUIDGenerator::threadLocal().generate();
 }
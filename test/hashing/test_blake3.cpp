@@ -0,0 +1,257 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/hashing/test_blake3.cpp
+*******************************************************************************/
+#include <solace/hashing/blake3.hpp>  // Class being tested
+#include <solace/base16.hpp>
+#include <solace/output_utils.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>  // std::min
+#include <cstring>  // strlen
+#include <vector>
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+
+namespace {
+
+char const kKey[] = "whats the Elvish word for friend";
+char const kContext[] = "BLAKE3 2019-12-27 16:29:52 test vectors context";
+
+/// Test vectors of BLAKE3 reference: input byte i is i % 251
+struct TestVector {
+    size_t      length;
+    char const* hash;
+    char const* keyedHash;
+    char const* derivedKey;
+};
+
+TestVector const kVectors[] = {
+    {     0, "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262",
+             "92b2b75604ed3c761f9d6f62392c8a9227ad0ea3f09573e783f1498a4ed60d26",
+             "2cc39783c223154fea8dfb7c1b1660f2ac2dcbd1c1de8277b0b0dd39b7e50d7d"},
+    {     1, "2d3adedff11b61f14c886e35afa036736dcd87a74d27b5c1510225d0f592e213",
+             "6d7878dfff2f485635d39013278ae14f1454b8c0a3a2d34bc1ab38228a80c95b",
+             "b3e2e340a117a499c6cf2398a19ee0d29cca2bb7404c73063382693bf66cb06c"},
+    {  1023, "10108970eeda3eb932baac1428c7a2163b0e924c9a9e25b35bba72b28f70bd11",
+             "c951ecdf03288d0fcc96ee3413563d8a6d3589547f2c2fb36d9786470f1b9d6e",
+             "74a16c1c3d44368a86e1ca6df64be6a2f64cce8f09220787450722d85725dea5"},
+    {  1024, "42214739f095a406f3fc83deb889744ac00df831c10daa55189b5d121c855af7",
+             "75c46f6f3d9eb4f55ecaaee480db732e6c2105546f1e675003687c31719c7ba4",
+             "7356cd7720d5b66b6d0697eb3177d9f8d73a4a5c5e968896eb6a689684302706"},
+    {  1025, "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444",
+             "357dc55de0c7e382c900fd6e320acc04146be01db6a8ce7210b7189bd664ea69",
+             "effaa245f065fbf82ac186839a249707c3bddf6d3fdda22d1b95a3c970379bcb"},
+    {  2048, "e776b6028c7cd22a4d0ba182a8bf62205d2ef576467e838ed6f2529b85fba24a",
+             "879cf1fa2ea0e79126cb1063617a05b6ad9d0b696d0d757cf053439f60a99dd1",
+             "7b2945cb4fef70885cc5d78a87bf6f6207dd901ff239201351ffac04e1088a23"},
+    {  2049, "5f4d72f40d7a5f82b15ca2b2e44b1de3c2ef86c426c95c1af0b6879522563030",
+             "9f29700902f7c86e514ddc4df1e3049f258b2472b6dd5267f61bf13983b78dd5",
+             "2ea477c5515cc3dd606512ee72bb3e0e758cfae7232826f35fb98ca1bcbdf273"},
+    {  3072, "b98cb0ff3623be03326b373de6b9095218513e64f1ee2edd2525c7ad1e5cffd2",
+             "044a0e7b172a312dc02a4c9a818c036ffa2776368d7f528268d2e6b5df191770",
+             "050df97f8c2ead654d9bb3ab8c9178edcd902a32f8495949feadcc1e0480c46b"},
+    {  3073, "7124b49501012f81cc7f11ca069ec9226cecb8a2c850cfe644e327d22d3e1cd3",
+             "68dede9bef00ba89e43f31a6825f4cf433389fedae75c04ee9f0cf16a427c95a",
+             "72613c9ec9ff7e40f8f5c173784c532ad852e827dba2bf85b2ab4b76f7079081"},
+    {  4096, "015094013f57a5277b59d8475c0501042c0b642e531b0a1c8f58d2163229e969",
+             "befc660aea2f1718884cd8deb9902811d332f4fc4a38cf7c7300d597a081bfc0",
+             "1e0d7f3db8c414c97c6307cbda6cd27ac3b030949da8e23be1a1a924ad2f25b9"},
+    {  4097, "9b4052b38f1c5fc8b1f9ff7ac7b27cd242487b3d890d15c96a1c25b8aa0fb995",
+             "00df940cd36bb9fa7cbbc3556744e0dbc8191401afe70520ba292ee3ca80abbc",
+             "aca51029626b55fda7117b42a7c211f8c6e9ba4fe5b7a8ca922f34299500ead8"},
+    {  5120, "9cadc15fed8b5d854562b26a9536d9707cadeda9b143978f319ab34230535833",
+             "2c493e48e9b9bf31e0553a22b23503c0a3388f035cece68eb438d22fa1943e20",
+             "7a7acac8a02adcf3038d74cdd1d34527de8a0fcc0ee3399d1262397ce5817f60"},
+    {  5121, "628bd2cb2004694adaab7bbd778a25df25c47b9d4155a55f8fbd79f2fe154cff",
+             "6ccf1c34753e7a044db80798ecd0782a8f76f33563accaddbfbb2e0ea4b2d024",
+             "b07f01e518e702f7ccb44a267e9e112d403a7b3f4883a47ffbed4b48339b3c34"},
+    {  6144, "3e2e5b74e048f3add6d21faab3f83aa44d3b2278afb83b80b3c35164ebeca205",
+             "3d6b6d21281d0ade5b2b016ae4034c5dec10ca7e475f90f76eac7138e9bc8f1d",
+             "2a95beae63ddce523762355cf4b9c1d8f131465780a391286a5d01abb5683a15"},
+    {  6145, "f1323a8631446cc50536a9f705ee5cb619424d46887f3c376c695b70e0f0507f",
+             "9ac301e9e39e45e3250a7e3b3df701aa0fb6889fbd80eeecf28dbc6300fbc539",
+             "379bcc61d0051dd489f686c13de00d5b14c505245103dc040d9e4dd1facab8e5"},
+    {  7168, "61da957ec2499a95d6b8023e2b0e604ec7f6b50e80a9678b89d2628e99ada77a",
+             "b42835e40e9d4a7f42ad8cc04f85a963a76e18198377ed84adddeaecacc6f3fc",
+             "11c37a112765370c94a51415d0d651190c288566e295d505defdad895dae2237"},
+    {  7169, "a003fc7a51754a9b3c7fae0367ab3d782dccf28855a03d435f8cfe74605e7817",
+             "ed9b1a922c046fdb3d423ae34e143b05ca1bf28b710432857bf738bcedbfa511",
+             "554b0a5efea9ef183f2f9b931b7497995d9eb26f5c5c6dad2b97d62fc5ac31d9"},
+    {  8192, "aae792484c8efe4f19e2ca7d371d8c467ffb10748d8a5a1ae579948f718a2a63",
+             "dc9637c8845a770b4cbf76b8daec0eebf7dc2eac11498517f08d44c8fc00d58a",
+             "ad01d7ae4ad059b0d33baa3c01319dcf8088094d0359e5fd45d6aeaa8b2d0c3d"},
+    {  8193, "bab6c09cb8ce8cf459261398d2e7aef35700bf488116ceb94a36d0f5f1b7bc3b",
+             "954a2a75420c8d6547e3ba5b98d963e6fa6491addc8c023189cc519821b4a1f5",
+             "af1e0346e389b17c23200270a64aa4e1ead98c61695d917de7d5b00491c9b0f1"},
+    { 16384, "f875d6646de28985646f34ee13be9a576fd515f76b5b0a26bb324735041ddde4",
+             "9e9fc4eb7cf081ea7c47d1807790ed211bfec56aa25bb7037784c13c4b707b0d",
+             "160e18b5878cd0df1c3af85eb25a0db5344d43a6fbd7a8ef4ed98d0714c3f7e1"},
+    { 31744, "62b6960e1a44bcc1eb1a611a8d6235b6b4b78f32e7abc4fb4c6cdcce94895c47",
+             "efa53b389ab67c593dba624d898d0f7353ab99e4ac9d42302ee64cbf9939a419",
+             "39772aef80e0ebe60596361e45b061e8f417429d529171b6764468c22928e28e"},
+    {102400, "bc3e3d41a1146b069abffad3c0d44860cf664390afce4d9661f7902e7943e085",
+             "1c35d1a5811083fd7119f5d5d1ba027b4d01c0c6c49fb6ff2cf75393ea5db4a7",
+             "4652cff7a3f385a6103b5c260fc1593e13c778dbe608efb092fe7ee69df6e9c6"},
+};
+
+
+std::vector<byte> makeInput(size_t length) {
+    std::vector<byte> input(length);
+    for (size_t i = 0; i < length; ++i) {
+        input[i] = static_cast<byte>(i % 251);
+    }
+
+    return input;
+}
+
+/// Decode expected digest from its hex string
+std::vector<byte> fromHex(char const* hex) {
+    auto const encoded = wrapMemory(hex, strlen(hex));
+
+    std::vector<byte> result;
+    for (auto i = base16Decode_begin(encoded), end = base16Decode_end(encoded); i != end; ++i) {
+        result.push_back(*i);
+    }
+
+    return result;
+}
+
+std::vector<byte> digestOf(Blake3& hash) {
+    auto const digest = hash.digest();
+
+    return std::vector<byte>(digest.begin(), digest.end());
+}
+
+Blake3 keyedHasher() {
+    return Blake3::keyed(wrapMemory(kKey, sizeof(kKey) - 1)).unwrap();
+}
+
+Blake3 deriveKeyHasher() {
+    return Blake3::deriveKey(StringView{kContext});
+}
+
+}  // namespace
+
+
+TEST(TestHashingBlake3, testAlgorithmName) {
+    EXPECT_EQ(StringLiteral("BLAKE3"), Blake3{}.getAlgorithm());
+    EXPECT_EQ(256U, Blake3{}.getDigestLength());
+}
+
+TEST(TestHashingBlake3, hashTestVectors) {
+    for (auto const& v : kVectors) {
+        auto const input = makeInput(v.length);
+        auto const inputView = wrapMemory(input.data(), input.size());
+
+        Blake3 hash;
+        hash.update(inputView);
+        EXPECT_EQ(fromHex(v.hash), digestOf(hash)) << "Length: " << v.length;
+
+        auto keyed = keyedHasher();
+        keyed.update(inputView);
+        EXPECT_EQ(fromHex(v.keyedHash), digestOf(keyed)) << "Length: " << v.length;
+
+        auto derived = deriveKeyHasher();
+        derived.update(inputView);
+        EXPECT_EQ(fromHex(v.derivedKey), digestOf(derived)) << "Length: " << v.length;
+    }
+}
+
+TEST(TestHashingBlake3, hashInChunks) {
+    auto const input = makeInput(102400);
+
+    // Chunk sizes that cross block and chunk boundaries at different points
+    for (size_t chunkSize : {1, 63, 64, 65, 1023, 1024, 1025, 3000, 17000}) {
+        Blake3 hash;
+        for (size_t offset = 0; offset < input.size(); offset += chunkSize) {
+            hash.update(wrapMemory(input.data() + offset, std::min(chunkSize, input.size() - offset)));
+        }
+
+        EXPECT_EQ(fromHex(kVectors[21].hash), digestOf(hash)) << "Chunk size: " << chunkSize;
+    }
+}
+
+TEST(TestHashingBlake3, hashLargeInput) {
+    auto const input = makeInput((1 << 20) + 12345);
+    auto const expected = fromHex("7a7e1c6a800e0cfbd45304d16a3544d5d55e2a723a11fc021bf9fb45ee8c1472");
+
+    Blake3 hash;
+    hash.update(wrapMemory(input.data(), input.size()));
+    EXPECT_EQ(expected, digestOf(hash));
+
+    // Start unaligned with the chunk boundary, so that subtrees are smaller than the input
+    Blake3 unaligned;
+    unaligned.update(wrapMemory(input.data(), 1000));
+    unaligned.update(wrapMemory(input.data() + 1000, input.size() - 1000));
+    EXPECT_EQ(expected, digestOf(unaligned));
+}
+
+TEST(TestHashingBlake3, updateParallel) {
+    auto const input = makeInput((1 << 20) + 12345);
+    auto const expected = fromHex("7a7e1c6a800e0cfbd45304d16a3544d5d55e2a723a11fc021bf9fb45ee8c1472");
+
+    for (uint32 threads : {0, 1, 2, 3, 8}) {
+        Blake3 hash;
+        hash.updateParallel(wrapMemory(input.data(), input.size()), threads);
+        EXPECT_EQ(expected, digestOf(hash)) << "Threads: " << threads;
+
+        auto keyed = keyedHasher();
+        keyed.updateParallel(wrapMemory(input.data(), 7000), threads);
+        keyed.updateParallel(wrapMemory(input.data() + 7000, input.size() - 7000), threads);
+
+        auto keyedExpected = keyedHasher();
+        keyedExpected.update(wrapMemory(input.data(), input.size()));
+        EXPECT_EQ(digestOf(keyedExpected), digestOf(keyed)) << "Threads: " << threads;
+    }
+}
+
+TEST(TestHashingBlake3, extendedOutput) {
+    auto const input = makeInput(1025);
+    auto const expected = fromHex("d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444"
+                                  "f4c4a22b4b399155358a994e52bf255de60035742ec71bd08ac275a1b51cc6bf"
+                                  "e332b0ef84b409108cda080e6269ed4b3e2c3f7d722aa4cdc98d16deb554e562"
+                                  "7be8f955c98e1d5f9565a9194cad0c4285f93700062d9595adb992ae68ff1280"
+                                  "0ab67a");
+
+    Blake3 hash;
+    hash.update(wrapMemory(input.data(), input.size()));
+
+    byte output[131];
+    hash.finalize(wrapMemory(output));
+    EXPECT_EQ(wrapMemory(expected.data(), expected.size()), wrapMemory(output));
+
+    // Output at an offset is the same part of the output stream
+    for (size_t offset : {1, 63, 64, 65, 100}) {
+        byte part[31];
+        hash.finalize(wrapMemory(part), offset);
+        EXPECT_EQ(wrapMemory(expected.data() + offset, sizeof(part)), wrapMemory(part)) << "Offset: " << offset;
+    }
+
+    // Finalizing doesn't change the state
+    EXPECT_EQ(std::vector<byte>(expected.begin(), expected.begin() + Blake3::kDigestSize), digestOf(hash));
+}
+
+TEST(TestHashingBlake3, keyedRequiresKeyOfKeySize) {
+    EXPECT_FALSE(Blake3::keyed(wrapMemory(kKey, sizeof(kKey) - 2)));
+    EXPECT_FALSE(Blake3::keyed(wrapMemory(kKey, sizeof(kKey))));
+    EXPECT_TRUE(Blake3::keyed(wrapMemory(kKey, sizeof(kKey) - 1)));
+}
@@ -0,0 +1,126 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/hashing/test_crc32c.cpp
+*******************************************************************************/
+#include <solace/hashing/crc32c.hpp>  // Class being tested
+#include <solace/output_utils.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>  // std::min, std::fill
+#include <vector>
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+
+namespace {
+
+std::vector<byte> makePattern(size_t size) {
+    std::vector<byte> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<byte>((i * 7 + 3) & 0xff);
+    }
+
+    return data;
+}
+
+}  // namespace
+
+
+TEST(TestHashingCrc32c, testAlgorithmName) {
+    EXPECT_EQ(StringLiteral("CRC32C"), Crc32c().getAlgorithm());
+    EXPECT_EQ(32U, Crc32c().getDigestLength());
+}
+
+TEST(TestHashingCrc32c, hashEmptyMessage) {
+    char message[] = "";
+    EXPECT_EQ(0U, Crc32c::compute(wrapMemory(message, sizeof(message) - 1)));
+    EXPECT_EQ(std::initializer_list<byte>({0x0, 0x0, 0x0, 0x0}),
+              Crc32c().update(wrapMemory(message, sizeof(message) - 1)).digest());
+}
+
+TEST(TestHashingCrc32c, hashCheckValue) {
+    char message[] = "123456789";
+    EXPECT_EQ(0xE3069283U, Crc32c::compute(wrapMemory(message, sizeof(message) - 1)));
+    EXPECT_EQ(std::initializer_list<byte>({0xE3, 0x06, 0x92, 0x83}),
+              Crc32c().update(wrapMemory(message, sizeof(message) - 1)).digest());
+}
+
+// Test vectors from RFC 3720, appendix B.4
+TEST(TestHashingCrc32c, hashRfc3720Vectors) {
+    byte buffer[32];
+
+    std::fill(buffer, buffer + 32, 0);
+    EXPECT_EQ(0x8A9136AAU, Crc32c::compute(wrapMemory(buffer)));
+
+    std::fill(buffer, buffer + 32, 0xFF);
+    EXPECT_EQ(0x62A8AB43U, Crc32c::compute(wrapMemory(buffer)));
+
+    for (int i = 0; i < 32; ++i) {
+        buffer[i] = static_cast<byte>(i);
+    }
+    EXPECT_EQ(0x46DD794EU, Crc32c::compute(wrapMemory(buffer)));
+
+    for (int i = 0; i < 32; ++i) {
+        buffer[i] = static_cast<byte>(31 - i);
+    }
+    EXPECT_EQ(0x113FDB5CU, Crc32c::compute(wrapMemory(buffer)));
+}
+
+TEST(TestHashingCrc32c, hashLargeMessage) {
+    auto const data = makePattern(70001);
+    EXPECT_EQ(0x21d851cdU, Crc32c::compute(wrapMemory(data.data(), data.size())));
+}
+
+TEST(TestHashingCrc32c, updateInChunks) {
+    auto const data = makePattern(70001);
+    auto const expected = Crc32c::compute(wrapMemory(data.data(), data.size()));
+
+    // Chunks of different sizes and alignments take all the code paths
+    for (size_t chunkSize : {1, 3, 7, 64, 255, 1000, 9001}) {
+        Crc32c crc;
+        for (size_t offset = 0; offset < data.size(); offset += chunkSize) {
+            crc.update(wrapMemory(data.data() + offset, std::min(chunkSize, data.size() - offset)));
+        }
+
+        EXPECT_EQ(expected, crc.value()) << "Chunk size: " << chunkSize;
+    }
+}
+
+TEST(TestHashingCrc32c, continueFromPreviousValue) {
+    char message[] = "123456789";
+    auto const head = Crc32c::compute(wrapMemory(message, 4));
+    EXPECT_EQ(0xE3069283U, Crc32c::compute(wrapMemory(message + 4, 5), head));
+
+    Crc32c crc{head};
+    crc.update(wrapMemory(message + 4, 5));
+    EXPECT_EQ(0xE3069283U, crc.value());
+}
+
+TEST(TestHashingCrc32c, combineChunks) {
+    auto const data = makePattern(20000);
+    auto const expected = Crc32c::compute(wrapMemory(data.data(), data.size()));
+
+    for (size_t split : {0, 1, 5, 16, 1000, 8192, 12345, 20000}) {
+        auto const crcA = Crc32c::compute(wrapMemory(data.data(), split));
+        auto const crcB = Crc32c::compute(wrapMemory(data.data() + split, data.size() - split));
+
+        EXPECT_EQ(expected, Crc32c::combine(crcA, crcB, data.size() - split)) << "Split at: " << split;
+    }
+}
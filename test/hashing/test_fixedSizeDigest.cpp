@@ -0,0 +1,173 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/hashing/test_fixedSizeDigest.cpp
+*******************************************************************************/
+#include <solace/hashing/fixedSizeDigest.hpp>  // Class being tested
+
+#include <solace/hashing/blake3.hpp>
+#include <solace/hashing/crc32c.hpp>
+#include <solace/hashing/md5.hpp>
+#include <solace/hashing/murmur3.hpp>
+#include <solace/hashing/sha1.hpp>
+#include <solace/hashing/sha2.hpp>
+#include <solace/hashing/sha3.hpp>
+#include <solace/hashing/xxhash.hpp>
+#include <solace/output_utils.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+
+namespace {
+
+char const kMessage[] = "The quick brown fox jumps over the lazy dog";
+
+MemoryView message() {
+    return wrapMemory(kMessage, sizeof(kMessage) - 1);
+}
+
+template<typename Algorithm, typename... Args>
+void expectSameDigests(Args... args) {
+    Algorithm expected{args...};
+    expected.update(message());
+    auto const expectedDigest = expected.digest();
+
+    Algorithm hash{args...};
+    hash.update(message());
+    byte result[HashingAlgorithm::kMaxDigestSize + 1];
+    wrapMemory(result).fill(0xA5);
+    ASSERT_TRUE(hash.digestInto(wrapMemory(result)).isOk());
+
+    EXPECT_EQ(Algorithm::kDigestSize * 8, expected.getDigestLength()) << expected.getAlgorithm();
+    EXPECT_TRUE(expectedDigest.view() == wrapMemory(result, Algorithm::kDigestSize)) << expected.getAlgorithm();
+    EXPECT_EQ(0xA5, result[Algorithm::kDigestSize]) << expected.getAlgorithm();
+
+    Algorithm fixed{args...};
+    fixed.update(message());
+    auto const digest = fixedDigest(fixed);
+    static_assert(decltype(digest)::kSize == Algorithm::kDigestSize, "Digest size");
+    EXPECT_EQ(expectedDigest, digest) << expected.getAlgorithm();
+}
+
+
+/// Algorithm of a user, with a digest longer than any of the library.
+class LongDigest : public HashingAlgorithm {
+public:
+    static constexpr size_type kDigestSize = 2 * kMaxDigestSize;
+
+    using HashingAlgorithm::update;
+
+    StringView getAlgorithm() const override { return "LongDigest"; }
+    size_type getDigestLength() const override { return kDigestSize * 8; }
+    HashingAlgorithm& update(MemoryView) override { return *this; }
+
+protected:
+    void digestUnchecked(MutableMemoryView dest) override {
+        for (size_type i = 0; i < dest.size(); ++i) {
+            dest[i] = static_cast<byte>(i);
+        }
+    }
+};
+
+}  // namespace
+
+
+TEST(TestFixedSizeDigest, sizeIsConstant) {
+    static_assert(FixedSizeDigest<20>::kSize == 20, "Digest size");
+    static_assert(FixedSizeDigest<32>{}.size() == 32, "Digest size");
+    static_assert(FixedSizeDigest<32>{}.getDigestLength() == 256, "Digest length");
+    static_assert(sizeof(FixedSizeDigest<32>) == 32, "Digest is stored in place");
+}
+
+TEST(TestFixedSizeDigest, defaultIsZero) {
+    FixedSizeDigest<4> digest;
+    EXPECT_EQ(std::initializer_list<byte>({0, 0, 0, 0}), digest);
+}
+
+TEST(TestFixedSizeDigest, digestIntoMatchesDigest) {
+    expectSameDigests<MD5>();
+    expectSameDigests<Sha1>();
+    expectSameDigests<Sha256>();
+    expectSameDigests<Sha3_224>();
+    expectSameDigests<Sha3_256>();
+    expectSameDigests<Sha3_384>();
+    expectSameDigests<Sha3_512>();
+    expectSameDigests<Shake128>();
+    expectSameDigests<Shake256>();
+    expectSameDigests<Blake3>();
+    expectSameDigests<Crc32c>();
+    expectSameDigests<XxHash64>();
+    expectSameDigests<XxHash3>();
+    expectSameDigests<Murmur3_32>(0u);
+    expectSameDigests<Murmur3_128>(0u);
+}
+
+TEST(TestFixedSizeDigest, digestLongerThanMax) {
+    LongDigest hash;
+    auto const digest = hash.digest();
+
+    ASSERT_EQ(LongDigest::kDigestSize, digest.size());
+    EXPECT_EQ(0, digest[0]);
+    EXPECT_EQ(LongDigest::kDigestSize - 1, digest[LongDigest::kDigestSize - 1]);
+}
+
+TEST(TestFixedSizeDigest, digestIntoSmallBufferFails) {
+    Sha256 hash;
+    hash.update(message());
+
+    FixedSizeDigest<Sha256::kDigestSize> result;
+    auto const maybeDigest = hash.digestInto(result.view().slice(0, result.size() - 1));
+    ASSERT_TRUE(maybeDigest.isError());
+    EXPECT_EQ(FixedSizeDigest<Sha256::kDigestSize>{}, result);
+
+    // Failed call must not finalize the state
+    Sha256 expected;
+    expected.update(message());
+    EXPECT_EQ(expected.digest(), fixedDigest(hash));
+}
+
+TEST(TestFixedSizeDigest, compare) {
+    Sha256 hashA;
+    hashA.update(message());
+    Sha256 hashB;
+    hashB.update(message());
+    Sha256 hashC;
+    hashC.update(wrapMemory(kMessage, 10));
+
+    auto const a = fixedDigest(hashA);
+    auto const b = fixedDigest(hashB);
+    auto const c = fixedDigest(hashC);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(a != c);
+    EXPECT_FALSE(a != b);
+}
+
+TEST(TestFixedSizeDigest, toHex) {
+    Sha256 hash;
+    hash.update(message());
+
+    EXPECT_EQ(StringLiteral("d7a8fbb307d7809469ca9abcb0082e4f8d5651e46d3cdb762d02d0bf37c9e592"),
+              fixedDigest(hash).toHex().view());
+
+    Crc32c crc;
+    EXPECT_EQ(StringLiteral("00000000"), fixedDigest(crc).toHex().view());
+}
@@ -0,0 +1,73 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/hashing/test_hasher.cpp
+*******************************************************************************/
+#include <solace/hashing/hasher.hpp>  // Class being tested
+
+#include <solace/hashing/murmur3.hpp>
+#include <solace/hashing/sha2.hpp>
+#include <solace/hashing/sha3.hpp>
+#include <solace/hashing/xxhash.hpp>
+#include <solace/output_utils.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+
+static char const kMessage[] = "The quick brown fox jumps over the lazy dog";
+
+
+TEST(TestHasher, hashFunction) {
+    auto const digest = hash<Sha256>(wrapMemory(kMessage, sizeof(kMessage) - 1));
+
+    static_assert(std::is_same<decltype(digest), FixedSizeDigest<32> const>::value, "Digest type");
+    EXPECT_EQ(StringLiteral("d7a8fbb307d7809469ca9abcb0082e4f8d5651e46d3cdb762d02d0bf37c9e592"),
+              digest.toHex().view());
+}
+
+TEST(TestHasher, hashFunctionWithSeed) {
+    auto const message = wrapMemory(kMessage, sizeof(kMessage) - 1);
+
+    Murmur3_128 murmur{42};
+    murmur.update(message);
+    EXPECT_EQ(murmur.digest(), hash<Murmur3_128>(message, 42u));
+
+    XxHash64 xxhash{7};
+    xxhash.update(message);
+    EXPECT_EQ(xxhash.digest(), hash<XxHash64>(message, 7u));
+}
+
+TEST(TestHasher, incrementalUpdate) {
+    Hasher<Sha3_256> hasher;
+    hasher.update(wrapMemory(kMessage, 10))
+            .update(wrapMemory(kMessage + 10, sizeof(kMessage) - 11));
+
+    EXPECT_EQ(hash<Sha3_256>(wrapMemory(kMessage, sizeof(kMessage) - 1)), hasher.digest());
+}
+
+TEST(TestHasher, typeErasedAdapter) {
+    Hasher<Sha256> hasher;
+    HashingAlgorithm& algorithm = hasher.algorithm();
+    EXPECT_EQ(StringLiteral("SHA256"), algorithm.getAlgorithm());
+    EXPECT_EQ(256U, algorithm.getDigestLength());
+
+    algorithm.update(wrapMemory(kMessage, sizeof(kMessage) - 1));
+    EXPECT_EQ(hash<Sha256>(wrapMemory(kMessage, sizeof(kMessage) - 1)), hasher.digest());
+}
@@ -0,0 +1,71 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/hashing/test_hkdf.cpp
+*******************************************************************************/
+#include <solace/hashing/hkdf.hpp>  // Class being tested
+
+#include <solace/hashing/sha2.hpp>
+#include <solace/output_utils.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+
+TEST(TestHkdf, rfc5869Basic) {
+    byte inputKey[22];
+    wrapMemory(inputKey).fill(0x0b);
+    byte salt[13];
+    byte info[10];
+    for (byte i = 0; i < sizeof(salt); ++i) {
+        salt[i] = i;
+    }
+    for (byte i = 0; i < sizeof(info); ++i) {
+        info[i] = 0xf0 + i;
+    }
+
+    auto const pseudorandomKey = Hkdf<Sha256>::extract(wrapMemory(salt), wrapMemory(inputKey));
+    EXPECT_EQ(StringLiteral("077709362c2e32df0ddc3f0dc47bba6390b6c73bb50f9c3122ec844ad7c2b3e5"),
+              pseudorandomKey.toHex().view());
+
+    FixedSizeDigest<42> output;
+    ASSERT_TRUE(Hkdf<Sha256>::expand(pseudorandomKey.view(), wrapMemory(info), output.view()).isOk());
+    EXPECT_EQ(StringLiteral("3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf34007208d5b887185865"),
+              output.toHex().view());
+}
+
+TEST(TestHkdf, rfc5869EmptySaltAndInfo) {
+    byte inputKey[22];
+    wrapMemory(inputKey).fill(0x0b);
+
+    FixedSizeDigest<42> output;
+    ASSERT_TRUE(Hkdf<Sha256>::deriveKey(MemoryView{}, wrapMemory(inputKey), MemoryView{}, output.view()).isOk());
+    EXPECT_EQ(StringLiteral("8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d9d201395faa4b61a96c8"),
+              output.toHex().view());
+}
+
+TEST(TestHkdf, outputLength) {
+    char const key[] = "key";
+    FixedSizeDigest<Hkdf<Sha256>::kMaxOutputSize> longest;
+    ASSERT_TRUE(Hkdf<Sha256>::expand(wrapMemory(key, 3), MemoryView{}, longest.view()).isOk());
+
+    FixedSizeDigest<Hkdf<Sha256>::kMaxOutputSize + 1> tooLong;
+    EXPECT_TRUE(Hkdf<Sha256>::expand(wrapMemory(key, 3), MemoryView{}, tooLong.view()).isError());
+    EXPECT_EQ(FixedSizeDigest<Hkdf<Sha256>::kMaxOutputSize + 1>{}, tooLong);
+}
@@ -0,0 +1,101 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/hashing/test_hmac.cpp
+*******************************************************************************/
+#include <solace/hashing/hmac.hpp>  // Class being tested
+
+#include <solace/hashing/md5.hpp>
+#include <solace/hashing/sha1.hpp>
+#include <solace/hashing/sha2.hpp>
+#include <solace/hashing/sha3.hpp>
+#include <solace/output_utils.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+
+namespace {
+
+MemoryView viewOf(char const* str) {
+    return wrapMemory(str, strlen(str));
+}
+
+}  // namespace
+
+
+TEST(TestHmac, rfc4231Sha256) {
+    byte key[20];
+    wrapMemory(key).fill(0x0b);
+
+    Hmac<Sha256> hmac{wrapMemory(key)};
+    EXPECT_EQ(StringLiteral("b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7"),
+              hmac.update(viewOf("Hi There")).digest().toHex().view());
+}
+
+TEST(TestHmac, keyLongerThanBlock) {
+    byte key[131];
+    wrapMemory(key).fill(0xaa);
+
+    Hmac<Sha256> hmac{wrapMemory(key)};
+    EXPECT_EQ(StringLiteral("60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54"),
+              hmac.mac(viewOf("Test Using Larger Than Block-Size Key - Hash Key First")).toHex().view());
+}
+
+TEST(TestHmac, emptyKeyAndMessage) {
+    EXPECT_EQ(StringLiteral("b613679a0814d9ec772f95d778c35fc5ff1697c493715653c6c712144292c5ad"),
+              Hmac<Sha256>{MemoryView{}}.digest().toHex().view());
+}
+
+TEST(TestHmac, otherAlgorithms) {
+    auto const key = viewOf("Jefe");
+    auto const message = viewOf("what do ya want for nothing?");
+
+    EXPECT_EQ(StringLiteral("750c783e6ab0b503eaa86e310a5db738"),
+              Hmac<MD5>{key}.mac(message).toHex().view());
+    EXPECT_EQ(StringLiteral("effcdf6ae5eb2fa2d27416d5f184df9c259a7c79"),
+              Hmac<Sha1>{key}.mac(message).toHex().view());
+    EXPECT_EQ(StringLiteral("c7d4072e788877ae3596bbb0da73b887c9171f93095b294ae857fbe2645e1ba5"),
+              Hmac<Sha3_256>{key}.mac(message).toHex().view());
+}
+
+TEST(TestHmac, reuseKey) {
+    Hmac<Sha256> hmac{viewOf("key")};
+
+    auto const first = hmac.update(viewOf("message ")).update(viewOf("one")).digest();
+    auto const second = hmac.update(viewOf("message two")).digest();
+    auto const firstAgain = hmac.update(viewOf("message one")).digest();
+
+    EXPECT_EQ(first, firstAgain);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(second, hmac.mac(viewOf("message two")));
+    EXPECT_EQ(first, Hmac<Sha256>{viewOf("key")}.mac(viewOf("message one")));
+}
+
+TEST(TestHmac, verify) {
+    Hmac<Sha256> const hmac{viewOf("key")};
+    auto code = hmac.mac(viewOf("message"));
+
+    EXPECT_TRUE(hmac.verify(viewOf("message"), code.view()));
+    EXPECT_FALSE(hmac.verify(viewOf("massage"), code.view()));
+    EXPECT_FALSE(hmac.verify(viewOf("message"), code.view().slice(0, 31)));
+
+    code.view()[31] ^= 1;
+    EXPECT_FALSE(hmac.verify(viewOf("message"), code.view()));
+}
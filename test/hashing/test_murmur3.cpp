@@ -22,6 +22,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>  // std::min
+
 using namespace Solace;
 using namespace Solace::hashing;
 
@@ -125,3 +127,55 @@ TEST(TestHashingMurmur3, hashNumbers128) {
                                         0xab, 0xf5, 0xd5, 0xa2, 0x27, 0xca, 0x4f, 0x77}),
                             Murmur3_128(0).update(wrapMemory(message, sizeof(message) - 1)).digest());
 }
+
+TEST(TestHashingMurmur3, chunkedUpdateMatchesOneShot) {
+    byte message[301];
+    for (size_t i = 0; i < sizeof(message); ++i) {
+        message[i] = static_cast<byte>(i * 7 + 3);
+    }
+
+    for (size_t length : {0, 1, 3, 4, 5, 15, 16, 17, 31, 33, 64, 255, 301}) {
+        auto const oneShot32 = Murmur3_32(42).update(wrapMemory(message, length)).digest();
+        auto const oneShot128 = Murmur3_128(42).update(wrapMemory(message, length)).digest();
+
+        for (size_t chunkSize = 1; chunkSize <= 19; ++chunkSize) {
+            Murmur3_32 hash32(42);
+            Murmur3_128 hash128(42);
+            for (size_t offset = 0; offset < length; offset += chunkSize) {
+                auto const n = std::min(chunkSize, length - offset);
+                hash32.update(wrapMemory(message + offset, n));
+                hash128.update(wrapMemory(message + offset, n));
+            }
+
+            EXPECT_EQ(oneShot32, hash32.digest()) << "Length: " << length << ", chunk size: " << chunkSize;
+            EXPECT_EQ(oneShot128, hash128.digest()) << "Length: " << length << ", chunk size: " << chunkSize;
+        }
+    }
+}
+
+TEST(TestHashingMurmur3, digestDoesNotChangeState) {
+    char message[] = "message digest";
+    Murmur3_128 hash(0);
+    hash.update(wrapMemory(message, 7));
+    hash.digest();
+    hash.update(wrapMemory(message + 7, sizeof(message) - 8));
+
+    EXPECT_EQ(Murmur3_128(0).update(wrapMemory(message, sizeof(message) - 1)).digest(), hash.digest());
+}
+
+TEST(TestHashingMurmur3, inlineFunction128) {
+    char message[] = "abc";
+    auto const hash = murmur3_x64_128(wrapMemory(message, sizeof(message) - 1));
+    EXPECT_EQ(0xb4963f3f3fad7867ULL, hash.h1);
+    EXPECT_EQ(0x3ba2744126ca2d52ULL, hash.h2);
+
+    char numbers[] = "12345678901234567890123456789012345678901234567890123456789012345678901234567890";
+    for (uint32 seed : {0U, 1U, 0xdeadbeefU}) {
+        Murmur3_128 streaming(seed);
+        streaming.update(wrapMemory(numbers, sizeof(numbers) - 1));
+
+        auto const value = murmur3_x64_128(wrapMemory(numbers, sizeof(numbers) - 1), seed);
+        EXPECT_EQ(streaming.value().h1, value.h1);
+        EXPECT_EQ(streaming.value().h2, value.h2);
+    }
+}
@@ -0,0 +1,229 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/hashing/test_parallelHasher.cpp
+*******************************************************************************/
+#include <solace/hashing/parallelHasher.hpp>  // Class being tested
+
+#include <solace/hashing/blake3.hpp>
+#include <solace/hashing/hasher.hpp>
+#include <solace/hashing/sha2.hpp>
+#include <solace/hashing/sha3.hpp>
+#include <solace/output_utils.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+
+namespace {
+
+std::vector<byte> makeInput(size_t size) {
+    std::vector<byte> input(size);
+    for (size_t i = 0; i < size; ++i) {
+        input[i] = static_cast<byte>(i % 251);
+    }
+
+    return input;
+}
+
+
+/// Temporary file with the given content, removed when done.
+class TempFile {
+public:
+    explicit TempFile(std::vector<byte> const& content) {
+        char name[] = "/tmp/solace_parallelHasherXXXXXX";
+        auto const fd = ::mkstemp(name);
+        _path = name;
+        if (fd >= 0) {
+            auto const written = ::write(fd, content.data(), content.size());
+            EXPECT_EQ(static_cast<ssize_t>(content.size()), written);
+            ::close(fd);
+        }
+    }
+
+    ~TempFile() {
+        ::unlink(_path.c_str());
+    }
+
+    StringView path() const { return StringView{_path.c_str()}; }
+
+private:
+    std::string _path;
+};
+
+}  // namespace
+
+
+TEST(TestParallelHasher, sha256MerkleKnownRoot) {
+    auto const input = makeInput(10000);
+
+    auto const root = ParallelHasher{1}.sha256Merkle(wrapMemory(input.data(), input.size()), 1024);
+    ASSERT_TRUE(root.isOk());
+    EXPECT_EQ(StringLiteral("cc8408e3281206a48665636da1efab5880228a6f5d03a3a59ac92f543a33ff0a"),
+              root.unwrap().toHex().view());
+}
+
+
+TEST(TestParallelHasher, sha256MerkleSmallInput) {
+    // Empty input is hashed as an empty string
+    auto const emptyRoot = ParallelHasher{}.sha256Merkle(MemoryView{});
+    ASSERT_TRUE(emptyRoot.isOk());
+    EXPECT_EQ(hash<Sha256>(MemoryView{}), emptyRoot.unwrap());
+
+    // Single leaf: SHA-256(0x00 || "abc")
+    auto const leafRoot = ParallelHasher{}.sha256Merkle(wrapMemory("abc", 3));
+    ASSERT_TRUE(leafRoot.isOk());
+    EXPECT_EQ(StringLiteral("609f6e36d2405585188d5cfd761f407c7cc46a7d3f314c88270469dde315fcd1"),
+              leafRoot.unwrap().toHex().view());
+
+    // Two leaves
+    byte const leafPrefix[] = {0x00};
+    byte const nodePrefix[] = {0x01};
+    Hasher<Sha256> left;
+    left.update(wrapMemory(leafPrefix)).update(wrapMemory("ab", 2));
+    Hasher<Sha256> right;
+    right.update(wrapMemory(leafPrefix)).update(wrapMemory("c", 1));
+    Hasher<Sha256> node;
+    node.update(wrapMemory(nodePrefix)).update(left.digest().view()).update(right.digest().view());
+
+    auto const nodeRoot = ParallelHasher{}.sha256Merkle(wrapMemory("abc", 3), 2);
+    ASSERT_TRUE(nodeRoot.isOk());
+    EXPECT_EQ(node.digest(), nodeRoot.unwrap());
+}
+
+
+TEST(TestParallelHasher, sha256MerkleDoesNotDependOnThreads) {
+    auto const input = makeInput(3 * 1024 * 1024 + 12345);
+    auto const view = wrapMemory(input.data(), input.size());
+
+    auto const expected = ParallelHasher{1}.sha256Merkle(view, 64 * 1024);
+    ASSERT_TRUE(expected.isOk());
+    for (uint32 threads : {2U, 3U, 4U, 7U}) {
+        auto const root = ParallelHasher{threads}.sha256Merkle(view, 64 * 1024);
+        ASSERT_TRUE(root.isOk());
+        EXPECT_EQ(expected.unwrap(), root.unwrap()) << "threads: " << threads;
+    }
+
+    // But it does depend on the chunk size
+    auto const otherChunks = ParallelHasher{4}.sha256Merkle(view, 32 * 1024);
+    ASSERT_TRUE(otherChunks.isOk());
+    EXPECT_NE(expected.unwrap(), otherChunks.unwrap());
+}
+
+
+TEST(TestParallelHasher, sha256MerkleZeroChunkSizeIsError) {
+    EXPECT_TRUE(ParallelHasher{}.sha256Merkle(wrapMemory("abc", 3), 0).isError());
+}
+
+
+TEST(TestParallelHasher, blake3IsSameAsSequential) {
+    auto const input = makeInput(2 * 1024 * 1024 + 777);
+    auto const view = wrapMemory(input.data(), input.size());
+
+    Blake3 sequential;
+    sequential.update(view);
+    auto const expected = fixedDigest(sequential);
+
+    for (uint32 threads : {1U, 2U, 4U}) {
+        EXPECT_EQ(expected, ParallelHasher{threads}.blake3(view)) << "threads: " << threads;
+    }
+}
+
+
+TEST(TestParallelHasher, pipelinedIsSameAsSequential) {
+    auto const input = makeInput(5 * ParallelHasher::kWindowSize + 4321);
+    auto const view = wrapMemory(input.data(), input.size());
+    auto const expected = hash<Sha256>(view);
+
+    for (uint32 threads : {1U, 2U}) {
+        Sha256 algorithm;
+        ParallelHasher{threads}.pipelined(algorithm, view);
+        EXPECT_EQ(expected, fixedDigest(algorithm)) << "threads: " << threads;
+    }
+}
+
+
+TEST(TestParallelHasher, pipelinedPropagatesUpdateFailure) {
+    auto const input = makeInput(5 * ParallelHasher::kWindowSize + 4321);
+    auto const view = wrapMemory(input.data(), input.size());
+
+    // Update after digest() throws: the helper thread must be stopped, not the process terminated
+    for (uint32 threads : {1U, 2U}) {
+        Sha3_256 algorithm;
+        static_cast<void>(algorithm.digest());
+        EXPECT_ANY_THROW(ParallelHasher{threads}.pipelined(algorithm, view)) << "threads: " << threads;
+    }
+}
+
+
+TEST(TestParallelHasher, fileModes) {
+    auto const content = makeInput(ParallelHasher::kPipelineDepth * ParallelHasher::kWindowSize + 999);
+    auto const view = wrapMemory(content.data(), content.size());
+    TempFile const file{content};
+    ParallelHasher const hasher{2};
+
+    auto const blake3Digest = hasher.blake3File(file.path());
+    ASSERT_TRUE(blake3Digest.isOk());
+    EXPECT_EQ(hasher.blake3(view), blake3Digest.unwrap());
+
+    auto const merkleRoot = hasher.sha256MerkleFile(file.path(), 100000);
+    ASSERT_TRUE(merkleRoot.isOk());
+    EXPECT_EQ(hasher.sha256Merkle(view, 100000).unwrap(), merkleRoot.unwrap());
+
+    Sha256 algorithm;
+    ASSERT_TRUE(hasher.pipelinedFile(algorithm, file.path()).isOk());
+    EXPECT_EQ(hash<Sha256>(view), fixedDigest(algorithm));
+}
+
+
+TEST(TestParallelHasher, emptyFile) {
+    TempFile const file{std::vector<byte>{}};
+    ParallelHasher const hasher{2};
+
+    auto const blake3Digest = hasher.blake3File(file.path());
+    ASSERT_TRUE(blake3Digest.isOk());
+    EXPECT_EQ(hasher.blake3(MemoryView{}), blake3Digest.unwrap());
+
+    auto const merkleRoot = hasher.sha256MerkleFile(file.path());
+    ASSERT_TRUE(merkleRoot.isOk());
+    EXPECT_EQ(hash<Sha256>(MemoryView{}), merkleRoot.unwrap());
+
+    Sha256 algorithm;
+    ASSERT_TRUE(hasher.pipelinedFile(algorithm, file.path()).isOk());
+    EXPECT_EQ(hash<Sha256>(MemoryView{}), fixedDigest(algorithm));
+}
+
+
+TEST(TestParallelHasher, missingFileIsError) {
+    ParallelHasher const hasher;
+    StringView const path{"/nonexistent/solace/file"};
+
+    EXPECT_TRUE(hasher.blake3File(path).isError());
+    EXPECT_TRUE(hasher.sha256MerkleFile(path).isError());
+
+    Sha256 algorithm;
+    EXPECT_TRUE(hasher.pipelinedFile(algorithm, path).isError());
+}
@@ -0,0 +1,110 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/hashing/test_pbkdf2.cpp
+*******************************************************************************/
+#include <solace/hashing/pbkdf2.hpp>  // Class being tested
+
+#include <solace/hashing/sha1.hpp>
+#include <solace/hashing/sha2.hpp>
+#include <solace/output_utils.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>  // std::min
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+
+namespace {
+
+MemoryView viewOf(char const* str) {
+    return wrapMemory(str, strlen(str));
+}
+
+/// Block of PBKDF2-HMAC-SHA256 output computed as written in RFC 8018, one HMAC after another.
+FixedSizeDigest<32> referenceBlock(MemoryView password, MemoryView salt, uint32 iterations, uint32 blockIndex) {
+    byte const counter[] = {
+        static_cast<byte>(blockIndex >> 24), static_cast<byte>(blockIndex >> 16),
+        static_cast<byte>(blockIndex >> 8), static_cast<byte>(blockIndex)
+    };
+
+    Hmac<Sha256> prf{password};
+    auto u = prf.update(salt).update(wrapMemory(counter)).digest();
+    auto block = u;
+    for (uint32 i = 1; i < iterations; ++i) {
+        u = prf.mac(u.view());
+        for (size_t j = 0; j < block.size(); ++j) {
+            block.view()[j] ^= u.view()[j];
+        }
+    }
+
+    return block;
+}
+
+}  // namespace
+
+
+TEST(TestPbkdf2, rfc6070Sha1) {
+    FixedSizeDigest<20> key;
+    ASSERT_TRUE(Pbkdf2<Sha1>::deriveKey(viewOf("password"), viewOf("salt"), 1, key.view()).isOk());
+    EXPECT_EQ(StringLiteral("0c60c80f961f0e71f3a9b524af6012062fe037a6"), key.toHex().view());
+
+    ASSERT_TRUE(Pbkdf2<Sha1>::deriveKey(viewOf("password"), viewOf("salt"), 4096, key.view()).isOk());
+    EXPECT_EQ(StringLiteral("4b007901b765489abead49d926f721d065a429c1"), key.toHex().view());
+}
+
+TEST(TestPbkdf2, multipleBlocks) {
+    FixedSizeDigest<25> key;
+    ASSERT_TRUE(Pbkdf2<Sha1>::deriveKey(viewOf("passwordPASSWORDpassword"),
+                                        viewOf("saltSALTsaltSALTsaltSALTsaltSALTsalt"),
+                                        4096, key.view()).isOk());
+    EXPECT_EQ(StringLiteral("3d2eec4fe41c849b80c8d83662c0e44a8b291a964cf2f07038"), key.toHex().view());
+
+    FixedSizeDigest<64> longKey;
+    ASSERT_TRUE(Pbkdf2<Sha256>::deriveKey(viewOf("passwd"), viewOf("salt"), 1, longKey.view()).isOk());
+    EXPECT_EQ(StringLiteral("55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc"
+                            "49ca9cccf179b645991664b39d77ef317c71b845b1e30bd509112041d3a19783"),
+              longKey.toHex().view());
+}
+
+TEST(TestPbkdf2, sha256) {
+    FixedSizeDigest<32> key;
+    ASSERT_TRUE(Pbkdf2<Sha256>::deriveKey(viewOf("password"), viewOf("salt"), 4096, key.view()).isOk());
+    EXPECT_EQ(StringLiteral("c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a"), key.toHex().view());
+}
+
+TEST(TestPbkdf2, sha256ManyBlocks) {
+    // Enough blocks for more than one batch of lanes, and a partial last block
+    byte key[20 * 32 + 5];
+    auto const password = viewOf("password");
+    auto const salt = viewOf("salt");
+    ASSERT_TRUE(Pbkdf2<Sha256>::deriveKey(password, salt, 100, wrapMemory(key)).isOk());
+
+    for (uint32 i = 0; i * 32 < sizeof(key); ++i) {
+        auto const expected = referenceBlock(password, salt, 100, i + 1);
+        auto const size = std::min<size_t>(32, sizeof(key) - i * 32);
+        EXPECT_EQ(expected.view().slice(0, size), wrapMemory(key + i * 32, size)) << "Block " << i;
+    }
+}
+
+TEST(TestPbkdf2, zeroIterations) {
+    FixedSizeDigest<32> key;
+    EXPECT_TRUE(Pbkdf2<Sha256>::deriveKey(viewOf("password"), viewOf("salt"), 0, key.view()).isError());
+    EXPECT_EQ(FixedSizeDigest<32>{}, key);
+}
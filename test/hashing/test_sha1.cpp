@@ -22,6 +22,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>  // std::min
+#include <vector>
+
 using namespace Solace;
 using namespace Solace::hashing;
 
@@ -89,3 +92,23 @@ TEST(TestHashingSHA1, hashMessageDigest) {
                                         0x4A, 0xA1, 0xF9, 0x51, 0x29, 0xE5, 0xE5, 0x46, 0x70, 0xF1}),
                             hash.digest());
 }
+
+TEST(TestHashingSHA1, hashMultipleBlocksInChunks) {
+    std::vector<byte> message(10007);
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<byte>(i * 13 + 5);
+    }
+
+    // Chunk sizes exercise both single block and multi-block processing, with and without buffered leftovers
+    for (size_t chunkSize : {1, 63, 64, 65, 128, 1000, 10007}) {
+        Sha1 hash;
+        for (size_t offset = 0; offset < message.size(); offset += chunkSize) {
+            hash.update(wrapMemory(message.data() + offset, std::min(chunkSize, message.size() - offset)));
+        }
+
+        EXPECT_EQ(std::initializer_list<byte>({0x1B, 0x16, 0x7C, 0x5E, 0xD1, 0x0A, 0x05, 0xC3,
+                                               0x9A, 0x27, 0xF2, 0x80, 0xA0, 0xDE, 0x0E, 0x17,
+                                               0x2D, 0xFE, 0x03, 0xFA}),
+                                hash.digest()) << "Chunk size: " << chunkSize;
+    }
+}
@@ -22,6 +22,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>  // std::min
+#include <vector>
+
 using namespace Solace;
 using namespace Solace::hashing;
 
@@ -83,3 +86,97 @@ TEST(TestHashingSHA256, hashMessageDigest) {
                                         0xF6, 0xEC, 0xED, 0xD4, 0x19, 0xDB, 0x06, 0xC1}),
                             hash.digest());
 }
+
+TEST(TestHashingSHA256, hashMultipleBlocksInChunks) {
+    std::vector<byte> message(10007);
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<byte>(i * 13 + 5);
+    }
+
+    // Chunk sizes exercise both single block and multi-block processing, with and without buffered leftovers
+    for (size_t chunkSize : {1, 63, 64, 65, 128, 1000, 10007}) {
+        Sha256 hash;
+        for (size_t offset = 0; offset < message.size(); offset += chunkSize) {
+            hash.update(wrapMemory(message.data() + offset, std::min(chunkSize, message.size() - offset)));
+        }
+
+        EXPECT_EQ(std::initializer_list<byte>({0xB0, 0xD5, 0xC9, 0x1C, 0x8B, 0x7A, 0x7E, 0x84,
+                                               0xD1, 0x64, 0x36, 0xDC, 0x8C, 0x0A, 0x0E, 0x5F,
+                                               0xB7, 0x2B, 0x1B, 0xEB, 0x12, 0x3F, 0xD3, 0x1F,
+                                               0x78, 0x0F, 0x90, 0xDD, 0xB2, 0xEF, 0xEB, 0xCC}),
+                                hash.digest()) << "Chunk size: " << chunkSize;
+    }
+}
+
+TEST(TestHashingSHA256, multiBufferMatchesSingleBuffer) {
+    std::vector<byte> data(5000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<byte>(i * 7 + 11);
+    }
+
+    // Lengths around padding boundaries, with a few long messages to keep some lanes busy longer than others
+    std::vector<MemoryView> messages;
+    for (size_t i = 0; i < 150; ++i) {
+        auto const length = (i % 5 == 4) ? 1000 + i * 20 : i;
+        messages.push_back(wrapMemory(data.data() + i, length));
+    }
+
+    for (size_t count : {size_t{0}, size_t{1}, size_t{3}, size_t{17}, messages.size()}) {
+        std::vector<byte> digests(count * Sha256xN::kDigestSize);
+        ASSERT_TRUE(Sha256xN::digest(arrayView(messages.data(), count), wrapMemory(digests.data(), digests.size())));
+
+        for (size_t i = 0; i < count; ++i) {
+            Sha256 hash;
+            hash.update(messages[i]);
+            auto const expected = hash.digest();
+
+            EXPECT_EQ(expected.view(), wrapMemory(digests.data() + i * Sha256xN::kDigestSize, Sha256xN::kDigestSize))
+                    << "Message " << i << " of " << count;
+        }
+    }
+}
+
+TEST(TestHashingSHA256, multiBufferCompressFromChainingValue) {
+    std::vector<byte> data(64 * 21);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<byte>(i * 7 + 11);
+    }
+
+    // First block is the common prefix, each of the rest is compressed in a lane of its own
+    Sha256 prefix;
+    prefix.update(wrapMemory(data.data(), 64));
+    auto const prefixState = prefix.chainingValue();
+    ASSERT_TRUE(prefixState.isOk());
+
+    for (size_t count : {size_t{1}, size_t{7}, size_t{20}}) {
+        std::vector<Sha256::ChainingValue> states(count, prefixState.unwrap());
+        ASSERT_TRUE(Sha256xN::compress(arrayView(states.data(), count), wrapMemory(data.data() + 64, 64 * count)));
+
+        for (size_t i = 0; i < count; ++i) {
+            Sha256 hash;
+            hash.update(wrapMemory(data.data(), 64));
+            hash.update(wrapMemory(data.data() + 64 * (i + 1), 64));
+            auto const expected = hash.chainingValue();
+            ASSERT_TRUE(expected.isOk());
+
+            EXPECT_TRUE(std::equal(states[i].words, states[i].words + 8, expected.unwrap().words))
+                    << "Block " << i << " of " << count;
+        }
+    }
+
+    // Chaining value is only defined on block boundaries, and there must be a block for every state
+    prefix.update(wrapMemory(data.data(), 1));
+    EXPECT_TRUE(prefix.chainingValue().isError());
+
+    Sha256::ChainingValue states[2] = {};
+    EXPECT_TRUE(Sha256xN::compress(arrayView(states), wrapMemory(data.data(), 64)).isError());
+}
+
+TEST(TestHashingSHA256, multiBufferDestinationTooSmall) {
+    char message[] = "abc";
+    MemoryView const messages[] = {wrapMemory(message, 3), wrapMemory(message, 2)};
+
+    byte digests[Sha256xN::kDigestSize * 2 - 1];
+    EXPECT_FALSE(Sha256xN::digest(arrayView(messages, 2), wrapMemory(digests)));
+    EXPECT_LE(1U, Sha256xN::lanes());
+}
@@ -0,0 +1,287 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/hashing/test_sha3.cpp
+*******************************************************************************/
+#include <solace/hashing/sha3.hpp>  // Class being tested
+#include <solace/base16.hpp>
+#include <solace/output_utils.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>  // std::min
+#include <cstring>  // strlen
+#include <vector>
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+
+namespace {
+
+char const kAbc[] = "abc";
+
+/// 1600 bit message of 0xA3 bytes from NIST examples: longer than the rate of all SHA-3 variants
+std::vector<byte> a3Message() {
+    return std::vector<byte>(200, 0xA3);
+}
+
+std::vector<byte> patternMessage() {
+    std::vector<byte> message(10007);
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<byte>(i * 13 + 5);
+    }
+
+    return message;
+}
+
+/// Decode expected digest from its hex string
+std::vector<byte> fromHex(char const* hex) {
+    auto const encoded = wrapMemory(hex, strlen(hex));
+
+    std::vector<byte> result;
+    for (auto i = base16Decode_begin(encoded), end = base16Decode_end(encoded); i != end; ++i) {
+        result.push_back(*i);
+    }
+
+    return result;
+}
+
+std::vector<byte> hexDigest(HashingAlgorithm& hash, MemoryView message) {
+    hash.update(message);
+    auto const digest = hash.digest();
+
+    return std::vector<byte>(digest.begin(), digest.end());
+}
+
+}  // namespace
+
+
+TEST(TestHashingSHA3, testAlgorithmName) {
+    EXPECT_EQ(StringLiteral("SHA3-224"), Sha3_224{}.getAlgorithm());
+    EXPECT_EQ(StringLiteral("SHA3-256"), Sha3_256{}.getAlgorithm());
+    EXPECT_EQ(StringLiteral("SHA3-384"), Sha3_384{}.getAlgorithm());
+    EXPECT_EQ(StringLiteral("SHA3-512"), Sha3_512{}.getAlgorithm());
+    EXPECT_EQ(StringLiteral("SHAKE128"), Shake128{}.getAlgorithm());
+    EXPECT_EQ(StringLiteral("SHAKE256"), Shake256{}.getAlgorithm());
+}
+
+TEST(TestHashingSHA3, digestLength) {
+    EXPECT_EQ(224U, Sha3_224{}.getDigestLength());
+    EXPECT_EQ(256U, Sha3_256{}.getDigestLength());
+    EXPECT_EQ(384U, Sha3_384{}.getDigestLength());
+    EXPECT_EQ(512U, Sha3_512{}.getDigestLength());
+    EXPECT_EQ(256U, Shake128{}.getDigestLength());
+    EXPECT_EQ(512U, Shake256{}.getDigestLength());
+}
+
+TEST(TestHashingSHA3, hashEmptyMessage) {
+    Sha3_224 sha224;
+    EXPECT_EQ(fromHex("6b4e03423667dbb73b6e15454f0eb1abd4597f9a1b078e3f5b5a6bc7"),
+              hexDigest(sha224, MemoryView{}));
+
+    Sha3_256 sha256;
+    EXPECT_EQ(fromHex("a7ffc6f8bf1ed76651c14756a061d662f580ff4de43b49fa82d80a4b80f8434a"),
+              hexDigest(sha256, MemoryView{}));
+
+    Sha3_384 sha384;
+    EXPECT_EQ(fromHex("0c63a75b845e4f7d01107d852e4c2485c51a50aaaa94fc61995e71bbee983a2a"
+                      "c3713831264adb47fb6bd1e058d5f004"),
+              hexDigest(sha384, MemoryView{}));
+
+    Sha3_512 sha512;
+    EXPECT_EQ(fromHex("a69f73cca23a9ac5c8b567dc185a756e97c982164fe25859e0d1dcc1475c80a6"
+                      "15b2123af1f5f94c11e3e9402c3ac558f500199d95b6d3e301758586281dcd26"),
+              hexDigest(sha512, MemoryView{}));
+}
+
+TEST(TestHashingSHA3, hashABC) {
+    auto const message = wrapMemory(kAbc, sizeof(kAbc) - 1);
+
+    Sha3_224 sha224;
+    EXPECT_EQ(fromHex("e642824c3f8cf24ad09234ee7d3c766fc9a3a5168d0c94ad73b46fdf"),
+              hexDigest(sha224, message));
+
+    Sha3_256 sha256;
+    EXPECT_EQ(fromHex("3a985da74fe225b2045c172d6bd390bd855f086e3e9d525b46bfe24511431532"),
+              hexDigest(sha256, message));
+
+    Sha3_384 sha384;
+    EXPECT_EQ(fromHex("ec01498288516fc926459f58e2c6ad8df9b473cb0fc08c2596da7cf0e49be4b2"
+                      "98d88cea927ac7f539f1edf228376d25"),
+              hexDigest(sha384, message));
+
+    Sha3_512 sha512;
+    EXPECT_EQ(fromHex("b751850b1a57168a5693cd924b6b096e08f621827444f70d884f5d0240d2712e"
+                      "10e116e9192af3c91a7ec57647e3934057340b4cf408d5a56592f8274eec53f0"),
+              hexDigest(sha512, message));
+}
+
+TEST(TestHashingSHA3, hash1600BitMessage) {
+    auto const data = a3Message();
+    auto const message = wrapMemory(data.data(), data.size());
+
+    Sha3_224 sha224;
+    EXPECT_EQ(fromHex("9376816aba503f72f96ce7eb65ac095deee3be4bf9bbc2a1cb7e11e0"),
+              hexDigest(sha224, message));
+
+    Sha3_256 sha256;
+    EXPECT_EQ(fromHex("79f38adec5c20307a98ef76e8324afbfd46cfd81b22e3973c65fa1bd9de31787"),
+              hexDigest(sha256, message));
+
+    Sha3_384 sha384;
+    EXPECT_EQ(fromHex("1881de2ca7e41ef95dc4732b8f5f002b189cc1e42b74168ed1732649ce1dbcdd"
+                      "76197a31fd55ee989f2d7050dd473e8f"),
+              hexDigest(sha384, message));
+
+    Sha3_512 sha512;
+    EXPECT_EQ(fromHex("e76dfad22084a8b1467fcf2ffa58361bec7628edf5f3fdc0e4805dc48caeeca8"
+                      "1b7c13c30adf52a3659584739a2df46be589c51ca1a4a8416df6545a1ce8ba00"),
+              hexDigest(sha512, message));
+}
+
+TEST(TestHashingSHA3, hashMultipleBlocksInChunks) {
+    auto const message = patternMessage();
+
+    // Chunk sizes below, at and above the rate of SHA3-256, with and without partially absorbed blocks
+    for (size_t chunkSize : {1, 135, 136, 137, 272, 1000, 10007}) {
+        Sha3_256 hash;
+        for (size_t offset = 0; offset < message.size(); offset += chunkSize) {
+            hash.update(wrapMemory(message.data() + offset, std::min(chunkSize, message.size() - offset)));
+        }
+
+        EXPECT_EQ(fromHex("1610e529cfa86639a737508623ce67670a9e484a167e11f393f32ef479f7a061"),
+                  hexDigest(hash, MemoryView{})) << "Chunk size: " << chunkSize;
+    }
+}
+
+TEST(TestHashingSHAKE, shakeDigest) {
+    auto const abc = wrapMemory(kAbc, sizeof(kAbc) - 1);
+    auto const data = a3Message();
+
+    Shake128 shake128;
+    EXPECT_EQ(fromHex("7f9c2ba4e88f827d616045507605853ed73b8093f6efbc88eb1a6eacfa66ef26"),
+              hexDigest(shake128, MemoryView{}));
+
+    Shake128 shake128abc;
+    EXPECT_EQ(fromHex("5881092dd818bf5cf8a3ddb793fbcba74097d5c526a6d35f97b83351940f2cc8"),
+              hexDigest(shake128abc, abc));
+
+    Shake128 shake128a3;
+    EXPECT_EQ(fromHex("131ab8d2b594946b9c81333f9bb6e0ce75c3b93104fa3469d3917457385da037"),
+              hexDigest(shake128a3, wrapMemory(data.data(), data.size())));
+
+    Shake256 shake256;
+    EXPECT_EQ(fromHex("46b9dd2b0ba88d13233b3feb743eeb243fcd52ea62b81b82b50c27646ed5762f"
+                      "d75dc4ddd8c0f200cb05019d67b592f6fc821c49479ab48640292eacb3b7c4be"),
+              hexDigest(shake256, MemoryView{}));
+
+    Shake256 shake256abc;
+    EXPECT_EQ(fromHex("483366601360a8771c6863080cc4114d8db44530f8f1e1ee4f94ea37e78b5739"
+                      "d5a15bef186a5386c75744c0527e1faa9f8726e462a12a4feb06bd8801e751e4"),
+              hexDigest(shake256abc, abc));
+
+    Shake256 shake256a3;
+    EXPECT_EQ(fromHex("cd8a920ed141aa0407a22d59288652e9d9f1a7ee0c1e7c1ca699424da84a904d"
+                      "2d700caae7396ece96604440577da4f3aa22aeb8857f961c4cd8e06f0ae6610b"),
+              hexDigest(shake256a3, wrapMemory(data.data(), data.size())));
+}
+
+TEST(TestHashingSHAKE, squeezeLongOutput) {
+    Shake256 hash;
+    hash.update(wrapMemory(kAbc, sizeof(kAbc) - 1));
+
+    byte output[1000];
+    hash.squeeze(wrapMemory(output));
+
+    EXPECT_EQ(wrapMemory(output).slice(0, 64), Shake256{}.update(wrapMemory(kAbc, 3)).digest().view());
+    EXPECT_EQ(std::initializer_list<byte>({0x6B, 0xFB, 0xB2, 0x4E, 0x7E, 0xDF, 0xD1, 0xE6,
+                                           0x66, 0xA4, 0xB3, 0x7F, 0x64, 0xD4, 0x05, 0xBB}),
+              MessageDigest(wrapMemory(output).slice(1000 - 16, 1000)));
+}
+
+TEST(TestHashingSHAKE, squeezeInParts) {
+    auto const message = patternMessage();
+
+    // Squeeze sizes below, at and above the rate of SHAKE128 so that output crosses permutations at any offset
+    for (size_t partSize : {1, 167, 168, 169, 500}) {
+        Shake128 hash;
+        hash.update(wrapMemory(message.data(), message.size()));
+
+        byte output[500];
+        for (size_t offset = 0; offset < sizeof(output); offset += partSize) {
+            hash.squeeze(wrapMemory(output + offset, std::min(partSize, sizeof(output) - offset)));
+        }
+
+        EXPECT_EQ(std::initializer_list<byte>({0x91, 0xB8, 0x5A, 0x93, 0xEA, 0x00, 0xCE, 0x85,
+                                               0x1B, 0x02, 0x4F, 0x74, 0x4E, 0x73, 0x0C, 0xD6,
+                                               0xA8, 0xED, 0xF8, 0x0C, 0xD0, 0x4D, 0xD2, 0xA0,
+                                               0xCA, 0x8A, 0x44, 0xFB, 0xD3, 0xCE, 0xA9, 0x9A}),
+                  MessageDigest(wrapMemory(output).slice(500 - 32, 500))) << "Part size: " << partSize;
+    }
+}
+
+TEST(TestHashingSHA3, multiBufferMatchesSingleBuffer) {
+    std::vector<byte> data(5000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<byte>(i * 7 + 11);
+    }
+
+    // Lengths around rate boundaries, with a few long messages to keep some lanes busy longer than others
+    std::vector<MemoryView> messages;
+    for (size_t i = 0; i < 150; ++i) {
+        auto const length = (i % 5 == 4) ? 1000 + i * 20 : i;
+        messages.push_back(wrapMemory(data.data() + i, length));
+    }
+
+    for (Sha3xN::size_type digestLength : {224, 256, 384, 512}) {
+        auto const digestSize = digestLength / 8;
+
+        for (size_t count : {size_t{0}, size_t{1}, size_t{3}, size_t{17}, messages.size()}) {
+            std::vector<byte> digests(count * digestSize);
+            ASSERT_TRUE(Sha3xN::digest(arrayView(messages.data(), count),
+                                       wrapMemory(digests.data(), digests.size()),
+                                       digestLength));
+
+            for (size_t i = 0; i < count; ++i) {
+                Sha3_224 sha224;
+                Sha3_256 sha256;
+                Sha3_384 sha384;
+                Sha3_512 sha512;
+                HashingAlgorithm& hash = (digestLength == 224) ? static_cast<HashingAlgorithm&>(sha224)
+                                       : (digestLength == 256) ? static_cast<HashingAlgorithm&>(sha256)
+                                       : (digestLength == 384) ? static_cast<HashingAlgorithm&>(sha384)
+                                       : static_cast<HashingAlgorithm&>(sha512);
+                hash.update(messages[i]);
+                auto const expected = hash.digest();
+
+                EXPECT_EQ(expected.view(), wrapMemory(digests.data() + i * digestSize, digestSize))
+                        << "Message " << i << " of " << count << ", digest length " << digestLength;
+            }
+        }
+    }
+}
+
+TEST(TestHashingSHA3, multiBufferInvalidParameters) {
+    MemoryView const messages[] = {wrapMemory(kAbc, 3), wrapMemory(kAbc, 2)};
+
+    byte digests[64 * 2];
+    EXPECT_FALSE(Sha3xN::digest(arrayView(messages, 2), wrapMemory(digests, 32 * 2 - 1)));
+    EXPECT_FALSE(Sha3xN::digest(arrayView(messages, 2), wrapMemory(digests), 128));
+    EXPECT_TRUE(Sha3xN::digest(arrayView(messages, 2), wrapMemory(digests), 512));
+    EXPECT_LE(1U, Sha3xN::lanes());
+}
@@ -0,0 +1,137 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/hashing/test_siphash.cpp
+*******************************************************************************/
+#include <solace/hashing/siphash.hpp>  // Class being tested
+#include <solace/output_utils.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>  // std::min
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+
+namespace {
+
+// Key and messages of the reference implementation test vectors: key is 00 01 .. 0f, message is 00 01 .. (len - 1)
+SipHashKey const kKey{0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL};
+HalfSipHashKey const kHalfKey{0x03020100U, 0x07060504U};
+
+struct Vector {
+    uint32  length;
+    uint64  sip24;
+    uint64  sip13;
+    uint32  halfSip24;
+    uint32  halfSip13;
+};
+
+// Values of hash as integers: reference digests are their little-endian bytes
+Vector const kVectors[] = {
+    { 0, 0x726fdb47dd0e0e31ULL, 0xabac0158050fc4dcULL, 0x5b9f35a9U, 0x5814c896U},
+    { 1, 0x74f839c593dc67fdULL, 0xc9f49bf37d57ca93ULL, 0xb85a4727U, 0xe7e864caU},
+    { 7, 0xab0200f58b01d137ULL, 0xd3927d989bb11140ULL, 0xc563cf8bU, 0x9d38d9d6U},
+    { 8, 0x93f5f5799a932462ULL, 0x369095118d299a8eULL, 0x8f84b8d0U, 0x577999b1U},
+    {15, 0xa129ca6149be45e5ULL, 0xd320d86d2a519956ULL, 0x972bfe74U, 0xd0257b04U},
+    {63, 0x958a324ceb064572ULL, 0x9d199062b7bbb3a8ULL, 0x744aea59U, 0x87178304U},
+};
+
+MemoryView messageOf(byte (&buffer)[64], uint32 length) {
+    for (uint32 i = 0; i < sizeof(buffer); ++i) {
+        buffer[i] = static_cast<byte>(i);
+    }
+
+    return wrapMemory(buffer, length);
+}
+
+}  // namespace
+
+
+TEST(TestSipHash, testAlgorithmName) {
+    EXPECT_EQ(StringLiteral("SIPHASH-2-4"), SipHash24{}.getAlgorithm());
+    EXPECT_EQ(StringLiteral("SIPHASH-1-3"), SipHash13{}.getAlgorithm());
+    EXPECT_EQ(StringLiteral("HALFSIPHASH-2-4"), HalfSipHash24{}.getAlgorithm());
+    EXPECT_EQ(StringLiteral("HALFSIPHASH-1-3"), HalfSipHash13{}.getAlgorithm());
+
+    EXPECT_EQ(64U, SipHash24{}.getDigestLength());
+    EXPECT_EQ(32U, HalfSipHash24{}.getDigestLength());
+}
+
+TEST(TestSipHash, referenceVectors) {
+    byte buffer[64];
+    for (auto const& v : kVectors) {
+        auto const message = messageOf(buffer, v.length);
+
+        EXPECT_EQ(v.sip24, sipHash24(kKey, message)) << "Length: " << v.length;
+        EXPECT_EQ(v.sip13, sipHash13(kKey, message)) << "Length: " << v.length;
+        EXPECT_EQ(v.halfSip24, halfSipHash24(kHalfKey, message)) << "Length: " << v.length;
+        EXPECT_EQ(v.halfSip13, halfSipHash13(kHalfKey, message)) << "Length: " << v.length;
+    }
+}
+
+TEST(TestSipHash, digestIsLittleEndian) {
+    byte buffer[64];
+    SipHash24 hash{kKey};
+    hash.update(messageOf(buffer, 0));
+    EXPECT_EQ(std::initializer_list<byte>({0x31, 0x0e, 0x0e, 0xdd, 0x47, 0xdb, 0x6f, 0x72}), hash.digest());
+
+    HalfSipHash24 halfHash{kHalfKey};
+    halfHash.update(messageOf(buffer, 1));
+    EXPECT_EQ(std::initializer_list<byte>({0x27, 0x47, 0x5a, 0xb8}), halfHash.digest());
+}
+
+TEST(TestSipHash, chunkedUpdateMatchesOneShot) {
+    byte buffer[64];
+    for (auto const& v : kVectors) {
+        auto const message = messageOf(buffer, v.length);
+
+        for (size_t chunkSize = 1; chunkSize <= 9; ++chunkSize) {
+            SipHash13 hash{kKey};
+            HalfSipHash24 halfHash{kHalfKey};
+            for (size_t offset = 0; offset < v.length; offset += chunkSize) {
+                auto const chunk = message.slice(offset, std::min<size_t>(offset + chunkSize, v.length));
+                hash.update(chunk);
+                halfHash.update(chunk);
+            }
+
+            EXPECT_EQ(v.sip13, hash.value()) << "Length: " << v.length << ", chunk size: " << chunkSize;
+            EXPECT_EQ(v.halfSip24, halfHash.value()) << "Length: " << v.length << ", chunk size: " << chunkSize;
+        }
+    }
+}
+
+TEST(TestSipHash, processKey) {
+    auto const& key = SipHashKey::processKey();
+    EXPECT_EQ(&key, &SipHashKey::processKey());
+    EXPECT_TRUE(key.k0 != 0 || key.k1 != 0);
+
+    char const message[] = "message";
+    SipHash13 hash;
+    hash.update(wrapMemory(message, 7));
+    EXPECT_EQ(sipHash13(key, wrapMemory(message, 7)), hash.value());
+}
+
+TEST(TestSipHash, hashFunctor) {
+    SipHasher const hasher{kKey};
+    byte buffer[64];
+
+    EXPECT_EQ(kVectors[2].sip13, hasher(messageOf(buffer, 7)));
+    EXPECT_EQ(hasher(StringView{"key"}), hasher(wrapMemory("key", 3)));
+    EXPECT_NE(hasher(StringView{"key"}), SipHasher{}(StringView{"key"}));
+}
@@ -0,0 +1,171 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/hashing/test_xxhash.cpp
+*******************************************************************************/
+#include <solace/hashing/xxhash.hpp>  // Class being tested
+#include <solace/output_utils.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>  // std::min
+#include <vector>
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+
+namespace {
+
+std::vector<byte> makePattern(size_t size) {
+    std::vector<byte> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<byte>((i * 31 + 7) & 0xff);
+    }
+
+    return data;
+}
+
+struct TestVector {
+    size_t length;
+    uint64 xxh64;
+    uint64 xxh3;
+    uint64 xxh3Seeded;
+};
+
+// Lengths cover every size class of XXH3 and the boundaries between them
+TestVector const kVectors[] = {
+    {0, 0xef46db3751d8e999ULL, 0x2d06800538d394c2ULL, 0x602b0e2cd6662c8bULL},
+    {1, 0xa96c7f0ce858bbb7ULL, 0x4c5cca45d0f4811fULL, 0x2f3acd3805f81de3ULL},
+    {3, 0x56e6957632a487f9ULL, 0x15f7093b173d005cULL, 0x079dd5d54d89480aULL},
+    {4, 0xc60d15b1e3ff8f04ULL, 0xdca012f95811b6b9ULL, 0x1a246e2efb9c9b2eULL},
+    {8, 0x3da5c7aa269683e0ULL, 0xdec6a9a43575982eULL, 0x19ef7d3919108affULL},
+    {9, 0x4b17a9ba9e215c09ULL, 0xcbe393399f17ffbdULL, 0x9c98d3e24dc54d34ULL},
+    {16, 0xa19ad429b02bc413ULL, 0x7e484c18d74895d0ULL, 0xa106510078b0a252ULL},
+    {17, 0xfe9f0feb7eeedc09ULL, 0x208bde5ee2bed407ULL, 0x0b2caf8bf9648effULL},
+    {128, 0x725a5b9b3bedfe94ULL, 0xf92b70eaa21a6288ULL, 0x95425530beb89fe8ULL},
+    {129, 0x28fc8362643627d7ULL, 0xf8f76713f2bb60faULL, 0x29fa850b97ed9666ULL},
+    {240, 0xd430520ae3ed2fc6ULL, 0xccc7375172c41f03ULL, 0x2d882e7899ff64ccULL},
+    {241, 0xd3f50496d5bf27e0ULL, 0x0b3b630948ce4a00ULL, 0x422e82e8913e49e0ULL},
+    {1000, 0x99594f4828043d35ULL, 0x989765d0ea7a5ecdULL, 0x75b5719d9f31a6a2ULL},
+    {4097, 0xd42496bbbecacb1dULL, 0xb319759b4671c221ULL, 0x52c95add56c13a9dULL},
+    {100000, 0x3ac9cbc5a9b7f843ULL, 0xccf90df7e7e37036ULL, 0x72b33bdf88b29062ULL},
+};
+
+constexpr uint64 kSeed = 0x9E3779B97F4A7C15ULL;
+
+}  // namespace
+
+
+TEST(TestHashingXxHash, testAlgorithmName) {
+    EXPECT_EQ(StringLiteral("XXH64"), XxHash64().getAlgorithm());
+    EXPECT_EQ(StringLiteral("XXH3"), XxHash3().getAlgorithm());
+    EXPECT_EQ(64U, XxHash64().getDigestLength());
+    EXPECT_EQ(64U, XxHash3().getDigestLength());
+}
+
+TEST(TestHashingXxHash, hashEmptyMessage) {
+    char message[] = "";
+    EXPECT_EQ(std::initializer_list<byte>({0xef, 0x46, 0xdb, 0x37, 0x51, 0xd8, 0xe9, 0x99}),
+              XxHash64().update(wrapMemory(message, sizeof(message) - 1)).digest());
+    EXPECT_EQ(std::initializer_list<byte>({0x2d, 0x06, 0x80, 0x05, 0x38, 0xd3, 0x94, 0xc2}),
+              XxHash3().update(wrapMemory(message, sizeof(message) - 1)).digest());
+}
+
+TEST(TestHashingXxHash, hashText) {
+    char abc[] = "abc";
+    char md[] = "message digest";
+
+    XxHash64 h64;
+    h64.update(wrapMemory(abc, sizeof(abc) - 1));
+    EXPECT_EQ(0x44bc2cf5ad770999ULL, h64.value());
+
+    XxHash3 h3;
+    h3.update(wrapMemory(abc, sizeof(abc) - 1));
+    EXPECT_EQ(0x78af5f94892f3950ULL, h3.value());
+
+    EXPECT_EQ(std::initializer_list<byte>({0x06, 0x6e, 0xd7, 0x28, 0xfc, 0xee, 0xb3, 0xbe}),
+              XxHash64().update(wrapMemory(md, sizeof(md) - 1)).digest());
+    EXPECT_EQ(std::initializer_list<byte>({0x16, 0x0d, 0x8e, 0x93, 0x29, 0xbe, 0x94, 0xf9}),
+              XxHash3().update(wrapMemory(md, sizeof(md) - 1)).digest());
+}
+
+TEST(TestHashingXxHash, hashVectors) {
+    for (auto const& v : kVectors) {
+        auto const data = makePattern(v.length);
+        auto const input = wrapMemory(data.data(), data.size());
+
+        XxHash64 h64;
+        h64.update(input);
+        EXPECT_EQ(v.xxh64, h64.value()) << "Length: " << v.length;
+
+        XxHash3 h3;
+        h3.update(input);
+        EXPECT_EQ(v.xxh3, h3.value()) << "Length: " << v.length;
+
+        XxHash3 h3Seeded{kSeed};
+        h3Seeded.update(input);
+        EXPECT_EQ(v.xxh3Seeded, h3Seeded.value()) << "Length: " << v.length;
+    }
+}
+
+TEST(TestHashingXxHash, hashSeeded64) {
+    auto const data = makePattern(1000);
+
+    XxHash64 h64{42};
+    h64.update(wrapMemory(data.data(), data.size()));
+    EXPECT_EQ(0xebbb006470311ebcULL, h64.value());
+}
+
+TEST(TestHashingXxHash, updateInChunks) {
+    for (auto const& v : kVectors) {
+        auto const data = makePattern(v.length);
+
+        for (size_t chunkSize : {1, 7, 32, 100, 256, 1031}) {
+            XxHash64 h64;
+            XxHash3 h3;
+            XxHash3 h3Seeded{kSeed};
+            for (size_t offset = 0; offset < data.size(); offset += chunkSize) {
+                auto const chunk = wrapMemory(data.data() + offset, std::min(chunkSize, data.size() - offset));
+                h64.update(chunk);
+                h3.update(chunk);
+                h3Seeded.update(chunk);
+            }
+
+            EXPECT_EQ(v.xxh64, h64.value()) << "Length: " << v.length << ", chunk: " << chunkSize;
+            EXPECT_EQ(v.xxh3, h3.value()) << "Length: " << v.length << ", chunk: " << chunkSize;
+            EXPECT_EQ(v.xxh3Seeded, h3Seeded.value()) << "Length: " << v.length << ", chunk: " << chunkSize;
+        }
+    }
+}
+
+TEST(TestHashingXxHash, valueDoesNotChangeState) {
+    auto const data = makePattern(4097);
+
+    XxHash3 h3;
+    XxHash64 h64;
+    for (size_t offset = 0; offset < data.size(); offset += 500) {
+        auto const chunk = wrapMemory(data.data() + offset, std::min<size_t>(500, data.size() - offset));
+        h3.update(chunk);
+        h64.update(chunk);
+        h3.value();
+        h64.value();
+    }
+
+    EXPECT_EQ(0xb319759b4671c221ULL, h3.value());
+    EXPECT_EQ(0xd42496bbbecacb1dULL, h64.value());
+}
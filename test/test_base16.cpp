@@ -22,6 +22,9 @@
 #include <solace/exception.hpp>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstring>
+
 using namespace Solace;
 
 
@@ -222,3 +225,122 @@ TEST(TestBase16, decodingIntoSmallerBufferErrors) {
 
     EXPECT_TRUE(v.encode(wrapMemory("666F6F626172", 12)).isError());
 }
+
+
+TEST(TestBase16, testStreamEncodingLineWrapping) {
+	byte buffer[64];
+	ByteWriter dest(wrapMemory(buffer));
+	Base16StreamEncoder encoder(dest, 8);
+
+	byte const src[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0xFF};
+	auto const firstChunk = wrapMemory(src, 3);
+	EXPECT_EQ(6U, encoder.encodedSize(firstChunk));
+	ASSERT_TRUE(encoder.encode(firstChunk).isOk());
+
+	auto const secondChunk = wrapMemory(src + 3, 6);
+	EXPECT_EQ(14U, encoder.encodedSize(secondChunk));
+	ASSERT_TRUE(encoder.encode(secondChunk).isOk());
+	ASSERT_TRUE(encoder.finish().isOk());
+
+	EXPECT_EQ(wrapMemory("01234567\n89abcdef\nff", 20), dest.viewWritten());
+}
+
+
+TEST(TestBase16, testStreamDecodingInChunks) {
+	char const* srcMem = "01234567\n89abcdef\r\nFF";
+	byte const expected[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0xFF};
+
+	byte buffer[16];
+	for (MemoryView::size_type chunkSize = 1; chunkSize <= strlen(srcMem); ++chunkSize) {
+		ByteWriter dest(wrapMemory(buffer));
+		Base16StreamDecoder decoder(dest);
+
+		for (MemoryView::size_type i = 0; i < strlen(srcMem); i += chunkSize) {
+			auto const len = std::min<MemoryView::size_type>(chunkSize, strlen(srcMem) - i);
+			ASSERT_TRUE(decoder.encode(wrapMemory(srcMem + i, len)).isOk());
+		}
+		ASSERT_TRUE(decoder.finish().isOk());
+
+		EXPECT_EQ(wrapMemory(expected), dest.viewWritten());
+	}
+}
+
+
+TEST(TestBase16, testStreamDecodingErrors) {
+	byte buffer[2];
+	ByteWriter dest(wrapMemory(buffer));
+	Base16StreamDecoder decoder(dest);
+
+	EXPECT_TRUE(decoder.encode(wrapMemory("0g", 2)).isError());
+	EXPECT_TRUE(decoder.encode(wrapMemory("\xF0", 1)).isError());
+	decoder.reset();
+
+	ASSERT_TRUE(decoder.encode(wrapMemory("abc", 3)).isOk());
+	EXPECT_TRUE(decoder.finish().isError());
+
+	dest.rewind();
+	EXPECT_TRUE(decoder.encode(wrapMemory("aabbcc", 6)).isError());
+	EXPECT_EQ(2U, dest.position());
+}
+
+
+TEST(TestBase16, testBulkEncodingRoundTrip) {
+	// Long enough inputs of every length modulo vector block sizes, so that all code paths are covered.
+	byte src[100];
+	for (size_t i = 0; i < sizeof(src); ++i) {
+		src[i] = static_cast<byte>(i * 37 + 5);
+	}
+
+	static constexpr char digits[] = "0123456789abcdef";
+	byte encodedBuffer[200];
+	byte decodedBuffer[100];
+	for (MemoryView::size_type len = 0; len <= sizeof(src); ++len) {
+		ByteWriter encoded(wrapMemory(encodedBuffer));
+		ASSERT_TRUE(Base16Encoder(encoded).encode(wrapMemory(src, len)).isOk());
+		ASSERT_EQ(2 * len, encoded.position());
+		for (MemoryView::size_type i = 0; i < len; ++i) {
+			EXPECT_EQ(digits[src[i] >> 4], encodedBuffer[2 * i]);
+			EXPECT_EQ(digits[src[i] & 0xF], encodedBuffer[2 * i + 1]);
+		}
+
+		ByteWriter decoded(wrapMemory(decodedBuffer));
+		ASSERT_TRUE(Base16Decoder(decoded).encode(encoded.viewWritten()).isOk());
+		EXPECT_EQ(wrapMemory(src, len), decoded.viewWritten());
+	}
+}
+
+
+TEST(TestBase16, testUpperCaseEncoding) {
+	byte buffer[80];
+	ByteWriter dest(wrapMemory(buffer));
+
+	ASSERT_TRUE(Base16Encoder(dest, Base16Case::Upper)
+				.encode(wrapMemory("This is test message we want to encode", 38)).isOk());
+	EXPECT_EQ(wrapMemory("546869732069732074657374206D6573736167652077652077616E7420746F20656E636F6465", 76),
+			  dest.viewWritten());
+
+	dest.rewind();
+	byte const src[] = {0xDE, 0xAD, 0xBE, 0xEF};
+	Base16StreamEncoder encoder(dest, Base16Case::Upper);
+	ASSERT_TRUE(encoder.encode(wrapMemory(src)).isOk());
+	EXPECT_EQ(wrapMemory("DEADBEEF", 8), dest.viewWritten());
+}
+
+
+TEST(TestBase16, testDecodingMixedCase) {
+	byte buffer[20];
+	ByteWriter dest(wrapMemory(buffer));
+
+	char const* srcMem = "0123456789abcdefABCDEF0123456789aBcD";
+	ASSERT_TRUE(Base16Decoder(dest).encode(wrapMemory(srcMem, strlen(srcMem))).isOk());
+
+	byte const expected[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0xAB, 0xCD, 0xEF,
+							 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD};
+	EXPECT_EQ(wrapMemory(expected), dest.viewWritten());
+
+	// Invalid digit past the first vector block
+	dest.rewind();
+	char const* invalid = "0123456789abcdef0123456789abcdeg";
+	EXPECT_TRUE(Base16Decoder(dest).encode(wrapMemory(invalid, strlen(invalid))).isError());
+	EXPECT_EQ(0U, dest.position());
+}
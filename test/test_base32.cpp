@@ -0,0 +1,302 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_base32.cpp
+ ********************************************************************************/
+#include <solace/base32.hpp>  // Class being tested
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Solace;
+
+
+namespace {
+
+MemoryView
+asBytes(char const* str) {
+	return wrapMemory(str, strlen(str));
+}
+
+/// Straightforward bit by bit Base32 encoding to check against.
+MemoryView::size_type
+referenceEncode(byte* dest, byte const* src, MemoryView::size_type len, char const* alphabet, bool padding) {
+	MemoryView::size_type n = 0;
+	for (MemoryView::size_type bit = 0; bit < len * 8; bit += 5) {
+		uint32 value = 0;
+		for (MemoryView::size_type k = bit; k < bit + 5; ++k) {
+			auto const b = (k < len * 8) ? (src[k / 8] >> (7 - k % 8)) & 1 : 0;
+			value = (value << 1) | static_cast<uint32>(b);
+		}
+		dest[n++] = static_cast<byte>(alphabet[value]);
+	}
+
+	while (padding && n % 8) {
+		dest[n++] = '=';
+	}
+
+	return n;
+}
+
+}  // namespace
+
+
+TEST(TestBase32, testEncodedSize) {
+	EXPECT_EQ(0U, Base32Encoder::encodedSize(0));
+	EXPECT_EQ(8U, Base32Encoder::encodedSize(1));
+	EXPECT_EQ(8U, Base32Encoder::encodedSize(5));
+	EXPECT_EQ(16U, Base32Encoder::encodedSize(6));
+	EXPECT_EQ(16U, Base32Encoder::encodedSize(10));
+
+	byte buffer[8];
+	ByteWriter dest(wrapMemory(buffer));
+	EXPECT_EQ(8U, Base32Encoder(dest).encodedSize(asBytes("f")));
+	EXPECT_EQ(2U, CrockfordBase32Encoder(dest).encodedSize(asBytes("f")));
+	EXPECT_EQ(7U, CrockfordBase32Encoder(dest).encodedSize(asBytes("foob")));
+}
+
+
+TEST(TestBase32, testBasicEncoding) {
+	// Test vectors from RFC-4648
+	char const* const expected[] = {"", "MY======", "MZXQ====", "MZXW6===", "MZXW6YQ=", "MZXW6YTB", "MZXW6YTBOI======"};
+
+	byte buffer[64];
+	for (MemoryView::size_type len = 0; len <= 6; ++len) {
+		ByteWriter dest(wrapMemory(buffer));
+		ASSERT_TRUE(Base32Encoder(dest).encode(wrapMemory("foobar", len)).isOk());
+		EXPECT_EQ(asBytes(expected[len]), dest.viewWritten());
+	}
+}
+
+
+TEST(TestBase32, testBasicDecoding) {
+	char const* const encoded[] = {"", "MY======", "MZXQ====", "MZXW6===", "MZXW6YQ=", "MZXW6YTB", "MZXW6YTBOI======"};
+
+	byte buffer[64];
+	for (MemoryView::size_type len = 0; len <= 6; ++len) {
+		ByteWriter dest(wrapMemory(buffer));
+		ASSERT_TRUE(Base32Decoder(dest).encode(asBytes(encoded[len])).isOk());
+		EXPECT_EQ(wrapMemory("foobar", len), dest.viewWritten());
+	}
+
+	// Padding is optional and lower case letters are accepted
+	ByteWriter dest(wrapMemory(buffer));
+	ASSERT_TRUE(Base32Decoder(dest).encode(asBytes("mzxw6ytboi")).isOk());
+	EXPECT_EQ(wrapMemory("foobar", 6), dest.viewWritten());
+}
+
+
+TEST(TestBase32, testHexAndCrockfordAlphabets) {
+	byte buffer[64];
+	{
+		ByteWriter dest(wrapMemory(buffer));
+		ASSERT_TRUE(Base32HexEncoder(dest).encode(wrapMemory("foobar", 6)).isOk());
+		EXPECT_EQ(asBytes("CPNMUOJ1E8======"), dest.viewWritten());
+	}
+	{
+		ByteWriter dest(wrapMemory(buffer));
+		ASSERT_TRUE(Base32HexDecoder(dest).encode(asBytes("CPNMUOJ1E8======")).isOk());
+		EXPECT_EQ(wrapMemory("foobar", 6), dest.viewWritten());
+	}
+	{
+		ByteWriter dest(wrapMemory(buffer));
+		ASSERT_TRUE(CrockfordBase32Encoder(dest).encode(wrapMemory("foobar", 6)).isOk());
+		EXPECT_EQ(asBytes("CSQPYRK1E8"), dest.viewWritten());
+	}
+	{
+		// Case insensitive, aliases for easily confused characters, hyphens ignored
+		ByteWriter dest(wrapMemory(buffer));
+		ASSERT_TRUE(CrockfordBase32Decoder(dest).encode(asBytes("csqp-yrkl-e8")).isOk());
+		EXPECT_EQ(wrapMemory("foobar", 6), dest.viewWritten());
+
+		dest.rewind();
+		ASSERT_TRUE(CrockfordBase32Decoder(dest).encode(asBytes("oi")).isOk());
+		ASSERT_TRUE(CrockfordBase32Decoder(dest).encode(asBytes("01")).isOk());
+		EXPECT_EQ(dest.viewWritten()[0], dest.viewWritten()[1]);
+
+		EXPECT_TRUE(CrockfordBase32Decoder(dest).encode(asBytes("CSQPU")).isError());
+		EXPECT_TRUE(CrockfordBase32Decoder(dest).encode(asBytes("MY======")).isError());
+	}
+}
+
+
+TEST(TestBase32, testBulkEncodingRoundTrip) {
+	// Long enough inputs of every length modulo vector block sizes, so that all code paths are covered.
+	byte src[200];
+	for (size_t i = 0; i < sizeof(src); ++i) {
+		src[i] = static_cast<byte>(i * 167 + 13);
+	}
+
+	byte encodedBuffer[400];
+	byte expectedBuffer[400];
+	byte decodedBuffer[200];
+	for (MemoryView::size_type len = 0; len <= sizeof(src); ++len) {
+		ByteWriter encoded(wrapMemory(encodedBuffer));
+		ASSERT_TRUE(Base32Encoder(encoded).encode(wrapMemory(src, len)).isOk());
+		auto const expectedLen = referenceEncode(expectedBuffer, src, len, "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567", true);
+		EXPECT_EQ(wrapMemory(expectedBuffer, expectedLen), encoded.viewWritten());
+
+		ByteWriter decoded(wrapMemory(decodedBuffer));
+		ASSERT_TRUE(Base32Decoder(decoded).encode(encoded.viewWritten()).isOk());
+		EXPECT_EQ(wrapMemory(src, len), decoded.viewWritten());
+
+		// Alphabets with different vectorized decoding ranges
+		encoded.rewind();
+		ASSERT_TRUE(Base32HexEncoder(encoded).encode(wrapMemory(src, len)).isOk());
+		decoded.rewind();
+		ASSERT_TRUE(Base32HexDecoder(decoded).encode(encoded.viewWritten()).isOk());
+		EXPECT_EQ(wrapMemory(src, len), decoded.viewWritten());
+
+		encoded.rewind();
+		ASSERT_TRUE(CrockfordBase32Encoder(encoded).encode(wrapMemory(src, len)).isOk());
+		auto const crockfordLen = referenceEncode(expectedBuffer, src, len, "0123456789ABCDEFGHJKMNPQRSTVWXYZ", false);
+		EXPECT_EQ(wrapMemory(expectedBuffer, crockfordLen), encoded.viewWritten());
+		decoded.rewind();
+		ASSERT_TRUE(CrockfordBase32Decoder(decoded).encode(encoded.viewWritten()).isOk());
+		EXPECT_EQ(wrapMemory(src, len), decoded.viewWritten());
+	}
+}
+
+
+TEST(TestBase32, testDecodingErrors) {
+	byte buffer[64];
+	ByteWriter dest(wrapMemory(buffer));
+
+	// Character outside of the alphabet, in the middle of a vector block and in the tail
+	EXPECT_TRUE(Base32Decoder(dest).encode(asBytes("MZXW6YTBOIMZXW6Y1BOIMZXW6YTB")).isError());
+	EXPECT_TRUE(Base32Decoder(dest).encode(asBytes("MZXW6YT!")).isError());
+	// Incomplete final group
+	EXPECT_TRUE(Base32Decoder(dest).encode(asBytes("MZX")).isError());
+	EXPECT_TRUE(Base32Decoder(dest).encode(asBytes("M=======")).isError());
+	// Data after padding
+	EXPECT_TRUE(Base32Decoder(dest).encode(asBytes("MY======MY======")).isError());
+
+	// Not enough space
+	byte small[3];
+	ByteWriter smallDest(wrapMemory(small));
+	EXPECT_TRUE(Base32Encoder(smallDest).encode(asBytes("foobar")).isError());
+	EXPECT_EQ(0U, smallDest.position());
+	EXPECT_TRUE(Base32Decoder(smallDest).encode(asBytes("MZXW6YTB")).isError());
+}
+
+
+TEST(TestBase32, testStreamEncodingInChunks) {
+	byte src[100];
+	for (size_t i = 0; i < sizeof(src); ++i) {
+		src[i] = static_cast<byte>(i * 31 + 7);
+	}
+
+	byte buffer[200];
+	for (MemoryView::size_type srcLen : {MemoryView::size_type{97}, MemoryView::size_type{100}}) {
+		byte expectedBuffer[200];
+		ByteWriter expected(wrapMemory(expectedBuffer));
+		ASSERT_TRUE(Base32Encoder(expected).encode(wrapMemory(src, srcLen)).isOk());
+
+		for (MemoryView::size_type chunkSize = 1; chunkSize <= 20; ++chunkSize) {
+			ByteWriter dest(wrapMemory(buffer));
+			Base32StreamEncoder encoder(dest);
+
+			for (MemoryView::size_type i = 0; i < srcLen; i += chunkSize) {
+				auto const chunk = wrapMemory(src).slice(i, std::min(i + chunkSize, srcLen));
+				auto const expectedSize = encoder.encodedSize(chunk);
+				auto const position = dest.position();
+				ASSERT_TRUE(encoder.encode(chunk).isOk());
+				EXPECT_EQ(expectedSize, dest.position() - position);
+			}
+			ASSERT_TRUE(encoder.finish().isOk());
+
+			EXPECT_EQ(expected.viewWritten(), dest.viewWritten());
+		}
+	}
+
+	ByteWriter dest(wrapMemory(buffer));
+	CrockfordBase32StreamEncoder encoder(dest);
+	ASSERT_TRUE(encoder.encode(wrapMemory("foo", 3)).isOk());
+	ASSERT_TRUE(encoder.encode(wrapMemory("bar", 3)).isOk());
+	ASSERT_TRUE(encoder.finish().isOk());
+	EXPECT_EQ(asBytes("CSQPYRK1E8"), dest.viewWritten());
+}
+
+
+TEST(TestBase32, testStreamDecodingInChunks) {
+	auto const encoded = asBytes("MZXW6YTBMZXW6YTB\r\nMZXW6YTBMZXW6YTB\r\nMZXW6YQ=");
+
+	byte expectedBuffer[64];
+	ByteWriter expected(wrapMemory(expectedBuffer));
+	for (int i = 0; i < 4; ++i) {
+		expected.write(wrapMemory("fooba", 5));
+	}
+	expected.write(wrapMemory("foob", 4));
+
+	byte buffer[64];
+	for (MemoryView::size_type chunkSize = 1; chunkSize <= 20; ++chunkSize) {
+		ByteWriter dest(wrapMemory(buffer));
+		Base32StreamDecoder decoder(dest);
+
+		for (MemoryView::size_type i = 0; i < encoded.size(); i += chunkSize) {
+			auto const chunk = encoded.slice(i, std::min(i + chunkSize, encoded.size()));
+			auto const maxSize = decoder.encodedSize(chunk);
+			auto const position = dest.position();
+			ASSERT_TRUE(decoder.encode(chunk).isOk());
+			EXPECT_LE(dest.position() - position, maxSize);
+		}
+		ASSERT_TRUE(decoder.finish().isOk());
+
+		EXPECT_EQ(expected.viewWritten(), dest.viewWritten());
+	}
+
+	// Incomplete final group
+	ByteWriter dest(wrapMemory(buffer));
+	Base32StreamDecoder decoder(dest);
+	ASSERT_TRUE(decoder.encode(asBytes("MZXW6YTBO")).isOk());
+	EXPECT_TRUE(decoder.finish().isError());
+
+	// Decoder is reusable after finish
+	dest.rewind();
+	ASSERT_TRUE(decoder.encode(asBytes("MZXW6")).isOk());
+	ASSERT_TRUE(decoder.encode(asBytes("===")).isOk());
+	ASSERT_TRUE(decoder.finish().isOk());
+	EXPECT_EQ(wrapMemory("foo", 3), dest.viewWritten());
+}
+
+
+TEST(TestBase32, testStreamDecodingOverflowKeepsCarry) {
+	byte buffer[5];
+	ByteWriter dest(wrapMemory(buffer));
+	Base32StreamDecoder decoder(dest);
+
+	ASSERT_TRUE(dest.write(wrapMemory("x", 1)).isOk());
+	ASSERT_TRUE(decoder.encode(asBytes("MZXW6YT")).isOk());
+	EXPECT_TRUE(decoder.encode(asBytes("B")).isError());
+
+	// Carried characters are still there once there is room for the group
+	dest.rewind();
+	ASSERT_TRUE(decoder.encode(asBytes("B")).isOk());
+	ASSERT_TRUE(decoder.finish().isOk());
+	EXPECT_EQ(wrapMemory("fooba", 5), dest.viewWritten());
+
+	// Same for a group completed by padding
+	ASSERT_TRUE(decoder.encode(asBytes("MZXW6")).isOk());
+	EXPECT_TRUE(decoder.encode(asBytes("===")).isError());
+
+	dest.rewind();
+	ASSERT_TRUE(decoder.encode(asBytes("===")).isOk());
+	ASSERT_TRUE(decoder.finish().isOk());
+	EXPECT_EQ(wrapMemory("foo", 3), dest.viewWritten());
+}
@@ -22,6 +22,7 @@
 #include <solace/exception.hpp>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstring>
 
 using namespace Solace;
@@ -218,3 +219,237 @@ TEST(TestBase64, testUnicodeCharactersDecoding) {
 
     EXPECT_EQ(wrapMemory(expectedMsg, strlen(expectedMsg)), dest.viewWritten());
 }
+
+
+TEST(TestBase64, testBulkEncodingRoundTrip) {
+	// Long enough inputs of every length modulo vector block sizes, so that all code paths are covered.
+	byte src[300];
+	for (size_t i = 0; i < sizeof(src); ++i) {
+		src[i] = static_cast<byte>(i * 167 + 13);
+	}
+
+	byte encodedBuffer[400];
+	byte decodedBuffer[300];
+	for (MemoryView::size_type len = 0; len <= sizeof(src); ++len) {
+		ByteWriter encoded(wrapMemory(encodedBuffer));
+		ASSERT_TRUE(Base64Encoder(encoded).encode(wrapMemory(src, len)).isOk());
+		ASSERT_EQ(Base64Encoder::encodedSize(len), encoded.position());
+
+		// Check against a straightforward encoding
+		static constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		for (MemoryView::size_type i = 0; i < len; i += 3) {
+			uint32 const group = (uint32{src[i]} << 16) |
+					((i + 1 < len) ? uint32{src[i + 1]} << 8 : 0) |
+					((i + 2 < len) ? uint32{src[i + 2]} : 0);
+			auto const out = encodedBuffer + i / 3 * 4;
+			EXPECT_EQ(alphabet[(group >> 18) & 0x3F], out[0]);
+			EXPECT_EQ(alphabet[(group >> 12) & 0x3F], out[1]);
+			EXPECT_EQ((i + 1 < len) ? alphabet[(group >> 6) & 0x3F] : '=', out[2]);
+			EXPECT_EQ((i + 2 < len) ? alphabet[group & 0x3F] : '=', out[3]);
+		}
+
+		if (len == 0) {
+			continue;
+		}
+
+		ByteWriter decoded(wrapMemory(decodedBuffer));
+		ASSERT_TRUE(Base64Decoder(decoded).encode(encoded.viewWritten()).isOk());
+		EXPECT_EQ(wrapMemory(src, len), decoded.viewWritten());
+	}
+}
+
+
+TEST(TestBase64, testBulkUrlEncodingRoundTrip) {
+	byte src[200];
+	for (size_t i = 0; i < sizeof(src); ++i) {
+		src[i] = static_cast<byte>(0xFB + i * 4);  // Lots of 62 and 63 sextets
+	}
+
+	byte encodedBuffer[300];
+	byte decodedBuffer[200];
+	for (MemoryView::size_type len = 1; len <= sizeof(src); ++len) {
+		ByteWriter encoded(wrapMemory(encodedBuffer));
+		ASSERT_TRUE(Base64UrlEncoder(encoded).encode(wrapMemory(src, len)).isOk());
+
+		for (auto c : encoded.viewWritten()) {
+			EXPECT_TRUE(c != '+' && c != '/');
+		}
+
+		ByteWriter decoded(wrapMemory(decodedBuffer));
+		ASSERT_TRUE(Base64UrlDecoder(decoded).encode(encoded.viewWritten()).isOk());
+		EXPECT_EQ(wrapMemory(src, len), decoded.viewWritten());
+	}
+}
+
+
+TEST(TestBase64, testDecodingStopsAtInvalidCharacter) {
+	byte buffer[64];
+	ByteWriter dest(wrapMemory(buffer));
+
+	// Invalid character in the middle of a long input
+	char const* srcMem = "VGhpcyBpcyB0ZXN0IG1lc3Nh*2Ugd2Ugd2FudCB0byBlbmNvZGU=";
+	EXPECT_TRUE(Base64Decoder(dest).encode(wrapMemory(srcMem, strlen(srcMem))).isOk());
+	EXPECT_EQ(wrapMemory("This is test messa", 18), dest.viewWritten());
+
+	// Standard alphabet characters are not valid for URL safe decoder
+	dest.rewind();
+	EXPECT_TRUE(Base64UrlDecoder(dest).encode(wrapMemory("Pz8/Pz8-", 8)).isOk());
+	EXPECT_EQ(wrapMemory("??", 2), dest.viewWritten());
+}
+
+
+TEST(TestBase64, testNotEnoughSpace) {
+	byte buffer[7];
+	ByteWriter dest(wrapMemory(buffer));
+
+	EXPECT_TRUE(Base64Encoder(dest).encode(wrapMemory("foob", 4)).isError());
+	EXPECT_EQ(0U, dest.position());
+
+	EXPECT_TRUE(Base64Decoder(dest).encode(wrapMemory("Zm9vYmFyYmF6", 12)).isError());
+	EXPECT_EQ(0U, dest.position());
+}
+
+
+TEST(TestBase64, testStreamEncodingInChunks) {
+	byte src[100];
+	for (size_t i = 0; i < sizeof(src); ++i) {
+		src[i] = static_cast<byte>(i * 31 + 7);
+	}
+
+	byte expectedBuffer[200];
+	ByteWriter expected(wrapMemory(expectedBuffer));
+	ASSERT_TRUE(Base64Encoder(expected).encode(wrapMemory(src)).isOk());
+
+	byte buffer[200];
+	for (MemoryView::size_type chunkSize = 1; chunkSize <= 20; ++chunkSize) {
+		ByteWriter dest(wrapMemory(buffer));
+		Base64StreamEncoder encoder(dest);
+
+		for (MemoryView::size_type i = 0; i < sizeof(src); i += chunkSize) {
+			auto const chunk = wrapMemory(src).slice(i, std::min<MemoryView::size_type>(i + chunkSize, sizeof(src)));
+			auto const expectedSize = encoder.encodedSize(chunk);
+			auto const position = dest.position();
+			ASSERT_TRUE(encoder.encode(chunk).isOk());
+			EXPECT_EQ(expectedSize, dest.position() - position);
+		}
+		ASSERT_TRUE(encoder.finish().isOk());
+
+		EXPECT_EQ(expected.viewWritten(), dest.viewWritten());
+	}
+}
+
+
+TEST(TestBase64, testStreamEncodingLineWrapping) {
+	char const* srcMem = "This is line one\nThis is line two\nThis is line three\nAnd so on...\n";
+
+	byte buffer[128];
+	ByteWriter dest(wrapMemory(buffer));
+	Base64StreamEncoder encoder(dest, Base64StreamEncoder::kPemLineLength, "\n");
+	ASSERT_TRUE(encoder.encode(wrapMemory(srcMem, 10)).isOk());
+	ASSERT_TRUE(encoder.encode(wrapMemory(srcMem + 10, strlen(srcMem) - 10)).isOk());
+	ASSERT_TRUE(encoder.finish().isOk());
+
+	char const* expected =
+			"VGhpcyBpcyBsaW5lIG9uZQpUaGlzIGlzIGxpbmUgdHdvClRoaXMgaXMgbGluZSB0\n"
+			"aHJlZQpBbmQgc28gb24uLi4K";
+	EXPECT_EQ(wrapMemory(expected, strlen(expected)), dest.viewWritten());
+
+	// Only the padded group from finish() goes to the next line, no line break after the last line
+	byte src[57] = {0};
+	dest.rewind();
+	Base64StreamEncoder mimeEncoder(dest, Base64StreamEncoder::kMimeLineLength);
+	ASSERT_TRUE(mimeEncoder.encode(wrapMemory(src, 57)).isOk());
+	EXPECT_EQ(76U, dest.position());
+	ASSERT_TRUE(mimeEncoder.encode(wrapMemory(src, 1)).isOk());
+	ASSERT_TRUE(mimeEncoder.finish().isOk());
+	EXPECT_EQ(82U, dest.position());
+	EXPECT_EQ(wrapMemory("\r\nAA==", 6), dest.viewWritten().slice(76, 82));
+}
+
+
+TEST(TestBase64, testStreamDecodingInChunks) {
+	char const* srcMem =
+			"VGhpcyBpcyBsaW5lIG9uZQpUaGlzIGlzIGxpbmUgdHdvClRoaXMgaXMgbGluZSB0\r\n"
+			"aHJlZQpBbmQgc28gb24uLi4K";
+	char const* expected = "This is line one\nThis is line two\nThis is line three\nAnd so on...\n";
+	auto const src = wrapMemory(srcMem, strlen(srcMem));
+
+	byte buffer[128];
+	for (MemoryView::size_type chunkSize = 1; chunkSize <= src.size(); ++chunkSize) {
+		ByteWriter dest(wrapMemory(buffer));
+		Base64StreamDecoder decoder(dest);
+
+		for (MemoryView::size_type i = 0; i < src.size(); i += chunkSize) {
+			auto const chunk = src.slice(i, std::min<MemoryView::size_type>(i + chunkSize, src.size()));
+			ASSERT_TRUE(decoder.encode(chunk).isOk());
+		}
+		ASSERT_TRUE(decoder.finish().isOk());
+
+		EXPECT_EQ(wrapMemory(expected, strlen(expected)), dest.viewWritten());
+	}
+}
+
+
+TEST(TestBase64, testStreamDecodingPadding) {
+	byte buffer[16];
+	ByteWriter dest(wrapMemory(buffer));
+	Base64UrlStreamDecoder decoder(dest);
+
+	// Padding split between chunks
+	ASSERT_TRUE(decoder.encode(wrapMemory("Pz8-P", 5)).isOk());
+	ASSERT_TRUE(decoder.encode(wrapMemory("w=", 2)).isOk());
+	ASSERT_TRUE(decoder.encode(wrapMemory("=\n", 2)).isOk());
+	ASSERT_TRUE(decoder.finish().isOk());
+	EXPECT_EQ(wrapMemory("?\?>?", 4), dest.viewWritten());
+
+	// Unpadded input is flushed by finish()
+	dest.rewind();
+	ASSERT_TRUE(decoder.encode(wrapMemory("Zm8", 3)).isOk());
+	EXPECT_EQ(0U, dest.position());
+	ASSERT_TRUE(decoder.finish().isOk());
+	EXPECT_EQ(wrapMemory("fo", 2), dest.viewWritten());
+}
+
+
+TEST(TestBase64, testStreamDecodingOverflowKeepsCarry) {
+	byte buffer[3];
+	ByteWriter dest(wrapMemory(buffer));
+	Base64StreamDecoder decoder(dest);
+
+	ASSERT_TRUE(decoder.encode(wrapMemory("QQ==", 4)).isOk());
+	ASSERT_TRUE(decoder.finish().isOk());
+	ASSERT_TRUE(decoder.encode(wrapMemory("Zm9", 3)).isOk());
+	EXPECT_TRUE(decoder.encode(wrapMemory("v", 1)).isError());
+
+	// Carried characters are still there once there is room for the group
+	dest.rewind();
+	ASSERT_TRUE(decoder.encode(wrapMemory("v", 1)).isOk());
+	ASSERT_TRUE(decoder.finish().isOk());
+	EXPECT_EQ(wrapMemory("foo", 3), dest.viewWritten());
+}
+
+
+TEST(TestBase64, testStreamDecodingErrors) {
+	byte buffer[16];
+	ByteWriter dest(wrapMemory(buffer));
+	Base64StreamDecoder decoder(dest);
+
+	EXPECT_TRUE(decoder.encode(wrapMemory("Zm9v*", 5)).isError());
+	decoder.reset();
+
+	EXPECT_TRUE(decoder.encode(wrapMemory("Zm8=Zm8=", 8)).isError());
+	decoder.reset();
+
+	EXPECT_TRUE(decoder.encode(wrapMemory("Z=", 2)).isError());
+	decoder.reset();
+
+	// More padding than the group needs
+	EXPECT_TRUE(decoder.encode(wrapMemory("QQ=====", 7)).isError());
+	decoder.reset();
+
+	EXPECT_TRUE(decoder.encode(wrapMemory("Zm8==", 5)).isError());
+	decoder.reset();
+
+	ASSERT_TRUE(decoder.encode(wrapMemory("Zm9vY", 5)).isOk());
+	EXPECT_TRUE(decoder.finish().isError());
+}
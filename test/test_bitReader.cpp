@@ -0,0 +1,139 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_bitReader.cpp
+*******************************************************************************/
+#include <solace/bitReader.hpp>  // Class being tested
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace Solace;
+
+
+TEST(TestBitReader, readMsbFirst) {
+    byte const data[] = {0xA5, 0x3C, 0xFF, 0x01};
+    BitReader reader{wrapMemory(data)};
+
+    EXPECT_EQ(32U, reader.limit());
+    EXPECT_EQ(1U, reader.readBits(1).unwrap());
+    EXPECT_EQ(1U, reader.readBits(2).unwrap());
+    EXPECT_EQ(0x5U, reader.readBits(5).unwrap());
+    EXPECT_EQ(0x3CFU, reader.peekBits(12).unwrap());
+    EXPECT_EQ(8U, reader.bitPosition());
+    EXPECT_EQ(0x3CFU, reader.readBits(12).unwrap());
+    EXPECT_EQ(0xF01U, reader.readBits(12).unwrap());
+    EXPECT_FALSE(reader.hasRemaining());
+
+    EXPECT_TRUE(reader.readBit().isError());
+    EXPECT_TRUE(reader.readBits(0).isOk());
+}
+
+
+TEST(TestBitReader, readLsbFirst) {
+    byte const data[] = {0xA5, 0x3C, 0xFF, 0x01};
+    BitReader reader{wrapMemory(data), BitOrder::LsbFirst};
+
+    EXPECT_TRUE(reader.readBit().unwrap());
+    EXPECT_EQ(0x2U, reader.readBits(2).unwrap());
+    EXPECT_EQ(0x14U, reader.readBits(5).unwrap());
+    EXPECT_EQ(0xF3CU, reader.readBits(12).unwrap());
+    EXPECT_EQ(0x01FU, reader.peekBits(12).unwrap());
+    EXPECT_EQ(0x01FU, reader.readBits(12).unwrap());
+    EXPECT_EQ(0U, reader.remainingBits());
+}
+
+
+TEST(TestBitReader, readWideValues) {
+    byte const data[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF,
+                         0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10, 0x0F};
+
+    BitReader msb{wrapMemory(data)};
+    EXPECT_EQ(0x0U, msb.readBits(4).unwrap());
+    EXPECT_EQ(0x123456789ABCDEFFULL, msb.readBits(64).unwrap());
+    EXPECT_EQ(0xEDCBA98765432ULL, msb.readBits(52).unwrap());
+    EXPECT_TRUE(msb.readBits(64).isError());
+    EXPECT_EQ(120U, msb.bitPosition());
+    EXPECT_TRUE(msb.peekBits(57).isError());
+    EXPECT_TRUE(msb.readBits(65).isError());
+
+    BitReader lsb{wrapMemory(data), BitOrder::LsbFirst};
+    EXPECT_EQ(0x1U, lsb.readBits(4).unwrap());
+    EXPECT_EQ(0xEEFCDAB896745230ULL, lsb.readBits(64).unwrap());
+    EXPECT_EQ(0x1032547698BADCFULL, lsb.readBits(60).unwrap());
+}
+
+
+TEST(TestBitReader, positioning) {
+    byte const data[] = {0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0, 0x11, 0x22};
+    BitReader reader{wrapMemory(data)};
+
+    EXPECT_TRUE(reader.skipBits(12).isOk());
+    EXPECT_EQ(0x4U, reader.readBits(4).unwrap());
+    EXPECT_EQ(0x2U, reader.readBits(3).unwrap());
+    EXPECT_EQ(19U, reader.bitPosition());
+
+    EXPECT_EQ(24U, reader.alignToByte().bitPosition());
+    EXPECT_EQ(0x78U, reader.readBits(8).unwrap());
+
+    EXPECT_TRUE(reader.bitPosition(68).isOk());
+    EXPECT_EQ(0x122U, reader.readBits(12).unwrap());
+    EXPECT_TRUE(reader.skipBits(5).isError());
+    EXPECT_EQ(80U, reader.bitPosition());
+
+    EXPECT_TRUE(reader.bitPosition(81).isError());
+    EXPECT_TRUE(reader.bitPosition(4).isOk());
+    EXPECT_EQ(0x234U, reader.readBits(12).unwrap());
+}
+
+
+TEST(TestBitReader, readPacked) {
+    std::vector<byte> data(300);
+    uint32 state = 0x12345678;
+    for (auto& b : data) {
+        state = state * 1103515245 + 12345;
+        b = static_cast<byte>(state >> 16);
+    }
+
+    for (auto order : {BitOrder::MsbFirst, BitOrder::LsbFirst}) {
+        for (uint32 width = 0; width <= 32; ++width) {
+            for (uint32 offset : {0, 3}) {
+                uint32 const count = (width == 0) ? 50 : (8 * data.size() - offset) / width;
+                BitReader scalar{wrapMemory(data.data(), data.size()), order};
+                ASSERT_TRUE(scalar.skipBits(offset).isOk());
+                std::vector<uint32> expected(count);
+                for (auto& value : expected) {
+                    value = static_cast<uint32>(scalar.readBits(width).unwrap());
+                }
+
+                BitReader bulk{wrapMemory(data.data(), data.size()), order};
+                ASSERT_TRUE(bulk.skipBits(offset).isOk());
+                std::vector<uint32> values(count, 0xDEADBEEF);
+                ASSERT_TRUE(bulk.readPacked(arrayView(values.data(), values.size()), width).isOk());
+                EXPECT_EQ(expected, values) << "width: " << width << ", offset: " << offset;
+                EXPECT_EQ(scalar.bitPosition(), bulk.bitPosition());
+            }
+        }
+    }
+
+    BitReader reader{wrapMemory(data.data(), 4)};
+    uint32 values[5];
+    EXPECT_TRUE(reader.readPacked(values, 7).isError());
+    EXPECT_TRUE(reader.readPacked(values, 33).isError());
+    EXPECT_EQ(0U, reader.bitPosition());
+}
@@ -0,0 +1,102 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_bitWriter.cpp
+*******************************************************************************/
+#include <solace/bitWriter.hpp>  // Class being tested
+#include <solace/bitReader.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace Solace;
+
+
+TEST(TestBitWriter, writeMsbFirst) {
+    byte mem[4] = {0};
+    BitWriter writer{wrapMemory(mem)};
+
+    EXPECT_TRUE(writer.writeBit(true).isOk());
+    EXPECT_TRUE(writer.writeBits(1, 2).isOk());
+    EXPECT_TRUE(writer.writeBits(0xFF05, 5).isOk());  // High bits are ignored
+    EXPECT_TRUE(writer.writeBits(0x3CF, 12).isOk());
+    EXPECT_TRUE(writer.writeBits(0xF0, 8).isOk());
+    EXPECT_EQ(28U, writer.bitPosition());
+    EXPECT_EQ(4U, writer.bytesWritten());
+
+    writer.flush();
+    byte const expected[] = {0xA5, 0x3C, 0xFF, 0x00};
+    EXPECT_EQ(wrapMemory(expected), wrapMemory(mem));
+
+    EXPECT_TRUE(writer.writeBits(0x1F, 5).isError());
+    EXPECT_TRUE(writer.writeBits(0x1, 4).isOk());
+    EXPECT_FALSE(writer.writeBit(false).isOk());
+    writer.flush();
+    EXPECT_EQ(0x01, mem[3]);
+}
+
+
+TEST(TestBitWriter, writeLsbFirst) {
+    byte mem[12] = {0};
+    BitWriter writer{wrapMemory(mem), BitOrder::LsbFirst};
+
+    EXPECT_TRUE(writer.writeBit(true).isOk());
+    EXPECT_TRUE(writer.writeBits(0x2, 2).isOk());
+    EXPECT_TRUE(writer.writeBits(0x14, 5).isOk());
+    EXPECT_TRUE(writer.writeBits(0xF3C, 12).isOk());
+    EXPECT_EQ(3U, writer.alignToByte().bytesWritten());
+    EXPECT_TRUE(writer.writeBits(0x0123456789ABCDEFULL, 64).isOk());
+    EXPECT_TRUE(writer.writeBits(0x1, 9).isError());
+
+    byte const expected[] = {0xA5, 0x3C, 0x0F, 0xEF, 0xCD, 0xAB, 0x89, 0x67, 0x45, 0x23, 0x01, 0x00};
+    EXPECT_EQ(wrapMemory(expected), wrapMemory(mem));
+}
+
+
+TEST(TestBitWriter, roundTrip) {
+    for (auto order : {BitOrder::MsbFirst, BitOrder::LsbFirst}) {
+        byte mem[300];
+        BitWriter writer{wrapMemory(mem), order};
+
+        uint64 value = 0x9E3779B97F4A7C15ULL;
+        uint64 totalBits = 0;
+        for (uint32 width = 0; width <= 64; ++width) {
+            ASSERT_TRUE(writer.writeBits(value * width, width).isOk());
+            totalBits += width;
+        }
+
+        uint32 packed[10];
+        for (uint32 i = 0; i < 10; ++i) {
+            packed[i] = i * 0x01010101;
+        }
+        EXPECT_TRUE(writer.writePacked(packed, 13).isOk());
+        EXPECT_TRUE(writer.writePacked(packed, 33).isError());
+        EXPECT_EQ(totalBits + 130, writer.bitPosition());
+        writer.flush();
+
+        BitReader reader{wrapMemory(mem, writer.bytesWritten()), order};
+        for (uint32 width = 0; width <= 64; ++width) {
+            auto const mask = (width == 64) ? ~uint64{0} : (uint64{1} << width) - 1;
+            EXPECT_EQ((value * width) & mask, reader.readBits(width).unwrap()) << "width: " << width;
+        }
+
+        uint32 unpacked[10];
+        ASSERT_TRUE(reader.readPacked(unpacked, 13).isOk());
+        for (uint32 i = 0; i < 10; ++i) {
+            EXPECT_EQ(packed[i] & 0x1FFF, unpacked[i]);
+        }
+    }
+}
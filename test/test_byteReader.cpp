@@ -18,9 +18,12 @@
  * @file: test/test_readBuffer.cpp
  ********************************************************************************/
 #include <solace/byteReader.hpp>  // Class being tested
+#include <solace/byteWriter.hpp>
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 using namespace Solace;
 
 
@@ -238,3 +241,184 @@ TEST(TestReadBuffer, readLittleEndian) {
         EXPECT_EQ(expected64, result);
     }
 }
+
+
+TEST(TestReadBuffer, readVarint) {
+    byte bytes[64];
+    ByteWriter writer{wrapMemory(bytes)};
+    EXPECT_TRUE(writer.writeVarint(uint32{300}).isOk());
+    EXPECT_TRUE(writer.writeVarint(uint64{0xFFFFFFFFFFFFFFFF}).isOk());
+    EXPECT_TRUE(writer.writeVarint(int32{-2147483647 - 1}).isOk());
+    EXPECT_TRUE(writer.writeVarint(int64{-3}).isOk());
+    EXPECT_TRUE(writer.writeVarint(uint64{0x100000000}).isOk());
+
+    ByteReader reader{writer.viewWritten()};
+    uint32 u32 = 0;
+    uint64 u64 = 0;
+    int32 i32 = 0;
+    int64 i64 = 0;
+    EXPECT_TRUE(reader.readVarint(u32).isOk());
+    EXPECT_EQ(300U, u32);
+    EXPECT_TRUE(reader.readVarint(u64).isOk());
+    EXPECT_EQ(0xFFFFFFFFFFFFFFFFU, u64);
+    EXPECT_TRUE(reader.readVarint(i32).isOk());
+    EXPECT_EQ(-2147483647 - 1, i32);
+    EXPECT_TRUE(reader.readVarint(i64).isOk());
+    EXPECT_EQ(-3, i64);
+
+    // Value does not fit: position is unchanged
+    auto const position = reader.position();
+    EXPECT_TRUE(reader.readVarint(u32).isError());
+    EXPECT_EQ(position, reader.position());
+    EXPECT_TRUE(reader.readVarint(u64).isOk());
+    EXPECT_EQ(0x100000000U, u64);
+    EXPECT_FALSE(reader.hasRemaining());
+
+    // Truncated and overlong encodings
+    byte const truncated[] = {0x80, 0x80};
+    EXPECT_TRUE(ByteReader{wrapMemory(truncated)}.readVarint(u64).isError());
+    byte const overlong[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02};
+    EXPECT_TRUE(ByteReader{wrapMemory(overlong)}.readVarint(u64).isError());
+}
+
+
+TEST(TestReadBuffer, readVarintsInBulk) {
+    // Mix of runs of small values and values of every encoded length
+    std::vector<uint64> values;
+    for (uint64 i = 0; i < 300; ++i) {
+        values.push_back((i % 50 < 20) ? i % 100 : (uint64{1} << (i * 7 % 64)) + i);
+    }
+    values.push_back(0xFFFFFFFFFFFFFFFF);
+
+    std::vector<byte> buffer(values.size() * kMaxVarintSize);
+    ByteWriter writer{wrapMemory(buffer.data(), buffer.size())};
+    for (auto v : values) {
+        EXPECT_TRUE(writer.writeVarint(v).isOk());
+    }
+
+    for (size_t count = 0; count <= values.size(); count += 7) {
+        std::vector<uint64> decoded(count);
+        ByteReader reader{writer.viewWritten()};
+        ASSERT_TRUE(reader.readVarints(arrayView(decoded.data(), decoded.size())).isOk());
+        EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(), values.begin()));
+
+        // Position is the same as after reading values one by one
+        ByteReader expected{writer.viewWritten()};
+        for (size_t i = 0; i < count; ++i) {
+            uint64 value = 0;
+            EXPECT_TRUE(expected.readVarint(value).isOk());
+        }
+        EXPECT_EQ(expected.position(), reader.position());
+    }
+
+    std::vector<uint64> tooMany(values.size() + 1);
+    ByteReader reader{writer.viewWritten()};
+    EXPECT_TRUE(reader.readVarints(arrayView(tooMany.data(), tooMany.size())).isError());
+    EXPECT_EQ(0U, reader.position());
+
+    byte const malformed[20] = {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+                                0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01};
+    uint64 one[1];
+    EXPECT_TRUE(ByteReader{wrapMemory(malformed)}.readVarints(one).isError());
+}
+
+
+TEST(TestReadBuffer, readGroupVarint) {
+    std::vector<uint32> values;
+    for (uint32 i = 0; i < 103; ++i) {
+        values.push_back((i * 2654435761U) >> (i % 4 * 8));
+    }
+
+    std::vector<byte> buffer(values.size() * 5);
+    ByteWriter writer{wrapMemory(buffer.data(), buffer.size())};
+    EXPECT_TRUE(writer.writeGroupVarint(arrayView(values.data(), values.size())).isOk());
+
+    for (size_t count = 0; count <= values.size(); ++count) {
+        ByteWriter groupWriter{wrapMemory(buffer.data(), buffer.size())};
+        EXPECT_TRUE(groupWriter.writeGroupVarint(arrayView(values.data(), count)).isOk());
+
+        std::vector<uint32> decoded(count);
+        ByteReader reader{groupWriter.viewWritten()};
+        ASSERT_TRUE(reader.readGroupVarint(arrayView(decoded.data(), decoded.size())).isOk());
+        EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(), values.begin()));
+        EXPECT_FALSE(reader.hasRemaining());
+
+        if (count > 0) {  // Truncated data
+            ByteReader truncated{groupWriter.viewWritten().slice(0, groupWriter.position() - 1)};
+            EXPECT_TRUE(truncated.readGroupVarint(arrayView(decoded.data(), decoded.size())).isError());
+            EXPECT_EQ(0U, truncated.position());
+        }
+    }
+}
+
+
+TEST(TestReadBuffer, readArrays) {
+    byte bytes[72];
+    for (size_t i = 0; i < sizeof(bytes); ++i) {
+        bytes[i] = static_cast<byte>(i);
+    }
+
+    uint32 be32[17];
+    ByteReader reader{wrapMemory(bytes)};
+    EXPECT_TRUE(reader.readBE(be32).isOk());
+    EXPECT_EQ(68U, reader.position());
+    for (uint32 i = 0; i < 17; ++i) {
+        EXPECT_EQ((4 * i) << 24 | (4 * i + 1) << 16 | (4 * i + 2) << 8 | (4 * i + 3), be32[i]);
+    }
+
+    // Bulk read matches reading values one by one
+    uint64 le64[9];
+    uint16 be16[36];
+    EXPECT_TRUE(reader.rewind().readLE(le64).isOk());
+    EXPECT_TRUE(reader.rewind().readBE(be16).isOk());
+    reader.rewind();
+    for (auto expected : le64) {
+        uint64 value = 0;
+        EXPECT_TRUE(reader.readLE(value).isOk());
+        EXPECT_EQ(expected, value);
+    }
+    reader.rewind();
+    for (auto expected : be16) {
+        uint16 value = 0;
+        EXPECT_TRUE(reader.readBE(value).isOk());
+        EXPECT_EQ(expected, value);
+    }
+
+    // Not enough data: nothing is read
+    uint32 tooMany[19];
+    reader.rewind();
+    EXPECT_TRUE(reader.readLE(tooMany).isError());
+    EXPECT_EQ(0U, reader.position());
+}
+
+
+TEST(TestReadBuffer, ensureAndRead) {
+    byte const bytes[] = {0xAA, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    ByteReader reader{wrapMemory(bytes)};
+
+    byte first = 0;
+    EXPECT_TRUE(reader.read(&first).isOk());
+    EXPECT_TRUE(reader.ensure(10).isError());
+    EXPECT_EQ(1U, reader.position());
+
+    {
+        auto maybeCursor = reader.ensure(9);
+        ASSERT_TRUE(maybeCursor.isOk());
+
+        auto& cursor = maybeCursor.unwrap();
+        uint32 be32 = 0;
+        uint16 le16 = 0;
+        byte rest[1];
+        cursor.readBE(be32).readLE(le16).read(wrapMemory(rest));
+        EXPECT_EQ(0x01020304U, be32);
+        EXPECT_EQ(0x0605U, le16);
+        EXPECT_EQ(7, rest[0]);
+        EXPECT_EQ(8, cursor.get());
+        EXPECT_EQ(9, *cursor.data());
+        EXPECT_EQ(8U, cursor.consumed());
+        EXPECT_EQ(1U, cursor.remaining());
+        EXPECT_EQ(1U, reader.position());
+    }
+
+    EXPECT_EQ(9U, reader.position());
+}
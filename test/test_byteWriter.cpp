@@ -139,3 +139,116 @@ TEST(TestByteWriter, writeLittleEndian) {
         EXPECT_EQ(static_cast<byte>(0x84), bytes[7]);
     }
 }
+
+
+TEST(TestByteWriter, writeVarint) {
+    byte bytes[16];
+
+    auto expectEncoding = [&bytes](auto value, std::initializer_list<byte> expected) {
+        ByteWriter writer{wrapMemory(bytes)};
+        EXPECT_TRUE(writer.writeVarint(value).isOk());
+        EXPECT_EQ(wrapMemory(expected.begin(), expected.size()), writer.viewWritten());
+    };
+
+    expectEncoding(uint32{0}, {0x00});
+    expectEncoding(uint32{127}, {0x7F});
+    expectEncoding(uint32{128}, {0x80, 0x01});
+    expectEncoding(uint32{300}, {0xAC, 0x02});
+    expectEncoding(uint64{0xFFFFFFFFFFFFFFFF}, {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01});
+
+    // Signed values are ZigZag encoded
+    expectEncoding(int32{0}, {0x00});
+    expectEncoding(int32{-1}, {0x01});
+    expectEncoding(int32{1}, {0x02});
+    expectEncoding(int32{-64}, {0x7F});
+    expectEncoding(int64{64}, {0x80, 0x01});
+
+    // Not enough space
+    ByteWriter writer{wrapMemory(bytes, 1)};
+    EXPECT_TRUE(writer.writeVarint(uint32{128}).isError());
+    EXPECT_EQ(0U, writer.position());
+}
+
+
+TEST(TestByteWriter, writeGroupVarint) {
+    byte bytes[16];
+    ByteWriter writer{wrapMemory(bytes)};
+
+    uint32 const values[] = {1, 0x0102, 0x010203, 0x01020304, 5};
+    EXPECT_TRUE(writer.writeGroupVarint(values).isOk());
+
+    byte const expected[] = {
+        0xE4, 0x01, 0x02, 0x01, 0x03, 0x02, 0x01, 0x04, 0x03, 0x02, 0x01,
+        0x00, 0x05
+    };
+    EXPECT_EQ(wrapMemory(expected), writer.viewWritten());
+
+    // Nothing is written if values don't fit
+    EXPECT_TRUE(writer.writeGroupVarint(values).isError());
+    EXPECT_EQ(sizeof(expected), writer.position());
+}
+
+
+TEST(TestByteWriter, writeArrays) {
+    uint64 values[9];
+    for (uint64 i = 0; i < 9; ++i) {
+        values[i] = 0x0102030405060708ULL * (i + 1);
+    }
+
+    byte bulk[72];
+    byte single[72];
+    {
+        ByteWriter bulkWriter{wrapMemory(bulk)};
+        ByteWriter singleWriter{wrapMemory(single)};
+        EXPECT_TRUE(bulkWriter.writeBE(values).isOk());
+        for (auto v : values) {
+            EXPECT_TRUE(singleWriter.writeBE(v).isOk());
+        }
+        EXPECT_EQ(singleWriter.viewWritten(), bulkWriter.viewWritten());
+        EXPECT_EQ(static_cast<byte>(0x01), bulk[0]);
+        EXPECT_EQ(static_cast<byte>(0x08), bulk[7]);
+    }
+    {
+        uint16 const shorts[] = {0x0102, 0x0304, 0x0506};
+        ByteWriter writer{wrapMemory(bulk)};
+        EXPECT_TRUE(writer.writeLE(shorts).isOk());
+        byte const expected[] = {0x02, 0x01, 0x04, 0x03, 0x06, 0x05};
+        EXPECT_EQ(wrapMemory(expected), writer.viewWritten());
+    }
+
+    // Values don't fit: nothing is written
+    ByteWriter writer{wrapMemory(bulk, 70)};
+    EXPECT_TRUE(writer.writeLE(values).isError());
+    EXPECT_EQ(0U, writer.position());
+}
+
+
+TEST(TestByteWriter, reserveAndWrite) {
+    byte bytes[16];
+    ByteWriter writer{wrapMemory(bytes)};
+    EXPECT_TRUE(writer.write(uint8{0xAA}).isOk());
+
+    {
+        auto maybeCursor = writer.reserve(15);
+        ASSERT_TRUE(maybeCursor.isOk());
+
+        auto& cursor = maybeCursor.unwrap();
+        cursor.writeBE(uint32{0x01020304})
+                .writeLE(uint16{0x0605})
+                .write(byte{7});
+        *cursor.data() = 8;
+        cursor.advance(1);
+        EXPECT_EQ(8U, cursor.written());
+        EXPECT_EQ(7U, cursor.remaining());
+
+        // Position is committed when the cursor goes out of scope
+        EXPECT_EQ(1U, writer.position());
+    }
+    EXPECT_EQ(9U, writer.position());
+
+    byte const expected[] = {0xAA, 1, 2, 3, 4, 5, 6, 7, 8};
+    EXPECT_EQ(wrapMemory(expected), writer.viewWritten());
+
+    EXPECT_TRUE(writer.reserve(8).isError());
+    EXPECT_EQ(9U, writer.position());
+}
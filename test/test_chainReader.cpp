@@ -0,0 +1,141 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_chainReader.cpp
+*******************************************************************************/
+#include <solace/chainReader.hpp>  // Class being tested
+
+#include <gtest/gtest.h>
+
+using namespace Solace;
+
+
+TEST(TestChainReader, emptyChain) {
+    ChainReader reader;
+    EXPECT_EQ(0U, reader.limit());
+    EXPECT_FALSE(reader.hasRemaining());
+    EXPECT_TRUE(reader.viewRemaining().empty());
+    EXPECT_TRUE(reader.get().isError());
+    EXPECT_TRUE(reader.advance(1).isError());
+    EXPECT_TRUE(reader.position(0).isOk());
+}
+
+
+TEST(TestChainReader, readAcrossSegments) {
+    byte const a[] = {0x01, 0x02, 0x03};
+    byte const b[] = {0x04};
+    byte const c[] = {0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F};
+    MemoryView const segments[] = {wrapMemory(a), MemoryView{}, wrapMemory(b), wrapMemory(c)};
+
+    ChainReader reader{segments};
+    EXPECT_EQ(4U, reader.segmentsCount());
+    EXPECT_EQ(15U, reader.limit());
+
+    uint8 u8 = 0;
+    EXPECT_TRUE(reader.readLE(u8).isOk());
+    EXPECT_EQ(0x01, u8);
+
+    uint32 u32 = 0;  // Spans three segments, one of them empty
+    EXPECT_TRUE(reader.readBE(u32).isOk());
+    EXPECT_EQ(0x02030405U, u32);
+    EXPECT_EQ(5U, reader.position());
+
+    uint16 u16 = 0;  // Within a segment
+    EXPECT_TRUE(reader.readLE(u16).isOk());
+    EXPECT_EQ(0x0706, u16);
+
+    uint64 u64 = 0;
+    EXPECT_TRUE(reader.readLE(u64).isOk());
+    EXPECT_EQ(0x0F0E0D0C0B0A0908ULL, u64);
+    EXPECT_FALSE(reader.hasRemaining());
+
+    EXPECT_TRUE(reader.readLE(u8).isError());
+
+    // Bulk read from the middle of the chain
+    EXPECT_TRUE(reader.position(2).isOk());
+    byte dest[6];
+    EXPECT_TRUE(reader.read(wrapMemory(dest)).isOk());
+    byte const expected[] = {0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+    EXPECT_EQ(wrapMemory(expected), wrapMemory(dest));
+    EXPECT_EQ(8U, reader.position());
+
+    // Failed read does not move the position
+    byte tooBig[8];
+    EXPECT_TRUE(reader.read(wrapMemory(tooBig)).isError());
+    EXPECT_EQ(8U, reader.position());
+
+    auto maybeByte = reader.get();
+    ASSERT_TRUE(maybeByte.isOk());
+    EXPECT_EQ(0x09, maybeByte.unwrap());
+}
+
+
+TEST(TestChainReader, positioning) {
+    char const a[] = "0123";
+    char const b[] = "4567";
+    MemoryView const segments[] = {wrapMemory(a, 4), wrapMemory(b, 4)};
+    ChainReader reader{segments};
+
+    EXPECT_TRUE(reader.advance(6).isOk());
+    EXPECT_EQ(6U, reader.position());
+    EXPECT_EQ(wrapMemory(b + 2, 2), reader.viewRemaining());
+
+    EXPECT_TRUE(reader.advance(3).isError());
+    EXPECT_EQ(6U, reader.position());
+
+    EXPECT_TRUE(reader.reset(1).isOk());
+    EXPECT_EQ(wrapMemory(a + 1, 3), reader.viewRemaining());
+
+    EXPECT_TRUE(reader.position(4).isOk());
+    EXPECT_EQ(wrapMemory(b, 4), reader.viewRemaining());
+
+    EXPECT_TRUE(reader.position(9).isError());
+    EXPECT_TRUE(reader.position(8).isOk());
+    EXPECT_TRUE(reader.viewRemaining().empty());
+
+    EXPECT_EQ(0U, reader.rewind().position());
+    EXPECT_EQ(8U, reader.remaining());
+}
+
+
+TEST(TestChainReader, readViewIsZeroCopyWithinSegment) {
+    char const a[] = "Hello";
+    char const b[] = "World";
+    MemoryView const segments[] = {wrapMemory(a, 5), wrapMemory(b, 5)};
+    ChainReader reader{segments};
+
+    byte scratch[8];
+    auto maybeView = reader.readView(3, wrapMemory(scratch));
+    ASSERT_TRUE(maybeView.isOk());
+    EXPECT_EQ(static_cast<void const*>(a), maybeView.unwrap().dataAddress());
+
+    maybeView = reader.readView(4, wrapMemory(scratch));  // Crosses the boundary
+    ASSERT_TRUE(maybeView.isOk());
+    EXPECT_EQ(static_cast<void const*>(scratch), maybeView.unwrap().dataAddress());
+    EXPECT_EQ(wrapMemory("loWo", 4), maybeView.unwrap());
+
+    maybeView = reader.readView(3, wrapMemory(scratch));  // Exactly the rest of a segment
+    ASSERT_TRUE(maybeView.isOk());
+    EXPECT_EQ(static_cast<void const*>(b + 2), maybeView.unwrap().dataAddress());
+
+    EXPECT_TRUE(reader.readView(1, wrapMemory(scratch)).isError());
+
+    // Scratch too small for the read that crosses the boundary
+    reader.rewind();
+    EXPECT_TRUE(reader.readView(8, wrapMemory(scratch, 4)).isError());
+    EXPECT_EQ(0U, reader.position());
+}
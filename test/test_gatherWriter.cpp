@@ -0,0 +1,150 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_gatherWriter.cpp
+*******************************************************************************/
+#include <solace/gatherWriter.hpp>  // Class being tested
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>  // pipe, read
+
+using namespace Solace;
+
+
+TEST(TestGatherWriter, smallWritesAreCoalesced) {
+    iovec segments[4];
+    byte scratch[32];
+    GatherWriter writer{arrayView(segments), wrapMemory(scratch), 8};
+
+    EXPECT_TRUE(writer.write(static_cast<uint8>(0x01)).isOk());
+    EXPECT_TRUE(writer.writeBE(static_cast<uint16>(0x0203)).isOk());
+    EXPECT_TRUE(writer.writeLE(static_cast<uint32>(0x07060504)).isOk());
+    EXPECT_TRUE(writer.write(wrapMemory("xyz", 3)).isOk());
+
+    EXPECT_EQ(10U, writer.size());
+    EXPECT_EQ(10U, 32 - writer.scratchRemaining());
+    ASSERT_EQ(1U, writer.segmentsCount());
+
+    byte const expected[] = {1, 2, 3, 4, 5, 6, 7, 'x', 'y', 'z'};
+    EXPECT_EQ(wrapMemory(expected), wrapMemory(writer.iovecs()[0].iov_base, writer.iovecs()[0].iov_len));
+}
+
+
+TEST(TestGatherWriter, largeWritesAreReferenced) {
+    iovec segments[4];
+    byte scratch[16];
+    GatherWriter writer{arrayView(segments), wrapMemory(scratch), 8};
+
+    byte payload[64];
+    for (size_t i = 0; i < sizeof(payload); ++i) {
+        payload[i] = static_cast<byte>(i);
+    }
+
+    EXPECT_TRUE(writer.writeBE(static_cast<uint32>(sizeof(payload))).isOk());
+    EXPECT_TRUE(writer.write(wrapMemory(payload)).isOk());
+    EXPECT_TRUE(writer.writeBE(static_cast<uint32>(0xCAFE)).isOk());
+
+    EXPECT_EQ(72U, writer.size());
+    EXPECT_EQ(8U, 16 - writer.scratchRemaining());
+    ASSERT_EQ(3U, writer.segmentsCount());
+    EXPECT_EQ(payload, writer.iovecs()[1].iov_base);
+    EXPECT_EQ(sizeof(payload), writer.iovecs()[1].iov_len);
+
+    // Forced copy of a large view and forced reference of a small one
+    EXPECT_TRUE(writer.clear().empty());
+    EXPECT_TRUE(writer.reference(wrapMemory(payload, 4)).isOk());
+    EXPECT_TRUE(writer.reference(wrapMemory(payload + 4, 4)).isOk());  // Adjacent - extends the last segment
+    EXPECT_TRUE(writer.copy(wrapMemory(payload, 12)).isOk());
+    ASSERT_EQ(2U, writer.segmentsCount());
+    EXPECT_EQ(payload, writer.iovecs()[0].iov_base);
+    EXPECT_EQ(8U, writer.iovecs()[0].iov_len);
+    EXPECT_EQ(scratch, writer.iovecs()[1].iov_base);
+}
+
+
+TEST(TestGatherWriter, overflowChangesNothing) {
+    iovec segments[2];
+    byte scratch[4];
+    GatherWriter writer{arrayView(segments), wrapMemory(scratch), 8};
+
+    byte payload[16] = {0};
+    EXPECT_TRUE(writer.writeLE(static_cast<uint16>(1)).isOk());
+    EXPECT_TRUE(writer.writeLE(static_cast<uint32>(2)).isError());  // No scratch space left
+    EXPECT_EQ(2U, writer.size());
+
+    EXPECT_TRUE(writer.write(wrapMemory(payload)).isOk());
+    EXPECT_TRUE(writer.writeLE(static_cast<uint16>(3)).isError());  // No segments left
+    EXPECT_TRUE(writer.write(wrapMemory(payload)).isError());
+    EXPECT_EQ(18U, writer.size());
+    EXPECT_EQ(2U, writer.segmentsCount());
+    EXPECT_EQ(2U, writer.scratchRemaining());
+}
+
+
+TEST(TestGatherWriter, copyTo) {
+    auto maybeWriter = makeGatherWriter(4, 16);
+    ASSERT_TRUE(maybeWriter.isOk());
+    auto& writer = maybeWriter.unwrap();
+
+    char const text[] = "A long enough message to be referenced";
+    EXPECT_TRUE(writer.write('[').isOk());
+    EXPECT_TRUE(writer.reference(wrapMemory(text, sizeof(text) - 1)).isOk());
+    EXPECT_TRUE(writer.write(']').isOk());
+
+    char small[8];
+    ByteWriter smallDest{wrapMemory(small)};
+    EXPECT_TRUE(writer.copyTo(smallDest).isError());
+    EXPECT_EQ(0U, smallDest.position());
+
+    char mem[64];
+    ByteWriter dest{wrapMemory(mem)};
+    ASSERT_TRUE(writer.copyTo(dest).isOk());
+    EXPECT_EQ(writer.size(), dest.position());
+    EXPECT_EQ(StringView{"[A long enough message to be referenced]"},
+              StringView(mem, dest.position()));
+}
+
+
+TEST(TestGatherWriter, writev) {
+    auto maybeWriter = makeGatherWriter(8, 64, 16);
+    ASSERT_TRUE(maybeWriter.isOk());
+    auto& writer = maybeWriter.unwrap();
+
+    char const body[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    EXPECT_TRUE(writer.writeBE(static_cast<uint16>(sizeof(body) - 1)).isOk());
+    EXPECT_TRUE(writer.write(wrapMemory(body, sizeof(body) - 1)).isOk());
+    EXPECT_TRUE(writer.write(wrapMemory("END", 3)).isOk());
+    ASSERT_EQ(3U, writer.segmentsCount());
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    auto const chain = writer.iovecs();
+    auto const written = ::writev(fds[1], chain.begin(), static_cast<int>(chain.size()));
+    ASSERT_EQ(static_cast<ssize_t>(writer.size()), written);
+
+    char received[64];
+    auto const bytesRead = ::read(fds[0], received, sizeof(received));
+    close(fds[0]);
+    close(fds[1]);
+
+    ASSERT_EQ(written, bytesRead);
+    EXPECT_EQ(0, received[0]);
+    EXPECT_EQ(36, received[1]);
+    EXPECT_EQ(StringView{"0123456789abcdefghijklmnopqrstuvwxyzEND"}, StringView(received + 2, 39));
+}
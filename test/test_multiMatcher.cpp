@@ -0,0 +1,195 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_multiMatcher.cpp
+*******************************************************************************/
+#include <solace/multiMatcher.hpp>	 // Class being tested
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace Solace;
+
+namespace {
+
+using Found = std::vector<std::pair<MultiMatcher::size_type, MultiMatcher::PatternId>>;
+
+Found scanAll(MultiMatcher const& matcher, StringView text) {
+	Found found;
+	auto const count = matcher.scan(text, [&found](MultiMatcher::Match const& m) {
+		found.emplace_back(m.offset, m.pattern);
+	});
+	EXPECT_EQ(found.size(), count);
+
+	std::sort(found.begin(), found.end());
+	return found;
+}
+
+Found findAllNaive(std::vector<std::string> const& patterns, std::string const& text) {
+	Found found;
+	for (size_t offset = 0; offset < text.size(); ++offset) {
+		for (uint32 id = 0; id < patterns.size(); ++id) {
+			auto const& p = patterns[id];
+			if (!p.empty() && text.compare(offset, p.size(), p) == 0) {
+				found.emplace_back(offset, id);
+			}
+		}
+	}
+
+	return found;
+}
+
+std::vector<StringView> toViews(std::vector<std::string> const& patterns) {
+	std::vector<StringView> views;
+	for (auto const& p : patterns) {
+		views.emplace_back(p.data(), narrow_cast<StringView::size_type>(p.size()));
+	}
+
+	return views;
+}
+
+}  // namespace
+
+
+TEST(TestMultiMatcher, testOverlappingMatches) {
+	StringView const patterns[] = {"he", "she", "his", "hers"};
+	auto maybeMatcher = makeMultiMatcher(patterns);
+	ASSERT_TRUE(maybeMatcher.isOk());
+
+	auto const& matcher = maybeMatcher.unwrap();
+	EXPECT_EQ(4U, matcher.patternsCount());
+	EXPECT_EQ(4U, matcher.patternLength(3));
+
+	Found const expected = {{1, 1}, {2, 0}, {2, 3}};
+	EXPECT_EQ(expected, scanAll(matcher, "ushers"));
+	EXPECT_TRUE(scanAll(matcher, "").empty());
+	EXPECT_TRUE(scanAll(matcher, "nothing to see").empty());
+}
+
+
+TEST(TestMultiMatcher, testEmptyAndDuplicatePatterns) {
+	StringView const patterns[] = {"", "ab", "ab", "b"};
+	auto maybeMatcher = makeMultiMatcher(patterns);
+	ASSERT_TRUE(maybeMatcher.isOk());
+
+	Found const expected = {{0, 1}, {0, 2}, {1, 3}, {3, 1}, {3, 2}, {4, 3}};
+	EXPECT_EQ(expected, scanAll(maybeMatcher.unwrap(), "abxab"));
+
+	auto noPatterns = makeMultiMatcher(ArrayView<StringView const>{});
+	ASSERT_TRUE(noPatterns.isOk());
+	EXPECT_TRUE(scanAll(noPatterns.unwrap(), "abxab").empty());
+	EXPECT_FALSE(noPatterns.unwrap().containsAny(StringView{"abxab"}));
+}
+
+
+TEST(TestMultiMatcher, testContainsAny) {
+	StringView const patterns[] = {"GET", "POST", "\r\n\r\n"};
+	auto maybeMatcher = makeMultiMatcher(patterns);
+	ASSERT_TRUE(maybeMatcher.isOk());
+
+	auto const& matcher = maybeMatcher.unwrap();
+	EXPECT_TRUE(matcher.containsAny(StringView{"HTTP/1.1 POST /index"}));
+	EXPECT_TRUE(matcher.containsAny(StringView{"headers\r\n\r\n"}));
+	EXPECT_FALSE(matcher.containsAny(StringView{"PUT /index HTTP/1.1\r\n"}));
+}
+
+
+TEST(TestMultiMatcher, testSmallSetMatchesNaiveSearch) {
+	// Small sets use the prefilter: check matches in full blocks, near block boundaries and in the tail.
+	std::vector<std::string> const patterns = {"a", "error", "warn", "fatal", "\xFF\xFE", "err", "xyz"};
+	std::string text;
+	for (int i = 0; i < 50; ++i) {
+		text += "some error, then a warning: \xFF\xFE fatal ";
+		text += std::string(static_cast<size_t>(i % 17), '.');
+	}
+	text += "xyz";
+
+	auto const views = toViews(patterns);
+	auto maybeMatcher = makeMultiMatcher(arrayView(views.data(), views.size()));
+	ASSERT_TRUE(maybeMatcher.isOk());
+
+	for (size_t len : {text.size(), size_t{3}, size_t{15}, size_t{16}, size_t{18}, size_t{33}, size_t{1000}}) {
+		auto const sub = text.substr(0, len);
+		EXPECT_EQ(findAllNaive(patterns, sub),
+				  scanAll(maybeMatcher.unwrap(), StringView{sub.data(), narrow_cast<StringView::size_type>(sub.size())}));
+	}
+}
+
+
+TEST(TestMultiMatcher, testLargeSetMatchesNaiveSearch) {
+	std::vector<std::string> patterns;
+	for (int i = 0; i < 200; ++i) {
+		patterns.push_back(std::to_string(i * 7919 % 1000));
+	}
+
+	std::string text;
+	for (int i = 0; i < 300; ++i) {
+		text += std::to_string(i * 31 % 977);
+		text += (i % 3) ? "-" : "";
+	}
+
+	auto const views = toViews(patterns);
+	auto maybeMatcher = makeMultiMatcher(arrayView(views.data(), views.size()));
+	ASSERT_TRUE(maybeMatcher.isOk());
+
+	auto const expected = findAllNaive(patterns, text);
+	EXPECT_FALSE(expected.empty());
+	EXPECT_EQ(expected,
+			  scanAll(maybeMatcher.unwrap(), StringView{text.data(), narrow_cast<StringView::size_type>(text.size())}));
+}
+
+
+TEST(TestMultiMatcher, testStreamAcrossChunks) {
+	StringView const patterns[] = {"needle", "needles", "les", "e"};
+	auto maybeMatcher = makeMultiMatcher(patterns);
+	ASSERT_TRUE(maybeMatcher.isOk());
+	auto const& matcher = maybeMatcher.unwrap();
+
+	StringView const text = "haystack needles and more needles";
+	auto const expected = scanAll(matcher, text);
+
+	for (StringView::size_type chunkSize = 1; chunkSize < text.size(); ++chunkSize) {
+		Found found;
+		std::vector<MultiMatcher::size_type> ends;
+		auto stream = matcher.stream();
+		for (StringView::size_type from = 0; from < text.size(); from += chunkSize) {
+			stream.feed(text.substring(from, std::min<StringView::size_type>(from + chunkSize, text.size())),
+						[&](MultiMatcher::Match const& m) {
+				found.emplace_back(m.offset, m.pattern);
+				ends.push_back(m.offset + matcher.patternLength(m.pattern));
+			});
+		}
+
+		EXPECT_EQ(text.size(), stream.position());
+		EXPECT_TRUE(std::is_sorted(ends.begin(), ends.end()));
+
+		std::sort(found.begin(), found.end());
+		EXPECT_EQ(expected, found);
+	}
+}
+
+
+TEST(TestMultiMatcher, testAllocationFailure) {
+	MemoryManager memManager{16};
+	StringView const patterns[] = {"one", "two", "three"};
+
+	EXPECT_TRUE(makeMultiMatcher(memManager, patterns).isError());
+}
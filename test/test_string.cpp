@@ -210,6 +210,47 @@ TEST(TestString, testReplace) {
 }
 
 
+TEST(TestString, testReplaceAllOccurrences) {
+	EXPECT_EQ(StringLiteral("b-b-b"),        makeStringReplace(StringView{"a-a-a"}, "a", "b"));
+	EXPECT_EQ(StringLiteral("--"),           makeStringReplace(StringView{"aaa-aaa-aaa"}, "aaa", ""));
+	EXPECT_EQ(StringLiteral("Xa"),           makeStringReplace(StringView{"aaa"}, "aa", "X"));
+	EXPECT_EQ(StringLiteral("no match"),     makeStringReplace(StringView{"no match"}, "xyz", "abc"));
+	EXPECT_EQ(StringLiteral("same"),         makeStringReplace(StringView{"same"}, "", "abc"));
+	EXPECT_EQ(StringLiteral(""),             makeStringReplace(StringView{}, "abc", "d"));
+
+	// More matches than recorded during the first pass
+	char source[301];
+	for (size_t i = 0; i < 300; i += 3) {
+		memcpy(source + i, "ab ", 3);
+	}
+	source[300] = 0;
+
+	auto result = makeStringReplace(StringView{source}, "ab", "xyz");
+	ASSERT_TRUE(result.isOk());
+	EXPECT_EQ(400U, result.unwrap().size());
+	EXPECT_FALSE(result.unwrap().contains("ab"));
+	EXPECT_TRUE(result.unwrap().endsWith("xyz "));
+}
+
+TEST(TestString, testReplaceMultiplePatterns) {
+	StringView const what[] = {"{name}", "{place}", "{n}"};
+	StringView const with[] = {"Alice", "Wonderland", "1"};
+
+	EXPECT_EQ(StringLiteral("Alice went to Wonderland 1 time"),
+			  makeStringReplace(StringView{"{name} went to {place} {n} time"}, what, with));
+	EXPECT_EQ(StringLiteral("nothing to see"),
+			  makeStringReplace(StringView{"nothing to see"}, what, with));
+	EXPECT_EQ(StringLiteral("AliceAlice1"),
+			  makeStringReplace(StringView{"{name}{name}{n}"}, what, with));
+
+	StringView const overlapping[] = {"abcd", "bc"};
+	StringView const replacement[] = {"X", "Y"};
+	EXPECT_EQ(StringLiteral("aYd"), makeStringReplace(StringView{"abcd"}, overlapping, replacement));
+
+	StringView const tooFew[] = {"X"};
+	EXPECT_TRUE(makeStringReplace(StringView{"abcd"}, overlapping, tooFew).isError());
+}
+
 TEST(TestString, testSplit) {
 	String const dest0 = makeString(StringLiteral{"boo"});
 	String const dest1 = makeString(StringLiteral{"and"});
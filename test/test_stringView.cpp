@@ -302,6 +302,64 @@ TEST(TestStringView, testHashCode) {
 			  StringView("Hello out there").hashCode());
 }
 
+/**
+    * @see StringView::equalsIgnoreCase
+    */
+TEST(TestStringView, testEqualsIgnoreCase) {
+    EXPECT_TRUE(StringView{}.equalsIgnoreCase(StringView{}));
+    EXPECT_TRUE(StringView{"Content-Length"}.equalsIgnoreCase("content-length"));
+    EXPECT_TRUE(StringView{"CONTENT-LENGTH"}.equalsIgnoreCase("Content-Length"));
+    EXPECT_FALSE(StringView{"Content-Length"}.equalsIgnoreCase("Content-Type"));
+    EXPECT_FALSE(StringView{"Content"}.equalsIgnoreCase("Content-Type"));
+
+    // Only ASCII letters are folded
+    EXPECT_FALSE(StringView{"@[`{"}.equalsIgnoreCase("`{@["));
+
+    // Long enough to span several vector blocks with a difference in the tail
+    StringView const longValue{"Sec-WebSocket-Extensions: PERMESSAGE-DEFLATE; client_max_window_bits"};
+    EXPECT_TRUE(longValue.equalsIgnoreCase("sec-websocket-extensions: permessage-deflate; CLIENT_MAX_WINDOW_BITS"));
+    EXPECT_FALSE(longValue.equalsIgnoreCase("sec-websocket-extensions: permessage-deflate; CLIENT_MAX_WINDOW_BITZ"));
+}
+
+/**
+    * @see StringView::compareToIgnoreCase
+    */
+TEST(TestStringView, testCompareToIgnoreCase) {
+    EXPECT_EQ(0, StringView{"Hello"}.compareToIgnoreCase("hELLO"));
+    EXPECT_LT(StringView{"apple"}.compareToIgnoreCase("Banana"), 0);
+    EXPECT_GT(StringView{"Cherry"}.compareToIgnoreCase("banana"), 0);
+    EXPECT_LT(StringView{"abc"}.compareToIgnoreCase("ABCD"), 0);
+    EXPECT_GT(StringView{"ABCD"}.compareToIgnoreCase("abc"), 0);
+    EXPECT_GT(StringView{"0123456789abcdefghiJ"}.compareToIgnoreCase("0123456789ABCDEFGHIi"), 0);
+}
+
+/**
+    * @see StringView::startsWithIgnoreCase
+    */
+TEST(TestStringView, testStartsWithIgnoreCase) {
+    EXPECT_TRUE(StringView{}.startsWithIgnoreCase(StringView{}));
+    EXPECT_TRUE(StringView{"Hello"}.startsWithIgnoreCase(""));
+    EXPECT_FALSE(StringView{}.startsWithIgnoreCase("Hello"));
+    EXPECT_TRUE(StringView{"Hello world"}.startsWithIgnoreCase("HELLO"));
+    EXPECT_FALSE(StringView{"Hello world"}.startsWithIgnoreCase("WORLD"));
+    EXPECT_FALSE(StringView{"Some"}.startsWithIgnoreCase("SOME very long statement"));
+}
+
+/**
+    * @see StringView::hashCodeIgnoreCase
+    */
+TEST(TestStringView, testHashCodeIgnoreCase) {
+    EXPECT_EQ(StringView{"Hello out there"}.hashCodeIgnoreCase(),
+              StringView{"HELLO OUT THERE"}.hashCodeIgnoreCase());
+    EXPECT_EQ(StringView{"hello out there"}.hashCode(),
+              StringView{"Hello Out There"}.hashCodeIgnoreCase());
+    EXPECT_NE(StringView{"Hello otu there"}.hashCodeIgnoreCase(),
+              StringView{"Hello out there"}.hashCodeIgnoreCase());
+
+    EXPECT_EQ(HashIgnoreCase{}("Accept"), HashIgnoreCase{}("ACCEPT"));
+    EXPECT_TRUE(EqualsIgnoreCase{}("Accept", "aCCEPT"));
+}
+
 TEST(TestStringView, testSplitByChar) {
     {
         int acc = 0;
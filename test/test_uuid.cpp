@@ -23,6 +23,11 @@
 
 #include <gtest/gtest.h>
 
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
 
 using namespace Solace;
 
@@ -49,6 +54,94 @@ TEST(TestUUID, testRandom) {
 }
 
 
+TEST(TestUUID, testRandomIsVersion4) {
+    for (uint i = 0; i < RandomSampleSize; ++i) {
+        auto const id = makeRandomUUID();
+        EXPECT_EQ(0x40, id[6] & 0xF0);
+        EXPECT_EQ(0x80, id[8] & 0xC0);
+    }
+}
+
+
+TEST(TestUUID, testGeneratorIsChaCha20) {
+    // Keystream of ChaCha20 with zero key and nonce (RFC 8439, A.1 #1): the first 32 bytes become the next key
+    byte const seed[UUIDGenerator::kSeedSize] = {0};
+    auto maybeGenerator = UUIDGenerator::seeded(wrapMemory(seed));
+    ASSERT_TRUE(maybeGenerator.isOk());
+
+    auto& generator = maybeGenerator.unwrap();
+    EXPECT_EQ(UUID::parse("da41597c-5157-488d-b724-e03fb8d84a37").unwrap(), generator.generate());
+    EXPECT_EQ(UUID::parse("6a43b8f4-1518-411c-8387-b669b2ee6586").unwrap(), generator.generate());
+
+    EXPECT_TRUE(UUIDGenerator::seeded(wrapMemory(seed, 16)).isError());
+}
+
+
+TEST(TestUUID, testGeneratorBatch) {
+    byte const seed[UUIDGenerator::kSeedSize] = {1, 2, 3, 4, 5, 6, 7, 8};
+    auto one = UUIDGenerator::seeded(wrapMemory(seed)).unwrap();
+    auto batch = UUIDGenerator::seeded(wrapMemory(seed)).unwrap();
+
+    // Enough to span several refills of the buffer, starting mid-buffer
+    UUID first[3];
+    batch.generate(arrayView(first));
+    UUID ids[200];
+    batch.generate(arrayView(ids));
+
+    for (auto const& id : first) {
+        EXPECT_EQ(one.generate(), id);
+    }
+    for (auto const& id : ids) {
+        EXPECT_EQ(one.generate(), id);
+        EXPECT_EQ(0x40, id[6] & 0xF0);
+        EXPECT_EQ(0x80, id[8] & 0xC0);
+    }
+
+    for (uint i = 0; i < 200; ++i) {
+        for (uint j = i + 1; j < 200; ++j) {
+            EXPECT_NE(ids[i], ids[j]);
+        }
+    }
+}
+
+
+TEST(TestUUID, testGeneratorPerThread) {
+    UUID other;
+    std::thread worker{[&other]() noexcept { other = makeRandomUUID(); }};
+    auto const id = makeRandomUUID();
+    worker.join();
+
+    EXPECT_NE(&UUIDGenerator::threadLocal(), nullptr);
+    EXPECT_NE(id, other);
+}
+
+
+TEST(TestUUID, testGeneratorReseedsAfterFork) {
+    static_cast<void>(makeRandomUUID());  // Make sure generator of this thread is seeded before fork
+
+    int fds[2];
+    ASSERT_EQ(0, ::pipe(fds));
+
+    auto const pid = ::fork();
+    ASSERT_LE(0, pid);
+    if (pid == 0) {
+        auto const id = makeRandomUUID();
+        auto const written = ::write(fds[1], id.begin(), id.size());
+        ::_exit(written == static_cast<ssize_t>(id.size()) ? 0 : 1);
+    }
+
+    byte childBytes[UUID::StaticSize];
+    auto const bytesRead = ::read(fds[0], childBytes, sizeof(childBytes));
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    ::close(fds[0]);
+    ::close(fds[1]);
+
+    ASSERT_EQ(static_cast<ssize_t>(sizeof(childBytes)), bytesRead);
+    EXPECT_NE(UUID{childBytes}, makeRandomUUID());
+}
+
+
 TEST(TestUUID, testConstruction) {
 
     // Random UUID using default constructor